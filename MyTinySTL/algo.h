@@ -9,6 +9,8 @@
 // 这个头文件包含了mystl的一系列算法
 #include <cstddef>
 #include <ctime>
+#include <functional>
+#include <type_traits>
 
 #include "algobase.h"
 #include "functional.h"
@@ -1489,8 +1491,6 @@ RandomIter partial_sort_copy(InputIter first,
 // sort
 // 将[first, last)内的元素以递增的方式排序
 /*************************************/
-// 小型区间的大小，在这个大小内采用插入排序
-constexpr static size_t kSmallSectionSize = 128;
 // 用于控制分割恶化的情况
 template <class Size>
 Size slg2(Size n) {
@@ -1554,52 +1554,6 @@ RandomIter unchecked_partition(RandomIter first,
     }
 }
 
-// 内省式排序，先进行 quick sort，当分割行为有恶化倾向时，改用 heap sort
-template <class RandomIter, class Size>
-void intro_sort(RandomIter first, RandomIter last, Size depth_limit) {
-    // 当待排序范围的大小大于一个预定义的阈值 kSmallSectionSize
-    // 时，会执行以下操作
-    while (static_cast<size_t>(last - first) > kSmallSectionSize) {
-        if (depth_limit == 0) {
-            // 到达最大分割深度限制
-            mystl::partial_sort(first, last, last);  // 改用heap_sort
-            return;
-        }
-        --depth_limit;
-        // 计算中间元素mid，它是first、(first+(last-first)/2)和*(last-1)三个元素的中位数
-        auto mid =
-            mystl::median((*first), *(first + (last - first) / 2), *(last - 1));
-        // 使用 mid 对范围进行划分，将小于 mid 的元素放在前面，大于 mid
-        // 的元素放在后面，并返回分割点 cut
-        auto cut = mystl::unchecked_partition(first, last, mid);
-        // 递归调用intro_sort函数，对后半部分范围进行排序，即调用intro_sort(cut,
-        // last, depth_limit)
-        mystl::intro_sort(cut, last, depth_limit);
-        // 更新 last 的值为 cut，表示待排序范围的右边界
-        last = cut;
-    }
-}
-
-// 内省式排序，先进行 quick sort，当分割行为有恶化倾向时，改用 heap sort
-template <class RandomIter, class Size, class Compared>
-void intro_sort(RandomIter first,
-                RandomIter last,
-                Size depth_limit,
-                Compared comp) {
-    while (static_cast<size_t>(last - first) > kSmallSectionSize) {
-        if (depth_limit == 0) {  // 到达最大分割深度限制
-            mystl::partial_sort(first, last, last, comp);  // 改用 heap_sort
-            return;
-        }
-        --depth_limit;
-        auto mid =
-            mystl::median(*(first), *(first + (last - first) / 2), *(last - 1));
-        auto cut = mystl::unchecked_partition(first, last, mid, comp);
-        mystl::intro_sort(cut, last, depth_limit, comp);
-        last = cut;
-    }
-}
-
 // 插入排序辅助函数 unchecked_linear_insert
 // 接受一个随机迭代器 last 和一个值 value。函数的作用是将值 value 插入到以 last
 // 为末尾的序列中，保持序列有序
@@ -1638,27 +1592,6 @@ void unchecked_linear_insert(RandomIter last, const T& value, Compared comp) {
     *last = value;
 }
 
-// 插入排序的基本思想是，将待排序的元素逐个插入到已排序的序列中的正确位置，直到所有元素都被插入完毕。
-// 在每次插入操作中，将当前元素与已排序的序列从后往前进行比较，找到合适的位置插入
-template <class RandomIter>
-void unchecked_insertion_sort(RandomIter first, RandomIter last) {
-    for (auto i = first; i != last; ++i) {
-        // 将当前迭代器 i 指向的元素插入到已排序的序列中
-        mystl::unchecked_linear_insert(i, *i);
-    }
-}
-
-// 插入排序函数 unchecked_insertion_sort
-// 使用comp函数对象进行重载
-template <class RandomIter, class Compared>
-void unchecked_insertion_sort(RandomIter first,
-                              RandomIter last,
-                              Compared comp) {
-    for (auto i = first; i != last; ++i) {
-        mystl::unchecked_linear_insert(i, *i, comp);
-    }
-}
-
 // 插入排序函数 insertion_sort
 // 插入排序算法的基本思想是将一个元素插入到已经排序好的序列中的适当位置，从而得到一个新的有序序列
 template <class RandomIter>
@@ -1700,59 +1633,835 @@ void insertion_sort(RandomIter first, RandomIter last, Compared comp) {
     }
 }
 
-// 最终插入排序函数 final_insertion_sort
-// 对一个范围内的元素进行最终的插入排序
-// 接受两个迭代器参数 first 和
-// last，表示要排序的范围。范围内的元素类型必须支持随机访问迭代器。
-// 这样的设计是为了在元素数量较大时，采用分段插入排序的方式，以提高排序效率。而在元素数量较小时，直接使用插入排序即可。
+// pattern-defeating quicksort (pdqsort)
+// 1. 小区间使用插入排序；大区间用 ninther（九个数的中位数）选取枢轴，较小的区间用三数取中
+// 2. 分割后若区间已经有序（分割时没有交换），尝试有限步数的插入排序，成功则直接结束，
+//    因此有序、逆序、organ-pipe 等有规律的输入接近线性时间
+// 3. 若分割严重不平衡，打乱两侧的部分元素以破坏导致坏枢轴的模式，
+//    不平衡的次数超过 log(n) 时改用 heap sort，保证最坏情况 O(nlogn)
+// 4. 若枢轴与左侧相邻的元素（上一个枢轴）相等，说明区间内有大量重复元素，
+//    把等于枢轴的元素分到左侧后直接跳过
+// 5. 对算术类型使用 less / greater 比较时，采用分块的无分支分割（BlockQuicksort），
+//    比较结果只用于计算下标，避免分支预测失败
+
+// 小于这个大小的区间使用插入排序
+constexpr size_t kPdqInsertionSortThreshold = 24;
+// 大于这个大小的区间使用 ninther 选取枢轴
+constexpr size_t kPdqNintherThreshold = 128;
+// partial_insertion_sort 最多移动的元素个数，超过时放弃
+constexpr size_t kPdqPartialInsertionSortLimit = 8;
+// 无分支分割每一块的大小
+constexpr size_t kPdqBlockSize = 64;
+
+// 是否使用无分支分割：比较函数为 less / greater，并且元素为算术类型
+template <class T, class Compared>
+struct pdq_use_branchless : public m_false_type {};
+
+template <class T>
+struct pdq_use_branchless<T, mystl::less<T>>
+    : public m_bool_constant<std::is_arithmetic<T>::value> {};
+
+template <class T>
+struct pdq_use_branchless<T, mystl::greater<T>>
+    : public m_bool_constant<std::is_arithmetic<T>::value> {};
+
+template <class T>
+struct pdq_use_branchless<T, std::less<T>>
+    : public m_bool_constant<std::is_arithmetic<T>::value> {};
+
+template <class T>
+struct pdq_use_branchless<T, std::greater<T>>
+    : public m_bool_constant<std::is_arithmetic<T>::value> {};
+
+// 插入排序，用移动代替复制
+template <class RandomIter, class Compared>
+void pdq_insertion_sort(RandomIter first, RandomIter last, Compared comp) {
+    if (first == last)
+        return;
+    for (auto cur = first + 1; cur != last; ++cur) {
+        auto sift = cur;
+        auto sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            auto tmp = mystl::move(*sift);
+            do {
+                *sift-- = mystl::move(*sift_1);
+            } while (sift != first && comp(tmp, *--sift_1));
+            *sift = mystl::move(tmp);
+        }
+    }
+}
+
+// 无边界检查的插入排序，要求 *(first - 1) 不大于区间内的任何元素
+template <class RandomIter, class Compared>
+void pdq_unguarded_insertion_sort(RandomIter first,
+                                  RandomIter last,
+                                  Compared comp) {
+    if (first == last)
+        return;
+    for (auto cur = first + 1; cur != last; ++cur) {
+        auto sift = cur;
+        auto sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            auto tmp = mystl::move(*sift);
+            do {
+                *sift-- = mystl::move(*sift_1);
+            } while (comp(tmp, *--sift_1));
+            *sift = mystl::move(tmp);
+        }
+    }
+}
+
+// 尝试用插入排序完成排序，移动的元素超过 kPdqPartialInsertionSortLimit
+// 时放弃并返回 false，区间仍然是原来元素的一个排列
+template <class RandomIter, class Compared>
+bool pdq_partial_insertion_sort(RandomIter first,
+                                RandomIter last,
+                                Compared comp) {
+    if (first == last)
+        return true;
+    size_t limit = 0;
+    for (auto cur = first + 1; cur != last; ++cur) {
+        auto sift = cur;
+        auto sift_1 = cur - 1;
+        if (comp(*sift, *sift_1)) {
+            auto tmp = mystl::move(*sift);
+            do {
+                *sift-- = mystl::move(*sift_1);
+            } while (sift != first && comp(tmp, *--sift_1));
+            *sift = mystl::move(tmp);
+            limit += static_cast<size_t>(cur - sift);
+        }
+        if (limit > kPdqPartialInsertionSortLimit)
+            return false;
+    }
+    return true;
+}
+
+// 使 *a <= *b <= *c
+template <class RandomIter, class Compared>
+void pdq_sort3(RandomIter a, RandomIter b, RandomIter c, Compared comp) {
+    if (comp(*b, *a))
+        mystl::iter_swap(a, b);
+    if (comp(*c, *b))
+        mystl::iter_swap(b, c);
+    if (comp(*b, *a))
+        mystl::iter_swap(a, b);
+}
+
+// 以 *first 为枢轴分割，小于枢轴的元素在左侧，不小于枢轴的元素在右侧
+// 返回枢轴的最终位置，以及分割前区间是否已经分好（没有发生交换）
+// 要求区间内存在不小于枢轴的元素，且 *(first - 1) 或区间末尾之前存在小于枢轴的元素作为哨兵
+template <class RandomIter, class Compared>
+mystl::pair<RandomIter, bool> pdq_partition_right(RandomIter first,
+                                                  RandomIter last,
+                                                  Compared comp) {
+    auto pivot = mystl::move(*first);
+    auto begin = first;
+    // 找到第一个不小于枢轴的元素，ninther / 三数取中保证它存在
+    while (comp(*++first, pivot)) {
+    }
+    // 找到最后一个小于枢轴的元素，左侧没有小于枢轴的元素时需要检查边界
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {
+        }
+    } else {
+        while (!comp(*--last, pivot)) {
+        }
+    }
+    const bool already_partitioned = first >= last;
+    while (first < last) {
+        mystl::iter_swap(first, last);
+        while (comp(*++first, pivot)) {
+        }
+        while (!comp(*--last, pivot)) {
+        }
+    }
+    auto pivot_pos = first - 1;
+    *begin = mystl::move(*pivot_pos);
+    *pivot_pos = mystl::move(pivot);
+    return mystl::make_pair(pivot_pos, already_partitioned);
+}
+
+// 按 offsets_l / offsets_r 记录的位置交换两侧放错的元素
+// 两侧个数相同时逐对交换，否则沿着一个环移动，减少一半的赋值
 template <class RandomIter>
-void final_insertion_sort(RandomIter first, RandomIter last) {
-    if (static_cast<size_t>(last - first) > kSmallSectionSize) {
-        // 如果元素数量大于 kSmallSectionSize，则将范围分成两部分进行排序。
-        // 首先使用 mystl::insertion_sort 函数对前 kSmallSectionSize
-        // 个元素进行插入排序。 然后使用 mystl::unchecked_insertion_sort
-        // 函数对剩余的元素进行插入排序
-        mystl::insertion_sort(first, first + kSmallSectionSize);
-        mystl::unchecked_insertion_sort(first + kSmallSectionSize, last);
+void pdq_swap_offsets(RandomIter first,
+                      RandomIter last,
+                      unsigned char* offsets_l,
+                      unsigned char* offsets_r,
+                      size_t num,
+                      bool use_swaps) {
+    if (use_swaps) {
+        for (size_t i = 0; i < num; ++i)
+            mystl::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+    } else if (num > 0) {
+        auto l = first + offsets_l[0];
+        auto r = last - offsets_r[0];
+        auto tmp = mystl::move(*l);
+        *l = mystl::move(*r);
+        for (size_t i = 1; i < num; ++i) {
+            l = first + offsets_l[i];
+            *r = mystl::move(*l);
+            r = last - offsets_r[i];
+            *l = mystl::move(*r);
+        }
+        *r = mystl::move(tmp);
+    }
+}
+
+// pdq_partition_right 的无分支版本
+// 每次从两端各扫描一块，把放错位置的元素的偏移量记录下来，再成对交换
+template <class RandomIter, class Compared>
+mystl::pair<RandomIter, bool> pdq_partition_right_branchless(RandomIter first,
+                                                             RandomIter last,
+                                                             Compared comp) {
+    auto pivot = mystl::move(*first);
+    auto begin = first;
+    while (comp(*++first, pivot)) {
+    }
+    if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {
+        }
     } else {
-        //
-        mystl::insertion_sort(first, last);
+        while (!comp(*--last, pivot)) {
+        }
+    }
+    const bool already_partitioned = first >= last;
+    if (!already_partitioned) {
+        mystl::iter_swap(first, last);
+        ++first;
+
+        unsigned char offsets_l[kPdqBlockSize];
+        unsigned char offsets_r[kPdqBlockSize];
+        auto offsets_l_base = first;
+        auto offsets_r_base = last;
+        size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+        while (first < last) {
+            // 还未扫描的元素个数，不足两块时在两侧之间分配
+            const size_t num_unknown = static_cast<size_t>(last - first);
+            const size_t left_split =
+                num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+            const size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+            // 左侧记录不小于枢轴的元素，右侧记录小于枢轴的元素
+            if (left_split >= kPdqBlockSize) {
+                for (size_t i = 0; i < kPdqBlockSize;) {
+                    for (size_t j = 0; j < 8; ++j) {
+                        offsets_l[num_l] = static_cast<unsigned char>(i++);
+                        num_l += !comp(*first, pivot);
+                        ++first;
+                    }
+                }
+            } else {
+                for (size_t i = 0; i < left_split;) {
+                    offsets_l[num_l] = static_cast<unsigned char>(i++);
+                    num_l += !comp(*first, pivot);
+                    ++first;
+                }
+            }
+            if (right_split >= kPdqBlockSize) {
+                for (size_t i = 0; i < kPdqBlockSize;) {
+                    for (size_t j = 0; j < 8; ++j) {
+                        offsets_r[num_r] = static_cast<unsigned char>(++i);
+                        num_r += comp(*--last, pivot);
+                    }
+                }
+            } else {
+                for (size_t i = 0; i < right_split;) {
+                    offsets_r[num_r] = static_cast<unsigned char>(++i);
+                    num_r += comp(*--last, pivot);
+                }
+            }
+
+            const size_t num = mystl::min(num_l, num_r);
+            mystl::pdq_swap_offsets(offsets_l_base, offsets_r_base,
+                                    offsets_l + start_l, offsets_r + start_r,
+                                    num, num_l == num_r);
+            num_l -= num;
+            num_r -= num;
+            start_l += num;
+            start_r += num;
+            if (num_l == 0) {
+                start_l = 0;
+                offsets_l_base = first;
+            }
+            if (num_r == 0) {
+                start_r = 0;
+                offsets_r_base = last;
+            }
+        }
+
+        // 一侧还有剩余的偏移量，把这些元素移到分割点
+        if (num_l) {
+            while (num_l--)
+                mystl::iter_swap(offsets_l_base + offsets_l[start_l + num_l],
+                                 --last);
+            first = last;
+        }
+        if (num_r) {
+            while (num_r--) {
+                mystl::iter_swap(offsets_r_base - offsets_r[start_r + num_r],
+                                 first);
+                ++first;
+            }
+            last = first;
+        }
     }
+    auto pivot_pos = first - 1;
+    *begin = mystl::move(*pivot_pos);
+    *pivot_pos = mystl::move(pivot);
+    return mystl::make_pair(pivot_pos, already_partitioned);
 }
 
-// 最终插入排序函数 final_insertion_sort
-// comp函数对象重载版
+// 以 *first 为枢轴分割，不大于枢轴的元素在左侧，大于枢轴的元素在右侧
+// 用于枢轴与左侧相邻元素相等的情况，返回枢轴的最终位置
 template <class RandomIter, class Compared>
-void final_insertion_sort(RandomIter first, RandomIter last, Compared comp) {
-    if (static_cast<size_t>(last - first) > kSmallSectionSize) {
-        mystl::insertion_sort(first, first + kSmallSectionSize, comp);
-        mystl::unchecked_insertion_sort(first + kSmallSectionSize, last, comp);
+RandomIter pdq_partition_left(RandomIter first,
+                              RandomIter last,
+                              Compared comp) {
+    auto pivot = mystl::move(*first);
+    auto begin = first;
+    auto end = last;
+    while (comp(pivot, *--last)) {
+    }
+    if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first)) {
+        }
     } else {
-        mystl::insertion_sort(first, last, comp);
+        while (!comp(pivot, *++first)) {
+        }
+    }
+    while (first < last) {
+        mystl::iter_swap(first, last);
+        while (comp(pivot, *--last)) {
+        }
+        while (!comp(pivot, *++first)) {
+        }
+    }
+    *begin = mystl::move(*last);
+    *last = mystl::move(pivot);
+    return last;
+}
+
+// 选择分割方式
+template <class RandomIter, class Compared>
+mystl::pair<RandomIter, bool> pdq_partition(RandomIter first,
+                                            RandomIter last,
+                                            Compared comp,
+                                            m_true_type) {
+    return mystl::pdq_partition_right_branchless(first, last, comp);
+}
+
+template <class RandomIter, class Compared>
+mystl::pair<RandomIter, bool> pdq_partition(RandomIter first,
+                                            RandomIter last,
+                                            Compared comp,
+                                            m_false_type) {
+    return mystl::pdq_partition_right(first, last, comp);
+}
+
+// pdqsort 的主循环
+// bad_allowed 为还允许出现的不平衡分割次数，leftmost 表示区间左侧没有其它元素
+template <class RandomIter, class Compared, class Branchless>
+void pdq_sort_loop(RandomIter first,
+                   RandomIter last,
+                   Compared comp,
+                   size_t bad_allowed,
+                   bool leftmost,
+                   Branchless branchless) {
+    while (true) {
+        const size_t size = static_cast<size_t>(last - first);
+        if (size < kPdqInsertionSortThreshold) {
+            if (leftmost)
+                mystl::pdq_insertion_sort(first, last, comp);
+            else
+                mystl::pdq_unguarded_insertion_sort(first, last, comp);
+            return;
+        }
+
+        // 选取枢轴并放到 first 处
+        const size_t s2 = size / 2;
+        if (size > kPdqNintherThreshold) {
+            mystl::pdq_sort3(first, first + s2, last - 1, comp);
+            mystl::pdq_sort3(first + 1, first + (s2 - 1), last - 2, comp);
+            mystl::pdq_sort3(first + 2, first + (s2 + 1), last - 3, comp);
+            mystl::pdq_sort3(first + (s2 - 1), first + s2, first + (s2 + 1),
+                             comp);
+            mystl::iter_swap(first, first + s2);
+        } else {
+            mystl::pdq_sort3(first + s2, first, last - 1, comp);
+        }
+
+        // 枢轴等于左侧的上一个枢轴时，等于枢轴的元素已经在正确的位置，跳过它们
+        if (!leftmost && !comp(*(first - 1), *first)) {
+            first = mystl::pdq_partition_left(first, last, comp) + 1;
+            continue;
+        }
+
+        auto part = mystl::pdq_partition(first, last, comp, branchless);
+        auto pivot_pos = part.first;
+        const bool already_partitioned = part.second;
+
+        const size_t l_size = static_cast<size_t>(pivot_pos - first);
+        const size_t r_size = static_cast<size_t>(last - (pivot_pos + 1));
+        const bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        if (highly_unbalanced) {
+            // 不平衡的次数过多，改用 heap sort
+            if (--bad_allowed == 0) {
+                mystl::partial_sort(first, last, last, comp);
+                return;
+            }
+            // 交换两侧的部分元素，打乱导致坏枢轴的模式
+            if (l_size >= kPdqInsertionSortThreshold) {
+                mystl::iter_swap(first, first + l_size / 4);
+                mystl::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > kPdqNintherThreshold) {
+                    mystl::iter_swap(first + 1, first + (l_size / 4 + 1));
+                    mystl::iter_swap(first + 2, first + (l_size / 4 + 2));
+                    mystl::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    mystl::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= kPdqInsertionSortThreshold) {
+                mystl::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                mystl::iter_swap(last - 1, last - r_size / 4);
+                if (r_size > kPdqNintherThreshold) {
+                    mystl::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    mystl::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    mystl::iter_swap(last - 2, last - (1 + r_size / 4));
+                    mystl::iter_swap(last - 3, last - (2 + r_size / 4));
+                }
+            }
+        } else if (already_partitioned &&
+                   mystl::pdq_partial_insertion_sort(first, pivot_pos, comp) &&
+                   mystl::pdq_partial_insertion_sort(pivot_pos + 1, last, comp)) {
+            // 分割前已经分好，并且两侧都几乎有序
+            return;
+        }
+
+        // 递归处理左侧，循环处理右侧
+        mystl::pdq_sort_loop(first, pivot_pos, comp, bad_allowed, leftmost,
+                             branchless);
+        first = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+// 整个区间严格递减时直接翻转，第一对元素不是递减时立即返回
+template <class RandomIter, class Compared>
+bool pdq_reverse_if_descending(RandomIter first,
+                               RandomIter last,
+                               Compared comp) {
+    auto next = first;
+    for (++next; next != last; ++first, ++next) {
+        if (!comp(*next, *first))
+            return false;
+    }
+    return true;
+}
+
+template <class RandomIter, class Compared>
+void sort(RandomIter first, RandomIter last, Compared comp) {
+    if (last - first < 2)
+        return;
+    // 严格递减的区间翻转后即有序，其余有规律的输入由 pdqsort 本身识别
+    if (mystl::pdq_reverse_if_descending(first, last, comp)) {
+        mystl::reverse(first, last);
+        return;
     }
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    mystl::pdq_sort_loop(first, last, comp, mystl::slg2(last - first), true,
+                         pdq_use_branchless<value_type, Compared>());
 }
 
 template <class RandomIter>
 void sort(RandomIter first, RandomIter last) {
-    if (first != last) {
-        // 内省式排序是一种将区间分割为多个小区间，然后对整体进行插入排序的排序算法。
-        // 它首先使用 mystl::intro_sort 函数对整个区间进行排序，其中 slg2(last -
-        // first) * 2 是一个用于确定递归深度的参数。 然后使用
-        // mystl::final_insertion_sort 函数对整个区间进行最后的插入排序。
-        mystl::intro_sort(first, last, slg2(last - first) * 2);
-        mystl::final_insertion_sort(first, last);
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    mystl::sort(first, last, mystl::less<value_type>());
+}
+
+/*****************************************************************************************/
+// stable_sort
+// 将[first, last)内的元素以递增的方式排序，相等元素保持原来的相对次序
+/*****************************************************************************************/
+// notes:
+//
+// 1. 从左向右识别自然有序段（run），严格递减的段原地翻转，
+//    短于 min_run 的段用插入排序补足到 min_run
+// 2. 按 powersort 的规则决定合并次序：相邻两段的 power 由它们的中点在整个区间中的位置决定，
+//    新段的 power 小于栈顶的 power 时先合并栈顶的段，使合并树接近平衡
+// 3. 合并时把较短的一段移入缓冲区，逐个比较；一侧连续胜出 min_gallop 次后改用倍增查找，
+//    整块移动，数据部分有序时比较次数接近 O(n)
+// 4. 缓冲区不足较短的一段时改用 merge_adaptive 分割递归，申请不到缓冲区时改用 merge_without_buffer
+
+// 小于这个大小的区间直接使用插入排序
+constexpr ptrdiff_t kStableSortMinMerge = 64;
+// 进入倍增模式的初始阈值
+constexpr ptrdiff_t kStableSortMinGallop = 7;
+
+// 由区间长度计算 min_run，使 n / min_run 接近且不超过 2 的幂
+template <class Distance>
+Distance stable_min_run(Distance n) {
+    Distance r = 0;
+    while (n >= kStableSortMinMerge) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+// [first, start) 已经有序，把 [start, last) 的元素依次插入
+// 算术类型比较代价低，从后向前逐个比较；其余类型用 upper_bound 查找插入位置，减少比较次数
+template <class RandomIter, class Compared>
+void stable_insertion_sort(RandomIter first,
+                           RandomIter start,
+                           RandomIter last,
+                           Compared comp,
+                           m_true_type) {
+    for (; start != last; ++start) {
+        auto value = mystl::move(*start);
+        auto pos = start;
+        for (; pos != first && comp(value, *(pos - 1)); --pos)
+            *pos = mystl::move(*(pos - 1));
+        *pos = mystl::move(value);
     }
 }
 
 template <class RandomIter, class Compared>
-void sort(RandomIter first, RandomIter last, Compared comp) {
-    if (first != last) {
-        // 内省式排序，将区间分为一个个小区间，然后对整体进行插入排序
-        mystl::intro_sort(first, last, slg2(last - first) * 2, comp);
-        mystl::final_insertion_sort(first, last, comp);
+void stable_insertion_sort(RandomIter first,
+                           RandomIter start,
+                           RandomIter last,
+                           Compared comp,
+                           m_false_type) {
+    for (; start != last; ++start) {
+        auto value = mystl::move(*start);
+        auto pos = mystl::upper_bound(first, start, value, comp);
+        mystl::move_backward(pos, start, start + 1);
+        *pos = mystl::move(value);
     }
 }
 
+template <class RandomIter, class Compared>
+void stable_insertion_sort(RandomIter first,
+                           RandomIter start,
+                           RandomIter last,
+                           Compared comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    mystl::stable_insertion_sort(
+        first, start, last, comp,
+        m_bool_constant<std::is_arithmetic<value_type>::value>());
+}
+
+// 返回从 first 开始的有序段的末尾，严格递减的段被翻转为递增
+template <class RandomIter, class Compared>
+RandomIter stable_count_run(RandomIter first, RandomIter last, Compared comp) {
+    auto run_end = first + 1;
+    if (run_end == last)
+        return last;
+    if (comp(*run_end, *first)) {  // 严格递减，翻转不会破坏稳定性
+        for (++run_end; run_end != last && comp(*run_end, *(run_end - 1));)
+            ++run_end;
+        mystl::reverse(first, run_end);
+    } else {
+        for (++run_end; run_end != last && !comp(*run_end, *(run_end - 1));)
+            ++run_end;
+    }
+    return run_end;
+}
+
+// 对满足 pred 的前缀从左向右倍增查找，返回第一个使 pred 为 false 的位置
+template <class RandomIter, class Predicate>
+RandomIter stable_gallop_forward(RandomIter first,
+                                 RandomIter last,
+                                 Predicate pred) {
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    const Distance n = last - first;
+    Distance prev = 0, ofs = 1;
+    while (ofs <= n && pred(*(first + (ofs - 1)))) {
+        prev = ofs;
+        ofs = ofs * 2 + 1;
+    }
+    // 结果在 [prev, hi] 之中
+    Distance hi = ofs > n ? n : ofs - 1;
+    while (prev < hi) {
+        const Distance mid = prev + (hi - prev) / 2;
+        if (pred(*(first + mid)))
+            prev = mid + 1;
+        else
+            hi = mid;
+    }
+    return first + prev;
+}
+
+// 同上，从右向左倍增查找
+template <class RandomIter, class Predicate>
+RandomIter stable_gallop_backward(RandomIter first,
+                                  RandomIter last,
+                                  Predicate pred) {
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    const Distance n = last - first;
+    Distance prev = 0, ofs = 1;
+    while (ofs <= n && !pred(*(last - ofs))) {
+        prev = ofs;
+        ofs = ofs * 2 + 1;
+    }
+    // 结果在 [lo, n - prev] 之中
+    Distance lo = ofs > n ? 0 : n - ofs + 1;
+    Distance hi = n - prev;
+    while (lo < hi) {
+        const Distance mid = lo + (hi - lo) / 2;
+        if (pred(*(first + mid)))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return first + lo;
+}
+
+// 把 [first, middle) 移入缓冲区，从前向后合并
+template <class RandomIter, class Pointer, class Compared>
+void stable_merge_lo(RandomIter first,
+                     RandomIter middle,
+                     RandomIter last,
+                     Pointer buffer,
+                     ptrdiff_t& min_gallop,
+                     Compared comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    Pointer cur1 = buffer;
+    Pointer last1 = mystl::move(first, middle, buffer);
+    RandomIter cur2 = middle;
+    RandomIter out = first;
+    while (cur1 != last1 && cur2 != last) {
+        // 逐个比较，直到一侧连续胜出 min_gallop 次
+        ptrdiff_t count1 = 0, count2 = 0;
+        do {
+            if (comp(*cur2, *cur1)) {
+                *out++ = mystl::move(*cur2++);
+                ++count2;
+                count1 = 0;
+                if (cur2 == last)
+                    break;
+            } else {
+                *out++ = mystl::move(*cur1++);
+                ++count1;
+                count2 = 0;
+                if (cur1 == last1)
+                    break;
+            }
+        } while ((count1 | count2) < min_gallop);
+        // 倍增模式，直到两侧每次移动的元素都少于 kStableSortMinGallop 个
+        while (cur1 != last1 && cur2 != last) {
+            const value_type& v2 = *cur2;
+            auto next1 = mystl::stable_gallop_forward(
+                cur1, last1, [&](const value_type& x) { return !comp(v2, x); });
+            count1 = next1 - cur1;
+            out = mystl::move(cur1, next1, out);
+            cur1 = next1;
+            if (cur1 == last1)
+                break;
+            const value_type& v1 = *cur1;
+            auto next2 = mystl::stable_gallop_forward(
+                cur2, last, [&](const value_type& x) { return comp(x, v1); });
+            count2 = next2 - cur2;
+            out = mystl::move(cur2, next2, out);
+            cur2 = next2;
+            if (min_gallop > 1)
+                --min_gallop;
+            if (count1 < kStableSortMinGallop && count2 < kStableSortMinGallop) {
+                min_gallop += 2;  // 离开倍增模式的惩罚
+                break;
+            }
+        }
+    }
+    // [cur2, last) 已经在最终位置
+    mystl::move(cur1, last1, out);
+}
+
+// 把 [middle, last) 移入缓冲区，从后向前合并
+template <class RandomIter, class Pointer, class Compared>
+void stable_merge_hi(RandomIter first,
+                     RandomIter middle,
+                     RandomIter last,
+                     Pointer buffer,
+                     ptrdiff_t& min_gallop,
+                     Compared comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    Pointer first2 = buffer;
+    Pointer cur2 = mystl::move(middle, last, buffer);
+    RandomIter cur1 = middle;
+    RandomIter out = last;
+    while (cur1 != first && cur2 != first2) {
+        ptrdiff_t count1 = 0, count2 = 0;
+        do {
+            if (comp(*(cur2 - 1), *(cur1 - 1))) {
+                *--out = mystl::move(*--cur1);
+                ++count1;
+                count2 = 0;
+                if (cur1 == first)
+                    break;
+            } else {
+                *--out = mystl::move(*--cur2);
+                ++count2;
+                count1 = 0;
+                if (cur2 == first2)
+                    break;
+            }
+        } while ((count1 | count2) < min_gallop);
+        while (cur1 != first && cur2 != first2) {
+            const value_type& v1 = *(cur1 - 1);
+            auto next2 = mystl::stable_gallop_backward(
+                first2, cur2, [&](const value_type& x) { return comp(x, v1); });
+            count2 = cur2 - next2;
+            out = mystl::move_backward(next2, cur2, out);
+            cur2 = next2;
+            if (cur2 == first2)
+                break;
+            const value_type& v2 = *(cur2 - 1);
+            auto next1 = mystl::stable_gallop_backward(
+                first, cur1, [&](const value_type& x) { return !comp(v2, x); });
+            count1 = cur1 - next1;
+            out = mystl::move_backward(next1, cur1, out);
+            cur1 = next1;
+            if (min_gallop > 1)
+                --min_gallop;
+            if (count1 < kStableSortMinGallop && count2 < kStableSortMinGallop) {
+                min_gallop += 2;
+                break;
+            }
+        }
+    }
+    // [first, cur1) 已经在最终位置
+    mystl::move_backward(first2, cur2, out);
+}
+
+// 合并相邻的两个有序段 [first, middle) 与 [middle, last)
+template <class RandomIter, class Pointer, class Distance, class Compared>
+void stable_merge_runs(RandomIter first,
+                       RandomIter middle,
+                       RandomIter last,
+                       Pointer buffer,
+                       Distance buffer_size,
+                       ptrdiff_t& min_gallop,
+                       Compared comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    // 前一段中不大于 *middle 的元素、后一段中不小于 *(middle - 1) 的元素已经在最终位置
+    const value_type& head2 = *middle;
+    first = mystl::stable_gallop_forward(
+        first, middle, [&](const value_type& x) { return !comp(head2, x); });
+    if (first == middle)
+        return;
+    const value_type& tail1 = *(middle - 1);
+    last = mystl::stable_gallop_backward(
+        middle, last, [&](const value_type& x) { return comp(x, tail1); });
+    const Distance len1 = middle - first;
+    const Distance len2 = last - middle;
+    if (len1 <= len2 && len1 <= buffer_size) {
+        mystl::stable_merge_lo(first, middle, last, buffer, min_gallop, comp);
+    } else if (len2 <= buffer_size) {
+        mystl::stable_merge_hi(first, middle, last, buffer, min_gallop, comp);
+    } else if (buffer_size > 0) {
+        mystl::merge_adaptive(first, middle, last, len1, len2, buffer,
+                              buffer_size, comp);
+    } else {
+        mystl::merge_without_buffer(first, middle, last, len1, len2, comp);
+    }
+}
+
+// powersort 中相邻两段 [begin1, begin2) 与 [begin2, end2) 的 power：
+// 两段中点除以 n 后的二进制小数相同的前缀位数加一
+template <class Distance>
+int stable_node_power(Distance n, Distance begin1, Distance begin2,
+                      Distance end2) {
+    const size_t two_n = static_cast<size_t>(n) * 2;
+    size_t l = static_cast<size_t>(begin1 + begin2);
+    size_t r = static_cast<size_t>(begin2 + end2);
+    int power = 1;
+    while ((l >= two_n) == (r >= two_n)) {
+        if (l >= two_n) {
+            l -= two_n;
+            r -= two_n;
+        }
+        l <<= 1;
+        r <<= 1;
+        ++power;
+    }
+    return power;
+}
+
+template <class RandomIter, class Pointer, class Distance, class Compared>
+void stable_sort_runs(RandomIter first,
+                      RandomIter last,
+                      Distance first_run,
+                      Pointer buffer,
+                      Distance buffer_size,
+                      Compared comp) {
+    const Distance n = last - first;
+    const Distance min_run = mystl::stable_min_run(n);
+    ptrdiff_t min_gallop = kStableSortMinGallop;
+    // 栈中各段的 power 严格递增，深度不超过 power 的最大值
+    Distance begins[sizeof(Distance) * 8 + 2];
+    int powers[sizeof(Distance) * 8 + 2];
+    int top = 0;
+    Distance cur = 0;
+    Distance run_end = first_run;
+    while (true) {
+        if (run_end - cur < min_run) {
+            const Distance force = n - cur < min_run ? n : cur + min_run;
+            mystl::stable_insertion_sort(first + cur, first + run_end,
+                                         first + force, comp);
+            run_end = force;
+        }
+        if (top > 0) {
+            const int p =
+                mystl::stable_node_power(n, begins[top - 1], cur, run_end);
+            while (top > 1 && powers[top - 2] > p) {
+                mystl::stable_merge_runs(first + begins[top - 2],
+                                         first + begins[top - 1], first + cur,
+                                         buffer, buffer_size, min_gallop, comp);
+                --top;
+            }
+            powers[top - 1] = p;
+        }
+        begins[top++] = cur;
+        cur = run_end;
+        if (cur == n)
+            break;
+        run_end = mystl::stable_count_run(first + cur, last, comp) - first;
+    }
+    for (; top > 1; --top) {
+        mystl::stable_merge_runs(first + begins[top - 2],
+                                 first + begins[top - 1], last, buffer,
+                                 buffer_size, min_gallop, comp);
+    }
+}
+
+template <class RandomIter, class Compared>
+void stable_sort(RandomIter first, RandomIter last, Compared comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    const Distance n = last - first;
+    if (n < 2)
+        return;
+    const Distance first_run = mystl::stable_count_run(first, last, comp) - first;
+    if (first_run == n)
+        return;
+    if (n < kStableSortMinMerge) {
+        mystl::stable_insertion_sort(first, first + first_run, last, comp);
+        return;
+    }
+    // 合并时只需要移入较短的一段
+    temporary_buffer<RandomIter, value_type> buf(first, first + (n + 1) / 2);
+    mystl::stable_sort_runs(first, last, first_run, buf.begin(),
+                            static_cast<Distance>(buf.size()), comp);
+}
+
+template <class RandomIter>
+void stable_sort(RandomIter first, RandomIter last) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    mystl::stable_sort(first, last, mystl::less<value_type>());
+}
+
 /********************************************/
 // nth_element
 // 对序列重排，使得所有小于第 n
@@ -1785,7 +2494,8 @@ void nth_element(RandomIter first,
     while (last - first > 3) {
         auto cut = mystl::unchecked_partition(
             first, last,
-            mystl::median(*first, *(first + (last - first) / 2), *(last - 1)),
+            mystl::median(*first, *(first + (last - first) / 2), *(last - 1),
+                          comp),
             comp);
         if (cut <= nth)   // 如果 nth 位于右段
             first = cut;  // 对右段进行分割
@@ -2411,39 +3121,21 @@ bool is_permutation_aux(ForwardIter1 first1,
                         ForwardIter2 first2,
                         ForwardIter2 last2,
                         BinaryPred pred) {
-    constexpr bool is_ra_it =
-        mystl::is_random_access_iterator<ForwardIter1>::value &&
-        mystl::is_random_access_iterator<ForwardIter2>::value;
-    if (is_ra_it) {
-        auto len1 = last1 - first1;
-        auto len2 = last2 - first2;
-        // 如果长度不相等，则它们肯定不是排列，可以直接返回 false
-        if (len1 != len2) {
-            return false;
-        }
-    }
+    // 如果长度不相等，则它们肯定不是排列，可以直接返回 false
+    // mystl::distance 对随机访问迭代器是常数时间
+    if (mystl::distance(first1, last1) != mystl::distance(first2, last2))
+        return false;
 
     // 先找出相同的前缀段
-    for (; first1 != last1 && first2 != last2; ++first1, (void)++first2) {
+    for (; first1 != last1; ++first1, (void)++first2) {
         // 从序列头开始依次比较两个序列中的元素，直到找到第一个不相同的元素为止
         if (!pred(*first1, *first2)) {
             break;
         }
     }
-    // 如果前缀段的长度等于其中一个序列的长度，则两个序列完全相等，可以直接返回true
-    if (is_ra_it) {
-        if (first1 == last1) {
-            return true;
-        }
-    } else {
-        auto len1 = mystl::distance(first1, last1);
-        auto len2 = mystl::distance(first2, last2);
-        if (len1 == 0 && len2 == 0) {
-            return true;
-        }
-        if (len1 != len2) {
-            return false;
-        }
+    // 如果前缀段的长度等于序列的长度，则两个序列完全相等，可以直接返回true
+    if (first1 == last1) {
+        return true;
     }
 
     // 判断剩余部分
@@ -2571,6 +3263,81 @@ BidirectionalIter partition(BidirectionalIter first,
     return first;
 }
 
+/**********************************************/
+// stable_partition
+// 与 partition 相同，但保持元素原来的相对次序
+// 缓冲区能放下整个区间时一次扫描完成，否则分成两半递归后旋转，申请不到缓冲区时旋转不借助缓冲区
+/**********************************************/
+// [first, last) 的长度为 len，*first 不满足 unary_pred
+template <class BidirectionalIter,
+          class UnaryPredicate,
+          class Distance,
+          class Pointer>
+BidirectionalIter stable_partition_adaptive(BidirectionalIter first,
+                                            BidirectionalIter last,
+                                            UnaryPredicate unary_pred,
+                                            Distance len,
+                                            Pointer buffer,
+                                            Distance buffer_size) {
+    if (len == 1)
+        return first;
+    if (len <= buffer_size) {
+        auto result1 = first;
+        auto result2 = buffer;
+        *result2 = mystl::move(*first);
+        ++result2;
+        for (++first; first != last; ++first) {
+            if (unary_pred(*first)) {
+                *result1 = mystl::move(*first);
+                ++result1;
+            } else {
+                *result2 = mystl::move(*first);
+                ++result2;
+            }
+        }
+        mystl::move(buffer, result2, result1);
+        return result1;
+    }
+    const Distance half = len / 2;
+    auto middle = first;
+    mystl::advance(middle, half);
+    auto left_split = mystl::stable_partition_adaptive(
+        first, middle, unary_pred, half, buffer, buffer_size);
+    // 跳过右半部分开头满足条件的元素
+    Distance right_len = len - half;
+    auto right_split = middle;
+    while (right_len > 0 && unary_pred(*right_split)) {
+        ++right_split;
+        --right_len;
+    }
+    if (right_len > 0) {
+        right_split = mystl::stable_partition_adaptive(
+            right_split, last, unary_pred, right_len, buffer, buffer_size);
+    }
+    return mystl::rotate_adaptive(left_split, middle, right_split,
+                                  static_cast<Distance>(
+                                      mystl::distance(left_split, middle)),
+                                  static_cast<Distance>(
+                                      mystl::distance(middle, right_split)),
+                                  buffer, buffer_size);
+}
+
+template <class BidirectionalIter, class UnaryPredicate>
+BidirectionalIter stable_partition(BidirectionalIter first,
+                                   BidirectionalIter last,
+                                   UnaryPredicate unary_pred) {
+    typedef typename iterator_traits<BidirectionalIter>::value_type value_type;
+    typedef typename iterator_traits<BidirectionalIter>::difference_type
+        Distance;
+    first = mystl::find_if_not(first, last, unary_pred);
+    if (first == last)
+        return first;
+    temporary_buffer<BidirectionalIter, value_type> buf(first, last);
+    return mystl::stable_partition_adaptive(
+        first, last, unary_pred, mystl::distance(first, last), buf.begin(),
+        static_cast<Distance>(buf.size()));
+}
+
 /***********************************************/
 // random_shuffle
 // 将[first, last)内的元素次序随机重排
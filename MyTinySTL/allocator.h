@@ -8,6 +8,12 @@
 
 namespace mystl {
 
+// 供 allocator_traits 检测分配器是否声明了某个类型成员
+template <class...>
+struct alloc_void {
+    typedef void type;
+};
+
 // 模板类：allocator
 // 模板函数代表数据类型
 template <class T>
@@ -21,7 +27,19 @@ public:
     typedef size_t size_type;          /*! 数据类型大小 */
     typedef ptrdiff_t difference_type; /*! 数据类型指针距离 */
 
+    // 无状态的分配器：所有实例都相等，容器之间可以直接交换节点
+    typedef m_true_type is_always_equal;
+
+    // 取得另一种类型的 allocator，容器借此分配节点
+    template <class U>
+    struct rebind {
+        typedef allocator<U> other;
+    };
+
 public:
+    allocator() noexcept = default;
+    template <class U>
+    allocator(const allocator<U>&) noexcept {}
 
     // 分配内存
     static T* allocate();
@@ -131,6 +149,71 @@ void allocator<T>::destroy(T* first, T* last) {
     mystl::destroy(first, last);
 }
 
+template <class T, class U>
+bool operator==(const allocator<T>&, const allocator<U>&) noexcept {
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const allocator<T>&, const allocator<U>&) noexcept {
+    return false;
+}
+
+/*****************************************************************************************/
+// allocator_traits
+// 容器通过它使用分配器：取得 rebind 后的类型，以及有状态分配器在复制、移动、交换时的传播方式
+// 分配器未声明的属性取缺省值：不传播，空类视为总是相等
+/*****************************************************************************************/
+
+template <class Alloc, class = void>
+struct alloc_pocca : m_false_type {};
+template <class Alloc>
+struct alloc_pocca<Alloc, typename alloc_void<typename Alloc::propagate_on_container_copy_assignment>::type>
+    : m_bool_constant<Alloc::propagate_on_container_copy_assignment::value> {};
+
+template <class Alloc, class = void>
+struct alloc_pocma : m_false_type {};
+template <class Alloc>
+struct alloc_pocma<Alloc, typename alloc_void<typename Alloc::propagate_on_container_move_assignment>::type>
+    : m_bool_constant<Alloc::propagate_on_container_move_assignment::value> {};
+
+template <class Alloc, class = void>
+struct alloc_pocs : m_false_type {};
+template <class Alloc>
+struct alloc_pocs<Alloc, typename alloc_void<typename Alloc::propagate_on_container_swap>::type>
+    : m_bool_constant<Alloc::propagate_on_container_swap::value> {};
+
+template <class Alloc, class = void>
+struct alloc_always_equal : m_bool_constant<std::is_empty<Alloc>::value> {};
+template <class Alloc>
+struct alloc_always_equal<Alloc, typename alloc_void<typename Alloc::is_always_equal>::type>
+    : m_bool_constant<Alloc::is_always_equal::value> {};
+
+template <class Alloc>
+struct allocator_traits {
+    typedef Alloc allocator_type;
+    typedef typename Alloc::value_type value_type;
+    typedef typename Alloc::size_type size_type;
+
+    template <class U>
+    using rebind_alloc = typename Alloc::template rebind<U>::other;
+
+    typedef alloc_pocca<Alloc> propagate_on_container_copy_assignment;
+    typedef alloc_pocma<Alloc> propagate_on_container_move_assignment;
+    typedef alloc_pocs<Alloc> propagate_on_container_swap;
+    typedef alloc_always_equal<Alloc> is_always_equal;
+
+    // 复制容器时，新容器使用的分配器
+    static Alloc select_on_container_copy_construction(const Alloc& a) {
+        return a;
+    }
+
+    // 两个分配器能否互相释放对方分配的内存
+    static bool equal(const Alloc& a, const Alloc& b) {
+        return is_always_equal::value || a == b;
+    }
+};
+
 }  // namespace mystl
 
 #endif  // !MYTINYSTL_ALLOCATOR_H_
\ No newline at end of file
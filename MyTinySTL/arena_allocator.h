@@ -0,0 +1,191 @@
+#ifndef MYTINYSTL_ARENA_ALLOCATOR_H_
+#define MYTINYSTL_ARENA_ALLOCATOR_H_
+
+// 这个头文件包含一个类 arena 与一个模板类 arena_allocator
+// arena           : 单调增长的内存区域，分配只是移动指针，所有内存在 release 或析构时一次性归还
+// arena_allocator : 从 arena 中分配内存的有状态分配器
+
+// notes:
+//
+// arena_allocator 的 deallocate 不做任何事，适合生命周期与 arena 一致的容器，
+// 例如一次请求内创建、请求结束后整体丢弃的临时 map / list
+// 使用 arena_allocator 的容器必须先于它的 arena 析构
+// 移动赋值与交换时分配器随元素一起传播，复制赋值时不传播
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "allocator.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+// arena : 单调增长的内存区域
+class arena {
+private:
+    // 每个从系统申请的块的头部
+    struct chunk {
+        chunk* next;
+        size_t size;
+    };
+
+    char* cur_;            // 当前块中下一个可用位置
+    char* end_;            // 当前块的末尾
+    chunk* chunks_;        // 从系统申请的块
+    char* initial_;        // 用户提供的初始缓冲区
+    size_t initial_size_;  // 初始缓冲区大小
+    size_t next_size_;     // 下一次向系统申请的大小
+    size_t used_;          // 已分配出去的字节数
+
+public:
+    explicit arena(size_t initial_size = 4096)
+        : cur_(nullptr),
+          end_(nullptr),
+          chunks_(nullptr),
+          initial_(nullptr),
+          initial_size_(0),
+          next_size_(initial_size < 64 ? 64 : initial_size),
+          used_(0) {}
+
+    // 先使用 [buffer, buffer + size) 分配，用完后再向系统申请
+    arena(void* buffer, size_t size)
+        : cur_(static_cast<char*>(buffer)),
+          end_(static_cast<char*>(buffer) + size),
+          chunks_(nullptr),
+          initial_(static_cast<char*>(buffer)),
+          initial_size_(size),
+          next_size_(size < 64 ? 64 : size),
+          used_(0) {}
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    ~arena() { free_chunks(); }
+
+    // 分配 bytes 字节，按 align 对齐
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        char* p = align_up(cur_, align);
+        if (static_cast<size_t>(end_ - cur_) < static_cast<size_t>(p - cur_) + bytes)
+            p = grow(bytes, align);
+        cur_ = p + bytes;
+        used_ += bytes;
+        return p;
+    }
+
+    // 归还所有内存，之前分配出去的指针全部失效
+    void release() noexcept {
+        free_chunks();
+        cur_ = initial_;
+        end_ = initial_ ? initial_ + initial_size_ : nullptr;
+        used_ = 0;
+    }
+
+    size_t bytes_used() const noexcept { return used_; }
+
+private:
+    static char* align_up(char* p, size_t align) noexcept {
+        const uintptr_t v = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char*>((v + align - 1) & ~(uintptr_t)(align - 1));
+    }
+
+    // 当前块不够用时，申请一个新块，块的大小按 2 倍增长
+    char* grow(size_t bytes, size_t align) {
+        const size_t need = bytes + align + sizeof(chunk);
+        THROW_LENGTH_ERROR_IF(bytes > static_cast<size_t>(-1) / 4,
+                              "arena allocation too big");
+        size_t size = next_size_;
+        while (size < need)
+            size *= 2;
+        next_size_ = size * 2;
+        chunk* c = static_cast<chunk*>(::operator new(size));
+        c->next = chunks_;
+        c->size = size;
+        chunks_ = c;
+        cur_ = reinterpret_cast<char*>(c) + sizeof(chunk);
+        end_ = reinterpret_cast<char*>(c) + size;
+        return align_up(cur_, align);
+    }
+
+    void free_chunks() noexcept {
+        while (chunks_) {
+            chunk* next = chunks_->next;
+            ::operator delete(chunks_);
+            chunks_ = next;
+        }
+    }
+};
+
+// 模板类：arena_allocator
+// 持有一个 arena 的指针，两个 arena_allocator 指向同一个 arena 时相等
+template <class T>
+class arena_allocator {
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    typedef m_false_type is_always_equal;
+    typedef m_false_type propagate_on_container_copy_assignment;
+    typedef m_true_type propagate_on_container_move_assignment;
+    typedef m_true_type propagate_on_container_swap;
+
+    template <class U>
+    struct rebind {
+        typedef arena_allocator<U> other;
+    };
+
+private:
+    template <class U>
+    friend class arena_allocator;
+
+    mystl::arena* arena_;
+
+public:
+    arena_allocator(mystl::arena& a) noexcept : arena_(&a) {}
+    template <class U>
+    arena_allocator(const arena_allocator<U>& rhs) noexcept
+        : arena_(rhs.arena_) {}
+
+    T* allocate() { return allocate(1); }
+    T* allocate(size_type n) {
+        if (n == 0)
+            return nullptr;
+        THROW_LENGTH_ERROR_IF(n > static_cast<size_type>(-1) / sizeof(T),
+                              "arena_allocator<T>'s size too big");
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    // 内存在 arena 释放时统一归还
+    void deallocate(T*) noexcept {}
+    void deallocate(T*, size_type) noexcept {}
+
+    template <class... Args>
+    static void construct(T* ptr, Args&&... args) {
+        mystl::construct(ptr, mystl::forward<Args>(args)...);
+    }
+
+    static void destroy(T* ptr) { mystl::destroy(ptr); }
+    static void destroy(T* first, T* last) { mystl::destroy(first, last); }
+
+    mystl::arena* get_arena() const noexcept { return arena_; }
+};
+
+template <class T, class U>
+bool operator==(const arena_allocator<T>& lhs,
+                const arena_allocator<U>& rhs) noexcept {
+    return lhs.get_arena() == rhs.get_arena();
+}
+
+template <class T, class U>
+bool operator!=(const arena_allocator<T>& lhs,
+                const arena_allocator<U>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_ARENA_ALLOCATOR_H_
@@ -8,10 +8,12 @@
 #include "functional.h"
 #include "iterator.h"
 #include "memory.h"
+#include "string_search.h"
 
 namespace mystl {
 
 // char_traits
+// 字符类型都是 POD，复制、移动直接按字节进行
 template <class CharType>
 struct char_traits {
     typedef CharType char_type;
@@ -25,44 +27,28 @@ struct char_traits {
     }
 
     static int compare(const char_type* s1, const char_type* s2, size_t n) {
-        for (; n != 0; --n, ++s1, ++s2) {
-            if (*s1 < *s2) {
-                return -1;
-            }
-            if (*s2 < *s1) {
-                return 1;
-            }
-        }
-        return 0;
+        return mystl::str_compare<char_type>(s1, s2, n);
+    }
+
+    // 在 [s, s + n) 中查找 ch，没有找到返回 nullptr
+    static const char_type* find(const char_type* s,
+                                 size_t n,
+                                 const char_type& ch) {
+        return mystl::str_find_char<char_type>(s, n, ch);
     }
 
     static char_type* copy(char_type* dst, const char_type* src, size_t n) {
         // 目标字符串和源字符串不可重叠，避免出错
         MYSTL_DEBUG(src + n <= dst || dst + n <= src);
-        char_type* r = dst;
-        for (; n != 0; --n, ++dst, ++src) {
-            *dst = *src;
-        }
-        return r;
+        return n == 0 ? dst
+                      : static_cast<char_type*>(
+                            std::memcpy(dst, src, n * sizeof(char_type)));
     }
 
     static char_type* move(char_type* dst, const char_type* src, size_t n) {
-        char_type* r = dst;
-        // dst在src之前直接复制
-        if (dst < src) {
-            for (; n != 0; --n, ++dst, ++src) {
-                *dst = *src;
-            }
-        }
-        // src在dst之前，从后往前复制，防止地址交叉
-        else if (src < dst) {
-            dst += n;
-            src += n;
-            for (; n != 0; --n) {
-                *--dst = *--src;
-            }
-        }
-        return r;
+        return n == 0 ? dst
+                      : static_cast<char_type*>(
+                            std::memmove(dst, src, n * sizeof(char_type)));
     }
 
     // 在dst指向的字符串内存空间上填充count个ch
@@ -73,12 +59,15 @@ struct char_traits {
         }
         return r;
     }
+
+    static char_type* assign(char_type* dst, size_t count, char_type ch) {
+        return fill(dst, ch, count);
+    }
 };
 
 // Partialized. char_traits<char> 部分化
-// 这里就是把上一个结构体用Linux系统函数重现了一下，只不过特定针对char类型
-// 用于定义字符类型char的一些基本操作。
-// 它提供了一些静态成员函数，可以用于比较、复制、查找、长度计算等操作。
+// 用于定义字符类型char的一些基本操作，全部交给 libc 的 str* / mem* 函数，
+// 它们通常带有针对当前 CPU 的向量化实现
 template <>
 struct char_traits<char> {
     typedef char char_type;
@@ -91,7 +80,14 @@ struct char_traits<char> {
     static int compare(const char_type* s1,
                        const char_type* s2,
                        size_t n) noexcept {
-        return std::memcmp(s1, s2, n);
+        return n == 0 ? 0 : std::memcmp(s1, s2, n);
+    }
+
+    static const char_type* find(const char_type* s,
+                                 size_t n,
+                                 const char_type& ch) noexcept {
+        return n == 0 ? nullptr
+                      : static_cast<const char_type*>(std::memchr(s, ch, n));
     }
 
     static char_type* copy(char_type* dst,
@@ -99,20 +95,30 @@ struct char_traits<char> {
                            size_t n) noexcept {
         // 目标字符串和源字符串不可重叠
         MYSTL_DEBUG(src + n <= dst || dst + n <= src);
-        return static_cast<char_type*>(std::memcpy(dst, src, n));
+        return n == 0 ? dst
+                      : static_cast<char_type*>(std::memcpy(dst, src, n));
     }
 
     // move和copy不一样的地方在于内存区域可以重叠
     static char_type* move(char_type* dst,
                            const char_type* src,
                            size_t n) noexcept {
-        return static_cast<char_type*>(std::memmove(dst, src, n));
+        return n == 0 ? dst
+                      : static_cast<char_type*>(std::memmove(dst, src, n));
     }
 
     static char_type* fill(char_type* dst,
                            char_type ch,
                            size_t count) noexcept {
-        return static_cast<char_type*>(std::memset(dst, ch, count));
+        return count == 0
+                   ? dst
+                   : static_cast<char_type*>(std::memset(dst, ch, count));
+    }
+
+    static char_type* assign(char_type* dst,
+                             size_t count,
+                             char_type ch) noexcept {
+        return fill(dst, ch, count);
     }
 };
 
@@ -129,35 +135,54 @@ struct char_traits<wchar_t> {
     static int compare(const char_type* s1,
                        const char_type* s2,
                        size_t n) noexcept {
-        return std::wmemcmp(s1, s2, n);
+        return n == 0 ? 0 : std::wmemcmp(s1, s2, n);
+    }
+
+    static const char_type* find(const char_type* s,
+                                 size_t n,
+                                 const char_type& ch) noexcept {
+        return n == 0 ? nullptr : std::wmemchr(s, ch, n);
     }
 
     static char_type* copy(char_type* dst,
                            const char_type* src,
                            size_t n) noexcept {
         MYSTL_DEBUG(src + n <= dst || dst + n <= src);
-        return static_cast<char_type*>(std::wmemcpy(dst, src, n));
+        return n == 0 ? dst
+                      : static_cast<char_type*>(std::wmemcpy(dst, src, n));
     }
 
     static char_type* move(char_type* dst,
                            const char_type* src,
                            size_t n) noexcept {
-        return static_cast<char_type*>(std::wmemmove(dst, src, n));
+        return n == 0 ? dst
+                      : static_cast<char_type*>(std::wmemmove(dst, src, n));
     }
 
     static char_type* fill(char_type* dst,
                            char_type ch,
                            size_t count) noexcept {
-        return static_cast<char_type*>(std::wmemset(dst, ch, count));
+        return count == 0
+                   ? dst
+                   : static_cast<char_type*>(std::wmemset(dst, ch, count));
+    }
+
+    static char_type* assign(char_type* dst,
+                             size_t count,
+                             char_type ch) noexcept {
+        return fill(dst, ch, count);
     }
 };
 
 // Partialized. char_traits<char16_t>
 // 普通的char默认是8位（1字节）
+// libc 没有 16 位字符的函数，比较和查找使用 string_search.h 中的 SSE2 版本，
+// 复制和移动按字节进行
 template <>
 struct char_traits<char16_t> {
     typedef char16_t char_type;
 
+    // 结尾符的位置未知，无法安全地一次读取多个字符，逐个查找
     static size_t length(const char_type* str) noexcept {
         size_t len = 0;
         for (; *str != char_type(0); ++str)
@@ -168,52 +193,50 @@ struct char_traits<char16_t> {
     static int compare(const char_type* s1,
                        const char_type* s2,
                        size_t n) noexcept {
-        for (; n != 0; --n, ++s1, ++s2) {
-            if (*s1 < *s2)
-                return -1;
-            if (*s2 < *s1)
-                return 1;
-        }
-        return 0;
+        return mystl::str_compare(s1, s2, n);
+    }
+
+    static const char_type* find(const char_type* s,
+                                 size_t n,
+                                 const char_type& ch) noexcept {
+        return mystl::str_find_char(s, n, ch);
     }
 
     static char_type* copy(char_type* dst,
                            const char_type* src,
                            size_t n) noexcept {
         MYSTL_DEBUG(src + n <= dst || dst + n <= src);
-        char_type* r = dst;
-        for (; n != 0; --n, ++dst, ++src)
-            *dst = *src;
-        return r;
+        return n == 0 ? dst
+                      : static_cast<char_type*>(
+                            std::memcpy(dst, src, n * sizeof(char_type)));
     }
 
     static char_type* move(char_type* dst,
                            const char_type* src,
                            size_t n) noexcept {
-        char_type* r = dst;
-        if (dst < src) {
-            for (; n != 0; --n, ++dst, ++src)
-                *dst = *src;
-        } else if (src < dst) {
-            dst += n;
-            src += n;
-            for (; n != 0; --n)
-                *--dst = *--src;
-        }
-        return r;
+        return n == 0 ? dst
+                      : static_cast<char_type*>(
+                            std::memmove(dst, src, n * sizeof(char_type)));
     }
 
+    // 简单的循环，编译器会自动向量化
     static char_type* fill(char_type* dst,
                            char_type ch,
                            size_t count) noexcept {
-        char_type* r = dst;
-        for (; count > 0; --count, ++dst)
-            *dst = ch;
-        return r;
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = ch;
+        return dst;
+    }
+
+    static char_type* assign(char_type* dst,
+                             size_t count,
+                             char_type ch) noexcept {
+        return fill(dst, ch, count);
     }
 };
 
 // Partialized. char_traits<char32_t>
+// 与 char_traits<char16_t> 相同
 template <>
 struct char_traits<char32_t> {
     typedef char32_t char_type;
@@ -228,64 +251,63 @@ struct char_traits<char32_t> {
     static int compare(const char_type* s1,
                        const char_type* s2,
                        size_t n) noexcept {
-        for (; n != 0; --n, ++s1, ++s2) {
-            if (*s1 < *s2)
-                return -1;
-            if (*s2 < *s1)
-                return 1;
-        }
-        return 0;
+        return mystl::str_compare(s1, s2, n);
+    }
+
+    static const char_type* find(const char_type* s,
+                                 size_t n,
+                                 const char_type& ch) noexcept {
+        return mystl::str_find_char(s, n, ch);
     }
 
     static char_type* copy(char_type* dst,
                            const char_type* src,
                            size_t n) noexcept {
         MYSTL_DEBUG(src + n <= dst || dst + n <= src);
-        char_type* r = dst;
-        for (; n != 0; --n, ++dst, ++src)
-            *dst = *src;
-        return r;
+        return n == 0 ? dst
+                      : static_cast<char_type*>(
+                            std::memcpy(dst, src, n * sizeof(char_type)));
     }
 
     static char_type* move(char_type* dst,
                            const char_type* src,
                            size_t n) noexcept {
-        char_type* r = dst;
-        if (dst < src) {
-            for (; n != 0; --n, ++dst, ++src)
-                *dst = *src;
-        } else if (src < dst) {
-            dst += n;
-            src += n;
-            for (; n != 0; --n)
-                *--dst = *--src;
-        }
-        return r;
+        return n == 0 ? dst
+                      : static_cast<char_type*>(
+                            std::memmove(dst, src, n * sizeof(char_type)));
     }
 
     static char_type* fill(char_type* dst,
                            char_type ch,
                            size_t count) noexcept {
-        char_type* r = dst;
-        for (; count > 0; --count, ++dst)
-            *dst = ch;
-        return r;
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = ch;
+        return dst;
+    }
+
+    static char_type* assign(char_type* dst,
+                             size_t count,
+                             char_type ch) noexcept {
+        return fill(dst, ch, count);
     }
 };
 
-// 初始化 basic_string 尝试分配的最小 buffer 大小，可能被忽略
+// basic_string 在堆上分配的最小 buffer 大小，可能被忽略
 #define STRING_INIT_SIZE 32
 
 // 模板类 basic_string
 // 参数一代表字符类型，参数二代表萃取字符类型的方式，缺省使用 mystl::char_traits
-template <class CharType, class CharTraits = mystl::char_traits<CharType>>
+// 参数三代表分配器，缺省使用 mystl::allocator
+template <class CharType,
+          class CharTraits = mystl::char_traits<CharType>,
+          class Alloc = mystl::allocator<CharType>>
 class basic_string {
 public:
     typedef CharTraits traits_type;
     typedef CharTraits char_traits;
 
-    typedef mystl::allocator<CharType> allocator_type;
-    typedef mystl::allocator<CharType> data_allocator;
+    typedef Alloc allocator_type;
+    typedef mystl::allocator_traits<Alloc> alloc_traits;
 
     typedef typename allocator_type::value_type value_type;
     typedef typename allocator_type::pointer pointer;
@@ -300,7 +322,7 @@ public:
     typedef mystl::reverse_iterator<iterator> reverse_iterator;
     typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
 
-    allocator_type get_allocator() { return allocator_type(); }
+    allocator_type get_allocator() const { return alloc_; }
 
     // static_assert表达式为false，会产生后面的错误信息
     static_assert(std::is_pod<CharType>::value,
@@ -326,59 +348,89 @@ public:
     static constexpr size_type npos = static_cast<size_type>(-1);
 
 private:
-    iterator buffer_;  // 储存字符串的其实位置
+    // 内部缓冲区的大小（包括结尾的空字符），不超过这个长度的短字符串
+    // 直接存放在对象内，不分配堆空间。char 类型可以存放 15 个字符
+    static constexpr size_type local_size =
+        16 / sizeof(CharType) > 1 ? 16 / sizeof(CharType) : 2;
+
+    allocator_type alloc_;  // 堆上空间的分配器
+    // 堆上空间的起始位置，使用内部缓冲区时为空指针。对象内不保存指向自身的指针，
+    // 因此可以按位搬移（见 is_trivially_relocatable）
+    iterator heap_;
     size_type size_;   // 大小
-    size_type cap_;    // 容量
+    union {
+        size_type cap_;                     // 堆上空间的容量，不包括空字符
+        value_type local_buf_[local_size];  // 短字符串的内部缓冲区
+    };
 
 public:
     // 构造、复制、移动、析构函数
-    basic_string() noexcept { try_init(); }
+    basic_string() noexcept : alloc_() { init_local(); }
 
-    basic_string(size_type n, value_type ch)
-        : buffer_(nullptr), size_(0), cap_(0) {
+    explicit basic_string(const allocator_type& alloc) noexcept
+        : alloc_(alloc) {
+        init_local();
+    }
+
+    basic_string(size_type n,
+                 value_type ch,
+                 const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
         fill_init(n, ch);
     }
 
-    basic_string(const basic_string& other, size_type pos)
-        : buffer_(nullptr), size_(0), cap_(0) {
-        init_from(other.buffer_, pos, other.size_ - pos);
+    basic_string(const basic_string& other,
+                 size_type pos,
+                 const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        init_from(other.buffer(), pos, other.size_ - pos);
     }
 
-    basic_string(const basic_string& other, size_type pos, size_type count)
-        : buffer_(nullptr), size_(0), cap_(0) {
-        init_from(other.buffer_, pos, count);
+    basic_string(const basic_string& other,
+                 size_type pos,
+                 size_type count,
+                 const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        init_from(other.buffer(), pos, count);
     }
 
-    basic_string(const_pointer str) : buffer_(nullptr), size_(0), cap_(0) {
+    basic_string(const_pointer str,
+                 const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
         init_from(str, 0, char_traits::length(str));
     }
 
-    basic_string(const_pointer str, size_type count)
-        : buffer_(nullptr), size_(0), cap_(0) {
+    basic_string(const_pointer str,
+                 size_type count,
+                 const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
         init_from(str, 0, count);
     }
 
     template <class Iter,
               typename std::enable_if<mystl::is_input_iterator<Iter>::value,
                                       int>::type = 0>
-    basic_string(Iter first, Iter last) {
+    basic_string(Iter first,
+                 Iter last,
+                 const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
         copy_init(first, last, iterator_category(first));
     }
 
     basic_string(const basic_string& rhs)
-        : buffer_(nullptr), size_(0), cap_(0) {
-        init_from(rhs.buffer_, 0, rhs.size_);
+        : alloc_(alloc_traits::select_on_container_copy_construction(
+              rhs.alloc_)) {
+        init_from(rhs.buffer(), 0, rhs.size_);
     }
 
-    basic_string(basic_string&& rhs) noexcept
-        : buffer_(rhs.buffer_), size_(rhs.size_), cap_(rhs.cap_) {
-        rhs.buffer_ = nullptr;
-        rhs.size_ = 0;
-        rhs.cap_ = 0;
+    basic_string(basic_string&& rhs) noexcept : alloc_(mystl::move(rhs.alloc_)) {
+        move_from(rhs);
     }
 
     basic_string& operator=(const basic_string& rhs);
-    basic_string& operator=(basic_string&& rhs) noexcept;
+    basic_string& operator=(basic_string&& rhs) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value);
 
     basic_string& operator=(const_pointer str);
     basic_string& operator=(value_type ch);
@@ -387,10 +439,10 @@ public:
 
 public:
     // 迭代器相关操作
-    iterator begin() noexcept { return buffer_; }
-    const_iterator begin() const noexcept { return buffer_; }
-    iterator end() noexcept { return buffer_ + size_; }
-    const_iterator end() const noexcept { return buffer_ + size_; }
+    iterator begin() noexcept { return buffer(); }
+    const_iterator begin() const noexcept { return buffer(); }
+    iterator end() noexcept { return buffer() + size_; }
+    const_iterator end() const noexcept { return buffer() + size_; }
 
     reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
     const_reverse_iterator rbegin() const noexcept {
@@ -411,7 +463,9 @@ public:
 
     size_type size() const noexcept { return size_; }
     size_type length() const noexcept { return size_; }
-    size_type capacity() const noexcept { return cap_; }
+    size_type capacity() const noexcept {
+        return is_local() ? local_size - 1 : cap_;
+    }
     // -1无符号整数的最大值，也就是容器可以容纳的最大元素数量
     size_type max_size() const noexcept { return static_cast<size_type>(-1); }
 
@@ -419,18 +473,14 @@ public:
     void shrink_to_fit();
 
     // 访问元素相关操作
-    // 访问元素相关操作
+    // buffer()[size_] 始终是空字符
     reference operator[](size_type n) {
         MYSTL_DEBUG(n <= size_);
-        if (n == size_)
-            *(buffer_ + n) = value_type();
-        return *(buffer_ + n);
+        return *(buffer() + n);
     }
     const_reference operator[](size_type n) const {
         MYSTL_DEBUG(n <= size_);
-        if (n == size_)
-            *(buffer_ + n) = value_type();
-        return *(buffer_ + n);
+        return *(buffer() + n);
     }
 
     reference at(size_type n) {
@@ -480,7 +530,7 @@ public:
     void push_back(value_type ch) { append(1, ch); }
     void pop_back() {
         MYSTL_DEBUG(!empty());
-        --size_;
+        set_size(size_ - 1);
     }
 
     // append
@@ -516,7 +566,7 @@ public:
     void resize(size_type count) { resize(count, value_type()); }
     void resize(size_type count, value_type ch);
 
-    void clear() noexcept { size_ = 0; }
+    void clear() noexcept { set_size(0); }
 
     // basic_string 相关操作
 
@@ -540,7 +590,7 @@ public:
     // substr
     basic_string substr(size_type index, size_type count = npos) {
         count = mystl::min(count, size_ - index);
-        return basic_string(buffer_ + index, buffer_ + index + count);
+        return basic_string(buffer() + index, buffer() + index + count);
     }
 
     // replace
@@ -550,21 +600,21 @@ public:
         THROW_OUT_OF_RANGE_IF(
             pos > size_,
             "basic_string<Char, Traits>::replace's pos out of range");
-        return replace_cstr(buffer_ + pos, count, str.buffer_, str.size_);
+        return replace_cstr(buffer() + pos, count, str.buffer(), str.size_);
     }
     basic_string& replace(const_iterator first,
                           const_iterator last,
                           const basic_string& str) {
         MYSTL_DEBUG(begin() <= first && last <= end() && first <= last);
         return replace_cstr(first, static_cast<size_type>(last - first),
-                            str.buffer_, str.size_);
+                            str.buffer(), str.size_);
     }
 
     basic_string& replace(size_type pos, size_type count, const_pointer str) {
         THROW_OUT_OF_RANGE_IF(
             pos > size_,
             "basic_string<Char, Traits>::replace's pos out of range");
-        return replace_cstr(buffer_ + pos, count, str,
+        return replace_cstr(buffer() + pos, count, str,
                             char_traits::length(str));
     }
     basic_string& replace(const_iterator first,
@@ -582,7 +632,7 @@ public:
         THROW_OUT_OF_RANGE_IF(
             pos > size_,
             "basic_string<Char, Traits>::replace's pos out of range");
-        return replace_cstr(buffer_ + pos, count, str, count2);
+        return replace_cstr(buffer() + pos, count, str, count2);
     }
     basic_string& replace(const_iterator first,
                           const_iterator last,
@@ -600,7 +650,7 @@ public:
         THROW_OUT_OF_RANGE_IF(
             pos > size_,
             "basic_string<Char, Traits>::replace's pos out of range");
-        return replace_fill(buffer_ + pos, count, count2, ch);
+        return replace_fill(buffer() + pos, count, count2, ch);
     }
     basic_string& replace(const_iterator first,
                           const_iterator last,
@@ -619,7 +669,7 @@ public:
         THROW_OUT_OF_RANGE_IF(
             pos1 > size_ || pos2 > str.size_,
             "basic_string<Char, Traits>::replace's pos out of range");
-        return replace_cstr(buffer_ + pos1, count1, str.buffer_ + pos2, count2);
+        return replace_cstr(buffer() + pos1, count1, str.buffer() + pos2, count2);
     }
 
     template <class Iter,
@@ -717,7 +767,7 @@ public:
         // 用输入流对象 `is` 的 `>>` 运算符将数据读取到`buf` 中
         is >> buf;
         // 根据 `buf` 创建一个临时的 `basic_string` 对象 `tmp`
-        basic_string tmp(buf);
+        basic_string tmp(buf, str.alloc_);
         // 将`tmp` 对象移动到传入的 `basic_string` 对象 `str`
         str = std::move(tmp);
         // 释放buf内存空间
@@ -732,7 +782,7 @@ public:
     friend std::ostream& operator<<(std::ostream& os, const basic_string& str) {
         // 遍历 `basic_string` 对象的每一个字符，并将其逐个输出到流中
         for (size_type i = 0; i < str.size_; ++i) {
-            os << *(str.buffer_ + i);
+            os << *(str.buffer() + i);
         }
         return os;
     }
@@ -740,8 +790,32 @@ public:
 private:
     // helper functions
 
+    // 当前是否使用内部缓冲区
+    bool is_local() const noexcept { return heap_ == nullptr; }
+
+    // 储存字符串的起始位置，指向 local_buf_ 或堆上的空间
+    pointer buffer() noexcept { return heap_ ? heap_ : local_buf_; }
+    const_pointer buffer() const noexcept {
+        return heap_ ? heap_ : local_buf_;
+    }
+
+    // 设置大小并写入结尾的空字符
+    void set_size(size_type n) noexcept {
+        size_ = n;
+        buffer()[n] = value_type();
+    }
+
+    // 查找结果转换为下标，没有找到时为 npos
+    size_type pos_of(const_pointer p) const noexcept {
+        return p == nullptr ? npos : static_cast<size_type>(p - buffer());
+    }
+
+    // 分配能容纳 n 个字符及结尾空字符的空间
+    pointer allocate_buffer(size_type n) { return alloc_.allocate(n + 1); }
+
     // init/destroy
-    void try_init() noexcept;
+    void init_local() noexcept;
+    pointer init_buffer(size_type n);
     void fill_init(size_type n, value_type ch);
 
     template <class Iter>
@@ -750,20 +824,35 @@ private:
     void copy_init(Iter first, Iter last, mystl::forward_iterator_tag);
 
     void init_from(const_pointer src, size_type pos, size_type n);
+    void move_from(basic_string& rhs) noexcept;
 
-    void destroy_buffer();
+    void destroy_buffer() noexcept;
+    void reset_buffer(pointer new_buffer, size_type new_cap) noexcept;
+
+    // allocator propagation
+    void swap_data(basic_string& rhs) noexcept;
+    void copy_alloc(const basic_string& rhs, m_true_type);
+    void copy_alloc(const basic_string&, m_false_type) {}
+    void move_assign(basic_string& rhs, m_true_type) noexcept;
+    void move_assign(basic_string& rhs, m_false_type);
+    void swap_alloc(basic_string& rhs, m_true_type) {
+        mystl::swap(alloc_, rhs.alloc_);
+    }
+    void swap_alloc(basic_string&, m_false_type) {}
 
     // get raw pointer
-    const_pointer to_raw_pointer() const;
+    const_pointer to_raw_pointer() const noexcept;
 
     // shrink_to_fit
     void reinsert(size_type size);
 
-    // append
     // append
     template <class Iter>
     basic_string& append_range(Iter first, Iter last);
 
+    // assign
+    void assign_cstr(const_pointer s, size_type n);
+
     // compare
     int compare_cstr(const_pointer s1,
                      size_type n1,
@@ -786,6 +875,7 @@ private:
                                Iter last2);
 
     // reallocate
+    size_type next_capacity(size_type need) const;
     void reallocate(size_type need);
     iterator reallocate_and_fill(iterator pos, size_type n, value_type ch);
     iterator reallocate_and_copy(iterator pos,
@@ -795,42 +885,37 @@ private:
 
 /* **************************************** */
 // 复制复制操作符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::operator=(const basic_string& rhs) {
+// 容量足够时直接复用原来的空间
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::operator=(const basic_string& rhs) {
     if (this != &rhs) {
-        basic_string tmp(rhs);
-        swap(tmp);
+        copy_alloc(rhs, typename alloc_traits::
+                            propagate_on_container_copy_assignment());
+        assign_cstr(rhs.buffer(), rhs.size_);
     }
     return *this;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::operator=(basic_string&& rhs) noexcept {
-    destroy_buffer();
-    buffer_ = rhs.buffer_;
-    size_ = rhs.size_;
-    cap_ = rhs.cap_;
-    rhs.buffer_ = nullptr;
-    rhs.size_ = 0;
-    rhs.cap_ = 0;
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::operator=(
+    basic_string&& rhs) noexcept(alloc_traits::
+                                     propagate_on_container_move_assignment::
+                                         value ||
+                                 alloc_traits::is_always_equal::value) {
+    if (this != &rhs) {
+        move_assign(rhs, typename alloc_traits::
+                             propagate_on_container_move_assignment());
+    }
     return *this;
 }
 
 // 用一个字符串赋值
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::operator=(const_pointer str) {
-    const size_type len = char_traits::length(str);
-    if (cap_ < len) {
-        auto new_buffer = data_allocator::allocate(len + 1);
-        data_allocator::deallocate(buffer_);
-        buffer_ = new_buffer;
-        cap_ = len + 1;
-    }
-    char_traits::copy(buffer_, str, len);
-    size_ = len;
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::operator=(const_pointer str) {
+    assign_cstr(str, char_traits::length(str));
     return *this;
 }
 
@@ -838,93 +923,85 @@ basic_string<CharType, CharTraits>::operator=(const_pointer str) {
 // 重载了赋值运算符，用于将一个字符赋值给一个字符串对象。具体来说，它接受一个
 // `value_type` 类型的参数
 // `ch`，也就是字符串中字符的类型，然后将这个字符赋值给当前字符串对象
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::operator=(value_type ch) {
-    if (cap_ < 1) {
-        // 如果当前字符串对象的容量不足以存储这个字符，它会重新分配一块大小为 2
-        // 的内存空间，并将原来的内存空间释放掉
-        auto new_buffer = data_allocator::allocate(2);
-        data_allocator::deallocate(buffer_);
-        buffer_ = new_buffer;
-        cap_ = 2;
-    }
-    *buffer_ = ch;
-    size_ = 1;
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::operator=(value_type ch) {
+    // 容量至少为 local_size - 1，一定放得下一个字符
+    *buffer() = ch;
+    set_size(1);
     // 返回一个指向当前字符串对象的引用
     return *this;
 }
 
 // 预留储存空间
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::reserve(size_type n) {
-    if (cap_ < n) {
-        THROW_LENGTH_ERROR_IF(n > max_size(),
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::reserve(size_type n) {
+    if (capacity() < n) {
+        THROW_LENGTH_ERROR_IF(n > max_size() - 1,
                               "n can not larger than max_size() in "
                               "basic_string<Char,Traits>::reserve(n)");
-        auto new_buffer = data_allocator::allocate(n);
-        char_traits::move(new_buffer, buffer_, size_);
-        buffer_ = new_buffer;
-        cap_ = n;
+        auto new_buffer = allocate_buffer(n);
+        char_traits::copy(new_buffer, buffer(), size_ + 1);
+        reset_buffer(new_buffer, n);
     }
 }
 
-// 减少不用的空间
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::shrink_to_fit() {
-    if (size_ != cap_) {
+// 减少不用的空间，内部缓冲区没有可以释放的空间
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::shrink_to_fit() {
+    if (!is_local() && size_ != cap_) {
         reinsert(size_);
     }
 }
 
 // 在 pos 处插入一个元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::insert(const_iterator pos, value_type ch) {
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::insert(const_iterator pos, value_type ch) {
     iterator r = const_cast<iterator>(pos);
-    if (size_ == cap_) {
+    if (size_ == capacity()) {
         // 重新分配地址空间并填充
         return reallocate_and_fill(r, 1, ch);
     }
     // 把r处开始的字符移到r+1处
     char_traits::move(r + 1, r, end() - r);
-    ++size_;
     *r = ch;
+    set_size(size_ + 1);
     return r;
 }
 
 // 在 pos 处插入 n 个元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::insert(const_iterator pos,
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::insert(const_iterator pos,
                                            size_type count,
                                            value_type ch) {
     iterator r = const_cast<iterator>(pos);
     if (count == 0) {
         return r;
     }
-    if (cap_ - size_ < count) {
+    if (capacity() - size_ < count) {
         return reallocate_and_fill(r, count, ch);
     }
     if (pos == end()) {
         char_traits::fill(end(), ch, count);
-        size_ += count;
+        set_size(size_ + count);
         return r;
     }
-    // 把r处的数据移到r+count处
-    char_traits::move(r + count, r, count);
+    // 把[r, end())的数据移到r+count处
+    char_traits::move(r + count, r, end() - r);
     // 在r处填充count个ch
     char_traits::fill(r, ch, count);
     // 大小+count
-    size_ += count;
+    set_size(size_ + count);
     return r;
 }
 
 // 在 pos 处插入 [first, last) 内的元素
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc>
 template <class Iter>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::insert(const_iterator pos,
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::insert(const_iterator pos,
                                            Iter first,
                                            Iter last) {
     iterator r = const_cast<iterator>(pos);
@@ -932,43 +1009,43 @@ basic_string<CharType, CharTraits>::insert(const_iterator pos,
     if (len == 0) {
         return r;
     }
-    if (cap_ - size_ < len) {
+    if (capacity() - size_ < len) {
         // 如果剩余空间不够，就要重新分配空间
         return reallocate_and_copy(r, first, last);
     }
     if (pos == end()) {
         // 直接从end_处开始
         mystl::uninitialized_copy(first, last, end());
-        size_ += len;
+        set_size(size_ + len);
         return r;
     }
     // 不然就移动，再插入
-    char_traits::move(r + len, r, len);
+    char_traits::move(r + len, r, end() - r);
     mystl::uninitialized_copy(first, last, r);
-    size_ += len;
+    set_size(size_ + len);
     return r;
 }
 
 // 在末尾添加 count 个 ch
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& basic_string<CharType, CharTraits>::append(
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>& basic_string<CharType, CharTraits, Alloc>::append(
     size_type count,
     value_type ch) {
     THROW_LENGTH_ERROR_IF(size_ > max_size() - count,
                           "basic_string<Char, Tratis>'s size too big");
-    if (cap_ - size_ < count) {
+    if (capacity() - size_ < count) {
         // 大小不够，重新分配地址空间
         reallocate(count);
     }
-    // 从buffer_+size_处开始填充count个ch
-    char_traits::fill(buffer_ + size_, ch, count);
-    size_ += count;
+    // 从buffer()+size_处开始填充count个ch
+    char_traits::fill(buffer() + size_, ch, count);
+    set_size(size_ + count);
     return *this;
 }
 
 // 在末尾添加 [str[pos] str[pos+count]) 一段
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& basic_string<CharType, CharTraits>::append(
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>& basic_string<CharType, CharTraits, Alloc>::append(
     const basic_string& str,
     size_type pos,
     size_type count) {
@@ -977,50 +1054,58 @@ basic_string<CharType, CharTraits>& basic_string<CharType, CharTraits>::append(
     if (count == 0) {
         return *this;
     }
-    if (count == 0)
-        return *this;
-    if (cap_ - size_ < count) {
+    if (capacity() - size_ < count) {
+        // str 可能就是自身，重新分配后 str.buffer() 随之更新
         reallocate(count);
     }
-    // 将str.buffer_ + pos开始的count个字符复制到buffer_+size_
-    char_traits::copy(buffer_ + size_, str.buffer_ + pos, count);
-    size_ += count;
+    // 将str.buffer() + pos开始的count个字符复制到buffer()+size_
+    char_traits::copy(buffer() + size_, str.buffer() + pos, count);
+    set_size(size_ + count);
     return *this;
 }
 
 // 在末尾添加 [s, s+count) 一段
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>& basic_string<CharType, CharTraits>::append(
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>& basic_string<CharType, CharTraits, Alloc>::append(
     const_pointer s,
     size_type count) {
     THROW_LENGTH_ERROR_IF(size_ > max_size() - count,
                           "basic_string<Char, Tratis>'s size too big");
-    // 容量不足，重新分配
-    if (cap_ - size_ < count) {
-        reallocate(count);
+    if (capacity() - size_ < count) {
+        // 容量不足，重新分配。s 可能指向自身，复制完成后才释放原来的空间
+        const auto new_cap = next_capacity(count);
+        auto new_buffer = allocate_buffer(new_cap);
+        char_traits::copy(new_buffer, buffer(), size_);
+        char_traits::copy(new_buffer + size_, s, count);
+        reset_buffer(new_buffer, new_cap);
+        size_ += count;
+        new_buffer[size_] = value_type();
+    } else {
+        // copy到末尾。写入字符后编译器需要重新读取 heap_，先记下起始位置
+        auto p = buffer();
+        char_traits::copy(p + size_, s, count);
+        size_ += count;
+        p[size_] = value_type();
     }
-    // copy到末尾
-    char_traits::copy(buffer_ + size_, s, count);
-    size_ += count;
     return *this;
 }
 
 // 删除 pos 处的元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::erase(const_iterator pos) {
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::erase(const_iterator pos) {
     MYSTL_DEBUG(pos != end());
     iterator r = const_cast<iterator>(pos);
     // 把pos+1处的end() - pos - 1个字符移到r
     char_traits::move(r, pos + 1, end() - pos - 1);
-    --size_;
+    set_size(size_ - 1);
     return r;
 }
 
 // 删除 [first, last) 的元素
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::erase(const_iterator first,
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::erase(const_iterator first,
                                           const_iterator last) {
     if (first == begin() && last == end()) {
         // 直接令size_=0
@@ -1031,17 +1116,17 @@ basic_string<CharType, CharTraits>::erase(const_iterator first,
     iterator r = const_cast<iterator>(first);
     // 直接把last开始的n个字符移到first处s
     char_traits::move(r, last, n);
-    size_ -= (last - first);
+    set_size(size_ - (last - first));
     return r;
 }
 
 // 重置容器大小
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::resize(size_type count,
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::resize(size_type count,
                                                 value_type ch) {
     if (count < size_) {
         // 小需要清除多的空间
-        erase(buffer_ + count, buffer_ + size_);
+        erase(buffer() + count, buffer() + size_);
     } else {
         // 大需要填充
         append(count - size_, ch);
@@ -1049,550 +1134,334 @@ void basic_string<CharType, CharTraits>::resize(size_type count,
 }
 
 // 比较两个 basic_string，小于返回 -1，大于返回 1，等于返回 0
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::compare(
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::compare(
     const basic_string& other) const {
-    return compare_cstr(buffer_, size_, other.buffer_, other.size_);
+    return compare_cstr(buffer(), size_, other.buffer(), other.size_);
 }
 
 // 从 pos1 下标开始的 count1 个字符跟另一个 basic_string 比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::compare(
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::compare(
     size_type pos1,
     size_type count1,
     const basic_string& other) const {
     // size_-pos1可能小于count1，也就是不足count1个字符
     auto n1 = mystl::min(count1, size_ - pos1);
-    return compare_cstr(buffer_ + pos1, n1, other.buffer_, other.size_);
+    return compare_cstr(buffer() + pos1, n1, other.buffer(), other.size_);
 }
 
 // 从 pos1 下标开始的 count1 个字符跟另一个 basic_string 下标 pos2 开始的 count2
 // 个字符比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::compare(size_type pos1,
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::compare(size_type pos1,
                                                 size_type count1,
                                                 const basic_string& other,
                                                 size_type pos2,
                                                 size_type count2) const {
     auto n1 = mystl::min(count1, size_ - pos1);
     auto n2 = mystl::min(count2, other.size_ - pos2);
-    return compare_cstr(buffer_, n1, other.buffer_, n2);
+    return compare_cstr(buffer(), n1, other.buffer(), n2);
 }
 
 // 跟一个字符串比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::compare(const_pointer s) const {
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::compare(const_pointer s) const {
     auto n2 = char_traits::length(s);
-    return compare_cstr(buffer_, size_, s, n2);
+    return compare_cstr(buffer(), size_, s, n2);
 }
 
 // 从下标 pos1 开始的 count1 个字符跟另一个字符串比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::compare(size_type pos1,
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::compare(size_type pos1,
                                                 size_type count1,
                                                 const_pointer s) const {
     auto n1 = mystl::min(count1, size_ - pos1);
     auto n2 = char_traits::length(s);
-    return compare_cstr(buffer_, n1, s, n2);
+    return compare_cstr(buffer(), n1, s, n2);
 }
 
 // 从下标 pos1 开始的 count1 个字符跟另一个字符串的前 count2 个字符比较
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::compare(size_type pos1,
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::compare(size_type pos1,
                                                 size_type count1,
                                                 const_pointer s,
                                                 size_type count2) const {
     auto n1 = mystl::min(count1, size_ - pos1);
-    return compare_cstr(buffer_, n1, s, count2);
+    return compare_cstr(buffer(), n1, s, count2);
 }
 
 // 反转 basic_string
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::reverse() noexcept {
-    for (auto i = begin(), j = end(); i < j;) {
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::reverse() noexcept {
+    if (size_ < 2)
+        return;
+    for (auto i = begin(), j = end() - 1; i < j;) {
         mystl::iter_swap(i++, j--);
     }
 }
 
 // 交换连个basic_string
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::swap(basic_string& rhs) noexcept {
-    if (this != &rhs) {
-        mystl::swap(buffer_, rhs.buffer_);
-        mystl::swap(size_, rhs.size_);
-        mystl::swap(cap_, rhs.cap_);
-    }
+// 内部缓冲区不能直接交换指针，借助移动完成
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::swap(basic_string& rhs) noexcept {
+    if (this == &rhs)
+        return;
+    swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+    swap_data(rhs);
 }
 
 // 从下标 pos 开始查找字符为 ch 的元素，若找到返回其下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find(value_type ch,
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find(value_type ch,
                                          size_type pos) const noexcept {
-    for (auto i = pos; i < size_; ++i) {
-        if (*(buffer_ + 1) == ch) {
-            return i;
-        }
-    }
-    return npos;
+    if (pos >= size_)
+        return npos;
+    return pos_of(mystl::str_find_char(buffer() + pos, size_ - pos, ch));
 }
 
 // 从下标 pos 开始查找字符串 str，若找到返回起始位置的下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find(const_pointer str,
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find(const_pointer str,
                                          size_type pos) const noexcept {
-    const auto len = char_traits::length(str);
-    if (len == 0)
-        return pos;
-    if (size_ - pos < len)
-        return npos;
-    const auto left = size_ - len;
-    for (auto i = pos; i <= left; ++i) {
-        if (*(buffer_ + i) == *str) {
-            size_type j = 1;
-            for (; j < len; ++j) {
-                if (*(buffer_ + i + j) != *(str + j))
-                    break;
-            }
-            if (j == len)
-                return i;
-        }
-    }
-    return npos;
+    return find(str, pos, char_traits::length(str));
 }
 
 // 从下标 pos 开始查找字符串 str 的前 count
 // 个字符，若找到返回起始位置的下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find(const_pointer str,
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find(const_pointer str,
                                          size_type pos,
                                          size_type count) const noexcept {
     if (count == 0) {
-        return pos;
+        return pos <= size_ ? pos : npos;
     }
-    if (size_ - pos < count) {
+    if (pos >= size_ || size_ - pos < count) {
         // 从pos开始的总字符数小于count一定找不到
         return npos;
     }
-    const auto left = size_ - count;
-    // 只要遍历到size_-count，因为最后预留count个
-    for (auto i = pos; i <= left; ++i) {
-        if (*(buffer_ + i) == *str) {
-            size_type j = 1;
-            for (; j < count; ++j) {
-                if (*(buffer_ + i + j) != *(str + j)) {
-                    break;
-                }
-            }
-            // 完整匹配上，return i
-            if (j == count) {
-                return i;
-            }
-        }
-    }
-    return npos;
+    return pos_of(mystl::str_find(buffer() + pos, size_ - pos, str, count));
 }
 
 // 从下标 pos 开始查找字符串 str，若找到返回起始位置的下标，否则返回 npos
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find(const basic_string& str,
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find(const basic_string& str,
                                          size_type pos) const noexcept {
-    // 现在的count变成了str的大小
-    const size_type count = str.size_;
-    if (count == 0)
-        return pos;
-    if (size_ - pos < count)
-        return npos;
-    const auto left = size_ - count;
-    for (auto i = pos; i <= left; ++i) {
-        if (*(buffer_ + i) == str.front()) {
-            size_type j = 1;
-            for (; j < count; ++j) {
-                if (*(buffer_ + i + j) != str[j])
-                    break;
-            }
-            if (j == count)
-                return i;
-        }
-    }
-    return npos;
+    return find(str.buffer(), pos, str.size_);
 }
 
-// 从下标 pos 开始反向查找值为 ch 的元素，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::rfind(value_type ch,
+// 反向查找值为 ch 的元素，下标不超过 pos
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::rfind(value_type ch,
                                           size_type pos) const noexcept {
-    if (pos >= size_) {
-        // 太大了置为尾巴
-        pos = size_ - 1;
-    }
-    for (auto i = pos; i != 0; --i) {
-        if (*(buffer_ + 1) == ch) {
-            // 反向查找，找到了就返回
-            return i;
-        }
-    }
-    // 验证第1个是否相等
-    return front() == ch ? 0 : npos;
+    if (size_ == 0)
+        return npos;
+    const size_type n = mystl::min(pos, size_ - 1) + 1;
+    return pos_of(mystl::str_rfind_char(buffer(), n, ch));
 }
 
-// 从下标 pos 开始反向查找字符串 str，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::rfind(const_pointer str,
+// 反向查找字符串 str，起始位置不超过 pos
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::rfind(const_pointer str,
                                           size_type pos) const noexcept {
-    if (pos >= size_)
-        pos = size_ - 1;
-    const size_type len = char_traits::length(str);
-    switch (len) {
-        case 0:
-            // 字符串长度为0，直接返回pos
-            return pos;
-        case 1: {
-            // 1个字符，返回i，同上一个函数
-            for (auto i = pos; i != 0; --i) {
-                if (*(buffer_ + i) == *str)
-                    return i;
-            }
-            return front() == *str ? 0 : npos;
-        }
-        default: {  // len >= 2
-            // 多个字符，逐一反向查找匹配
-            for (auto i = pos; i >= len - 1; --i) {
-                if (*(buffer_ + i) == *(str + len - 1)) {
-                    size_type j = 1;
-                    for (; j < len; ++j) {
-                        if (*(buffer_ + i - j) != *(str + len - j - 1))
-                            break;
-                    }
-                    if (j == len)
-                        return i - len + 1;
-                }
-            }
-            break;
-        }
-    }
-    return npos;
+    return rfind(str, pos, char_traits::length(str));
 }
 
-// 从下标 pos 开始反向查找字符串 str 前 count 个字符，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::rfind(const_pointer str,
+// 反向查找字符串 str 的前 count 个字符，起始位置不超过 pos
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::rfind(const_pointer str,
                                           size_type pos,
                                           size_type count) const noexcept {
-    if (count == 0)
-        return pos;
-    if (pos >= size_)
-        pos = size_ - 1;
-    // 因为反向查找，pos本身相对于beign要至少为count
-    if (pos < count - 1)
+    if (count > size_)
         return npos;
-    for (auto i = pos; i >= count - 1; --i) {
-        if (*(buffer_ + i) == *(str + count - 1)) {
-            size_type j = 1;
-            for (; j < count; ++j) {
-                if (*(buffer_ + i - j) != *(str + count - j - 1))
-                    break;
-            }
-            if (j == count)
-                return i - count + 1;
-        }
-    }
-    return npos;
+    // 起始位置最大为 size_ - count
+    const size_type last = mystl::min(pos, size_ - count);
+    if (count == 0)
+        return last;
+    return pos_of(mystl::str_rfind(buffer(), last + count, str, count));
 }
 
-// 从下标 pos 开始反向查找字符串 str，与 find 类似
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::rfind(const basic_string& str,
+// 反向查找字符串 str，起始位置不超过 pos
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::rfind(const basic_string& str,
                                           size_type pos) const noexcept {
-    const size_type count = str.size_;
-    if (pos >= size_)
-        pos = size_ - 1;
-    if (count == 0)
-        return pos;
-    if (pos < count - 1)
-        return npos;
-    for (auto i = pos; i >= count - 1; --i) {
-        if (*(buffer_ + i) == str[count - 1]) {
-            size_type j = 1;
-            for (; j < count; ++j) {
-                if (*(buffer_ + i - j) != str[count - j - 1])
-                    break;
-            }
-            if (j == count)
-                return i - count + 1;
-        }
-    }
-    return npos;
+    return rfind(str.buffer(), pos, str.size_);
 }
 
 // 从下标 pos 开始查找 ch 出现的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_first_of(value_type ch, size_type pos)
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_first_of(value_type ch, size_type pos)
     const noexcept {
-    for (auto i = pos; i < size_; ++i) {
-        if (*(buffer_ + i) == ch)
-            return i;
-    }
-    return npos;
+    return find(ch, pos);
 }
 
 // 从下标 pos 开始查找字符串 s 其中的一个字符出现的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_first_of(
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_first_of(
     const_pointer s,
     size_type pos) const noexcept {
-    const size_type len = char_traits::length(s);
-    // 每个pos指向的字符都去匹配s中所有字符
-    for (auto i = pos; i < size_; ++i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < len; ++j) {
-            if (ch == *(s + j))
-                return i;
-        }
-    }
-    return npos;
+    return find_first_of(s, pos, char_traits::length(s));
 }
 
 // 从下标 pos 开始查找字符串 s 前count个字符中的一个字符出现的第1个位置
-// 就是把上一个函数的len用count自己指定了
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_first_of(
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_first_of(
     const_pointer s,
     size_type pos,
     size_type count) const noexcept {
-    for (auto i = pos; i < size_; ++i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < count; ++j) {
-            if (ch == *(s + j))
-                return i;
-        }
-    }
-    return npos;
+    if (pos >= size_)
+        return npos;
+    return pos_of(mystl::str_find_first_of(buffer() + pos, size_ - pos, s,
+                                           count, true));
 }
 
 // 从下标 pos 开始查找字符串 str 其中一个字符出现的第一个位置
-// 前面函数的s是const_pointer，这里的str是basic_string
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_first_of(
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_first_of(
     const basic_string& str,
     size_type pos) const noexcept {
-    for (auto i = pos; i < size_; ++i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < str.size_; ++j) {
-            if (ch == str[j])
-                return i;
-        }
-    }
-    return npos;
+    return find_first_of(str.buffer(), pos, str.size_);
 }
 
 // 从下标 pos 开始查找与 ch 不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_first_not_of(
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_first_not_of(
     value_type ch,
     size_type pos) const noexcept {
-    for (auto i = pos; i < size_; ++i) {
-        if (*(buffer_ + i) != ch)
-            return i;
-    }
-    return npos;
+    return find_first_not_of(&ch, pos, 1);
 }
 
-// 从下标 pos 开始查找与字符串 s 其中一个字符不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_first_not_of(
+// 从下标 pos 开始查找第一个不在字符串 s 中的字符
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_first_not_of(
     const_pointer s,
     size_type pos) const noexcept {
-    const size_type len = char_traits::length(s);
-    for (auto i = pos; i < size_; ++i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < len; ++j) {
-            if (ch != *(s + j))
-                return i;
-        }
-    }
-    return npos;
+    return find_first_not_of(s, pos, char_traits::length(s));
 }
 
-// 从下标 pos 开始查找与字符串 s 前 count 个字符中不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_first_not_of(
+// 从下标 pos 开始查找第一个不在字符串 s 前 count 个字符中的字符
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_first_not_of(
     const_pointer s,
     size_type pos,
     size_type count) const noexcept {
-    for (auto i = pos; i < size_; i++) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < count; ++j) {
-            if (ch != *(s + j)) {
-                return i;
-            }
-        }
-    }
-    return npos;
+    if (pos >= size_)
+        return npos;
+    return pos_of(mystl::str_find_first_of(buffer() + pos, size_ - pos, s,
+                                           count, false));
 }
 
-// 从下标 pos 开始查找与字符串 str 的字符中不相等的第一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_first_not_of(
+// 从下标 pos 开始查找第一个不在字符串 str 中的字符
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_first_not_of(
     const basic_string& str,
     size_type pos) const noexcept {
-    for (auto i = pos; i < size_; ++i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < str.size_; ++j) {
-            if (ch != str[j])
-                return i;
-        }
-    }
-    return npos;
+    return find_first_not_of(str.buffer(), pos, str.size_);
 }
 
-// 从下标 pos 开始查找与 ch 相等的最后一个位置
-// i从最后反着来就行
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_last_of(value_type ch,
+// 在 [pos, size()) 中查找与 ch 相等的最后一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_last_of(value_type ch,
                                                  size_type pos) const noexcept {
-    for (auto i = size_ - 1; i >= pos; --i) {
-        if (*(buffer_ + i) == ch)
-            return i;
-    }
-    return npos;
+    if (pos >= size_)
+        return npos;
+    return pos_of(mystl::str_rfind_char(buffer() + pos, size_ - pos, ch));
 }
 
-// 从下标 pos 开始查找与字符串 s 其中一个字符相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_last_of(const_pointer s,
+// 在 [pos, size()) 中查找与字符串 s 其中一个字符相等的最后一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_last_of(const_pointer s,
                                                  size_type pos) const noexcept {
-    const size_type len = char_traits::length(s);
-    for (auto i = size_ - 1; i >= pos; --i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < len; ++j) {
-            if (ch == *(s + j))
-                return i;
-        }
-    }
-    return npos;
+    return find_last_of(s, pos, char_traits::length(s));
 }
 
-// 从下标 pos 开始查找与字符串 s 前 count 个字符中相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_last_of(
+// 在 [pos, size()) 中查找与字符串 s 前 count 个字符中相等的最后一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_last_of(
     const_pointer s,
     size_type pos,
     size_type count) const noexcept {
-    for (auto i = size_ - 1; i >= pos; --i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < count; ++j) {
-            if (ch == *(s + j))
-                return i;
-        }
-    }
-    return npos;
+    if (pos >= size_)
+        return npos;
+    return pos_of(mystl::str_find_last_of(buffer() + pos, size_ - pos, s,
+                                          count, true));
 }
 
-// 从下标 pos 开始查找与字符串 str 字符中相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_last_of(const basic_string& str,
+// 在 [pos, size()) 中查找与字符串 str 字符中相等的最后一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_last_of(const basic_string& str,
                                                  size_type pos) const noexcept {
-    for (auto i = size_ - 1; i >= pos; --i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < str.size_; ++j) {
-            if (ch == str[j])
-                return i;
-        }
-    }
-    return npos;
+    return find_last_of(str.buffer(), pos, str.size_);
 }
 
-// 从下标 pos 开始查找与 ch 字符不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_last_not_of(
+// 在 [pos, size()) 中查找与 ch 字符不相等的最后一个位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_last_not_of(
     value_type ch,
     size_type pos) const noexcept {
-    for (auto i = size_ - 1; i >= pos; --i) {
-        if (*(buffer_ + i) != ch)
-            return i;
-    }
-    return npos;
+    return find_last_not_of(&ch, pos, 1);
 }
 
-// 从下标 pos 开始查找与字符串 s 的字符中不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_last_not_of(
+// 在 [pos, size()) 中查找最后一个不在字符串 s 中的字符
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_last_not_of(
     const_pointer s,
     size_type pos) const noexcept {
-    const size_type len = char_traits::length(s);
-    for (auto i = size_ - 1; i >= pos; --i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < len; ++j) {
-            if (ch != *(s + j))
-                return i;
-        }
-    }
-    return npos;
+    return find_last_not_of(s, pos, char_traits::length(s));
 }
 
-// 从下标 pos 开始查找与字符串 s 前 count 个字符中不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_last_not_of(
+// 在 [pos, size()) 中查找最后一个不在字符串 s 前 count 个字符中的字符
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_last_not_of(
     const_pointer s,
     size_type pos,
     size_type count) const noexcept {
-    for (auto i = size_ - 1; i >= pos; --i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < count; ++j) {
-            if (ch != *(s + j))
-                return i;
-        }
-    }
-    return npos;
+    if (pos >= size_)
+        return npos;
+    return pos_of(mystl::str_find_last_of(buffer() + pos, size_ - pos, s,
+                                          count, false));
 }
 
-// 从下标 pos 开始查找与字符串 str 字符中不相等的最后一个位置
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::find_last_not_of(
+// 在 [pos, size()) 中查找最后一个不在字符串 str 中的字符
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::find_last_not_of(
     const basic_string& str,
     size_type pos) const noexcept {
-    for (auto i = size_ - 1; i >= pos; --i) {
-        value_type ch = *(buffer_ + i);
-        for (size_type j = 0; j < str.size_; ++j) {
-            if (ch != str[j])
-                return i;
-        }
-    }
-    return npos;
+    return find_last_not_of(str.buffer(), pos, str.size_);
 }
 
 // 返回从下标 pos 开始字符为 ch 的元素出现的次数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::size_type
-basic_string<CharType, CharTraits>::count(value_type ch,
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::count(value_type ch,
                                           size_type pos) const noexcept {
     size_type n = 0;
     for (auto i = pos; i < size_; ++i) {
-        if (*(buffer_ + i) == ch)
+        if (*(buffer() + i) == ch)
             ++n;
     }
     return n;
@@ -1601,159 +1470,237 @@ basic_string<CharType, CharTraits>::count(value_type ch,
 /* ***************************************** */
 // helper function
 
-// 尝试初始化一段 buffer，若分配失败则忽略，不会抛出异常
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::try_init() noexcept {
-    try {
-        buffer_ =
-            data_allocator::allocate(static_cast<size_type>(STRING_INIT_SIZE));
-        size_ = 0;
-        cap_ = 0;
-    } catch (...) {
-        buffer_ = nullptr;
-        size_ = 0;
-        cap_ = 0;
-        // no throw
+// 使用内部缓冲区初始化一个空字符串，不会分配空间
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::init_local() noexcept {
+    heap_ = nullptr;
+    size_ = 0;
+    local_buf_[0] = value_type();
+}
+
+// 为 n 个字符准备空间，短字符串直接使用内部缓冲区，返回空间的起始位置
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::pointer
+basic_string<CharType, CharTraits, Alloc>::init_buffer(size_type n) {
+    if (n < local_size) {
+        heap_ = nullptr;
+        return local_buf_;
     }
+    const auto init_size =
+        mystl::max(static_cast<size_type>(STRING_INIT_SIZE), n);
+    heap_ = allocate_buffer(init_size);
+    cap_ = init_size;
+    return heap_;
 }
 
 // fill_init函数
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::fill_init(size_type n, value_type ch) {
-    const auto init_size =
-        mystl::max(static_cast<size_type>(STRING_INIT_SIZE), n + 1);
-    buffer_ = data_allocator::allocate(init_size);
-    char_traits::fill(buffer_, ch, n);
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::fill_init(size_type n, value_type ch) {
+    auto p = init_buffer(n);
+    char_traits::fill(p, ch, n);
     size_ = n;
-    cap_ = init_size;
+    p[n] = value_type();
 }
 
 // copy_init 函数
-// 拷贝构造
-template <class CharType, class CharTraits>
+// 输入迭代器只能遍历一次，逐个追加
+template <class CharType, class CharTraits, class Alloc>
 template <class Iter>
-void basic_string<CharType, CharTraits>::copy_init(Iter first,
+void basic_string<CharType, CharTraits, Alloc>::copy_init(Iter first,
                                                    Iter last,
                                                    mystl::input_iterator_tag) {
-    size_type n = mystl::distance(first, last);
-    // 决定string容器的容量
-    const auto init_size =
-        mystl::max(static_cast<size_type>(STRING_INIT_SIZE), n + 1);
+    init_local();
     try {
-        // 分配内存空间
-        buffer_ = data_allocator::allocate(init_size);
-        size_ = n;
-        cap_ = init_size;
+        for (; first != last; ++first)
+            append(1, *first);
     } catch (...) {
-        // 抛出异常
-        buffer_ = nullptr;
-        size_ = 0;
-        cap_ = 0;
+        destroy_buffer();
         throw;
     }
-    // 逐一填充数据
-    for (; n > 0; --n, ++first)
-        append(*first);
 }
 
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc>
 template <class Iter>
-void basic_string<CharType, CharTraits>::copy_init(
+void basic_string<CharType, CharTraits, Alloc>::copy_init(
     Iter first,
     Iter last,
     mystl::forward_iterator_tag) {
     const size_type n = mystl::distance(first, last);
-    const auto init_size =
-        mystl::max(static_cast<size_type>(STRING_INIT_SIZE), n + 1);
+    auto p = init_buffer(n);
     try {
-        buffer_ = data_allocator::allocate(init_size);
-        size_ = n;
-        cap_ = init_size;
-        // uninitialized_copy将[first, last)拷贝到buffer_
-        mystl::uninitialized_copy(first, last, buffer_);
+        // uninitialized_copy将[first, last)拷贝到buffer()
+        mystl::uninitialized_copy(first, last, p);
     } catch (...) {
-        buffer_ = nullptr;
-        size_ = 0;
-        cap_ = 0;
+        destroy_buffer();
         throw;
     }
+    set_size(n);
 }
 
 // init_from函数
-// 从字符串src的pos位置复制count个字符到buffer_
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::init_from(const_pointer src,
+// 从字符串src的pos位置复制count个字符到buffer()
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::init_from(const_pointer src,
                                                    size_type pos,
                                                    size_type count) {
-    const auto init_size =
-        mystl::max(static_cast<size_type>(STRING_INIT_SIZE), count + 1);
-    buffer_ = data_allocator::allocate(init_size);
-    char_traits::copy(buffer_, src + pos, count);
+    auto p = init_buffer(count);
+    char_traits::copy(p, src + pos, count);
     size_ = count;
-    cap_ = init_size;
+    p[count] = value_type();
+}
+
+// move_from 函数
+// 接管 rhs 的内容，短字符串直接复制整个内部缓冲区，rhs 变为空字符串
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::move_from(basic_string& rhs) noexcept {
+    if (rhs.is_local()) {
+        heap_ = nullptr;
+        char_traits::copy(local_buf_, rhs.local_buf_, local_size);
+    } else {
+        heap_ = rhs.heap_;
+        cap_ = rhs.cap_;
+    }
+    size_ = rhs.size_;
+    rhs.init_local();
 }
 
 // destroy_buffer 函数
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::destroy_buffer() {
-    if (buffer_ != nullptr) {
-        // 执行的是delete buffer_的操作
-        data_allocator::deallocate(buffer_, cap_);
-        buffer_ = nullptr;
-        size_ = 0;
-        cap_ = 0;
+// 只有堆上的空间需要释放
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::destroy_buffer() noexcept {
+    if (!is_local()) {
+        alloc_.deallocate(heap_, cap_ + 1);
+    }
+}
+
+// swap_data 函数
+// 交换除分配器以外的内容，内部缓冲区不能直接交换指针，借助 move_from 完成
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::swap_data(
+    basic_string& rhs) noexcept {
+    if (!is_local() && !rhs.is_local()) {
+        mystl::swap(heap_, rhs.heap_);
+        mystl::swap(size_, rhs.size_);
+        mystl::swap(cap_, rhs.cap_);
+    } else {
+        // move_from 之后来源总是空的短字符串，tmp 析构时没有空间需要释放
+        basic_string tmp(alloc_);
+        tmp.move_from(rhs);
+        rhs.move_from(*this);
+        move_from(tmp);
+    }
+}
+
+// copy_alloc 函数
+// 复制赋值时传播分配器，分配器不同时先用旧的分配器释放原来的空间
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::copy_alloc(
+    const basic_string& rhs,
+    m_true_type) {
+    if (alloc_ != rhs.alloc_) {
+        destroy_buffer();
+        init_local();
+        alloc_ = rhs.alloc_;
+    }
+}
+
+// move_assign 函数
+// 分配器随内容传播，直接接管 rhs 的空间
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::move_assign(
+    basic_string& rhs,
+    m_true_type) noexcept {
+    destroy_buffer();
+    alloc_ = rhs.alloc_;
+    move_from(rhs);
+}
+
+// 分配器不传播时，只有两个分配器相等或 rhs 为短字符串才能直接接管，否则复制内容
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::move_assign(basic_string& rhs,
+                                                            m_false_type) {
+    if (rhs.is_local() || alloc_traits::equal(alloc_, rhs.alloc_)) {
+        destroy_buffer();
+        move_from(rhs);
+    } else {
+        assign_cstr(rhs.buffer(), rhs.size_);
+        rhs.clear();
     }
 }
 
+// reset_buffer 函数
+// 释放原来的空间，改用容量为 new_cap 的 new_buffer
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::reset_buffer(
+    pointer new_buffer,
+    size_type new_cap) noexcept {
+    destroy_buffer();
+    heap_ = new_buffer;
+    cap_ = new_cap;
+}
+
 // to_raw_pointer 函数
-// 用于将当前字符串对象转换为一个C风格的字符串指针
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::const_pointer
-basic_string<CharType, CharTraits>::to_raw_pointer() const {
-    // 在当前字符串的末尾添加一个空字符，以便将其转换为 C 风格的字符串
-    *(buffer_ + size_) = value_type();
-    // 返回指向当前字符串首字符的指针
-    return buffer_;
+// buffer() 始终以空字符结尾，可以直接作为 C 风格的字符串使用
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::const_pointer
+basic_string<CharType, CharTraits, Alloc>::to_raw_pointer() const noexcept {
+    return buffer();
 }
 
 // reinsert函数
-// 重新分配内存空间，以容纳更多的字符，同时保留原有的字符内容
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::reinsert(size_type size) {
-    auto new_buffer = data_allocator::allocate(size);
-    try {
-        // buffer_开始的size个复制到new_buffer
-        char_traits::move(new_buffer, buffer_, size);
-    } catch (...) {
-        data_allocator::deallocate(new_buffer);
+// 把容量缩小到 size，足够短时搬回内部缓冲区
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::reinsert(size_type size) {
+    if (size < local_size) {
+        // cap_ 与 local_buf_ 共用空间，先记下原来的空间再复制
+        const auto old_buffer = heap_;
+        const auto old_cap = cap_;
+        char_traits::copy(local_buf_, old_buffer, size + 1);
+        heap_ = nullptr;
+        alloc_.deallocate(old_buffer, old_cap + 1);
+    } else {
+        auto new_buffer = allocate_buffer(size);
+        char_traits::copy(new_buffer, buffer(), size + 1);
+        reset_buffer(new_buffer, size);
     }
-    // new_buffer再重新赋给buffer_
-    buffer_ = new_buffer;
-    size_=size;
-    cap_=size;
 }
 
 // append_range，末尾追加一段 [first, last) 内的字符
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc>
 template <class Iter>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::append_range(Iter first, Iter last) {
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::append_range(Iter first, Iter last) {
     const size_type n = mystl::distance(first, last);
     THROW_LENGTH_ERROR_IF(size_ > max_size() - n,
                           "basic_string<Char, Tratis>'s size too big");
-    if (cap_ - size_ < n) {
+    if (capacity() - size_ < n) {
         reallocate(n);
     }
-    // 把 [first, first + n)区间上的元素拷贝到 [buffer_ + size_, buffer_ + size_
+    // 把 [first, first + n)区间上的元素拷贝到 [buffer() + size_, buffer() + size_
     // + n)上
-    mystl::uninitialized_copy_n(first, n, buffer_ + size_);
-    size_ += n;
+    mystl::uninitialized_copy_n(first, n, buffer() + size_);
+    set_size(size_ + n);
     return *this;
 }
 
+// assign_cstr，用 [s, s + n) 替换全部内容，容量足够时不重新分配
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::assign_cstr(const_pointer s,
+                                                     size_type n) {
+    if (capacity() < n) {
+        // 先复制再释放，s 可能指向自身
+        auto new_buffer = allocate_buffer(n);
+        char_traits::copy(new_buffer, s, n);
+        reset_buffer(new_buffer, n);
+    } else {
+        char_traits::move(buffer(), s, n);
+    }
+    set_size(n);
+}
+
 // 比较两个字符串是否相等
-template <class CharType, class CharTraits>
-int basic_string<CharType, CharTraits>::compare_cstr(const_pointer s1,
+template <class CharType, class CharTraits, class Alloc>
+int basic_string<CharType, CharTraits, Alloc>::compare_cstr(const_pointer s1,
                                                      size_type n1,
                                                      const_pointer s2,
                                                      size_type n2) const {
@@ -1772,9 +1719,9 @@ int basic_string<CharType, CharTraits>::compare_cstr(const_pointer s1,
 }
 
 // 把 first 开始的 count1 个字符替换成 str 开始的 count2 个字符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::replace_cstr(const_iterator first,
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::replace_cstr(const_iterator first,
                                                  size_type count1,
                                                  const_pointer str,
                                                  size_type count2) {
@@ -1782,329 +1729,339 @@ basic_string<CharType, CharTraits>::replace_cstr(const_iterator first,
         // 字符串从first开始到cend()，不足count1个字符
         count1 = cend() - first;
     }
+    // 重新分配后 first 会失效，先记下下标
+    const size_type pos = first - cbegin();
     if (count1 < count2) {
         // add为需要添加的字符数
         const size_type add = count2 - count1;
         THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
                               "basic_string<Char, Traits>'s size too big");
-        if (size_ > cap_ - add) {
+        if (capacity() - size_ < add) {
             // 剩余空间不足，需要重新分配add
             reallocate(add);
         }
-        pointer r = const_cast<pointer>(first);
-        // [first+count1,end())移到r+count2开始，空出count2个位置
-        char_traits::move(r + count2, first + count1, end() - (first + count1));
+        pointer r = buffer() + pos;
+        // [r+count1,end())移到r+count2开始，空出count2个位置
+        char_traits::move(r + count2, r + count1, end() - (r + count1));
         // 拷贝count2个
         char_traits::copy(r, str, count2);
-        size_ += add;
+        set_size(size_ + add);
     } else {
-        pointer r = const_cast<pointer>(first);
-        // [first+count1,end())移到r+count2开始，空出count2个位置
-        char_traits::move(r + count2, first + count1, end() - (first + count1));
+        pointer r = buffer() + pos;
+        // [r+count1,end())移到r+count2开始，空出count2个位置
+        char_traits::move(r + count2, r + count1, end() - (r + count1));
         char_traits::copy(r, str, count2);
         // size_减少了count1-count2个
-        size_ -= count1 - count2;
+        set_size(size_ - (count1 - count2));
     }
     return *this;
 }
 
 // 把 first 开始的 count1 个字符替换成 count2 个 ch 字符
-// 把 first 开始的 count1 个字符替换成 count2 个 ch 字符
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::
-replace_fill(const_iterator first, size_type count1, size_type count2, value_type ch)
-{
-  if (static_cast<size_type>(cend() - first) < count1)
-  {
-    count1 = cend() - first;
-  }
-  if (count1 < count2)
-  {
-    const size_type add = count2 - count1;
-    THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
-                          "basic_string<Char, Traits>'s size too big");
-    if (size_ > cap_ - add)
-    {
-      reallocate(add);
-    }
-    pointer r = const_cast<pointer>(first);
-    char_traits::move(r + count2, first + count1, end() - (first + count1));
-    // 只是把上一个函数的copy改成了fill
-    char_traits::fill(r, ch, count2);
-    size_ += add;
-  }
-  else
-  {
-    pointer r = const_cast<pointer>(first);
-    char_traits::move(r + count2, first + count1, end() - (first + count1));
-    char_traits::fill(r, ch, count2);
-    size_ -= (count1 - count2);
-  }
-  return *this;
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::replace_fill(const_iterator first,
+                                                 size_type count1,
+                                                 size_type count2,
+                                                 value_type ch) {
+    if (static_cast<size_type>(cend() - first) < count1) {
+        count1 = cend() - first;
+    }
+    const size_type pos = first - cbegin();
+    if (count1 < count2) {
+        const size_type add = count2 - count1;
+        THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
+                              "basic_string<Char, Traits>'s size too big");
+        if (capacity() - size_ < add) {
+            reallocate(add);
+        }
+        pointer r = buffer() + pos;
+        char_traits::move(r + count2, r + count1, end() - (r + count1));
+        // 只是把上一个函数的copy改成了fill
+        char_traits::fill(r, ch, count2);
+        set_size(size_ + add);
+    } else {
+        pointer r = buffer() + pos;
+        char_traits::move(r + count2, r + count1, end() - (r + count1));
+        char_traits::fill(r, ch, count2);
+        set_size(size_ - (count1 - count2));
+    }
+    return *this;
 }
 
 // 把 [first, last) 的字符替换成 [first2, last2)
-template <class CharType, class CharTraits>
+template <class CharType, class CharTraits, class Alloc>
 template <class Iter>
-basic_string<CharType, CharTraits>&
-basic_string<CharType, CharTraits>::replace_copy(const_iterator first,
+basic_string<CharType, CharTraits, Alloc>&
+basic_string<CharType, CharTraits, Alloc>::replace_copy(const_iterator first,
                                                  const_iterator last,
                                                  Iter first2,
                                                  Iter last2) {
     size_type len1 = last - first;
     size_type len2 = last2 - first2;
+    const size_type pos = first - cbegin();
     if (len1 < len2) {
-        const size_type add = len2 - len2;
+        const size_type add = len2 - len1;
         THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
                               "basic_string<Char, Traits>'s size too big");
-        if (size_ > cap_ - add) {
+        if (capacity() - size_ < add) {
             reallocate(add);
         }
-        pointer r = const_cast<pointer>(first);
-        char_traits::move(r + len2, first + len1, end() - (first + len1));
+        pointer r = buffer() + pos;
+        char_traits::move(r + len2, r + len1, end() - (r + len1));
         char_traits::copy(r, first2, len2);
-        size_ += add;
+        set_size(size_ + add);
     } else {
-        pointer r = const_cast<pointer>(first);
-        char_traits::move(r + len2, first + len1, end() - (first + len1));
+        pointer r = buffer() + pos;
+        char_traits::move(r + len2, r + len1, end() - (r + len1));
         char_traits::copy(r, first2, len2);
-        size_ -= (len1 - len2);
+        set_size(size_ - (len1 - len2));
     }
     return *this;
 }
 
+// next_capacity 函数
+// 至少再容纳 need 个字符，否则按 1.5 倍增长
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::size_type
+basic_string<CharType, CharTraits, Alloc>::next_capacity(size_type need) const {
+    const auto old_cap = capacity();
+    return mystl::max(mystl::max(size_ + need, old_cap + (old_cap >> 1)),
+                      static_cast<size_type>(STRING_INIT_SIZE));
+}
+
 // reallocate 函数
 // 重新分配一块容量较大的内存空间
-template <class CharType, class CharTraits>
-void basic_string<CharType, CharTraits>::reallocate(size_type need) {
-    // 新容量为cap_+need, cap_+cap_/2中的较大值
-    const auto new_cap = mystl::max(cap_ + need, cap_ + (cap_ >> 1));
-    auto new_buffer = data_allocator::allocate(new_cap);
-    // 当前的buffer_拷贝到new_buffer
-    char_traits::move(new_buffer, buffer_, size_);
-    // delete 旧的buffer_
-    data_allocator::deallocate(buffer_);
-    buffer_ = new_buffer;
-    cap_ = new_cap;
+template <class CharType, class CharTraits, class Alloc>
+void basic_string<CharType, CharTraits, Alloc>::reallocate(size_type need) {
+    const auto new_cap = next_capacity(need);
+    auto new_buffer = allocate_buffer(new_cap);
+    // 当前的buffer()连同结尾的空字符拷贝到new_buffer
+    char_traits::copy(new_buffer, buffer(), size_ + 1);
+    reset_buffer(new_buffer, new_cap);
 }
 
 // reallocate_and_fill 函数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::reallocate_and_fill(iterator pos,
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::reallocate_and_fill(iterator pos,
                                                         size_type n,
                                                         value_type ch) {
-    // r为pos相对buffer_的长度
-    const auto r = pos - buffer_;
-    const auto old_cap = cap_;
+    // r为pos相对buffer()的长度
+    const auto r = pos - buffer();
     // 设置新的容量
-    const auto new_cap = mystl::max(old_cap + n, old_cap + (old_cap >> 1));
-    auto new_buffer = data_allocator::allocate(new_cap);
-    // 先buffer_中的r个数
-    auto e1 = char_traits::move(new_buffer, buffer_, r) + r;
+    const auto new_cap = next_capacity(n);
+    auto new_buffer = allocate_buffer(new_cap);
+    // 先buffer()中的r个数
+    auto e1 = char_traits::copy(new_buffer, buffer(), r) + r;
     // 再自己填充的n个ch字符
     auto e2 = char_traits::fill(e1, ch, n) + n;
     // 最后剩下的size_-r个
-    char_traits::move(e2, buffer_ + r, size_ - r);
-    // delete掉原来的buffer_
-    data_allocator::deallocate(buffer_, old_cap);
-    buffer_ = new_buffer;
-    size_ += n;
-    cap_ = new_cap;
+    char_traits::copy(e2, buffer() + r, size_ - r);
+    // 释放原来的buffer()
+    reset_buffer(new_buffer, new_cap);
+    set_size(size_ + n);
     // 返回pos的位置
-    return buffer_ + r;
+    return buffer() + r;
 }
 
 // reallocate_and_copy 函数
-template <class CharType, class CharTraits>
-typename basic_string<CharType, CharTraits>::iterator
-basic_string<CharType, CharTraits>::reallocate_and_copy(iterator pos,
+template <class CharType, class CharTraits, class Alloc>
+typename basic_string<CharType, CharTraits, Alloc>::iterator
+basic_string<CharType, CharTraits, Alloc>::reallocate_and_copy(iterator pos,
                                                         const_iterator first,
                                                         const_iterator last) {
-    const auto r = pos - buffer_;
-    const auto old_cap = cap_;
+    const auto r = pos - buffer();
     const size_type n = mystl::distance(first, last);
-    const auto new_cap = mystl::max(old_cap + n, old_cap + (old_cap >> 1));
-    auto new_buffer = data_allocator::allocate(new_cap);
-    auto e1 = char_traits::move(new_buffer, buffer_, r) + r;
-    auto e2 = mystl::uninitialized_copy_n(first, n, e1) + n;
-    char_traits::move(e2, buffer_ + r, size_ - r);
-    data_allocator::deallocate(buffer_, old_cap);
-    buffer_ = new_buffer;
-    size_ += n;
-    cap_ = new_cap;
-    return buffer_ + r;
+    const auto new_cap = next_capacity(n);
+    auto new_buffer = allocate_buffer(new_cap);
+    auto e1 = char_traits::copy(new_buffer, buffer(), r) + r;
+    auto e2 = mystl::uninitialized_copy_n(first, n, e1);
+    char_traits::copy(e2, buffer() + r, size_ - r);
+    reset_buffer(new_buffer, new_cap);
+    set_size(size_ + n);
+    return buffer() + r;
 }
 
 /* *************************************** */
 // 重载全局操作符
 
 // 重载operator+
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
-    const basic_string<CharType, CharTraits>& lhs,
-    const basic_string<CharType, CharTraits>& rhs) {
-    basic_string<CharType, CharTraits> tmp(lhs);
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
+    const basic_string<CharType, CharTraits, Alloc>& lhs,
+    const basic_string<CharType, CharTraits, Alloc>& rhs) {
+    basic_string<CharType, CharTraits, Alloc> tmp(lhs);
     tmp.append(rhs);
     return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
     const CharType* lhs,
-    const basic_string<CharType, CharTraits>& rhs) {
-    basic_string<CharType, CharTraits> tmp(lhs);
+    const basic_string<CharType, CharTraits, Alloc>& rhs) {
+    basic_string<CharType, CharTraits, Alloc> tmp(lhs, rhs.get_allocator());
     tmp.append(rhs);
     return tmp;
 }
 
 // 1个字符ch + rhs
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
     CharType ch,
-    const basic_string<CharType, CharTraits>& rhs) {
-    basic_string<CharType, CharTraits> tmp(1, ch);
+    const basic_string<CharType, CharTraits, Alloc>& rhs) {
+    basic_string<CharType, CharTraits, Alloc> tmp(1, ch, rhs.get_allocator());
     tmp.append(rhs);
     return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
-    const basic_string<CharType, CharTraits>& lhs,
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
+    const basic_string<CharType, CharTraits, Alloc>& lhs,
     const CharType* rhs) {
-    basic_string<CharType, CharTraits> tmp(lhs);
+    basic_string<CharType, CharTraits, Alloc> tmp(lhs);
     tmp.append(rhs);
     return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
-    const basic_string<CharType, CharTraits>& lhs,
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
+    const basic_string<CharType, CharTraits, Alloc>& lhs,
     CharType ch) {
-    basic_string<CharType, CharTraits> tmp(lhs);
+    basic_string<CharType, CharTraits, Alloc> tmp(lhs);
     tmp.append(1, ch);
     return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
-    basic_string<CharType, CharTraits>&& lhs,
-    const basic_string<CharType, CharTraits>& rhs) {
-    basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
+    basic_string<CharType, CharTraits, Alloc>&& lhs,
+    const basic_string<CharType, CharTraits, Alloc>& rhs) {
+    basic_string<CharType, CharTraits, Alloc> tmp(mystl::move(lhs));
     tmp.append(rhs);
     return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
-    const basic_string<CharType, CharTraits>& lhs,
-    basic_string<CharType, CharTraits>&& rhs) {
-    basic_string<CharType, CharTraits> tmp(mystl::move(rhs));
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
+    const basic_string<CharType, CharTraits, Alloc>& lhs,
+    basic_string<CharType, CharTraits, Alloc>&& rhs) {
+    basic_string<CharType, CharTraits, Alloc> tmp(mystl::move(rhs));
     // 在tmp.begin()处，插入[lhs.begin(), lhs.end())
     tmp.insert(tmp.begin(), lhs.begin(), lhs.end());
     return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
-    basic_string<CharType, CharTraits>&& lhs,
-    basic_string<CharType, CharTraits>&& rhs) {
-    basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
+    basic_string<CharType, CharTraits, Alloc>&& lhs,
+    basic_string<CharType, CharTraits, Alloc>&& rhs) {
+    basic_string<CharType, CharTraits, Alloc> tmp(mystl::move(lhs));
     tmp.append(rhs);
     return tmp;
 }
 
 // 这几个函数的区别在于CharType，basic_string，const，*，&，&&
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
     const CharType* lhs,
-    basic_string<CharType, CharTraits>&& rhs) {
-    basic_string<CharType, CharTraits> tmp(mystl::move(rhs));
+    basic_string<CharType, CharTraits, Alloc>&& rhs) {
+    basic_string<CharType, CharTraits, Alloc> tmp(mystl::move(rhs));
     tmp.insert(tmp.begin(), lhs, lhs + char_traits<CharType>::length(lhs));
     return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
     CharType ch,
-    basic_string<CharType, CharTraits>&& rhs) {
-    basic_string<CharType, CharTraits> tmp(mystl::move(rhs));
+    basic_string<CharType, CharTraits, Alloc>&& rhs) {
+    basic_string<CharType, CharTraits, Alloc> tmp(mystl::move(rhs));
     tmp.insert(tmp.begin(), ch);
     return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
-    basic_string<CharType, CharTraits>&& lhs,
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
+    basic_string<CharType, CharTraits, Alloc>&& lhs,
     const CharType* rhs) {
-    basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
+    basic_string<CharType, CharTraits, Alloc> tmp(mystl::move(lhs));
     tmp.append(rhs);
     return tmp;
 }
 
-template <class CharType, class CharTraits>
-basic_string<CharType, CharTraits> operator+(
-    basic_string<CharType, CharTraits>&& lhs,
+template <class CharType, class CharTraits, class Alloc>
+basic_string<CharType, CharTraits, Alloc> operator+(
+    basic_string<CharType, CharTraits, Alloc>&& lhs,
     CharType ch) {
-    basic_string<CharType, CharTraits> tmp(mystl::move(lhs));
+    basic_string<CharType, CharTraits, Alloc> tmp(mystl::move(lhs));
     tmp.append(1, ch);
     return tmp;
 }
 
 // 重载比较操作符
-template <class CharType, class CharTraits>
-bool operator==(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs) {
+template <class CharType, class CharTraits, class Alloc>
+bool operator==(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs) {
     return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator!=(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs) {
+template <class CharType, class CharTraits, class Alloc>
+bool operator!=(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs) {
     return lhs.size() != rhs.size() || lhs.compare(rhs) != 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator<(const basic_string<CharType, CharTraits>& lhs,
-               const basic_string<CharType, CharTraits>& rhs) {
+template <class CharType, class CharTraits, class Alloc>
+bool operator<(const basic_string<CharType, CharTraits, Alloc>& lhs,
+               const basic_string<CharType, CharTraits, Alloc>& rhs) {
     return lhs.compare(rhs) < 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator<=(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs) {
+template <class CharType, class CharTraits, class Alloc>
+bool operator<=(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs) {
     return lhs.compare(rhs) <= 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator>(const basic_string<CharType, CharTraits>& lhs,
-               const basic_string<CharType, CharTraits>& rhs) {
+template <class CharType, class CharTraits, class Alloc>
+bool operator>(const basic_string<CharType, CharTraits, Alloc>& lhs,
+               const basic_string<CharType, CharTraits, Alloc>& rhs) {
     return lhs.compare(rhs) > 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator>=(const basic_string<CharType, CharTraits>& lhs,
-                const basic_string<CharType, CharTraits>& rhs) {
+template <class CharType, class CharTraits, class Alloc>
+bool operator>=(const basic_string<CharType, CharTraits, Alloc>& lhs,
+                const basic_string<CharType, CharTraits, Alloc>& rhs) {
     return lhs.compare(rhs) >= 0;
 }
 
 // 重载 mystl 的 swap
-template <class CharType, class CharTraits>
-void swap(basic_string<CharType, CharTraits>& lhs,
-          basic_string<CharType, CharTraits>& rhs) noexcept {
+template <class CharType, class CharTraits, class Alloc>
+void swap(basic_string<CharType, CharTraits, Alloc>& lhs,
+          basic_string<CharType, CharTraits, Alloc>& rhs) noexcept {
     lhs.swap(rhs);
 }
 
 // 特化mystl::hash
-template <class CharType, class CharTraits>
-struct hash<basic_string<CharType, CharTraits>> {
-    size_t operator()(const basic_string<CharType, CharTraits>& str) {
+template <class CharType, class CharTraits, class Alloc>
+struct hash<basic_string<CharType, CharTraits, Alloc>> {
+    size_t operator()(
+        const basic_string<CharType, CharTraits, Alloc>& str) const noexcept {
         return bitwise_hash((const unsigned char*)str.c_str(),
                             str.size() * sizeof(CharType));
     }
 };
 
+// 字符串的哈希需要遍历整个字符串，在 hashtable 节点中缓存哈希值
+template <class CharType, class CharTraits, class Alloc>
+struct cache_hash_code<hash<basic_string<CharType, CharTraits, Alloc>>>
+    : public mystl::m_true_type {};
+
+// 短字符串模式下不保存指向内部缓冲区的指针，整个对象可以按位搬移
+template <class CharType, class CharTraits, class Alloc>
+struct is_trivially_relocatable<basic_string<CharType, CharTraits, Alloc>>
+    : is_trivially_relocatable<Alloc> {};
+
 }  // namespace mystl
 
 #endif  // !MYTINYSTL_BASIC_STRING_H_
\ No newline at end of file
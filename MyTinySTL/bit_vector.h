@@ -0,0 +1,812 @@
+#ifndef MYTINYSTL_BIT_VECTOR_H_
+#define MYTINYSTL_BIT_VECTOR_H_
+
+// 这个头文件包含 vector<bool> 的特化版本
+// vector<bool>：按位压缩的布尔向量
+
+// notes:
+//
+// 每个元素只占一位，按 64 位的字储存，字内低位在前。operator[]、解引用迭代器
+// 得到的是代理对象 bit_reference 而不是 bool&，因此没有 data()，也不能取元素地址。
+// 最后一个字中超出 size() 的位始终为 0，比较与计数可以直接按字进行。
+//
+// mystl::count、find、fill、copy、copy_backward、equal 对 vector<bool> 的迭代器
+// 提供重载，每次处理一个字，count 使用 popcount；其他算法仍按位逐个访问
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include "vector.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace mystl {
+
+// 储存位的字及其位数
+typedef uint64_t bit_word;
+#define BIT_WORD_BITS 64
+
+// 低 n 位为 1 的掩码，n 取 [0, BIT_WORD_BITS]
+inline bit_word bit_mask(size_t n) noexcept {
+    return n >= BIT_WORD_BITS ? ~bit_word(0) : (bit_word(1) << n) - 1;
+}
+
+inline size_t bit_popcount(bit_word w) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(w));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<size_t>(__popcnt64(w));
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<size_t>((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// w 的最低的 1 所在的位，w 不能为 0
+inline unsigned bit_ctz(bit_word w) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(w));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long r;
+    _BitScanForward64(&r, w);
+    return static_cast<unsigned>(r);
+#else
+    unsigned r = 0;
+    for (; !(w & 1); w >>= 1)
+        ++r;
+    return r;
+#endif
+}
+
+// 读出从 p 的第 off 位开始的 n 位，放在结果的低位，n 取 [1, BIT_WORD_BITS]
+inline bit_word bit_load(const bit_word* p, unsigned off, size_t n) noexcept {
+    bit_word w = p[0] >> off;
+    if (off + n > BIT_WORD_BITS)
+        w |= p[1] << (BIT_WORD_BITS - off);
+    return w & bit_mask(n);
+}
+
+// 把 w 的低 n 位写到从 p 的第 off 位开始的位置，n 取 [1, BIT_WORD_BITS]
+inline void bit_store(bit_word* p, unsigned off, size_t n, bit_word w) noexcept {
+    const bit_word m = bit_mask(n);
+    w &= m;
+    p[0] = (p[0] & ~(m << off)) | (w << off);
+    if (off + n > BIT_WORD_BITS) {
+        const unsigned shift = BIT_WORD_BITS - off;
+        p[1] = (p[1] & ~(m >> shift)) | (w >> shift);
+    }
+}
+
+// 代理对象，引用字 p 中由 mask 指定的一位
+class bit_reference {
+    bit_word* p_;
+    bit_word mask_;
+
+public:
+    bit_reference(bit_word* p, bit_word mask) noexcept : p_(p), mask_(mask) {}
+    bit_reference(const bit_reference&) noexcept = default;
+
+    operator bool() const noexcept { return (*p_ & mask_) != 0; }
+
+    bit_reference& operator=(bool x) noexcept {
+        if (x)
+            *p_ |= mask_;
+        else
+            *p_ &= ~mask_;
+        return *this;
+    }
+
+    bit_reference& operator=(const bit_reference& x) noexcept {
+        return *this = static_cast<bool>(x);
+    }
+
+    bool operator~() const noexcept { return !static_cast<bool>(*this); }
+    void flip() noexcept { *p_ ^= mask_; }
+};
+
+// 交换两个代理对象所引用的位，声明见 util.h
+inline void swap(bit_reference x, bit_reference y) noexcept {
+    const bool tmp = x;
+    x = static_cast<bool>(y);
+    y = tmp;
+}
+
+// 位迭代器的公共部分：指向字 p 中的第 off 位
+struct bit_iterator_base
+    : public mystl::iterator<mystl::random_access_iterator_tag, bool> {
+    bit_word* p;
+    unsigned off;
+
+    bit_iterator_base(bit_word* x, unsigned y) noexcept : p(x), off(y) {}
+
+    void bump_up() noexcept {
+        if (off++ == BIT_WORD_BITS - 1) {
+            off = 0;
+            ++p;
+        }
+    }
+
+    void bump_down() noexcept {
+        if (off-- == 0) {
+            off = BIT_WORD_BITS - 1;
+            --p;
+        }
+    }
+
+    void incr(ptrdiff_t n) noexcept {
+        ptrdiff_t i = n + static_cast<ptrdiff_t>(off);
+        p += i / BIT_WORD_BITS;
+        i %= BIT_WORD_BITS;
+        if (i < 0) {
+            i += BIT_WORD_BITS;
+            --p;
+        }
+        off = static_cast<unsigned>(i);
+    }
+
+    ptrdiff_t distance_from(const bit_iterator_base& x) const noexcept {
+        return BIT_WORD_BITS * (p - x.p) + static_cast<ptrdiff_t>(off) -
+               static_cast<ptrdiff_t>(x.off);
+    }
+
+    bool operator==(const bit_iterator_base& x) const noexcept {
+        return p == x.p && off == x.off;
+    }
+    bool operator!=(const bit_iterator_base& x) const noexcept {
+        return !(*this == x);
+    }
+    bool operator<(const bit_iterator_base& x) const noexcept {
+        return p < x.p || (p == x.p && off < x.off);
+    }
+    bool operator>(const bit_iterator_base& x) const noexcept { return x < *this; }
+    bool operator<=(const bit_iterator_base& x) const noexcept {
+        return !(x < *this);
+    }
+    bool operator>=(const bit_iterator_base& x) const noexcept {
+        return !(*this < x);
+    }
+};
+
+struct bit_iterator : public bit_iterator_base {
+    typedef bit_reference reference;
+    typedef void pointer;
+    typedef bit_iterator self;
+
+    bit_iterator() noexcept : bit_iterator_base(nullptr, 0) {}
+    bit_iterator(bit_word* x, unsigned y) noexcept : bit_iterator_base(x, y) {}
+
+    reference operator*() const noexcept {
+        return reference(p, bit_word(1) << off);
+    }
+    reference operator[](ptrdiff_t n) const noexcept { return *(*this + n); }
+
+    self& operator++() noexcept {
+        bump_up();
+        return *this;
+    }
+    self operator++(int) noexcept {
+        self tmp = *this;
+        bump_up();
+        return tmp;
+    }
+    self& operator--() noexcept {
+        bump_down();
+        return *this;
+    }
+    self operator--(int) noexcept {
+        self tmp = *this;
+        bump_down();
+        return tmp;
+    }
+
+    self& operator+=(ptrdiff_t n) noexcept {
+        incr(n);
+        return *this;
+    }
+    self& operator-=(ptrdiff_t n) noexcept { return *this += -n; }
+    self operator+(ptrdiff_t n) const noexcept {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self operator-(ptrdiff_t n) const noexcept {
+        self tmp = *this;
+        return tmp -= n;
+    }
+    ptrdiff_t operator-(const bit_iterator_base& x) const noexcept {
+        return distance_from(x);
+    }
+};
+
+inline bit_iterator operator+(ptrdiff_t n, const bit_iterator& x) noexcept {
+    return x + n;
+}
+
+struct bit_const_iterator : public bit_iterator_base {
+    typedef bool reference;
+    typedef bool const_reference;
+    typedef void pointer;
+    typedef bit_const_iterator self;
+
+    bit_const_iterator() noexcept : bit_iterator_base(nullptr, 0) {}
+    bit_const_iterator(bit_word* x, unsigned y) noexcept : bit_iterator_base(x, y) {}
+    bit_const_iterator(const bit_iterator& x) noexcept : bit_iterator_base(x.p, x.off) {}
+
+    const_reference operator*() const noexcept { return (*p >> off) & 1; }
+    const_reference operator[](ptrdiff_t n) const noexcept { return *(*this + n); }
+
+    self& operator++() noexcept {
+        bump_up();
+        return *this;
+    }
+    self operator++(int) noexcept {
+        self tmp = *this;
+        bump_up();
+        return tmp;
+    }
+    self& operator--() noexcept {
+        bump_down();
+        return *this;
+    }
+    self operator--(int) noexcept {
+        self tmp = *this;
+        bump_down();
+        return tmp;
+    }
+
+    self& operator+=(ptrdiff_t n) noexcept {
+        incr(n);
+        return *this;
+    }
+    self& operator-=(ptrdiff_t n) noexcept { return *this += -n; }
+    self operator+(ptrdiff_t n) const noexcept {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self operator-(ptrdiff_t n) const noexcept {
+        self tmp = *this;
+        return tmp -= n;
+    }
+    ptrdiff_t operator-(const bit_iterator_base& x) const noexcept {
+        return distance_from(x);
+    }
+};
+
+inline bit_const_iterator operator+(ptrdiff_t n,
+                                    const bit_const_iterator& x) noexcept {
+    return x + n;
+}
+
+/*****************************************************************************************/
+// 位迭代器上的算法
+// 先处理到字边界的零头，中间整字处理，最后处理剩下的零头
+/*****************************************************************************************/
+
+// count
+inline size_t count(bit_const_iterator first,
+                    bit_const_iterator last,
+                    const bool& value) {
+    size_t n = static_cast<size_t>(last - first);
+    const size_t total = n;
+    const bit_word* p = first.p;
+    size_t ones = 0;
+    if (first.off != 0 && n != 0) {
+        const size_t k = mystl::min(n, size_t(BIT_WORD_BITS - first.off));
+        ones += bit_popcount(bit_load(p++, first.off, k));
+        n -= k;
+    }
+    for (; n >= BIT_WORD_BITS; n -= BIT_WORD_BITS)
+        ones += bit_popcount(*p++);
+    if (n != 0)
+        ones += bit_popcount(*p & bit_mask(n));
+    return value ? ones : total - ones;
+}
+
+inline size_t count(bit_iterator first, bit_iterator last, const bool& value) {
+    return mystl::count(bit_const_iterator(first), bit_const_iterator(last), value);
+}
+
+// find
+// 与 value 异或后第一个非零的字即包含第一个匹配的位
+inline bit_const_iterator find(bit_const_iterator first,
+                               bit_const_iterator last,
+                               const bool& value) {
+    const bit_word flip = value ? 0 : ~bit_word(0);
+    size_t n = static_cast<size_t>(last - first);
+    bit_word* p = first.p;
+    if (first.off != 0 && n != 0) {
+        const size_t k = mystl::min(n, size_t(BIT_WORD_BITS - first.off));
+        const bit_word w = (bit_load(p, first.off, k) ^ flip) & bit_mask(k);
+        if (w != 0)
+            return bit_const_iterator(p, first.off + bit_ctz(w));
+        ++p;
+        n -= k;
+    }
+    for (; n >= BIT_WORD_BITS; n -= BIT_WORD_BITS, ++p) {
+        const bit_word w = *p ^ flip;
+        if (w != 0)
+            return bit_const_iterator(p, bit_ctz(w));
+    }
+    if (n != 0) {
+        const bit_word w = (*p ^ flip) & bit_mask(n);
+        if (w != 0)
+            return bit_const_iterator(p, bit_ctz(w));
+    }
+    return last;
+}
+
+inline bit_iterator find(bit_iterator first, bit_iterator last, const bool& value) {
+    const bit_const_iterator i =
+        mystl::find(bit_const_iterator(first), bit_const_iterator(last), value);
+    return bit_iterator(i.p, i.off);
+}
+
+// fill
+inline void fill(bit_iterator first, bit_iterator last, const bool& value) {
+    size_t n = static_cast<size_t>(last - first);
+    bit_word* p = first.p;
+    if (first.off != 0 && n != 0) {
+        const size_t k = mystl::min(n, size_t(BIT_WORD_BITS - first.off));
+        bit_store(p++, first.off, k, value ? ~bit_word(0) : 0);
+        n -= k;
+    }
+    const size_t words = n / BIT_WORD_BITS;
+    if (words != 0)
+        std::memset(p, value ? 0xff : 0, words * sizeof(bit_word));
+    p += words;
+    n %= BIT_WORD_BITS;
+    if (n != 0)
+        bit_store(p, 0, n, value ? ~bit_word(0) : 0);
+}
+
+// copy
+// 源与目的同一偏移时整字用 memmove，否则每次读写 64 位。result 不大于 first 时
+// 区间可以重叠
+inline bit_iterator copy(bit_const_iterator first,
+                         bit_const_iterator last,
+                         bit_iterator result) {
+    size_t n = static_cast<size_t>(last - first);
+    if (first.off == result.off) {
+        bit_word* src = first.p;
+        bit_word* dst = result.p;
+        if (first.off != 0 && n != 0) {
+            const size_t k = mystl::min(n, size_t(BIT_WORD_BITS - first.off));
+            bit_store(dst++, first.off, k, bit_load(src++, first.off, k));
+            n -= k;
+        }
+        const size_t words = n / BIT_WORD_BITS;
+        if (words != 0)
+            std::memmove(dst, src, words * sizeof(bit_word));
+        n %= BIT_WORD_BITS;
+        if (n != 0)
+            bit_store(dst + words, 0, n, bit_load(src + words, 0, n));
+        return result + static_cast<ptrdiff_t>(last - first);
+    }
+    while (n != 0) {
+        const size_t k = mystl::min(n, size_t(BIT_WORD_BITS));
+        bit_store(result.p, result.off, k, bit_load(first.p, first.off, k));
+        first += static_cast<ptrdiff_t>(k);
+        result += static_cast<ptrdiff_t>(k);
+        n -= k;
+    }
+    return result;
+}
+
+inline bit_iterator copy(bit_iterator first, bit_iterator last, bit_iterator result) {
+    return mystl::copy(bit_const_iterator(first), bit_const_iterator(last), result);
+}
+
+// copy_backward
+// 从后往前每次读写 64 位，result 不小于 last 时区间可以重叠
+inline bit_iterator copy_backward(bit_const_iterator first,
+                                  bit_const_iterator last,
+                                  bit_iterator result) {
+    size_t n = static_cast<size_t>(last - first);
+    while (n != 0) {
+        const size_t k = mystl::min(n, size_t(BIT_WORD_BITS));
+        last -= static_cast<ptrdiff_t>(k);
+        result -= static_cast<ptrdiff_t>(k);
+        bit_store(result.p, result.off, k, bit_load(last.p, last.off, k));
+        n -= k;
+    }
+    return result;
+}
+
+inline bit_iterator copy_backward(bit_iterator first,
+                                  bit_iterator last,
+                                  bit_iterator result) {
+    return mystl::copy_backward(bit_const_iterator(first), bit_const_iterator(last),
+                                result);
+}
+
+// equal
+inline bool equal(bit_const_iterator first1,
+                  bit_const_iterator last1,
+                  bit_const_iterator first2) {
+    size_t n = static_cast<size_t>(last1 - first1);
+    if (first1.off == first2.off) {
+        const bit_word* p1 = first1.p;
+        const bit_word* p2 = first2.p;
+        if (first1.off != 0 && n != 0) {
+            const size_t k = mystl::min(n, size_t(BIT_WORD_BITS - first1.off));
+            if (bit_load(p1++, first1.off, k) != bit_load(p2++, first1.off, k))
+                return false;
+            n -= k;
+        }
+        const size_t words = n / BIT_WORD_BITS;
+        if (words != 0 && std::memcmp(p1, p2, words * sizeof(bit_word)) != 0)
+            return false;
+        n %= BIT_WORD_BITS;
+        return n == 0 ||
+               bit_load(p1 + words, 0, n) == bit_load(p2 + words, 0, n);
+    }
+    while (n != 0) {
+        const size_t k = mystl::min(n, size_t(BIT_WORD_BITS));
+        if (bit_load(first1.p, first1.off, k) != bit_load(first2.p, first2.off, k))
+            return false;
+        first1 += static_cast<ptrdiff_t>(k);
+        first2 += static_cast<ptrdiff_t>(k);
+        n -= k;
+    }
+    return true;
+}
+
+inline bool equal(bit_iterator first1, bit_iterator last1, bit_iterator first2) {
+    return mystl::equal(bit_const_iterator(first1), bit_const_iterator(last1),
+                        bit_const_iterator(first2));
+}
+
+inline bool equal(bit_const_iterator first1,
+                  bit_const_iterator last1,
+                  bit_iterator first2) {
+    return mystl::equal(first1, last1, bit_const_iterator(first2));
+}
+
+inline bool equal(bit_iterator first1, bit_iterator last1, bit_const_iterator first2) {
+    return mystl::equal(bit_const_iterator(first1), bit_const_iterator(last1), first2);
+}
+
+// 模板类 vector<bool>
+// 用 vector<bit_word> 保存字，扩容、分配器传播都交给它
+template <class Alloc>
+class vector<bool, Alloc> {
+public:
+    // vector<bool> 的嵌套型别定义
+    typedef Alloc allocator_type;
+    typedef bool value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef bit_reference reference;
+    typedef bool const_reference;
+    typedef void pointer;
+    typedef void const_pointer;
+
+    typedef bit_iterator iterator;
+    typedef bit_const_iterator const_iterator;
+    typedef mystl::reverse_iterator<iterator> reverse_iterator;
+    typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    typedef bit_word word_type;
+
+private:
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<bit_word>
+        word_allocator;
+
+    mystl::vector<bit_word, word_allocator> words_;  // 按字储存的位
+    size_type size_;                                  // 元素个数
+
+public:
+    allocator_type get_allocator() const {
+        return allocator_type(words_.get_allocator());
+    }
+
+public:
+    // 构造、复制、移动、析构函数
+    vector() noexcept : size_(0) {}
+
+    explicit vector(const allocator_type& alloc) noexcept
+        : words_(word_allocator(alloc)), size_(0) {}
+
+    explicit vector(size_type n, const allocator_type& alloc = allocator_type())
+        : words_(word_count(n), 0, word_allocator(alloc)), size_(n) {}
+
+    vector(size_type n,
+           const bool& value,
+           const allocator_type& alloc = allocator_type())
+        : words_(word_count(n), 0, word_allocator(alloc)), size_(n) {
+        if (value)
+            mystl::fill(begin(), end(), true);
+    }
+
+    template <class Iter,
+              typename std::enable_if<mystl::is_input_iterator<Iter>::value,
+                                      int>::type = 0>
+    vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+        : words_(word_allocator(alloc)), size_(0) {
+        range_assign(first, last, iterator_category(first));
+    }
+
+    vector(const vector& rhs) = default;
+
+    vector(vector&& rhs) noexcept
+        : words_(mystl::move(rhs.words_)), size_(rhs.size_) {
+        rhs.size_ = 0;
+    }
+
+    vector(std::initializer_list<bool> ilist,
+           const allocator_type& alloc = allocator_type())
+        : words_(word_allocator(alloc)), size_(0) {
+        range_assign(ilist.begin(), ilist.end(), mystl::forward_iterator_tag());
+    }
+
+    vector& operator=(const vector& rhs) = default;
+
+    vector& operator=(vector&& rhs) noexcept {
+        words_ = mystl::move(rhs.words_);
+        size_ = rhs.size_;
+        rhs.size_ = 0;
+        return *this;
+    }
+
+    vector& operator=(std::initializer_list<bool> ilist) {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~vector() = default;
+
+public:
+    // 迭代器相关操作
+    iterator begin() noexcept { return iterator(word_begin(), 0); }
+    const_iterator begin() const noexcept { return const_iterator(word_begin(), 0); }
+    iterator end() noexcept { return begin() + static_cast<difference_type>(size_); }
+    const_iterator end() const noexcept {
+        return begin() + static_cast<difference_type>(size_);
+    }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept {
+        return words_.max_size() * BIT_WORD_BITS;
+    }
+    size_type capacity() const noexcept {
+        return words_.capacity() * BIT_WORD_BITS;
+    }
+    void reserve(size_type n) { words_.reserve(word_count(n)); }
+    void shrink_to_fit() { words_.shrink_to_fit(); }
+
+    // 访问元素相关操作
+    reference operator[](size_type n) {
+        MYSTL_DEBUG(n < size());
+        return *(begin() + static_cast<difference_type>(n));
+    }
+    const_reference operator[](size_type n) const {
+        MYSTL_DEBUG(n < size());
+        return *(begin() + static_cast<difference_type>(n));
+    }
+    reference at(size_type n) {
+        THROW_OUT_OF_RANGE_IF(!(n < size()),
+                              "vector<bool>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size()),
+                              "vector<bool>::at() subscript out of range");
+        return (*this)[n];
+    }
+
+    reference front() {
+        MYSTL_DEBUG(!empty());
+        return *begin();
+    }
+    const_reference front() const {
+        MYSTL_DEBUG(!empty());
+        return *begin();
+    }
+    reference back() {
+        MYSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+    const_reference back() const {
+        MYSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+
+    // 按字访问底层储存，共 (size() + BIT_WORD_BITS - 1) / BIT_WORD_BITS 个字
+    word_type* word_data() noexcept { return words_.data(); }
+    const word_type* word_data() const noexcept { return words_.data(); }
+
+    // 修改容器相关操作
+
+    // assign
+    void assign(size_type n, const bool& value) {
+        set_size(0);
+        resize(n, value);
+    }
+
+    template <class Iter,
+              typename std::enable_if<mystl::is_input_iterator<Iter>::value,
+                                      int>::type = 0>
+    void assign(Iter first, Iter last) {
+        set_size(0);
+        range_assign(first, last, iterator_category(first));
+    }
+
+    void assign(std::initializer_list<bool> il) { assign(il.begin(), il.end()); }
+
+    // emplace / emplace_back
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        return insert(pos, bool(mystl::forward<Args>(args)...));
+    }
+
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        push_back(bool(mystl::forward<Args>(args)...));
+    }
+
+    // push_back / pop_back
+    void push_back(const bool& value) {
+        if (size_ % BIT_WORD_BITS == 0)
+            words_.push_back(0);
+        if (value)
+            words_.back() |= bit_word(1) << (size_ % BIT_WORD_BITS);
+        ++size_;
+    }
+
+    void pop_back() {
+        MYSTL_DEBUG(!empty());
+        set_size(size_ - 1);
+    }
+
+    // insert
+    iterator insert(const_iterator pos, const bool& value) {
+        return insert(pos, 1, value);
+    }
+
+    iterator insert(const_iterator pos, size_type n, const bool& value) {
+        MYSTL_DEBUG(pos >= begin() && pos <= end());
+        const size_type idx = static_cast<size_type>(pos - begin());
+        const iterator first = open_gap(idx, n);
+        mystl::fill(first, first + static_cast<difference_type>(n), value);
+        return first;
+    }
+
+    template <class Iter,
+              typename std::enable_if<mystl::is_input_iterator<Iter>::value,
+                                      int>::type = 0>
+    iterator insert(const_iterator pos, Iter first, Iter last) {
+        MYSTL_DEBUG(pos >= begin() && pos <= end());
+        const size_type idx = static_cast<size_type>(pos - begin());
+        const vector tmp(first, last, get_allocator());
+        const iterator r = open_gap(idx, tmp.size());
+        mystl::copy(tmp.begin(), tmp.end(), r);
+        return r;
+    }
+
+    // erase / clear
+    iterator erase(const_iterator pos) {
+        MYSTL_DEBUG(pos >= begin() && pos < end());
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        const size_type idx = static_cast<size_type>(first - begin());
+        const iterator r(first.p, first.off);
+        mystl::copy(last, cend(), r);
+        set_size(size_ - static_cast<size_type>(last - first));
+        return begin() + static_cast<difference_type>(idx);
+    }
+
+    void clear() { set_size(0); }
+
+    // resize / flip / swap
+    void resize(size_type new_size) { resize(new_size, false); }
+    void resize(size_type new_size, const bool& value) {
+        const size_type old_size = size_;
+        set_size(new_size);
+        if (value && new_size > old_size)
+            mystl::fill(begin() + static_cast<difference_type>(old_size), end(), true);
+    }
+
+    // 翻转所有位
+    void flip() noexcept {
+        for (auto& w : words_)
+            w = ~w;
+        clear_tail();
+    }
+
+    void swap(vector& rhs) noexcept {
+        words_.swap(rhs.words_);
+        mystl::swap(size_, rhs.size_);
+    }
+
+    static void swap(reference x, reference y) noexcept { mystl::swap(x, y); }
+
+    template <class A>
+    friend bool operator==(const vector<bool, A>& lhs, const vector<bool, A>& rhs);
+
+private:
+    static size_type word_count(size_type n) noexcept {
+        return (n + BIT_WORD_BITS - 1) / BIT_WORD_BITS;
+    }
+
+    bit_word* word_begin() const noexcept {
+        return const_cast<bit_word*>(words_.data());
+    }
+
+    // 清掉最后一个字中超出 size_ 的位
+    void clear_tail() noexcept {
+        if (size_ % BIT_WORD_BITS != 0)
+            words_.back() &= bit_mask(size_ % BIT_WORD_BITS);
+    }
+
+    // 调整元素个数，新增的位为 0
+    void set_size(size_type n) {
+        words_.resize(word_count(n), 0);
+        size_ = n;
+        clear_tail();
+    }
+
+    // 在 idx 处空出 n 位，返回指向空位开头的迭代器
+    iterator open_gap(size_type idx, size_type n) {
+        const size_type old_size = size_;
+        set_size(size_ + n);
+        const iterator first = begin() + static_cast<difference_type>(idx);
+        mystl::copy_backward(first, begin() + static_cast<difference_type>(old_size),
+                             end());
+        return first;
+    }
+
+    template <class IIter>
+    void range_assign(IIter first, IIter last, input_iterator_tag) {
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    template <class FIter>
+    void range_assign(FIter first, FIter last, forward_iterator_tag) {
+        const size_type n = static_cast<size_type>(mystl::distance(first, last));
+        set_size(n);
+        mystl::copy(first, last, begin());
+    }
+};
+
+/*****************************************************************************************/
+// 重载比较操作符
+// 超出 size() 的位始终为 0，相等比较可以直接比较字
+
+template <class Alloc>
+bool operator==(const vector<bool, Alloc>& lhs, const vector<bool, Alloc>& rhs) {
+    return lhs.size_ == rhs.size_ && lhs.words_ == rhs.words_;
+}
+
+template <class Alloc>
+bool operator<(const vector<bool, Alloc>& lhs, const vector<bool, Alloc>& rhs) {
+    return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                          rhs.end());
+}
+
+}  // namespace mystl
+
+#endif  // !MYTINYSTL_BIT_VECTOR_H_
@@ -0,0 +1,1194 @@
+#ifndef MYTINYSTL_BTREE_H_
+#define MYTINYSTL_BTREE_H_
+
+// 这个头文件包含一个模板类 btree
+// btree : B 树，每个节点连续存放多个元素，用作 btree_map / btree_set 的底层机制
+
+// notes:
+//
+// 1. 节点大小约为 btree_node_bytes 字节，元素直接存放在节点内。查找时在节点内二分，
+//    每层只访问一个节点，层数约为 log_B(n)，B 为每个节点的元素个数
+// 2. 所有叶节点位于同一层。插入总在叶节点进行，节点满时分裂并把中间元素移到父节点；
+//    在节点末尾/开头插入时分裂偏向一侧，顺序插入得到的节点几乎是满的
+// 3. 删除内部节点的元素时先用前驱元素替换它，再从叶节点删除；
+//    节点过空时与相邻的兄弟节点合并，合并不下时从兄弟节点借一个元素
+// 4. 插入、删除会在节点内和节点间移动元素，所有迭代器、指针、引用都会失效
+// 5. 元素的键值萃取沿用 rb_tree_value_traits，不接受分配器参数
+//
+// 异常保证：
+// 满足基本异常保证，要求元素的移动构造不抛出异常
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "allocator.h"
+#include "rb_tree.h"
+
+namespace mystl {
+
+// 每个节点的目标大小（字节）
+static constexpr size_t btree_node_bytes = 256;
+
+template <class T>
+struct btree_internal_node;
+
+// btree 的叶节点，同时是内部节点的基类
+template <class T>
+struct btree_node {
+    typedef btree_node<T>* node_ptr;
+    typedef btree_internal_node<T>* internal_ptr;
+    typedef mystl::allocator<T> data_allocator;
+    typedef size_t size_type;
+
+    // 每个节点最多存放的元素个数，扣除约 16 字节的头部，至少为 3
+    static constexpr size_type slot_count =
+        btree_node_bytes > 16 + 3 * sizeof(T)
+            ? (btree_node_bytes - 16) / sizeof(T)
+            : 3;
+
+    internal_ptr parent;      // 父节点，根节点为 nullptr
+    unsigned short position;  // 本节点是父节点的第几个子节点
+    unsigned short count;     // 元素个数
+    bool leaf;                // 是否为叶节点
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type
+        slots[slot_count];
+
+    T* slot(size_type i) { return reinterpret_cast<T*>(slots + i); }
+    const T* slot(size_type i) const {
+        return reinterpret_cast<const T*>(slots + i);
+    }
+    T& value(size_type i) { return *slot(i); }
+    const T& value(size_type i) const { return *slot(i); }
+
+    internal_ptr as_internal() { return static_cast<internal_ptr>(this); }
+    node_ptr child(size_type i) const {
+        return static_cast<const btree_internal_node<T>*>(this)->children[i];
+    }
+
+    // 把 from 处的元素移动到未初始化的 to 处
+    static void move_slot(T* from, T* to) {
+        data_allocator::construct(to, mystl::move(*from));
+        data_allocator::destroy(from);
+    }
+
+    // 在 i 处放入一个新元素，原有的 [i, count) 右移一位
+    void insert_value(size_type i, T&& value) {
+        for (size_type k = count; k > i; --k)
+            move_slot(slot(k - 1), slot(k));
+        data_allocator::construct(slot(i), mystl::move(value));
+        ++count;
+    }
+
+    // i 处的元素已被移走，把 [i + 1, count) 左移一位填补
+    void close_gap(size_type i) {
+        for (size_type k = i + 1; k < count; ++k)
+            move_slot(slot(k), slot(k - 1));
+        --count;
+    }
+
+    void erase_value(size_type i) {
+        data_allocator::destroy(slot(i));
+        close_gap(i);
+    }
+};
+
+// btree 的内部节点，比叶节点多出 count + 1 个子节点
+template <class T>
+struct btree_internal_node : public btree_node<T> {
+    typedef btree_node<T>* node_ptr;
+    typedef size_t size_type;
+
+    node_ptr children[btree_node<T>::slot_count + 1];
+
+    void set_child(size_type i, node_ptr x) {
+        children[i] = x;
+        x->parent = this;
+        x->position = static_cast<unsigned short>(i);
+    }
+
+    // 在 i 处放入一个子节点，调用前 count 已经加一
+    void insert_child(size_type i, node_ptr x) {
+        for (size_type k = this->count; k > i; --k)
+            set_child(k, children[k - 1]);
+        set_child(i, x);
+    }
+
+    // 移除第 i 个子节点，调用前 count 已经减一
+    void remove_child(size_type i) {
+        for (size_type k = i; k <= this->count; ++k)
+            set_child(k, children[k + 1]);
+    }
+};
+
+// btree 的迭代器设计
+// 迭代器保存节点与节点内的位置，end() 为最右叶节点的末尾
+
+template <class T>
+struct btree_iterator;
+template <class T>
+struct btree_const_iterator;
+
+template <class T>
+struct btree_iterator_base
+    : public mystl::iterator<mystl::bidirectional_iterator_tag, T> {
+    typedef btree_node<T>* node_ptr;
+    typedef size_t size_type;
+
+    node_ptr node;       // 所在的节点
+    size_type position;  // 节点内的位置
+
+    btree_iterator_base() : node(nullptr), position(0) {}
+    btree_iterator_base(node_ptr x, size_type i) : node(x), position(i) {}
+
+    // 使迭代器前进
+    void inc() {
+        if (node->leaf) {
+            if (++position < node->count)
+                return;
+            // 叶节点已走完，向上找到第一个还有后续元素的祖先
+            auto save = *this;
+            while (position == node->count && node->parent != nullptr) {
+                position = node->position;
+                node = node->parent;
+            }
+            if (position == node->count)  // 已是最后一个元素，停在 end()
+                *this = save;
+        } else {
+            node = node->child(position + 1);
+            while (!node->leaf)
+                node = node->child(0);
+            position = 0;
+        }
+    }
+
+    // 使迭代器后退
+    void dec() {
+        if (node->leaf) {
+            if (position > 0) {
+                --position;
+                return;
+            }
+            auto save = *this;
+            while (position == 0 && node->parent != nullptr) {
+                position = node->position;
+                node = node->parent;
+            }
+            if (position == 0)
+                *this = save;
+            else
+                --position;
+        } else {
+            node = node->child(position);
+            while (!node->leaf)
+                node = node->child(node->count);
+            position = node->count - 1;
+        }
+    }
+
+    bool operator==(const btree_iterator_base& rhs) const {
+        return node == rhs.node && position == rhs.position;
+    }
+    bool operator!=(const btree_iterator_base& rhs) const {
+        return !(*this == rhs);
+    }
+};
+
+template <class T>
+struct btree_iterator : public btree_iterator_base<T> {
+    typedef T value_type;
+    typedef T* pointer;
+    typedef T& reference;
+    typedef btree_node<T>* node_ptr;
+    typedef size_t size_type;
+
+    typedef btree_iterator<T> iterator;
+    typedef btree_const_iterator<T> const_iterator;
+    typedef iterator self;
+
+    using btree_iterator_base<T>::node;
+    using btree_iterator_base<T>::position;
+
+    // 构造函数
+    btree_iterator() {}
+    btree_iterator(node_ptr x, size_type i) : btree_iterator_base<T>(x, i) {}
+    btree_iterator(const iterator& rhs)
+        : btree_iterator_base<T>(rhs.node, rhs.position) {}
+    btree_iterator(const const_iterator& rhs)
+        : btree_iterator_base<T>(rhs.node, rhs.position) {}
+
+    // 重载操作符
+    reference operator*() const { return node->value(position); }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator=(const iterator& rhs) = default;
+
+    self& operator++() {
+        this->inc();
+        return *this;
+    }
+    self operator++(int) {
+        self tmp(*this);
+        this->inc();
+        return tmp;
+    }
+    self& operator--() {
+        this->dec();
+        return *this;
+    }
+    self operator--(int) {
+        self tmp(*this);
+        this->dec();
+        return tmp;
+    }
+};
+
+template <class T>
+struct btree_const_iterator : public btree_iterator_base<T> {
+    typedef T value_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+    typedef btree_node<T>* node_ptr;
+    typedef size_t size_type;
+
+    typedef btree_iterator<T> iterator;
+    typedef btree_const_iterator<T> const_iterator;
+    typedef const_iterator self;
+
+    using btree_iterator_base<T>::node;
+    using btree_iterator_base<T>::position;
+
+    // 构造函数
+    btree_const_iterator() {}
+    btree_const_iterator(node_ptr x, size_type i)
+        : btree_iterator_base<T>(x, i) {}
+    btree_const_iterator(const iterator& rhs)
+        : btree_iterator_base<T>(rhs.node, rhs.position) {}
+    btree_const_iterator(const const_iterator& rhs)
+        : btree_iterator_base<T>(rhs.node, rhs.position) {}
+
+    // 重载操作符
+    reference operator*() const { return node->value(position); }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator=(const const_iterator& rhs) = default;
+
+    self& operator++() {
+        this->inc();
+        return *this;
+    }
+    self operator++(int) {
+        self tmp(*this);
+        this->inc();
+        return tmp;
+    }
+    self& operator--() {
+        this->dec();
+        return *this;
+    }
+    self operator--(int) {
+        self tmp(*this);
+        this->dec();
+        return tmp;
+    }
+};
+
+// 模板类 btree
+// 参数一代表数据类型，参数二代表键值比较类型
+template <class T, class Compare>
+class btree {
+public:
+    // btree 的嵌套型别定义
+
+    typedef rb_tree_value_traits<T> value_traits;
+
+    typedef typename value_traits::key_type key_type;
+    typedef typename value_traits::mapped_type mapped_type;
+    typedef typename value_traits::value_type value_type;
+    typedef Compare key_compare;
+
+    typedef btree_node<T> node_type;
+    typedef btree_internal_node<T> internal_type;
+    typedef node_type* node_ptr;
+    typedef internal_type* internal_ptr;
+
+    typedef mystl::allocator<T> allocator_type;
+    typedef mystl::allocator<T> data_allocator;
+    typedef mystl::allocator<node_type> leaf_allocator;
+    typedef mystl::allocator<internal_type> internal_allocator;
+
+    typedef typename allocator_type::pointer pointer;
+    typedef typename allocator_type::const_pointer const_pointer;
+    typedef typename allocator_type::reference reference;
+    typedef typename allocator_type::const_reference const_reference;
+    typedef typename allocator_type::size_type size_type;
+    typedef typename allocator_type::difference_type difference_type;
+
+    typedef btree_iterator<T> iterator;
+    typedef btree_const_iterator<T> const_iterator;
+    typedef mystl::reverse_iterator<iterator> reverse_iterator;
+    typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    // 每个节点最多存放的元素个数
+    static constexpr size_type node_slots = node_type::slot_count;
+    // 删除后节点的元素少于这个数时，与兄弟节点合并或借一个元素
+    static constexpr size_type min_slots = node_slots / 2;
+
+    allocator_type get_allocator() const { return allocator_type(); }
+    key_compare key_comp() const { return comp_; }
+
+private:
+    node_ptr root_;       // 根节点，空树时为 nullptr
+    node_ptr leftmost_;   // 最左的叶节点
+    node_ptr rightmost_;  // 最右的叶节点
+    size_type size_;      // 元素个数
+    key_compare comp_;    // 键值比较的准则
+
+public:
+    // 构造、复制、析构函数
+
+    btree()
+        : root_(nullptr),
+          leftmost_(nullptr),
+          rightmost_(nullptr),
+          size_(0),
+          comp_() {}
+
+    explicit btree(const key_compare& comp)
+        : root_(nullptr),
+          leftmost_(nullptr),
+          rightmost_(nullptr),
+          size_(0),
+          comp_(comp) {}
+
+    btree(const btree& rhs);
+    btree(btree&& rhs) noexcept;
+
+    btree& operator=(const btree& rhs);
+    btree& operator=(btree&& rhs) noexcept;
+
+    ~btree() { clear(); }
+
+public:
+    // 迭代器相关操作
+
+    iterator begin() noexcept { return iterator(leftmost_, 0); }
+    const_iterator begin() const noexcept {
+        return const_iterator(leftmost_, 0);
+    }
+    iterator end() noexcept {
+        return iterator(rightmost_,
+                        rightmost_ == nullptr ? 0 : rightmost_->count);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(rightmost_,
+                              rightmost_ == nullptr ? 0 : rightmost_->count);
+    }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关操作
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+    // 所有节点占用的字节数
+    size_type bytes_used() const noexcept {
+        return root_ == nullptr ? 0 : bytes_used(root_);
+    }
+
+    // 插入删除相关操作
+
+    // emplace
+
+    template <class... Args>
+    iterator emplace_multi(Args&&... args);
+
+    template <class... Args>
+    mystl::pair<iterator, bool> emplace_unique(Args&&... args);
+
+    template <class... Args>
+    iterator emplace_multi_use_hint(const_iterator hint, Args&&... args);
+
+    template <class... Args>
+    iterator emplace_unique_use_hint(const_iterator hint, Args&&... args);
+
+    // insert
+
+    iterator insert_multi(const value_type& value) {
+        return emplace_multi(value);
+    }
+    iterator insert_multi(value_type&& value) {
+        return emplace_multi(mystl::move(value));
+    }
+
+    iterator insert_multi(const_iterator hint, const value_type& value) {
+        return emplace_multi_use_hint(hint, value);
+    }
+    iterator insert_multi(const_iterator hint, value_type&& value) {
+        return emplace_multi_use_hint(hint, mystl::move(value));
+    }
+
+    // 有序的输入每次都落在末尾，只需比较一次
+    template <class InputIterator>
+    void insert_multi(InputIterator first, InputIterator last) {
+        for (; first != last; ++first)
+            emplace_multi_use_hint(end(), *first);
+    }
+
+    mystl::pair<iterator, bool> insert_unique(const value_type& value) {
+        return emplace_unique(value);
+    }
+    mystl::pair<iterator, bool> insert_unique(value_type&& value) {
+        return emplace_unique(mystl::move(value));
+    }
+
+    iterator insert_unique(const_iterator hint, const value_type& value) {
+        return emplace_unique_use_hint(hint, value);
+    }
+    iterator insert_unique(const_iterator hint, value_type&& value) {
+        return emplace_unique_use_hint(hint, mystl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert_unique(InputIterator first, InputIterator last) {
+        for (; first != last; ++first)
+            emplace_unique_use_hint(end(), *first);
+    }
+
+    // erase
+
+    iterator erase(const_iterator position);
+
+    size_type erase_multi(const key_type& key);
+    size_type erase_unique(const key_type& key);
+
+    iterator erase(const_iterator first, const_iterator last);
+
+    void clear();
+
+    // btree 相关操作
+
+    iterator find(const key_type& key);
+    const_iterator find(const key_type& key) const;
+
+    size_type count_multi(const key_type& key) const {
+        auto p = equal_range_multi(key);
+        return static_cast<size_type>(mystl::distance(p.first, p.second));
+    }
+    size_type count_unique(const key_type& key) const {
+        return find(key) != end() ? 1 : 0;
+    }
+
+    iterator lower_bound(const key_type& key) {
+        return iterator(lower_bound_pos(key));
+    }
+    const_iterator lower_bound(const key_type& key) const {
+        return lower_bound_pos(key);
+    }
+
+    iterator upper_bound(const key_type& key) {
+        return iterator(upper_bound_pos(key));
+    }
+    const_iterator upper_bound(const key_type& key) const {
+        return upper_bound_pos(key);
+    }
+
+    mystl::pair<iterator, iterator> equal_range_multi(const key_type& key) {
+        return mystl::pair<iterator, iterator>(lower_bound(key),
+                                               upper_bound(key));
+    }
+    mystl::pair<const_iterator, const_iterator> equal_range_multi(
+        const key_type& key) const {
+        return mystl::pair<const_iterator, const_iterator>(lower_bound(key),
+                                                           upper_bound(key));
+    }
+
+    mystl::pair<iterator, iterator> equal_range_unique(const key_type& key) {
+        iterator it = find(key);
+        auto next = it;
+        return it == end() ? mystl::make_pair(it, it)
+                           : mystl::make_pair(it, ++next);
+    }
+    mystl::pair<const_iterator, const_iterator> equal_range_unique(
+        const key_type& key) const {
+        const_iterator it = find(key);
+        auto next = it;
+        return it == end() ? mystl::make_pair(it, it)
+                           : mystl::make_pair(it, ++next);
+    }
+
+    void swap(btree& rhs) noexcept;
+
+private:
+    // node related
+    node_ptr create_leaf();
+    node_ptr create_internal();
+    void destroy_node(node_ptr x);
+    void destroy_subtree(node_ptr x);
+    size_type bytes_used(node_ptr x) const;
+
+    const key_type& key_of(node_ptr x, size_type i) const {
+        return value_traits::get_key(x->value(i));
+    }
+
+    // 节点内的二分查找
+    size_type node_lower_bound(node_ptr x, const key_type& key) const;
+    size_type node_upper_bound(node_ptr x, const key_type& key) const;
+
+    const_iterator lower_bound_pos(const key_type& key) const;
+    const_iterator upper_bound_pos(const key_type& key) const;
+
+    // 把指向节点末尾之后的位置换成下一个元素的位置
+    const_iterator normalize(const_iterator it) const;
+
+    // get insert pos
+    const_iterator get_insert_multi_pos(const key_type& key) const;
+    mystl::pair<const_iterator, bool> get_insert_unique_pos(
+        const key_type& key) const;
+
+    // insert
+    iterator insert_before(const_iterator position, value_type&& value);
+    iterator insert_at(node_ptr x, size_type i, value_type&& value);
+    void split(node_ptr& x, size_type& i);
+
+    // erase
+    void rebalance_after_erase(iterator& res);
+    void merge(node_ptr left);
+    void borrow_from_left(node_ptr x);
+    void borrow_from_right(node_ptr x);
+};
+
+/*****************************************************************************************/
+
+// 复制构造函数，依次追加到末尾，得到的节点几乎是满的
+template <class T, class Compare>
+btree<T, Compare>::btree(const btree& rhs)
+    : root_(nullptr),
+      leftmost_(nullptr),
+      rightmost_(nullptr),
+      size_(0),
+      comp_(rhs.comp_) {
+    try {
+        for (auto it = rhs.begin(); it != rhs.end(); ++it)
+            insert_before(end(), value_type(*it));
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+// 移动构造函数
+template <class T, class Compare>
+btree<T, Compare>::btree(btree&& rhs) noexcept
+    : root_(rhs.root_),
+      leftmost_(rhs.leftmost_),
+      rightmost_(rhs.rightmost_),
+      size_(rhs.size_),
+      comp_(rhs.comp_) {
+    rhs.root_ = rhs.leftmost_ = rhs.rightmost_ = nullptr;
+    rhs.size_ = 0;
+}
+
+// 复制赋值操作符
+template <class T, class Compare>
+btree<T, Compare>& btree<T, Compare>::operator=(const btree& rhs) {
+    if (this != &rhs) {
+        btree tmp(rhs);
+        swap(tmp);
+    }
+    return *this;
+}
+
+// 移动赋值操作符
+template <class T, class Compare>
+btree<T, Compare>& btree<T, Compare>::operator=(btree&& rhs) noexcept {
+    if (this != &rhs) {
+        clear();
+        root_ = rhs.root_;
+        leftmost_ = rhs.leftmost_;
+        rightmost_ = rhs.rightmost_;
+        size_ = rhs.size_;
+        comp_ = rhs.comp_;
+        rhs.root_ = rhs.leftmost_ = rhs.rightmost_ = nullptr;
+        rhs.size_ = 0;
+    }
+    return *this;
+}
+
+// 就地插入元素，键值允许重复
+template <class T, class Compare>
+template <class... Args>
+typename btree<T, Compare>::iterator btree<T, Compare>::emplace_multi(
+    Args&&... args) {
+    value_type value(mystl::forward<Args>(args)...);
+    return insert_before(get_insert_multi_pos(value_traits::get_key(value)),
+                         mystl::move(value));
+}
+
+// 就地插入元素，键值不允许重复
+template <class T, class Compare>
+template <class... Args>
+mystl::pair<typename btree<T, Compare>::iterator, bool>
+btree<T, Compare>::emplace_unique(Args&&... args) {
+    value_type value(mystl::forward<Args>(args)...);
+    auto res = get_insert_unique_pos(value_traits::get_key(value));
+    if (!res.second)
+        return mystl::make_pair(iterator(res.first), false);
+    return mystl::make_pair(insert_before(res.first, mystl::move(value)),
+                            true);
+}
+
+// 就地插入元素，键值允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
+template <class T, class Compare>
+template <class... Args>
+typename btree<T, Compare>::iterator btree<T, Compare>::emplace_multi_use_hint(
+    const_iterator hint,
+    Args&&... args) {
+    value_type value(mystl::forward<Args>(args)...);
+    const key_type& key = value_traits::get_key(value);
+    if (hint != begin()) {
+        auto prev = hint;
+        --prev;
+        if (comp_(key, value_traits::get_key(*prev)))
+            return insert_before(get_insert_multi_pos(key), mystl::move(value));
+    }
+    if (hint != end() && comp_(value_traits::get_key(*hint), key))
+        return insert_before(get_insert_multi_pos(key), mystl::move(value));
+    return insert_before(hint, mystl::move(value));
+}
+
+// 就地插入元素，键值不允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
+template <class T, class Compare>
+template <class... Args>
+typename btree<T, Compare>::iterator
+btree<T, Compare>::emplace_unique_use_hint(const_iterator hint,
+                                           Args&&... args) {
+    value_type value(mystl::forward<Args>(args)...);
+    const key_type& key = value_traits::get_key(value);
+    bool fit = true;
+    if (hint != begin()) {
+        auto prev = hint;
+        --prev;
+        fit = comp_(value_traits::get_key(*prev), key);
+    }
+    if (fit && hint != end())
+        fit = comp_(key, value_traits::get_key(*hint));
+    if (fit)
+        return insert_before(hint, mystl::move(value));
+    auto res = get_insert_unique_pos(key);
+    if (!res.second)
+        return iterator(res.first);
+    return insert_before(res.first, mystl::move(value));
+}
+
+// 删除 position 位置的元素，返回下一个元素的位置
+template <class T, class Compare>
+typename btree<T, Compare>::iterator btree<T, Compare>::erase(
+    const_iterator position) {
+    node_ptr x = position.node;
+    size_type i = position.position;
+    const bool internal = !x->leaf;
+    if (internal) {
+        // 用前驱元素（左子树最右叶节点的最后一个元素）替换被删除的元素
+        node_ptr y = x->child(i);
+        while (!y->leaf)
+            y = y->child(y->count);
+        data_allocator::destroy(x->slot(i));
+        node_type::move_slot(y->slot(y->count - 1), x->slot(i));
+        --y->count;
+        x = y;
+        i = y->count;
+    } else {
+        x->erase_value(i);
+    }
+    --size_;
+    iterator res(x, i);
+    rebalance_after_erase(res);
+    if (size_ == 0)
+        return end();
+    res = iterator(normalize(res));
+    // 此时 res 指向替换上去的前驱元素，被删除元素的下一个元素在它之后
+    if (internal)
+        ++res;
+    return res;
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <class T, class Compare>
+typename btree<T, Compare>::size_type btree<T, Compare>::erase_multi(
+    const key_type& key) {
+    auto p = equal_range_multi(key);
+    size_type n = mystl::distance(p.first, p.second);
+    iterator it = p.first;
+    for (size_type k = 0; k < n; ++k)
+        it = erase(it);
+    return n;
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <class T, class Compare>
+typename btree<T, Compare>::size_type btree<T, Compare>::erase_unique(
+    const key_type& key) {
+    auto it = find(key);
+    if (it != end()) {
+        erase(it);
+        return 1;
+    }
+    return 0;
+}
+
+// 删除 [first, last) 区间内的元素
+// 删除会使 last 失效，因此先数出个数再逐个删除
+template <class T, class Compare>
+typename btree<T, Compare>::iterator btree<T, Compare>::erase(
+    const_iterator first,
+    const_iterator last) {
+    if (first == begin() && last == end()) {
+        clear();
+        return end();
+    }
+    size_type n = mystl::distance(first, last);
+    iterator it(first);
+    for (; n > 0; --n)
+        it = erase(it);
+    return it;
+}
+
+// 清空 btree
+template <class T, class Compare>
+void btree<T, Compare>::clear() {
+    if (root_ != nullptr) {
+        destroy_subtree(root_);
+        root_ = leftmost_ = rightmost_ = nullptr;
+        size_ = 0;
+    }
+}
+
+// 查找键值为 key 的元素，返回指向它的迭代器
+template <class T, class Compare>
+typename btree<T, Compare>::iterator btree<T, Compare>::find(
+    const key_type& key) {
+    iterator it = lower_bound(key);
+    return (it == end() || comp_(key, value_traits::get_key(*it))) ? end()
+                                                                    : it;
+}
+
+template <class T, class Compare>
+typename btree<T, Compare>::const_iterator btree<T, Compare>::find(
+    const key_type& key) const {
+    const_iterator it = lower_bound(key);
+    return (it == end() || comp_(key, value_traits::get_key(*it))) ? end()
+                                                                    : it;
+}
+
+// 交换 btree
+template <class T, class Compare>
+void btree<T, Compare>::swap(btree& rhs) noexcept {
+    if (this != &rhs) {
+        mystl::swap(root_, rhs.root_);
+        mystl::swap(leftmost_, rhs.leftmost_);
+        mystl::swap(rightmost_, rhs.rightmost_);
+        mystl::swap(size_, rhs.size_);
+        mystl::swap(comp_, rhs.comp_);
+    }
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 创建一个空的叶节点
+template <class T, class Compare>
+typename btree<T, Compare>::node_ptr btree<T, Compare>::create_leaf() {
+    node_ptr x = leaf_allocator::allocate(1);
+    x->parent = nullptr;
+    x->position = 0;
+    x->count = 0;
+    x->leaf = true;
+    return x;
+}
+
+// 创建一个空的内部节点
+template <class T, class Compare>
+typename btree<T, Compare>::node_ptr btree<T, Compare>::create_internal() {
+    internal_ptr x = internal_allocator::allocate(1);
+    x->parent = nullptr;
+    x->position = 0;
+    x->count = 0;
+    x->leaf = false;
+    return x;
+}
+
+// 销毁节点内的元素并释放节点，不处理子节点
+template <class T, class Compare>
+void btree<T, Compare>::destroy_node(node_ptr x) {
+    for (size_type i = 0; i < x->count; ++i)
+        data_allocator::destroy(x->slot(i));
+    if (x->leaf)
+        leaf_allocator::deallocate(x, 1);
+    else
+        internal_allocator::deallocate(x->as_internal(), 1);
+}
+
+template <class T, class Compare>
+void btree<T, Compare>::destroy_subtree(node_ptr x) {
+    if (!x->leaf) {
+        for (size_type i = 0; i <= x->count; ++i)
+            destroy_subtree(x->child(i));
+    }
+    destroy_node(x);
+}
+
+template <class T, class Compare>
+typename btree<T, Compare>::size_type btree<T, Compare>::bytes_used(
+    node_ptr x) const {
+    if (x->leaf)
+        return sizeof(node_type);
+    size_type n = sizeof(internal_type);
+    for (size_type i = 0; i <= x->count; ++i)
+        n += bytes_used(x->child(i));
+    return n;
+}
+
+// 节点内第一个键值不小于 key 的位置
+template <class T, class Compare>
+typename btree<T, Compare>::size_type btree<T, Compare>::node_lower_bound(
+    node_ptr x,
+    const key_type& key) const {
+    size_type lo = 0, hi = x->count;
+    while (lo < hi) {
+        const size_type mid = (lo + hi) / 2;
+        if (comp_(key_of(x, mid), key))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// 节点内第一个键值大于 key 的位置
+template <class T, class Compare>
+typename btree<T, Compare>::size_type btree<T, Compare>::node_upper_bound(
+    node_ptr x,
+    const key_type& key) const {
+    size_type lo = 0, hi = x->count;
+    while (lo < hi) {
+        const size_type mid = (lo + hi) / 2;
+        if (comp_(key, key_of(x, mid)))
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+// 一直走到叶节点，叶节点内的位置若在末尾，则答案是某个祖先节点中的元素
+template <class T, class Compare>
+typename btree<T, Compare>::const_iterator btree<T, Compare>::lower_bound_pos(
+    const key_type& key) const {
+    if (root_ == nullptr)
+        return end();
+    node_ptr x = root_;
+    for (;;) {
+        const size_type i = node_lower_bound(x, key);
+        if (x->leaf)
+            return normalize(const_iterator(x, i));
+        x = x->child(i);
+    }
+}
+
+template <class T, class Compare>
+typename btree<T, Compare>::const_iterator btree<T, Compare>::upper_bound_pos(
+    const key_type& key) const {
+    if (root_ == nullptr)
+        return end();
+    node_ptr x = root_;
+    for (;;) {
+        const size_type i = node_upper_bound(x, key);
+        if (x->leaf)
+            return normalize(const_iterator(x, i));
+        x = x->child(i);
+    }
+}
+
+template <class T, class Compare>
+typename btree<T, Compare>::const_iterator btree<T, Compare>::normalize(
+    const_iterator it) const {
+    while (it.position == it.node->count) {
+        if (it.node->parent == nullptr)
+            return end();
+        it.position = it.node->position;
+        it.node = it.node->parent;
+    }
+    return it;
+}
+
+// 键值允许重复时的插入位置：叶节点中最后一个不大于 key 的元素之后
+template <class T, class Compare>
+typename btree<T, Compare>::const_iterator
+btree<T, Compare>::get_insert_multi_pos(const key_type& key) const {
+    if (root_ == nullptr)
+        return end();
+    node_ptr x = root_;
+    for (;;) {
+        const size_type i = node_upper_bound(x, key);
+        if (x->leaf)
+            return const_iterator(x, i);
+        x = x->child(i);
+    }
+}
+
+// 键值不允许重复时的插入位置
+// 返回的 bool 为 false 时，first 指向与 key 相等的元素
+template <class T, class Compare>
+mystl::pair<typename btree<T, Compare>::const_iterator, bool>
+btree<T, Compare>::get_insert_unique_pos(const key_type& key) const {
+    if (root_ == nullptr)
+        return mystl::make_pair(end(), true);
+    node_ptr x = root_;
+    for (;;) {
+        const size_type i = node_lower_bound(x, key);
+        if (i < x->count && !comp_(key, key_of(x, i)))
+            return mystl::make_pair(const_iterator(x, i), false);
+        if (x->leaf)
+            return mystl::make_pair(const_iterator(x, i), true);
+        x = x->child(i);
+    }
+}
+
+// 在 position 之前插入元素
+// position 在内部节点时，插入到它的前驱所在叶节点的末尾
+template <class T, class Compare>
+typename btree<T, Compare>::iterator btree<T, Compare>::insert_before(
+    const_iterator position,
+    value_type&& value) {
+    if (root_ == nullptr) {
+        root_ = leftmost_ = rightmost_ = create_leaf();
+        return insert_at(root_, 0, mystl::move(value));
+    }
+    node_ptr x = position.node;
+    if (x->leaf)
+        return insert_at(x, position.position, mystl::move(value));
+    x = x->child(position.position);
+    while (!x->leaf)
+        x = x->child(x->count);
+    return insert_at(x, x->count, mystl::move(value));
+}
+
+// 在叶节点 x 的 i 处插入元素，节点已满时先分裂
+template <class T, class Compare>
+typename btree<T, Compare>::iterator btree<T, Compare>::insert_at(
+    node_ptr x,
+    size_type i,
+    value_type&& value) {
+    if (x->count == node_slots)
+        split(x, i);
+    x->insert_value(i, mystl::move(value));
+    ++size_;
+    return iterator(x, i);
+}
+
+// 分裂已满的节点 x，使 i 处可以放入一个元素，x 与 i 更新为分裂后的插入位置
+// 父节点也满时先分裂父节点；x 为根节点时新建一个根节点
+template <class T, class Compare>
+void btree<T, Compare>::split(node_ptr& x, size_type& i) {
+    node_ptr y = x->leaf ? create_leaf() : create_internal();
+    try {
+        if (x->parent == nullptr) {
+            internal_ptr r = create_internal()->as_internal();
+            r->set_child(0, x);
+            root_ = r;
+        } else if (x->parent->count == node_slots) {
+            node_ptr p = x->parent;
+            size_type pi = x->position;
+            split(p, pi);
+        }
+    } catch (...) {
+        destroy_node(y);
+        throw;
+    }
+
+    // 在末尾插入时左边保留全部元素，在开头插入时右边保留全部元素，否则对半分
+    const size_type split_at =
+        i == node_slots ? node_slots - 1 : (i == 0 ? 0 : node_slots / 2);
+    for (size_type k = split_at + 1; k < node_slots; ++k)
+        node_type::move_slot(x->slot(k), y->slot(k - split_at - 1));
+    y->count = static_cast<unsigned short>(node_slots - split_at - 1);
+    if (!x->leaf) {
+        for (size_type k = split_at + 1; k <= node_slots; ++k)
+            y->as_internal()->set_child(k - split_at - 1, x->child(k));
+    }
+
+    // 中间元素移到父节点，y 成为 x 右边的兄弟
+    internal_ptr parent = x->parent;
+    const size_type pos = x->position;
+    parent->insert_value(pos, mystl::move(x->value(split_at)));
+    data_allocator::destroy(x->slot(split_at));
+    x->count = static_cast<unsigned short>(split_at);
+    parent->insert_child(pos + 1, y);
+
+    if (x == rightmost_)
+        rightmost_ = y;
+    if (i > split_at) {
+        x = y;
+        i -= split_at + 1;
+    }
+}
+
+// 删除后自 res 所在的叶节点向上调整过空的节点，res 随元素的移动而更新
+template <class T, class Compare>
+void btree<T, Compare>::rebalance_after_erase(iterator& res) {
+    node_ptr x = res.node;
+    while (x != root_ && x->count < min_slots) {
+        internal_ptr p = x->parent;
+        const size_type pos = x->position;
+        node_ptr left = pos > 0 ? p->child(pos - 1) : nullptr;
+        node_ptr right = pos < p->count ? p->child(pos + 1) : nullptr;
+        const size_type x_count = x->count;
+        if (left != nullptr && left->count + 1 + x_count <= node_slots) {
+            if (res.node == x) {
+                res.node = left;
+                res.position += left->count + 1;
+            }
+            merge(left);
+        } else if (right != nullptr &&
+                   x_count + 1 + right->count <= node_slots) {
+            merge(x);
+        } else if (left != nullptr &&
+                   (right == nullptr || left->count >= right->count)) {
+            borrow_from_left(x);
+            if (res.node == x)
+                ++res.position;
+            break;
+        } else {
+            borrow_from_right(x);
+            break;
+        }
+        x = p;
+    }
+
+    // 根节点为空时降低树高，或整棵树已空
+    if (root_->count == 0) {
+        node_ptr old = root_;
+        if (old->leaf) {
+            root_ = leftmost_ = rightmost_ = nullptr;
+        } else {
+            root_ = old->child(0);
+            root_->parent = nullptr;
+            root_->position = 0;
+        }
+        destroy_node(old);
+    }
+}
+
+// 把 left 右边的兄弟节点与父节点中的分隔元素并入 left，并释放该兄弟节点
+template <class T, class Compare>
+void btree<T, Compare>::merge(node_ptr left) {
+    internal_ptr p = left->parent;
+    const size_type pos = left->position;
+    node_ptr right = p->child(pos + 1);
+
+    node_type::move_slot(p->slot(pos), left->slot(left->count));
+    for (size_type k = 0; k < right->count; ++k)
+        node_type::move_slot(right->slot(k),
+                             left->slot(left->count + 1 + k));
+    if (!left->leaf) {
+        for (size_type k = 0; k <= right->count; ++k)
+            left->as_internal()->set_child(left->count + 1 + k,
+                                           right->child(k));
+    }
+    left->count = static_cast<unsigned short>(left->count + 1 + right->count);
+    right->count = 0;
+
+    p->close_gap(pos);
+    p->remove_child(pos + 1);
+    if (right == rightmost_)
+        rightmost_ = left;
+    destroy_node(right);
+}
+
+// 父节点中的分隔元素移到 x 的开头，左兄弟的最后一个元素移到父节点
+template <class T, class Compare>
+void btree<T, Compare>::borrow_from_left(node_ptr x) {
+    internal_ptr p = x->parent;
+    const size_type pos = x->position;
+    node_ptr left = p->child(pos - 1);
+
+    x->insert_value(0, mystl::move(p->value(pos - 1)));
+    data_allocator::destroy(p->slot(pos - 1));
+    node_type::move_slot(left->slot(left->count - 1), p->slot(pos - 1));
+    if (!x->leaf)
+        x->as_internal()->insert_child(0, left->child(left->count));
+    --left->count;
+}
+
+// 父节点中的分隔元素移到 x 的末尾，右兄弟的第一个元素移到父节点
+template <class T, class Compare>
+void btree<T, Compare>::borrow_from_right(node_ptr x) {
+    internal_ptr p = x->parent;
+    const size_type pos = x->position;
+    node_ptr right = p->child(pos + 1);
+
+    x->insert_value(x->count, mystl::move(p->value(pos)));
+    data_allocator::destroy(p->slot(pos));
+    node_type::move_slot(right->slot(0), p->slot(pos));
+    if (!x->leaf)
+        x->as_internal()->set_child(x->count, right->child(0));
+    right->close_gap(0);
+    if (!right->leaf)
+        right->as_internal()->remove_child(0);
+}
+
+// 重载比较操作符
+template <class T, class Compare>
+bool operator==(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+    return lhs.size() == rhs.size() &&
+           mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, class Compare>
+bool operator<(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+    return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                          rhs.end());
+}
+
+template <class T, class Compare>
+bool operator!=(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <class T, class Compare>
+bool operator>(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+    return rhs < lhs;
+}
+
+template <class T, class Compare>
+bool operator<=(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <class T, class Compare>
+bool operator>=(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+    return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, class Compare>
+void swap(btree<T, Compare>& lhs, btree<T, Compare>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_BTREE_H_
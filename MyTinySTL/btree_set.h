@@ -0,0 +1,420 @@
+#ifndef MYTINYSTL_BTREE_SET_H_
+#define MYTINYSTL_BTREE_SET_H_
+
+// 这个头文件包含两个模板类 btree_set 和 btree_multiset
+// btree_set      : 有序集合，功能与用法与 set 类似，键值不允许重复
+// btree_multiset : 有序集合，功能与用法与 multiset 类似，键值允许重复
+// 二者使用 btree 作为底层实现机制
+
+// notes:
+//
+// 与 set 的区别：
+//   * 插入、删除会使所有迭代器、指针、引用失效
+//   * 不接受分配器参数
+//
+// 异常保证：
+// mystl::btree_set<Key> / mystl::btree_multiset<Key> 满足基本异常保证，
+// 要求元素的移动构造不抛出异常
+
+#include "btree.h"
+
+namespace mystl {
+
+// 模板类 btree_set，键值不允许重复
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less
+template <class Key, class Compare = mystl::less<Key>>
+class btree_set {
+public:
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+
+private:
+    // 以 mystl::btree 作为底层机制
+    typedef mystl::btree<value_type, key_compare> base_type;
+    base_type tree_;
+
+public:
+    // 使用 btree 定义的型别，元素有序，迭代器不能写入
+    typedef typename base_type::const_pointer pointer;
+    typedef typename base_type::const_pointer const_pointer;
+    typedef typename base_type::const_reference reference;
+    typedef typename base_type::const_reference const_reference;
+    typedef typename base_type::const_iterator iterator;
+    typedef typename base_type::const_iterator const_iterator;
+    typedef typename base_type::const_reverse_iterator reverse_iterator;
+    typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::difference_type difference_type;
+    typedef typename base_type::allocator_type allocator_type;
+
+public:
+    // 构造、复制、移动函数
+
+    btree_set() = default;
+
+    explicit btree_set(const key_compare& comp) : tree_(comp) {}
+
+    template <class InputIterator>
+    btree_set(InputIterator first,
+              InputIterator last,
+              const key_compare& comp = key_compare())
+        : tree_(comp) {
+        tree_.insert_unique(first, last);
+    }
+
+    btree_set(std::initializer_list<value_type> ilist,
+              const key_compare& comp = key_compare())
+        : tree_(comp) {
+        tree_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    btree_set(const btree_set& rhs) : tree_(rhs.tree_) {}
+    btree_set(btree_set&& rhs) noexcept : tree_(mystl::move(rhs.tree_)) {}
+
+    btree_set& operator=(const btree_set& rhs) {
+        tree_ = rhs.tree_;
+        return *this;
+    }
+    btree_set& operator=(btree_set&& rhs) {
+        tree_ = mystl::move(rhs.tree_);
+        return *this;
+    }
+    btree_set& operator=(std::initializer_list<value_type> ilist) {
+        tree_.clear();
+        tree_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return tree_.key_comp(); }
+    value_compare value_comp() const { return tree_.key_comp(); }
+    allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+    // 迭代器相关
+
+    iterator begin() const noexcept { return tree_.begin(); }
+    iterator end() const noexcept { return tree_.end(); }
+
+    reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+
+    bool empty() const noexcept { return tree_.empty(); }
+    size_type size() const noexcept { return tree_.size(); }
+    size_type max_size() const noexcept { return tree_.max_size(); }
+
+    // 所有节点占用的字节数
+    size_type bytes_used() const noexcept { return tree_.bytes_used(); }
+
+    // 插入删除操作
+
+    template <class... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return tree_.emplace_unique(mystl::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return tree_.emplace_unique_use_hint(hint,
+                                             mystl::forward<Args>(args)...);
+    }
+
+    pair<iterator, bool> insert(const value_type& value) {
+        return tree_.insert_unique(value);
+    }
+    pair<iterator, bool> insert(value_type&& value) {
+        return tree_.insert_unique(mystl::move(value));
+    }
+
+    iterator insert(const_iterator hint, const value_type& value) {
+        return tree_.insert_unique(hint, value);
+    }
+    iterator insert(const_iterator hint, value_type&& value) {
+        return tree_.insert_unique(hint, mystl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        tree_.insert_unique(first, last);
+    }
+
+    iterator erase(const_iterator position) { return tree_.erase(position); }
+    size_type erase(const key_type& key) { return tree_.erase_unique(key); }
+    iterator erase(const_iterator first, const_iterator last) {
+        return tree_.erase(first, last);
+    }
+
+    void clear() { tree_.clear(); }
+
+    // btree_set 相关操作
+
+    iterator find(const key_type& key) const { return tree_.find(key); }
+
+    size_type count(const key_type& key) const {
+        return tree_.count_unique(key);
+    }
+
+    iterator lower_bound(const key_type& key) const {
+        return tree_.lower_bound(key);
+    }
+
+    iterator upper_bound(const key_type& key) const {
+        return tree_.upper_bound(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) const {
+        return tree_.equal_range_unique(key);
+    }
+
+    void swap(btree_set& rhs) noexcept { tree_.swap(rhs.tree_); }
+
+public:
+    friend bool operator==(const btree_set& lhs, const btree_set& rhs) {
+        return lhs.tree_ == rhs.tree_;
+    }
+    friend bool operator<(const btree_set& lhs, const btree_set& rhs) {
+        return lhs.tree_ < rhs.tree_;
+    }
+};
+
+// 重载比较操作符
+template <class Key, class Compare>
+bool operator!=(const btree_set<Key, Compare>& lhs,
+                const btree_set<Key, Compare>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <class Key, class Compare>
+bool operator>(const btree_set<Key, Compare>& lhs,
+               const btree_set<Key, Compare>& rhs) {
+    return rhs < lhs;
+}
+
+template <class Key, class Compare>
+bool operator<=(const btree_set<Key, Compare>& lhs,
+                const btree_set<Key, Compare>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <class Key, class Compare>
+bool operator>=(const btree_set<Key, Compare>& lhs,
+                const btree_set<Key, Compare>& rhs) {
+    return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class Compare>
+void swap(btree_set<Key, Compare>& lhs, btree_set<Key, Compare>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+
+// 模板类 btree_multiset，键值允许重复
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less
+template <class Key, class Compare = mystl::less<Key>>
+class btree_multiset {
+public:
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+
+private:
+    // 以 mystl::btree 作为底层机制
+    typedef mystl::btree<value_type, key_compare> base_type;
+    base_type tree_;
+
+public:
+    // 使用 btree 定义的型别，元素有序，迭代器不能写入
+    typedef typename base_type::const_pointer pointer;
+    typedef typename base_type::const_pointer const_pointer;
+    typedef typename base_type::const_reference reference;
+    typedef typename base_type::const_reference const_reference;
+    typedef typename base_type::const_iterator iterator;
+    typedef typename base_type::const_iterator const_iterator;
+    typedef typename base_type::const_reverse_iterator reverse_iterator;
+    typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::difference_type difference_type;
+    typedef typename base_type::allocator_type allocator_type;
+
+public:
+    // 构造、复制、移动函数
+
+    btree_multiset() = default;
+
+    explicit btree_multiset(const key_compare& comp) : tree_(comp) {}
+
+    template <class InputIterator>
+    btree_multiset(InputIterator first,
+                   InputIterator last,
+                   const key_compare& comp = key_compare())
+        : tree_(comp) {
+        tree_.insert_multi(first, last);
+    }
+
+    btree_multiset(std::initializer_list<value_type> ilist,
+                   const key_compare& comp = key_compare())
+        : tree_(comp) {
+        tree_.insert_multi(ilist.begin(), ilist.end());
+    }
+
+    btree_multiset(const btree_multiset& rhs) : tree_(rhs.tree_) {}
+    btree_multiset(btree_multiset&& rhs) noexcept : tree_(mystl::move(rhs.tree_)) {}
+
+    btree_multiset& operator=(const btree_multiset& rhs) {
+        tree_ = rhs.tree_;
+        return *this;
+    }
+    btree_multiset& operator=(btree_multiset&& rhs) {
+        tree_ = mystl::move(rhs.tree_);
+        return *this;
+    }
+    btree_multiset& operator=(std::initializer_list<value_type> ilist) {
+        tree_.clear();
+        tree_.insert_multi(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return tree_.key_comp(); }
+    value_compare value_comp() const { return tree_.key_comp(); }
+    allocator_type get_allocator() const { return tree_.get_allocator(); }
+
+    // 迭代器相关
+
+    iterator begin() const noexcept { return tree_.begin(); }
+    iterator end() const noexcept { return tree_.end(); }
+
+    reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+
+    bool empty() const noexcept { return tree_.empty(); }
+    size_type size() const noexcept { return tree_.size(); }
+    size_type max_size() const noexcept { return tree_.max_size(); }
+
+    // 所有节点占用的字节数
+    size_type bytes_used() const noexcept { return tree_.bytes_used(); }
+
+    // 插入删除操作
+
+    template <class... Args>
+    iterator emplace(Args&&... args) {
+        return tree_.emplace_multi(mystl::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return tree_.emplace_multi_use_hint(hint,
+                                            mystl::forward<Args>(args)...);
+    }
+
+    iterator insert(const value_type& value) {
+        return tree_.insert_multi(value);
+    }
+    iterator insert(value_type&& value) {
+        return tree_.insert_multi(mystl::move(value));
+    }
+
+    iterator insert(const_iterator hint, const value_type& value) {
+        return tree_.insert_multi(hint, value);
+    }
+    iterator insert(const_iterator hint, value_type&& value) {
+        return tree_.insert_multi(hint, mystl::move(value));
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        tree_.insert_multi(first, last);
+    }
+
+    iterator erase(const_iterator position) { return tree_.erase(position); }
+    size_type erase(const key_type& key) { return tree_.erase_multi(key); }
+    iterator erase(const_iterator first, const_iterator last) {
+        return tree_.erase(first, last);
+    }
+
+    void clear() { tree_.clear(); }
+
+    // btree_multiset 相关操作
+
+    iterator find(const key_type& key) const { return tree_.find(key); }
+
+    size_type count(const key_type& key) const {
+        return tree_.count_multi(key);
+    }
+
+    iterator lower_bound(const key_type& key) const {
+        return tree_.lower_bound(key);
+    }
+
+    iterator upper_bound(const key_type& key) const {
+        return tree_.upper_bound(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) const {
+        return tree_.equal_range_multi(key);
+    }
+
+    void swap(btree_multiset& rhs) noexcept { tree_.swap(rhs.tree_); }
+
+public:
+    friend bool operator==(const btree_multiset& lhs, const btree_multiset& rhs) {
+        return lhs.tree_ == rhs.tree_;
+    }
+    friend bool operator<(const btree_multiset& lhs, const btree_multiset& rhs) {
+        return lhs.tree_ < rhs.tree_;
+    }
+};
+
+// 重载比较操作符
+template <class Key, class Compare>
+bool operator!=(const btree_multiset<Key, Compare>& lhs,
+                const btree_multiset<Key, Compare>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <class Key, class Compare>
+bool operator>(const btree_multiset<Key, Compare>& lhs,
+               const btree_multiset<Key, Compare>& rhs) {
+    return rhs < lhs;
+}
+
+template <class Key, class Compare>
+bool operator<=(const btree_multiset<Key, Compare>& lhs,
+                const btree_multiset<Key, Compare>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <class Key, class Compare>
+bool operator>=(const btree_multiset<Key, Compare>& lhs,
+                const btree_multiset<Key, Compare>& rhs) {
+    return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class Compare>
+void swap(btree_multiset<Key, Compare>& lhs, btree_multiset<Key, Compare>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_BTREE_SET_H_
@@ -9,6 +9,7 @@
 
 #include "iterator.h"
 #include "type_traits.h"
+#include "util.h"
 
 /* 这段代码是用于禁用 Visual Studio 编译器的一个警告，警告代码为
  * 4100，表示未使用的形参。`#ifdef _MSC_VER` 判断是否是 Visual Studio
@@ -67,6 +68,9 @@ void destroy_cat(ForwardIter, ForwardIter, std::true_type) {}
 `destroy` 函数销毁它们。注意，这里使用了 `&*first`
 来获取迭代器指向的对象的地址，这是因为 `destroy`
 函数接受的是一个指针类型的参数。 */
+template <class Ty>
+void destroy(Ty* pointer);
+
 template <class ForwardIter>
 void destroy_cat(ForwardIter first, ForwardIter last, std::false_type) {
     for (; first != last; ++first) {
@@ -184,14 +184,14 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T> {
 };
 
 // 模板类 deque
-// 模板参数代表数据类型
-template <class T>
+// 模板参数代表数据类型，Alloc 代表分配器，缺省使用 mystl::allocator
+template <class T, class Alloc = mystl::allocator<T>>
 class deque {
 public:
     // deque 的型别定义
-    typedef mystl::allocator<T> allocator_type;
-    typedef mystl::allocator<T> data_allocator;
-    typedef mystl::allocator<T*> map_allocator;
+    typedef Alloc allocator_type;
+    typedef mystl::allocator_traits<Alloc> alloc_traits;
+    typedef typename alloc_traits::template rebind_alloc<T*> map_allocator;
 
     typedef typename allocator_type::value_type value_type;
     typedef typename allocator_type::pointer pointer;
@@ -208,11 +208,13 @@ public:
     typedef mystl::reverse_iterator<iterator> reverse_iterator;
     typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
 
-    allocator_type get_allocator() { return allocator_type(); }
+    allocator_type get_allocator() const { return alloc_; }
 
     static const size_type buffer_size = deque_buf_size<T>::value;
 
 private:
+    allocator_type alloc_;  // 缓冲区与 map 的分配器
+
     // 用以下四个数据来表现一个 deque
     iterator begin_;  // 指向第一个节点
     iterator end_;    // 指向最后一个结点
@@ -223,28 +225,46 @@ private:
 public:
     // 构造、复制、移动、析构函数
 
-    deque() { fill_init(0, value_type()); }
+    deque() : alloc_() { fill_init(0, value_type()); }
 
-    explicit deque(size_type n) { fill_init(n, value_type()); }
+    explicit deque(const allocator_type& alloc) : alloc_(alloc) {
+        fill_init(0, value_type());
+    }
 
-    deque(size_type n, const value_type& value) { fill_init(n, value); }
+    explicit deque(size_type n, const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        fill_init(n, value_type());
+    }
+
+    deque(size_type n,
+          const value_type& value,
+          const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        fill_init(n, value);
+    }
 
     template <class IIter,
               typename std::enable_if<mystl::is_input_iterator<IIter>::value,
                                       int>::type = 0>
-    deque(IIter first, IIter last) {
+    deque(IIter first, IIter last, const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
         copy_init(first, last, iterator_category(first));
     }
 
-    deque(std::initializer_list<value_type> ilist) {
+    deque(std::initializer_list<value_type> ilist,
+          const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
         copy_init(ilist.begin(), ilist.end(), mystl::forward_iterator_tag());
     }
 
-    deque(const deque& rhs) {
+    deque(const deque& rhs)
+        : alloc_(alloc_traits::select_on_container_copy_construction(
+              rhs.alloc_)) {
         copy_init(rhs.begin(), rhs.end(), mystl::forward_iterator_tag());
     }
     deque(deque&& rhs) noexcept
-        : begin_(mystl::move(rhs.begin_)),
+        : alloc_(mystl::move(rhs.alloc_)),
+          begin_(mystl::move(rhs.begin_)),
           end_(mystl::move(rhs.end_)),
           map_(rhs.map_),
           map_size_(rhs.map_size_) {
@@ -253,10 +273,12 @@ public:
     }
 
     deque& operator=(const deque& rhs);
-    deque& operator=(deque&& rhs);
+    deque& operator=(deque&& rhs) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value);
 
     deque& operator=(std::initializer_list<value_type> ilist) {
-        deque tmp(ilist);
+        deque tmp(ilist, alloc_);
         swap(tmp);
         return *this;
     }
@@ -264,9 +286,9 @@ public:
     ~deque() {
         if (map_ != nullptr) {
             clear();
-            data_allocator::deallocate(*begin_.node, buffer_size);
+            alloc_.deallocate(*begin_.node, buffer_size);
             *begin_.node = nullptr;
-            map_allocator::deallocate(map_, map_size_);
+            map_allocator(alloc_).deallocate(map_, map_size_);
             map_ = nullptr;
         }
     }
@@ -404,6 +426,15 @@ public:
 private:
     // helper functions
 
+    // allocator propagation
+    void swap_data(deque& rhs) noexcept;
+    void copy_alloc(const deque& rhs, m_true_type);
+    void copy_alloc(const deque&, m_false_type) {}
+    void move_assign(deque& rhs, m_true_type) noexcept;
+    void move_assign(deque& rhs, m_false_type);
+    void swap_alloc(deque& rhs, m_true_type) { mystl::swap(alloc_, rhs.alloc_); }
+    void swap_alloc(deque&, m_false_type) {}
+
     // create node / destroy node
     map_pointer create_map(size_type size);
     void create_buffer(map_pointer nstart, map_pointer nfinish);
@@ -442,10 +473,12 @@ private:
 };
 
 // 复制赋值运算符
-template <class T>
-deque<T>& deque<T>::operator=(const deque& rhs) {
+template <class T, class Alloc>
+deque<T, Alloc>& deque<T, Alloc>::operator=(const deque& rhs) {
     // 当赋值的deque不是自身时
     if (this != &rhs) {
+        copy_alloc(rhs, typename alloc_traits::
+                            propagate_on_container_copy_assignment());
         // 判断当前deque的大小，如果大于等于rhs的大小
         const auto len = size();
         if (len >= rhs.size()) {
@@ -466,21 +499,52 @@ deque<T>& deque<T>::operator=(const deque& rhs) {
 // 移动赋值运算符
 // 制赋值是将一个对象的值复制到另一个对象中，
 // 而移动赋值则是将一个对象的资源（比如内存或文件句柄）移动到另一个对象中，同时将原对象置为空。
-template <class T>
-deque<T>& deque<T>::operator=(deque&& rhs) {
-    clear();
-    begin_ = mystl::move(rhs.begin_);
-    end_ = mystl::move(rhs.end_);
-    map_ = rhs.map_;
-    map_size_ = rhs.map_size_;
-    rhs.map_ = nullptr;
-    rhs.map_size_ = 0;
+template <class T, class Alloc>
+deque<T, Alloc>& deque<T, Alloc>::operator=(deque&& rhs) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value ||
+    alloc_traits::is_always_equal::value) {
+    if (this != &rhs) {
+        move_assign(rhs, typename alloc_traits::
+                             propagate_on_container_move_assignment());
+    }
     return *this;
 }
 
+// 复制赋值时传播分配器：先换成一个使用新分配器的空 deque，旧的空间随临时对象释放
+template <class T, class Alloc>
+void deque<T, Alloc>::copy_alloc(const deque& rhs, m_true_type) {
+    if (alloc_ == rhs.alloc_)
+        return;
+    deque tmp(rhs.alloc_);
+    swap_data(tmp);
+    mystl::swap(alloc_, tmp.alloc_);
+}
+
+// 分配器随元素传播：接管 rhs 的空间与分配器，旧的空间随临时对象由旧的分配器释放
+template <class T, class Alloc>
+void deque<T, Alloc>::move_assign(deque& rhs, m_true_type) noexcept {
+    deque tmp(mystl::move(rhs));
+    swap_data(tmp);
+    mystl::swap(alloc_, tmp.alloc_);
+}
+
+// 分配器不传播时，只有两个分配器相等才能直接接管空间，否则逐个移动元素
+template <class T, class Alloc>
+void deque<T, Alloc>::move_assign(deque& rhs, m_false_type) {
+    if (alloc_traits::equal(alloc_, rhs.alloc_)) {
+        deque tmp(mystl::move(rhs));
+        swap_data(tmp);
+    } else {
+        clear();
+        for (auto it = rhs.begin(); it != rhs.end(); ++it)
+            emplace_back(mystl::move(*it));
+        rhs.clear();
+    }
+}
+
 // 重置容器大小
-template <class T>
-void deque<T>::resize(size_type new_size, const value_type& value) {
+template <class T, class Alloc>
+void deque<T, Alloc>::resize(size_type new_size, const value_type& value) {
     const auto len = size();
     if (new_size < len) {
         // 减小容器大小，做erase清楚操作
@@ -493,39 +557,39 @@ void deque<T>::resize(size_type new_size, const value_type& value) {
 
 // 减小容器容量
 // 作用:将deque中多余的缓冲区释放，使得deque中只留下必要的缓冲区
-template <class T>
-void deque<T>::shrink_to_fit() noexcept {
+template <class T, class Alloc>
+void deque<T, Alloc>::shrink_to_fit() noexcept {
     // 至少会留下头部缓冲区
     // 遍历map_指向的数组，释放begin_.node之前的缓冲区
     for (auto cur = map_; cur < begin_.node; ++cur) {
-        data_allocator::deallocate(*cur, buffer_size);
+        alloc_.deallocate(*cur, buffer_size);
         *cur = nullptr;
     }
     // 遍历end_.node之后的缓冲区，释放多余的缓冲区
     for (auto cur = end_.node + 1; cur < map_ + map_size_; ++cur) {
-        // 调用data_allocator::deallocate函数来释放内存，并将对应的指针设置为nullptr，以避免重复释放
-        data_allocator::deallocate(*cur, buffer_size);
+        // 调用alloc_.deallocate函数来释放内存，并将对应的指针设置为nullptr，以避免重复释放
+        alloc_.deallocate(*cur, buffer_size);
         *cur = nullptr;
     }
 }
 
 // 在头部就地构建元素
-template <class T>
+template <class T, class Alloc>
 template <class... Args>
-void deque<T>::emplace_front(Args&&... args) {
+void deque<T, Alloc>::emplace_front(Args&&... args) {
     if (begin_.cur != begin_.first) {
         // 说明当前begin_节点缓冲区还有可用位置
         // 直接在cur之前构造一个
-        data_allocator::construct(begin_.cur - 1,
-                                  mystl::forward<Args>(args)...);
+        mystl::construct(begin_.cur - 1,
+                         mystl::forward<Args>(args)...);
         --begin_.cur;
     } else {
         require_capacity(1, true);
         try {
             // 往前移动一个节点，然后狗仔
             --begin_;
-            data_allocator::construct(begin_.cur,
-                                      mystl::forward<Args>(args)...);
+            mystl::construct(begin_.cur,
+                             mystl::forward<Args>(args)...);
         } catch (...) {
             // 异常了再加回来
             ++begin_;
@@ -535,23 +599,23 @@ void deque<T>::emplace_front(Args&&... args) {
 }
 
 // 在尾部就地构建元素
-template <class T>
+template <class T, class Alloc>
 template <class... Args>
-void deque<T>::emplace_back(Args&&... args) {
+void deque<T, Alloc>::emplace_back(Args&&... args) {
     if (end_.cur != end_.last - 1) {
-        data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
+        mystl::construct(end_.cur, mystl::forward<Args>(args)...);
         ++end_.cur;
     } else {
         require_capacity(1, false);
-        data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
+        mystl::construct(end_.cur, mystl::forward<Args>(args)...);
         ++end_;
     }
 }
 
 // 在 pos 位置就地构建元素
-template <class T>
+template <class T, class Alloc>
 template <class... Args>
-typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&&... args) {
+typename deque<T, Alloc>::iterator deque<T, Alloc>::emplace(iterator pos, Args&&... args) {
     // 如果pos位置刚好在头尾
     if (pos.cur == begin_.cur) {
         emplace_front(mystl::forward<Args>(args)...);
@@ -565,18 +629,18 @@ typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&&... args) {
 }
 
 // 在头部插入元素
-template <class T>
-void deque<T>::push_front(const value_type& value) {
+template <class T, class Alloc>
+void deque<T, Alloc>::push_front(const value_type& value) {
     if (begin_.cur != begin_.first) {
         // 当前begin_节点缓冲区还有可用位置
-        data_allocator::construct(begin_.cur - 1, value);
+        mystl::construct(begin_.cur - 1, value);
         --begin_.cur;
     } else {
         require_capacity(1, true);
         try {
             // 节点前移
             --begin_;
-            data_allocator::construct(begin_.cur, value);
+            mystl::construct(begin_.cur, value);
         } catch (...) {
             ++begin_;
             throw;
@@ -585,51 +649,51 @@ void deque<T>::push_front(const value_type& value) {
 }
 
 // 在尾部插入元素
-template <class T>
-void deque<T>::push_back(const value_type& value) {
+template <class T, class Alloc>
+void deque<T, Alloc>::push_back(const value_type& value) {
     if (end_.cur != end_.last - 1) {
-        data_allocator::construct(end_.cur, value);
+        mystl::construct(end_.cur, value);
         ++end_.cur;
     } else {
         require_capacity(1, false);
-        data_allocator::construct(end_.cur, value);
+        mystl::construct(end_.cur, value);
         ++end_;
     }
 }
 
 // 弹出头部元素
-template <class T>
-void deque<T>::pop_front() {
+template <class T, class Alloc>
+void deque<T, Alloc>::pop_front() {
     MYSTL_DEBUG(!empty());
     if (begin_.cur != begin_.last - 1) {
-        data_allocator::destroy(begin_.cur);
+        mystl::destroy(begin_.cur);
         ++begin_.cur;
     } else {
         // 如果在当前begin_节点所在缓冲区的尾部
-        data_allocator::destroy(begin_.cur);
+        mystl::destroy(begin_.cur);
         ++begin_;
         destroy_buffer(begin_.node - 1, begin_.node - 1);
     }
 }
 
 // 弹出尾部元素
-template <class T>
-void deque<T>::pop_back() {
+template <class T, class Alloc>
+void deque<T, Alloc>::pop_back() {
     MYSTL_DEBUG(!empty());
     if (end_.cur != end_.first) {
         --end_.cur;
-        data_allocator::destroy(end_.cur);
+        mystl::destroy(end_.cur);
     } else {
         --end_;
-        data_allocator::destroy(end_.cur);
+        mystl::destroy(end_.cur);
         // 只删除一个元素，缓冲区中开始位置和结束位置可以一样
         destroy_buffer(end_.node + 1, end_.node + 1);
     }
 }
 
 // 在 position 处插入元素
-template <class T>
-typename deque<T>::iterator deque<T>::insert(iterator position,
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::insert(iterator position,
                                              const value_type& value) {
     if (position.cur == begin_.cur) {
         push_front(value);
@@ -644,8 +708,8 @@ typename deque<T>::iterator deque<T>::insert(iterator position,
     }
 }
 
-template <class T>
-typename deque<T>::iterator deque<T>::insert(iterator position,
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::insert(iterator position,
                                              value_type&& value) {
     if (position.cur == begin_.cur) {
         // 移动引用
@@ -662,8 +726,8 @@ typename deque<T>::iterator deque<T>::insert(iterator position,
 }
 
 // 在 position 位置插入 n 个元素
-template <class T>
-void deque<T>::insert(iterator position, size_type n, const value_type& value) {
+template <class T, class Alloc>
+void deque<T, Alloc>::insert(iterator position, size_type n, const value_type& value) {
     if (position.cur == begin_.cur) {
         // 刚好指向最头部
         require_capacity(n, true);
@@ -683,8 +747,8 @@ void deque<T>::insert(iterator position, size_type n, const value_type& value) {
 
 // 删除 position 处的元素
 // 要么前移，要么后移，选择移动元素少的
-template <class T>
-typename deque<T>::iterator deque<T>::erase(iterator position) {
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::erase(iterator position) {
     auto next = position;
     ++next;
     const size_type elems_before = position - begin_;
@@ -702,8 +766,8 @@ typename deque<T>::iterator deque<T>::erase(iterator position) {
 }
 
 // 删除[first, last)上的元素
-template <class T>
-typename deque<T>::iterator deque<T>::erase(iterator first, iterator last) {
+template <class T, class Alloc>
+typename deque<T, Alloc>::iterator deque<T, Alloc>::erase(iterator first, iterator last) {
     // 如果真个deque删除，直接调用clear
     if (first == begin_ && last == end_) {
         clear();
@@ -717,7 +781,7 @@ typename deque<T>::iterator deque<T>::erase(iterator first, iterator last) {
             // 然后调整begin_指针的位置，使其指向新的起始位置
             mystl::copy_backward(begin_, first, last);
             auto new_begin = begin_ + len;
-            data_allocator::destroy(begin_.cur, new_begin.cur);
+            mystl::destroy(begin_.cur, new_begin.cur);
             begin_ = new_begin;
         } else {
             // 要删除的元素位于deque的后半部分，
@@ -725,7 +789,7 @@ typename deque<T>::iterator deque<T>::erase(iterator first, iterator last) {
             // 然后调整end_指针的位置，使其指向新的结束位置。
             mystl::copy(last, end_, first);
             auto new_end = end_ - len;
-            data_allocator::destroy(new_end.cur, end_.cur);
+            mystl::destroy(new_end.cur, end_.cur);
             end_ = new_end;
         }
         // 最后返回的是begin_+elems_before，也就是删除操作之后，第一个未被删除的元素的位置
@@ -734,14 +798,14 @@ typename deque<T>::iterator deque<T>::erase(iterator first, iterator last) {
 }
 
 // 清空 deque
-template <class T>
-void deque<T>::clear() {
+template <class T, class Alloc>
+void deque<T, Alloc>::clear() {
     // clear会保留头部的缓冲区，因为只有一个缓冲区时，需要保留该缓冲区以供后续使用
     // 遍历 deque 容器中除了头部和尾部缓冲区之外的所有缓冲区，并调用 destroy
     // 函数销毁其中的所有元素。
     for (map_pointer cur = begin_.node + 1; cur < end_.node; ++cur) {
-        // data_allocator::destroy删除缓冲区
-        data_allocator::destroy(*cur, *cur + buffer_size);
+        // mystl::destroy删除缓冲区
+        mystl::destroy(*cur, *cur + buffer_size);
     }
 
     // mystl::destroy删除缓冲区内的元素
@@ -757,8 +821,15 @@ void deque<T>::clear() {
 }
 
 // 交换两个 deque
-template <class T>
-void deque<T>::swap(deque& rhs) noexcept {
+template <class T, class Alloc>
+void deque<T, Alloc>::swap(deque& rhs) noexcept {
+    swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+    swap_data(rhs);
+}
+
+// 交换除分配器以外的所有成员
+template <class T, class Alloc>
+void deque<T, Alloc>::swap_data(deque& rhs) noexcept {
     if (this != &rhs) {
         mystl::swap(begin_, rhs.begin_);
         mystl::swap(end_, rhs.end_);
@@ -771,11 +842,11 @@ void deque<T>::swap(deque& rhs) noexcept {
 // helper function
 
 // 创建一个大小为size的map，map是一个指针数组，每个指针指向一个缓冲区，缓冲区中存储了多个元素
-template <class T>
-typename deque<T>::map_pointer deque<T>::create_map(size_type size) {
+template <class T, class Alloc>
+typename deque<T, Alloc>::map_pointer deque<T, Alloc>::create_map(size_type size) {
     map_pointer mp = nullptr;
     // allocate函数分配一段连续内存空间，大小为size个指针的大小
-    mp = map_allocator::allocate(size);
+    mp = map_allocator(alloc_).allocate(size);
     for (size_type i = 0; i < size; ++i)
         // 使用for循环将每个指针初始化为nullptr
         *(mp + i) = nullptr;
@@ -785,22 +856,22 @@ typename deque<T>::map_pointer deque<T>::create_map(size_type size) {
 // create_buffer 函数
 // 为 deque 分配一段内存空间，并将这段内存空间划分成若干个大小为 buffer_size
 // 的块，这些块被称为“缓冲区”，每个缓冲区可以容纳多个元素
-template <class T>
+template <class T, class Alloc>
 // 该函数接受两个参数 nstart 和 nfinish，它们是指向指针的指针，表示 deque
 // 的起始和结束位置
-void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish) {
+void deque<T, Alloc>::create_buffer(map_pointer nstart, map_pointer nfinish) {
     map_pointer cur;
     try {
         for (cur = nstart; cur <= nfinish; ++cur) {
             // 一个一个分配大小为buffer_size的块，并将大小存在cur这个指向指针的指针里
             // buffer_size是一个之前算出来的值
-            *cur = data_allocator::allocate(buffer_size);
+            *cur = alloc_.allocate(buffer_size);
         }
     } catch (...) {
         // 否则从后往前释放已经分配的内存
         while (cur != nstart) {
             --cur;
-            data_allocator::deallocate(*cur, buffer_size);
+            alloc_.deallocate(*cur, buffer_size);
             *cur = nullptr;
         }
         throw;
@@ -808,10 +879,10 @@ void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish) {
 }
 
 // destroy_buffer 函数
-template <class T>
-void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish) {
+template <class T, class Alloc>
+void deque<T, Alloc>::destroy_buffer(map_pointer nstart, map_pointer nfinish) {
     for (map_pointer n = nstart; n <= nfinish; ++n) {
-        data_allocator::deallocate(*n, buffer_size);
+        alloc_.deallocate(*n, buffer_size);
         *n = nullptr;
     }
 }
@@ -819,8 +890,8 @@ void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish) {
 // map_init 函数
 // 用于初始化deque的map和buffer
 // 根据需要存储的元素数量nElem，计算需要分配的缓冲区数量nNode，然后分配map和buffer的内存空间，并将它们初始化
-template <class T>
-void deque<T>::map_init(size_type nElem) {
+template <class T, class Alloc>
+void deque<T, Alloc>::map_init(size_type nElem) {
     const size_type nNode = nElem / buffer_size + 1;  // 需要分配的缓冲区个数
     // map数组的大小map_size_
     map_size_ =
@@ -841,7 +912,7 @@ void deque<T>::map_init(size_type nElem) {
         // 分配缓冲区的内存空间
         create_buffer(nstart, nfinish);
     } catch (...) {
-        map_allocator::deallocate(map_, map_size_);
+        map_allocator(alloc_).deallocate(map_, map_size_);
         map_ = nullptr;
         map_size_ = 0;
         throw;
@@ -855,8 +926,8 @@ void deque<T>::map_init(size_type nElem) {
 }
 
 // fill_init 函数
-template <class T>
-void deque<T>::fill_init(size_type n, const value_type& value) {
+template <class T, class Alloc>
+void deque<T, Alloc>::fill_init(size_type n, const value_type& value) {
     map_init(n);
     if (n != 0) {
         for (auto cur = begin_.node; cur < end_.node; ++cur) {
@@ -867,18 +938,18 @@ void deque<T>::fill_init(size_type n, const value_type& value) {
 }
 
 // copy_init 函数
-template <class T>
+template <class T, class Alloc>
 template <class IIter>
-void deque<T>::copy_init(IIter first, IIter last, input_iterator_tag) {
+void deque<T, Alloc>::copy_init(IIter first, IIter last, input_iterator_tag) {
     const size_type n = mystl::distance(first, last);
     map_init(n);
     for (; first != last; ++first)
         emplace_back(*first);
 }
 
-template <class T>
+template <class T, class Alloc>
 template <class FIter>
-void deque<T>::copy_init(FIter first, FIter last, forward_iterator_tag) {
+void deque<T, Alloc>::copy_init(FIter first, FIter last, forward_iterator_tag) {
     const size_type n = mystl::distance(first, last);
     map_init(n);
     for (auto cur = begin_.node; cur < end_.node; ++cur) {
@@ -891,8 +962,8 @@ void deque<T>::copy_init(FIter first, FIter last, forward_iterator_tag) {
 }
 
 // fill_assign 函数
-template <class T>
-void deque<T>::fill_assign(size_type n, const value_type& value) {
+template <class T, class Alloc>
+void deque<T, Alloc>::fill_assign(size_type n, const value_type& value) {
     if (n > size()) {
         // 现填充几个
         mystl::fill(begin(), end(), value);
@@ -906,9 +977,9 @@ void deque<T>::fill_assign(size_type n, const value_type& value) {
 }
 
 // copy_assign 函数
-template <class T>
+template <class T, class Alloc>
 template <class IIter>
-void deque<T>::copy_assign(IIter first, IIter last, input_iterator_tag) {
+void deque<T, Alloc>::copy_assign(IIter first, IIter last, input_iterator_tag) {
     auto first1 = begin();
     auto last1 = end();
     for (; first != last && first1 != last1; ++first, ++first1) {
@@ -921,9 +992,9 @@ void deque<T>::copy_assign(IIter first, IIter last, input_iterator_tag) {
     }
 }
 
-template <class T>
+template <class T, class Alloc>
 template <class FIter>
-void deque<T>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
+void deque<T, Alloc>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
     const size_type len1 = size();
     const size_type len2 = mystl::distance(first, last);
     if (len1 < len2) {
@@ -938,9 +1009,9 @@ void deque<T>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
 
 // insert_aux 函数
 // 用于在指定位置插入元素
-template <class T>
+template <class T, class Alloc>
 template <class... Args>
-typename deque<T>::iterator deque<T>::insert_aux(iterator position,
+typename deque<T, Alloc>::iterator deque<T, Alloc>::insert_aux(iterator position,
                                                  Args&&... args) {
     // 首先计算出目标位置之前的元素个数，即elems_before
     const size_type elems_before = position - begin_;
@@ -973,8 +1044,8 @@ typename deque<T>::iterator deque<T>::insert_aux(iterator position,
 }
 
 // fill_insert 函数
-template <class T>
-void deque<T>::fill_insert(iterator position,
+template <class T, class Alloc>
+void deque<T, Alloc>::fill_insert(iterator position,
                            size_type n,
                            const value_type& value) {
     const size_type elems_before = position - begin_;
@@ -1034,9 +1105,9 @@ void deque<T>::fill_insert(iterator position,
 }
 
 // copy_insert
-template <class T>
+template <class T, class Alloc>
 template <class FIter>
-void deque<T>::copy_insert(iterator position,
+void deque<T, Alloc>::copy_insert(iterator position,
                            FIter first,
                            FIter last,
                            size_type n) {
@@ -1101,9 +1172,9 @@ void deque<T>::copy_insert(iterator position,
 
 // insert_dispatch 函数
 // 用于在deque中插入元素，使用了迭代器的标签来区分不同类型的迭代器
-template <class T>
+template <class T, class Alloc>
 template <class IIter>
-void deque<T>::insert_dispatch(iterator position,
+void deque<T, Alloc>::insert_dispatch(iterator position,
                                IIter first,
                                IIter last,
                                input_iterator_tag) {
@@ -1127,9 +1198,9 @@ void deque<T>::insert_dispatch(iterator position,
     }
 }
 
-template <class T>
+template <class T, class Alloc>
 template <class FIter>
-void deque<T>::insert_dispatch(iterator position,
+void deque<T, Alloc>::insert_dispatch(iterator position,
                                FIter first,
                                FIter last,
                                forward_iterator_tag) {
@@ -1165,9 +1236,9 @@ void deque<T>::insert_dispatch(iterator position,
 
 // require_capacity 函数
 // 用于确保deque中有足够的容量来存储元素，至少有n个元素的存储空间
-template <class T>
+template <class T, class Alloc>
 // front参数指定了是在deque的前端进行插入或删除操作，还是在后端进行插入或删除操作
-void deque<T>::require_capacity(size_type n, bool front) {
+void deque<T, Alloc>::require_capacity(size_type n, bool front) {
     // 前端进行插入或删除操作，并且当前deque的缓存块不足以容纳n个元素，那么就需要重新分配缓存块
     if (front && (static_cast<size_type>(begin_.cur - begin_.first) < n)) {
         // 判断需要多少个缓存块才能容纳n个元素
@@ -1196,8 +1267,8 @@ void deque<T>::require_capacity(size_type n, bool front) {
 
 // reallocate_map_at_front 函数
 // 用于在 deque 的前端重新分配内存
-template <class T>
-void deque<T>::reallocate_map_at_front(size_type need_buffer) {
+template <class T, class Alloc>
+void deque<T, Alloc>::reallocate_map_at_front(size_type need_buffer) {
     // 首先计算出新的 map 大小，即将原来的 map 大小翻倍，或者是原来的 map
     // 大小加上需要的缓存空间和一个初始大小（DEQUE_MAP_INIT_SIZE）的较大值
     const size_type new_map_size = mystl::max(
@@ -1216,14 +1287,12 @@ void deque<T>::reallocate_map_at_front(size_type need_buffer) {
     auto end = mid + old_buffer;
     // 创建begin到mid-1的缓冲区，用来存新创建的
     create_buffer(begin, mid - 1);
-    // 原始缓存区中的元素复制到新的缓存区中
-    for (auto begin1 = mid, begin2 = begin_.node; begin1 != end;
-         ++begin1, ++begin2)
-        *begin1 = *begin2;
+    // 原来 map 中指向缓冲区的指针整体搬到新的 map 中
+    mystl::uninitialized_relocate(begin_.node, end_.node + 1, mid);
 
     // 更新数据
     // 释放原来的 map 内存
-    map_allocator::deallocate(map_, map_size_);
+    map_allocator(alloc_).deallocate(map_, map_size_);
     map_ = new_map;
     map_size_ = new_map_size;
     begin_ = iterator(*mid + (begin_.cur - begin_.first), mid);
@@ -1231,8 +1300,8 @@ void deque<T>::reallocate_map_at_front(size_type need_buffer) {
 }
 
 // reallocate_map_at_back 函数
-template <class T>
-void deque<T>::reallocate_map_at_back(size_type need_buffer) {
+template <class T, class Alloc>
+void deque<T, Alloc>::reallocate_map_at_back(size_type need_buffer) {
     const size_type new_map_size = mystl::max(
         map_size_ << 1, map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
     map_pointer new_map = create_map(new_map_size);
@@ -1243,13 +1312,11 @@ void deque<T>::reallocate_map_at_back(size_type need_buffer) {
     auto begin = new_map + ((new_map_size - new_buffer) / 2);
     auto mid = begin + old_buffer;
     auto end = mid + need_buffer;
-    for (auto begin1 = begin, begin2 = begin_.node; begin1 != mid;
-         ++begin1, ++begin2)
-        *begin1 = *begin2;
+    mystl::uninitialized_relocate(begin_.node, end_.node + 1, begin);
     create_buffer(mid, end - 1);
 
     // 更新数据
-    map_allocator::deallocate(map_, map_size_);
+    map_allocator(alloc_).deallocate(map_, map_size_);
     map_ = new_map;
     map_size_ = new_map_size;
     begin_ = iterator(*begin + (begin_.cur - begin_.first), begin);
@@ -1257,43 +1324,48 @@ void deque<T>::reallocate_map_at_back(size_type need_buffer) {
 }
 
 // 重载比较操作符
-template <class T>
-bool operator==(const deque<T>& lhs, const deque<T>& rhs) {
+template <class T, class Alloc>
+bool operator==(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
     return lhs.size() == rhs.size() &&
            mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator<(const deque<T>& lhs, const deque<T>& rhs) {
+template <class T, class Alloc>
+bool operator<(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
     return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
                                           rhs.end());
 }
 
-template <class T>
-bool operator!=(const deque<T>& lhs, const deque<T>& rhs) {
+template <class T, class Alloc>
+bool operator!=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
     return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const deque<T>& lhs, const deque<T>& rhs) {
+template <class T, class Alloc>
+bool operator>(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
     return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const deque<T>& lhs, const deque<T>& rhs) {
+template <class T, class Alloc>
+bool operator<=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
     return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const deque<T>& lhs, const deque<T>& rhs) {
+template <class T, class Alloc>
+bool operator>=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
     return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T>
-void swap(deque<T>& lhs, deque<T>& rhs) {
+template <class T, class Alloc>
+void swap(deque<T, Alloc>& lhs, deque<T, Alloc>& rhs) {
     lhs.swap(rhs);
 }
 
+// map 与缓冲区都在堆上，迭代器只指向堆上的空间，可以按位搬移
+template <class T, class Alloc>
+struct is_trivially_relocatable<deque<T, Alloc>>
+    : is_trivially_relocatable<Alloc> {};
+
 }  // namespace mystl
 #endif  // !MYTINYSTL_DEQUE_H_
@@ -0,0 +1,221 @@
+#ifndef MYTINYSTL_EYTZINGER_H_
+#define MYTINYSTL_EYTZINGER_H_
+
+// 这个头文件包含一个模板类 eytzinger_index
+// eytzinger_index : 只读的有序查找表，元素按 Eytzinger（BFS）顺序存放
+
+// notes:
+//
+// 1. 有序序列中第 i 小的元素放在完全二叉树中序遍历的第 i 个结点上，结点 k 的子结点为 2k 与 2k + 1，
+//    结点按层存放在一段连续的数组中，查找路径上前几层的结点集中在少数几个缓存行中
+// 2. 查找时每层只做一次比较并由结果计算下一个结点，没有分支预测失败；
+//    同时预取 4 层以下的结点，使内存访问与比较重叠
+// 3. begin() / end() 按存放顺序遍历，不是有序的；lower_bound / upper_bound 返回指向元素的迭代器，
+//    没有满足条件的元素时返回 end()
+// 4. 构造后不能修改元素，需要修改时重新调用 assign
+// 5. 允许重复的元素，count 返回与 value 等价的元素个数，复杂度为 O(logn + count)
+
+#include <cstdint>
+#include <initializer_list>
+
+#include "algo.h"
+#include "functional.h"
+#include "memory.h"
+#include "vector.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace mystl {
+
+// k 的二进制表示中末尾连续的 1 的个数
+inline unsigned eyt_trailing_ones(size_t k) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(~static_cast<unsigned long long>(k)));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long r;
+    _BitScanForward64(&r, ~static_cast<unsigned long long>(k));
+    return static_cast<unsigned>(r);
+#else
+    unsigned r = 0;
+    for (; k & 1; k >>= 1)
+        ++r;
+    return r;
+#endif
+}
+
+// 模板类 eytzinger_index
+// 参数一代表元素类型，参数二代表比较方式，缺省使用 mystl::less
+template <class T, class Compare = mystl::less<T>>
+class eytzinger_index {
+public:
+    typedef T value_type;
+    typedef Compare value_compare;
+    typedef const T& reference;
+    typedef const T& const_reference;
+    typedef const T* pointer;
+    typedef const T* const_pointer;
+    typedef const T* iterator;
+    typedef const T* const_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+private:
+    // 结点 k 往下若干层的所有子孙是连续的，预取 k * prefetch_stride 时
+    // 一个缓存行正好覆盖这一层的子孙：4 字节的结点预取 4 层以下，8 字节的结点预取 3 层以下
+    static constexpr size_t prefetch_stride =
+        sizeof(T) <= 4 ? 16 : (sizeof(T) <= 8 ? 8 : (sizeof(T) <= 16 ? 4 : 2));
+
+    mystl::vector<T> data_;  // data_[k - 1] 为结点 k
+    Compare comp_;
+
+public:
+    eytzinger_index() = default;
+    explicit eytzinger_index(const Compare& comp) : data_(), comp_(comp) {}
+
+    // [first, last) 不需要有序，构造时按 comp 排序
+    template <class InputIter,
+              typename std::enable_if<mystl::is_input_iterator<InputIter>::value,
+                                      int>::type = 0>
+    eytzinger_index(InputIter first,
+                    InputIter last,
+                    const Compare& comp = Compare())
+        : data_(), comp_(comp) {
+        assign(first, last);
+    }
+
+    eytzinger_index(std::initializer_list<T> ilist,
+                    const Compare& comp = Compare())
+        : data_(), comp_(comp) {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    // 由有序的 vector 重建，sorted 不需要有序，无序时先排序
+    explicit eytzinger_index(const mystl::vector<T>& sorted,
+                             const Compare& comp = Compare())
+        : data_(), comp_(comp) {
+        assign(sorted.begin(), sorted.end());
+    }
+
+    template <class InputIter,
+              typename std::enable_if<mystl::is_input_iterator<InputIter>::value,
+                                      int>::type = 0>
+    void assign(InputIter first, InputIter last) {
+        mystl::vector<T> sorted(first, last);
+        if (!mystl::is_sorted(sorted.begin(), sorted.end(), comp_))
+            mystl::sort(sorted.begin(), sorted.end(), comp_);
+        // 中序遍历求出每个结点对应的有序位置，再按存放顺序依次移入
+        const size_type n = sorted.size();
+        mystl::vector<size_type> rank(n);
+        build_rank(rank, 0, 1);
+        data_.clear();
+        data_.reserve(n);
+        for (size_type k = 0; k < n; ++k)
+            data_.push_back(mystl::move(sorted[rank[k]]));
+    }
+
+public:
+    const_iterator begin() const noexcept { return data_.begin(); }
+    const_iterator end() const noexcept { return data_.end(); }
+
+    bool empty() const noexcept { return data_.empty(); }
+    size_type size() const noexcept { return data_.size(); }
+
+    value_compare value_comp() const { return comp_; }
+
+    // 第一个不小于 value 的元素
+    const_iterator lower_bound(const T& value) const {
+        const size_type n = data_.size();
+        const T* node = data_.data();  // node[k - 1] 为结点 k
+        size_type k = 1;
+        while (k <= n) {
+            mystl::prefetch(node_address(k * prefetch_stride));
+            k = 2 * k + static_cast<size_type>(comp_(node[k - 1], value));
+        }
+        return result(k);
+    }
+
+    // 第一个大于 value 的元素
+    const_iterator upper_bound(const T& value) const {
+        const size_type n = data_.size();
+        const T* node = data_.data();
+        size_type k = 1;
+        while (k <= n) {
+            mystl::prefetch(node_address(k * prefetch_stride));
+            k = 2 * k + static_cast<size_type>(!comp_(value, node[k - 1]));
+        }
+        return result(k);
+    }
+
+    bool contains(const T& value) const {
+        auto it = lower_bound(value);
+        return it != end() && !comp_(value, *it);
+    }
+
+    // 从 lower_bound 开始按中序依次访问后继，直到遇到大于 value 的元素
+    size_type count(const T& value) const {
+        auto it = lower_bound(value);
+        if (it == end())
+            return 0;
+        size_type k = static_cast<size_type>(it - data_.begin()) + 1;
+        size_type n = 0;
+        while (k != 0 && !comp_(value, data_[k - 1])) {
+            ++n;
+            k = next_node(k);
+        }
+        return n;
+    }
+
+    void swap(eytzinger_index& rhs) noexcept {
+        data_.swap(rhs.data_);
+        mystl::swap(comp_, rhs.comp_);
+    }
+
+private:
+    // 结点 k 的地址，只用于预取，k 可以超出范围
+    const void* node_address(size_type k) const noexcept {
+        return reinterpret_cast<const void*>(
+            reinterpret_cast<uintptr_t>(data_.data()) + (k - 1) * sizeof(T));
+    }
+
+    // 查找结束时 k 越过了叶子，去掉最后一段向右的路径后剩下的就是最后一次向左时所在的结点
+    const_iterator result(size_type k) const noexcept {
+        k >>= eyt_trailing_ones(k) + 1;
+        return k == 0 ? end() : data_.begin() + (k - 1);
+    }
+
+    // 结点 k 在中序遍历中的后继，没有后继时返回 0：有右子树时为右子树最左的结点，
+    // 否则去掉末尾向右的路径，回到最后一次向左时所在结点的父结点
+    size_type next_node(size_type k) const noexcept {
+        const size_type n = data_.size();
+        if (2 * k + 1 <= n) {
+            k = 2 * k + 1;
+            while (2 * k <= n)
+                k = 2 * k;
+            return k;
+        }
+        return k >> (eyt_trailing_ones(k) + 1);
+    }
+
+    // 中序遍历以 k 为根的子树，结点依次对应有序位置 i, i + 1, ...，返回下一个有序位置
+    static size_type build_rank(mystl::vector<size_type>& rank,
+                                size_type i,
+                                size_type k) {
+        if (k > rank.size())
+            return i;
+        i = build_rank(rank, i, 2 * k);
+        rank[k - 1] = i++;
+        return build_rank(rank, i, 2 * k + 1);
+    }
+};
+
+// 重载 mystl 的 swap
+template <class T, class Compare>
+void swap(eytzinger_index<T, Compare>& lhs,
+          eytzinger_index<T, Compare>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_EYTZINGER_H_
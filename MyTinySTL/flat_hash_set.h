@@ -0,0 +1,219 @@
+#ifndef MYTINYSTL_FLAT_HASH_SET_H_
+#define MYTINYSTL_FLAT_HASH_SET_H_
+
+// 这个头文件包含一个模板类 flat_hash_set
+// 功能与用法与 unordered_set 类似，不同的是使用 flat_hashtable 作为底层实现机制，
+// 元素直接存放在一段连续的数组中，适合键值较小、查找频繁的场景
+
+// notes:
+//
+// 与 unordered_set 的区别：
+//   * 插入、rehash 会使所有迭代器、指针、引用失效
+//   * 不提供 bucket 相关的 local_iterator 接口
+//
+// 异常保证：
+// mystl::flat_hash_set<Key> 满足基本异常保证
+
+#include "flat_hashtable.h"
+
+namespace mystl {
+
+// 模板类 flat_hash_set，键值不允许重复
+// 参数一代表键值类型，参数二代表哈希函数，缺省使用 mystl::hash，
+// 参数三代表键值比较方式，缺省使用 mystl::equal_to
+template <class Key,
+          class Hash = mystl::hash<Key>,
+          class KeyEqual = mystl::equal_to<Key>>
+class flat_hash_set {
+private:
+    // 使用 flat_hashtable 作为底层机制
+    typedef flat_hashtable<Key, Hash, KeyEqual> base_type;
+    base_type ht_;
+
+public:
+    // 使用 flat_hashtable 的型别
+    typedef typename base_type::allocator_type allocator_type;
+    typedef typename base_type::key_type key_type;
+    typedef typename base_type::value_type value_type;
+    typedef typename base_type::hasher hasher;
+    typedef typename base_type::key_equal key_equal;
+
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::difference_type difference_type;
+    typedef typename base_type::pointer pointer;
+    typedef typename base_type::const_pointer const_pointer;
+    typedef typename base_type::reference reference;
+    typedef typename base_type::const_reference const_reference;
+
+    typedef typename base_type::const_iterator iterator;
+    typedef typename base_type::const_iterator const_iterator;
+
+    allocator_type get_allocator() const { return ht_.get_allocator(); }
+
+public:
+    // 构造、复制、移动函数
+
+    // 缺省构造时不分配空间
+    flat_hash_set() : ht_(0, Hash(), KeyEqual()) {}
+
+    explicit flat_hash_set(size_type bucket_count,
+                           const Hash& hash = Hash(),
+                           const KeyEqual& equal = KeyEqual())
+        : ht_(bucket_count, hash, equal) {}
+
+    template <class InputIterator>
+    flat_hash_set(InputIterator first,
+                  InputIterator last,
+                  const size_type bucket_count = 0,
+                  const Hash& hash = Hash(),
+                  const KeyEqual& equal = KeyEqual())
+        : ht_(bucket_count, hash, equal) {
+        ht_.insert_unique(first, last);
+    }
+
+    flat_hash_set(std::initializer_list<value_type> ilist,
+                  const size_type bucket_count = 0,
+                  const Hash& hash = Hash(),
+                  const KeyEqual& equal = KeyEqual())
+        : ht_(bucket_count, hash, equal) {
+        ht_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    flat_hash_set(const flat_hash_set& rhs) : ht_(rhs.ht_) {}
+    flat_hash_set(flat_hash_set&& rhs) noexcept : ht_(mystl::move(rhs.ht_)) {}
+
+    flat_hash_set& operator=(const flat_hash_set& rhs) {
+        ht_ = rhs.ht_;
+        return *this;
+    }
+    flat_hash_set& operator=(flat_hash_set&& rhs) {
+        ht_ = mystl::move(rhs.ht_);
+        return *this;
+    }
+
+    flat_hash_set& operator=(std::initializer_list<value_type> ilist) {
+        ht_.clear();
+        ht_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~flat_hash_set() = default;
+
+    // 迭代器相关
+
+    iterator begin() noexcept { return ht_.begin(); }
+    const_iterator begin() const noexcept { return ht_.begin(); }
+    iterator end() noexcept { return ht_.end(); }
+    const_iterator end() const noexcept { return ht_.end(); }
+
+    const_iterator cbegin() const noexcept { return ht_.cbegin(); }
+    const_iterator cend() const noexcept { return ht_.cend(); }
+
+    // 容量相关
+
+    bool empty() const noexcept { return ht_.empty(); }
+    size_type size() const noexcept { return ht_.size(); }
+    size_type max_size() const noexcept { return ht_.max_size(); }
+
+    // 修改容器操作
+
+    // empalce / empalce_hint
+
+    template <class... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return ht_.emplace_unique(mystl::forward<Args>(args)...);
+    }
+
+    // [note]: hint 对于 flat_hashtable 没有意义，选择忽略它
+    template <class... Args>
+    iterator emplace_hint(const_iterator /*hint*/, Args&&... args) {
+        return ht_.emplace_unique(mystl::forward<Args>(args)...).first;
+    }
+
+    // insert
+
+    pair<iterator, bool> insert(const value_type& value) {
+        return ht_.insert_unique(value);
+    }
+    pair<iterator, bool> insert(value_type&& value) {
+        return ht_.insert_unique(mystl::move(value));
+    }
+
+    iterator insert(const_iterator /*hint*/, const value_type& value) {
+        return ht_.insert_unique(value).first;
+    }
+    iterator insert(const_iterator /*hint*/, value_type&& value) {
+        return ht_.insert_unique(mystl::move(value)).first;
+    }
+
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        ht_.insert_unique(first, last);
+    }
+
+    // erase / clear
+
+    iterator erase(const_iterator it) { return ht_.erase(it); }
+    iterator erase(const_iterator first, const_iterator last) {
+        return ht_.erase(first, last);
+    }
+
+    size_type erase(const key_type& key) { return ht_.erase_unique(key); }
+
+    void clear() { ht_.clear(); }
+
+    void swap(flat_hash_set& other) noexcept { ht_.swap(other.ht_); }
+
+    // 查找相关
+
+    size_type count(const key_type& key) const { return ht_.count(key); }
+
+    iterator find(const key_type& key) { return ht_.find(key); }
+    const_iterator find(const key_type& key) const { return ht_.find(key); }
+
+    pair<iterator, iterator> equal_range(const key_type& key) {
+        return ht_.equal_range_unique(key);
+    }
+    pair<const_iterator, const_iterator> equal_range(
+        const key_type& key) const {
+        return ht_.equal_range_unique(key);
+    }
+
+    // bucket interface
+
+    size_type bucket_count() const noexcept { return ht_.bucket_count(); }
+    size_type max_bucket_count() const noexcept {
+        return ht_.max_bucket_count();
+    }
+
+    // hash policy
+
+    float load_factor() const noexcept { return ht_.load_factor(); }
+
+    float max_load_factor() const noexcept { return ht_.max_load_factor(); }
+    void max_load_factor(float ml) { ht_.max_load_factor(ml); }
+
+    void rehash(size_type count) { ht_.rehash(count); }
+    void reserve(size_type count) { ht_.reserve(count); }
+
+    hasher hash_fcn() const { return ht_.hash_fcn(); }
+    key_equal key_eq() const { return ht_.key_eq(); }
+
+public:
+    friend bool operator==(const flat_hash_set& lhs, const flat_hash_set& rhs) {
+        return lhs.ht_.equal_to_unique(rhs.ht_);
+    }
+    friend bool operator!=(const flat_hash_set& lhs, const flat_hash_set& rhs) {
+        return !lhs.ht_.equal_to_unique(rhs.ht_);
+    }
+};
+
+// 重载 mystl 的 swap
+template <class Key, class Hash, class KeyEqual>
+void swap(flat_hash_set<Key, Hash, KeyEqual>& lhs,
+          flat_hash_set<Key, Hash, KeyEqual>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_FLAT_HASH_SET_H_
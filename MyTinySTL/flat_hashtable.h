@@ -0,0 +1,758 @@
+#ifndef MYTINYSTL_FLAT_HASHTABLE_H_
+#define MYTINYSTL_FLAT_HASHTABLE_H_
+
+// 这个头文件包含了一个模板类 flat_hashtable
+// flat_hashtable : 开放定址的哈希表，使用 Robin Hood 线性探测处理冲突，
+// 元素直接存放在一段连续的数组中，不为每个元素单独分配节点
+
+// notes:
+//
+// 1. 起始位置的个数总是 2 的幂次，哈希值经 ht_hash_mix 混合后取低位
+// 2. 数组末尾额外留出 max_probe_ 个位置，探测不会回绕到数组开头，
+//    删除时把后面的元素前移（backward shift），遍历不会重复或遗漏元素
+// 3. 插入、rehash 会移动元素，所有迭代器、指针、引用都会失效；
+//    删除只会让被删除位置之后、同一簇内的元素前移一位
+// 4. 键值不允许重复
+//
+// 异常保证：
+// 满足基本异常保证，emplace / insert 在元素的移动构造不抛出异常时提供强异常安全保证
+
+#include <cstring>
+#include <initializer_list>
+
+#include "hashtable.h"
+
+namespace mystl {
+
+// 探测距离表中的标记
+// 0 表示空位，1 ~ max_probe_ 表示探测距离加一，末尾的哨兵用于结束遍历
+static constexpr unsigned char fht_empty = 0;
+static constexpr unsigned char fht_sentinel = 0xff;
+
+// 探测距离的上限，受 unsigned char 的表示范围限制
+static constexpr size_t fht_probe_limit = 254;
+
+// 起始位置为 n 个时，允许的最大探测距离，取 log2(n)，至少为 8
+inline size_t fht_max_probe(size_t n) {
+    size_t result = 0;
+    while (n >>= 1)
+        ++result;
+    return result < 8 ? 8 : result;
+}
+
+// flat_hashtable 的迭代器
+// 迭代器只保存元素和探测距离的位置，遍历时跳过空位，遇到末尾的哨兵停止
+
+template <class T>
+struct fht_iterator;
+
+template <class T>
+struct fht_const_iterator;
+
+template <class T>
+struct fht_iterator_base
+    : public mystl::iterator<mystl::forward_iterator_tag, T> {
+    typedef fht_iterator_base<T> base;
+
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    T* slot;                    // 迭代器当前所指的元素
+    const unsigned char* dist;  // 当前位置的探测距离
+
+    fht_iterator_base() = default;
+    fht_iterator_base(T* s, const unsigned char* d) : slot(s), dist(d) {}
+
+    // 前进到下一个非空位置
+    void incr() {
+        MYSTL_DEBUG(*dist != fht_sentinel);
+        do {
+            ++slot;
+            ++dist;
+        } while (*dist == fht_empty);
+    }
+
+    bool operator==(const base& rhs) const { return slot == rhs.slot; }
+    bool operator!=(const base& rhs) const { return slot != rhs.slot; }
+};
+
+template <class T>
+struct fht_iterator : public fht_iterator_base<T> {
+    typedef fht_iterator_base<T> base;
+    typedef fht_iterator<T> self;
+
+    typedef T value_type;
+    typedef value_type* pointer;
+    typedef value_type& reference;
+
+    using base::dist;
+    using base::slot;
+
+    fht_iterator() = default;
+    fht_iterator(T* s, const unsigned char* d) : base(s, d) {}
+
+    reference operator*() const { return *slot; }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator++() {
+        this->incr();
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        this->incr();
+        return tmp;
+    }
+};
+
+template <class T>
+struct fht_const_iterator : public fht_iterator_base<T> {
+    typedef fht_iterator_base<T> base;
+    typedef fht_const_iterator<T> self;
+
+    typedef T value_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+
+    using base::dist;
+    using base::slot;
+
+    fht_const_iterator() = default;
+    fht_const_iterator(T* s, const unsigned char* d) : base(s, d) {}
+    fht_const_iterator(const fht_iterator<T>& rhs) : base(rhs.slot, rhs.dist) {}
+
+    reference operator*() const { return *slot; }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator++() {
+        this->incr();
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        this->incr();
+        return tmp;
+    }
+};
+
+// 模板类 flat_hashtable
+// 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数
+template <class T, class Hash, class KeyEqual>
+class flat_hashtable {
+public:
+    // flat_hashtable 的型别定义，键值萃取与 hashtable 共用 ht_value_traits
+    typedef ht_value_traits<T> value_traits;
+    typedef typename value_traits::key_type key_type;
+    typedef typename value_traits::mapped_type mapped_type;
+    typedef typename value_traits::value_type value_type;
+    typedef Hash hasher;
+    typedef KeyEqual key_equal;
+
+    typedef mystl::allocator<T> allocator_type;
+    typedef mystl::allocator<T> data_allocator;
+    typedef mystl::allocator<unsigned char> dist_allocator;
+
+    typedef typename allocator_type::pointer pointer;
+    typedef typename allocator_type::const_pointer const_pointer;
+    typedef typename allocator_type::reference reference;
+    typedef typename allocator_type::const_reference const_reference;
+    typedef typename allocator_type::size_type size_type;
+    typedef typename allocator_type::difference_type difference_type;
+
+    typedef mystl::fht_iterator<T> iterator;
+    typedef mystl::fht_const_iterator<T> const_iterator;
+
+    allocator_type get_allocator() const { return allocator_type(); }
+
+private:
+    // 用以下参数来表现 flat_hashtable
+    pointer slots_;          // 元素数组，共 slot_count_ 个位置
+    unsigned char* dist_;    // 每个位置的探测距离，长度为 slot_count_ + 1
+    size_type bucket_size_;  // 起始位置的个数，为 2 的幂次
+    size_type max_probe_;    // 允许的最大探测距离
+    size_type slot_count_;   // bucket_size_ + max_probe_
+    size_type size_;
+    float mlf_;
+    hasher hash_;
+    key_equal equal_;
+
+private:
+    // 没有分配空间时使用的探测距离表，只有一个哨兵
+    static unsigned char* empty_dist() noexcept {
+        static unsigned char sentinel = fht_sentinel;
+        return &sentinel;
+    }
+
+    bool is_equal(const key_type& key1, const key_type& key2) const {
+        return equal_(key1, key2);
+    }
+
+    // 哈希值对应的起始位置
+    size_type home(size_type code) const noexcept {
+        return ht_hash_mix(code) & (bucket_size_ - 1);
+    }
+
+    iterator M_it(size_type n) noexcept {
+        return iterator(slots_ + n, dist_ + n);
+    }
+    const_iterator M_cit(size_type n) const noexcept {
+        return const_iterator(slots_ + n, dist_ + n);
+    }
+
+    size_type M_begin() const noexcept {
+        size_type n = 0;
+        while (dist_[n] == fht_empty)
+            ++n;
+        return n;
+    }
+
+public:
+    // 构造、复制、移动、析构函数
+    explicit flat_hashtable(size_type bucket_count,
+                            const Hash& hash = Hash(),
+                            const KeyEqual& equal = KeyEqual())
+        : slots_(nullptr),
+          dist_(empty_dist()),
+          bucket_size_(0),
+          max_probe_(0),
+          slot_count_(0),
+          size_(0),
+          mlf_(0.8f),
+          hash_(hash),
+          equal_(equal) {
+        if (bucket_count != 0)
+            init(ht_next_pow2(bucket_count));
+    }
+
+    flat_hashtable(const flat_hashtable& rhs)
+        : slots_(nullptr),
+          dist_(empty_dist()),
+          bucket_size_(0),
+          max_probe_(0),
+          slot_count_(0),
+          size_(0),
+          mlf_(rhs.mlf_),
+          hash_(rhs.hash_),
+          equal_(rhs.equal_) {
+        copy_init(rhs);
+    }
+    flat_hashtable(flat_hashtable&& rhs) noexcept
+        : slots_(rhs.slots_),
+          dist_(rhs.dist_),
+          bucket_size_(rhs.bucket_size_),
+          max_probe_(rhs.max_probe_),
+          slot_count_(rhs.slot_count_),
+          size_(rhs.size_),
+          mlf_(rhs.mlf_),
+          hash_(rhs.hash_),
+          equal_(rhs.equal_) {
+        rhs.slots_ = nullptr;
+        rhs.dist_ = empty_dist();
+        rhs.bucket_size_ = 0;
+        rhs.max_probe_ = 0;
+        rhs.slot_count_ = 0;
+        rhs.size_ = 0;
+    }
+
+    flat_hashtable& operator=(const flat_hashtable& rhs) {
+        if (this != &rhs) {
+            flat_hashtable tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+    flat_hashtable& operator=(flat_hashtable&& rhs) noexcept {
+        flat_hashtable tmp(mystl::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    ~flat_hashtable() { destroy_table(); }
+
+    // 迭代器相关操作
+    iterator begin() noexcept { return M_it(M_begin()); }
+    const_iterator begin() const noexcept { return M_cit(M_begin()); }
+    iterator end() noexcept { return M_it(slot_count_); }
+    const_iterator end() const noexcept { return M_cit(slot_count_); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // 容量相关操作
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+    // 修改容器相关操作
+
+    // emplace / insert
+    // 先构造出元素取得键值，键值不存在时再把元素移入表中
+    template <class... Args>
+    pair<iterator, bool> emplace_unique(Args&&... args) {
+        value_type tmp(mystl::forward<Args>(args)...);
+        return insert_value_unique(mystl::move(tmp));
+    }
+
+    pair<iterator, bool> insert_unique(const value_type& value) {
+        return insert_value_unique(value);
+    }
+    pair<iterator, bool> insert_unique(value_type&& value) {
+        return insert_value_unique(mystl::move(value));
+    }
+
+    template <class InputIter>
+    void insert_unique(InputIter first, InputIter last) {
+        copy_insert_unique(first, last, iterator_category(first));
+    }
+
+    // erase / clear
+
+    iterator erase(const_iterator position);
+    iterator erase(const_iterator first, const_iterator last);
+
+    size_type erase_unique(const key_type& key);
+
+    void clear();
+
+    void swap(flat_hashtable& rhs) noexcept;
+
+    // 查找相关操作
+
+    size_type count(const key_type& key) const {
+        return find_index(key) != slot_count_ ? 1 : 0;
+    }
+
+    iterator find(const key_type& key) { return M_it(find_index(key)); }
+    const_iterator find(const key_type& key) const {
+        return M_cit(find_index(key));
+    }
+
+    pair<iterator, iterator> equal_range_unique(const key_type& key) {
+        auto it = find(key);
+        if (it == end())
+            return mystl::make_pair(it, it);
+        auto next = it;
+        return mystl::make_pair(it, ++next);
+    }
+    pair<const_iterator, const_iterator> equal_range_unique(
+        const key_type& key) const {
+        auto it = find(key);
+        if (it == end())
+            return mystl::make_pair(it, it);
+        auto next = it;
+        return mystl::make_pair(it, ++next);
+    }
+
+    // bucket interface
+
+    size_type bucket_count() const noexcept { return bucket_size_; }
+    size_type max_bucket_count() const noexcept {
+        return ht_pow2_max;
+    }
+
+    // hash policy
+
+    float load_factor() const noexcept {
+        return bucket_size_ != 0 ? (float)size_ / bucket_size_ : 0.0f;
+    }
+
+    float max_load_factor() const noexcept { return mlf_; }
+    void max_load_factor(float ml) {
+        THROW_OUT_OF_RANGE_IF(ml != ml || ml <= 0 || ml > 1,
+                              "invalid hash load factor");
+        mlf_ = ml;
+    }
+
+    void rehash(size_type count);
+
+    void reserve(size_type count) {
+        rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f));
+    }
+
+    hasher hash_fcn() const { return hash_; }
+    key_equal key_eq() const { return equal_; }
+
+    bool equal_to_unique(const flat_hashtable& other) const;
+
+private:
+    // flat_hashtable 成员函数
+
+    // init / destroy
+    void init(size_type bucket_count, size_type max_probe = 0);
+    void copy_init(const flat_hashtable& rhs);
+    void destroy_table();
+
+    // find
+    size_type find_index(const key_type& key) const;
+
+    // insert
+    template <class V>
+    pair<iterator, bool> insert_value_unique(V&& value);
+    template <class V>
+    size_type insert_value_noresize(size_type code, V&& value);
+    template <class V>
+    size_type insert_value_grow(size_type code, V&& value);
+    size_type find_insert_pos(size_type code, size_type& d) const;
+    void rehash_if_need(size_type n);
+    void grow();
+    void rehash_to(size_type bucket_count, size_type max_probe);
+
+    template <class InputIter>
+    void copy_insert_unique(InputIter first,
+                            InputIter last,
+                            mystl::input_iterator_tag);
+    template <class ForwardIter>
+    void copy_insert_unique(ForwardIter first,
+                            ForwardIter last,
+                            mystl::forward_iterator_tag);
+
+    // erase
+    void erase_at(size_type n);
+    void backward_shift(size_type n);
+};
+
+/*****************************************************************************************/
+
+// 删除迭代器所指的元素，返回下一个元素的位置
+template <class T, class Hash, class KeyEqual>
+typename flat_hashtable<T, Hash, KeyEqual>::iterator
+flat_hashtable<T, Hash, KeyEqual>::erase(const_iterator position) {
+    const size_type n = static_cast<size_type>(position.slot - slots_);
+    MYSTL_DEBUG(n < slot_count_ && dist_[n] != fht_empty);
+    erase_at(n);
+    iterator it = M_it(n);
+    if (dist_[n] == fht_empty)  // 后面的元素没有前移，跳到下一个元素
+        it.incr();
+    return it;
+}
+
+// 删除[first, last)内的元素
+// 删除会让后面的元素前移，所以先数出个数，再从 first 开始逐个删除
+template <class T, class Hash, class KeyEqual>
+typename flat_hashtable<T, Hash, KeyEqual>::iterator
+flat_hashtable<T, Hash, KeyEqual>::erase(const_iterator first,
+                                         const_iterator last) {
+    auto n = mystl::distance(first, last);
+    iterator it = M_it(static_cast<size_type>(first.slot - slots_));
+    for (; n > 0; --n)
+        it = erase(it);
+    return it;
+}
+
+// 删除键值为 key 的元素
+template <class T, class Hash, class KeyEqual>
+typename flat_hashtable<T, Hash, KeyEqual>::size_type
+flat_hashtable<T, Hash, KeyEqual>::erase_unique(const key_type& key) {
+    const size_type n = find_index(key);
+    if (n == slot_count_)
+        return 0;
+    erase_at(n);
+    return 1;
+}
+
+// 清空 flat_hashtable，保留已分配的空间
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::clear() {
+    if (size_ != 0) {
+        for (size_type i = 0; i < slot_count_; ++i) {
+            if (dist_[i] != fht_empty)
+                data_allocator::destroy(slots_ + i);
+        }
+        std::memset(dist_, fht_empty, slot_count_);
+        size_ = 0;
+    }
+}
+
+// 交换 flat_hashtable
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::swap(flat_hashtable& rhs) noexcept {
+    if (this != &rhs) {
+        mystl::swap(slots_, rhs.slots_);
+        mystl::swap(dist_, rhs.dist_);
+        mystl::swap(bucket_size_, rhs.bucket_size_);
+        mystl::swap(max_probe_, rhs.max_probe_);
+        mystl::swap(slot_count_, rhs.slot_count_);
+        mystl::swap(size_, rhs.size_);
+        mystl::swap(mlf_, rhs.mlf_);
+        mystl::swap(hash_, rhs.hash_);
+        mystl::swap(equal_, rhs.equal_);
+    }
+}
+
+// 重新调整起始位置的个数，至少能以 max_load_factor 容纳现有元素
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::rehash(size_type count) {
+    const auto need =
+        static_cast<size_type>((float)size_ / max_load_factor()) + 1;
+    const auto n = ht_next_pow2(mystl::max(count, need));
+    if (n != bucket_size_)
+        rehash_to(n, fht_max_probe(n));
+}
+
+// 比较两个 flat_hashtable 是否含有相同的元素
+template <class T, class Hash, class KeyEqual>
+bool flat_hashtable<T, Hash, KeyEqual>::equal_to_unique(
+    const flat_hashtable& other) const {
+    if (size_ != other.size_)
+        return false;
+    for (auto f = begin(), l = end(); f != l; ++f) {
+        auto res = other.find(value_traits::get_key(*f));
+        if (res == other.end() || !(*res == *f))
+            return false;
+    }
+    return true;
+}
+
+/****************************************************************************************/
+// helper function
+
+// init 函数
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::init(size_type bucket_count,
+                                             size_type max_probe) {
+    if (max_probe == 0)
+        max_probe = fht_max_probe(bucket_count);
+    const size_type slot_count = bucket_count + max_probe;
+    auto slots = data_allocator::allocate(slot_count);
+    unsigned char* dist = nullptr;
+    try {
+        dist = dist_allocator::allocate(slot_count + 1);
+    } catch (...) {
+        data_allocator::deallocate(slots, slot_count);
+        throw;
+    }
+    std::memset(dist, fht_empty, slot_count);
+    dist[slot_count] = fht_sentinel;
+    slots_ = slots;
+    dist_ = dist;
+    bucket_size_ = bucket_count;
+    max_probe_ = max_probe;
+    slot_count_ = slot_count;
+    size_ = 0;
+}
+
+// copy_init 函数，按原样复制每个位置
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::copy_init(const flat_hashtable& rhs) {
+    if (rhs.bucket_size_ == 0)
+        return;
+    init(rhs.bucket_size_, rhs.max_probe_);
+    try {
+        for (size_type i = 0; i < slot_count_; ++i) {
+            if (rhs.dist_[i] != fht_empty) {
+                data_allocator::construct(slots_ + i, rhs.slots_[i]);
+                dist_[i] = rhs.dist_[i];
+                ++size_;
+            }
+        }
+    } catch (...) {
+        destroy_table();
+        throw;
+    }
+}
+
+// destroy_table 函数，销毁所有元素并释放空间
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::destroy_table() {
+    if (slots_ != nullptr) {
+        clear();
+        data_allocator::deallocate(slots_, slot_count_);
+        dist_allocator::deallocate(dist_, slot_count_ + 1);
+    }
+    slots_ = nullptr;
+    dist_ = empty_dist();
+    bucket_size_ = 0;
+    max_probe_ = 0;
+    slot_count_ = 0;
+    size_ = 0;
+}
+
+// find_index 函数，找不到时返回 slot_count_
+// 探测到的位置的探测距离比当前距离短时，说明键值不存在，可以提前结束
+template <class T, class Hash, class KeyEqual>
+typename flat_hashtable<T, Hash, KeyEqual>::size_type
+flat_hashtable<T, Hash, KeyEqual>::find_index(const key_type& key) const {
+    if (size_ == 0)
+        return slot_count_;
+    size_type n = home(hash_(key));
+    for (size_type d = 1; dist_[n] >= d; ++n, ++d) {
+        if (dist_[n] == d && is_equal(value_traits::get_key(slots_[n]), key))
+            return n;
+    }
+    return slot_count_;
+}
+
+// insert_value_unique 函数
+template <class T, class Hash, class KeyEqual>
+template <class V>
+pair<typename flat_hashtable<T, Hash, KeyEqual>::iterator, bool>
+flat_hashtable<T, Hash, KeyEqual>::insert_value_unique(V&& value) {
+    const key_type& key = value_traits::get_key(value);
+    const size_type pos = find_index(key);
+    if (pos != slot_count_)
+        return mystl::make_pair(M_it(pos), false);
+    const size_type code = hash_(key);
+    rehash_if_need(1);
+    return mystl::make_pair(
+        M_it(insert_value_grow(code, mystl::forward<V>(value))), true);
+}
+
+// find_insert_pos 函数
+// 找到新元素应该放入的位置：第一个空位，或者第一个探测距离比新元素短的位置，
+// d 返回新元素在该位置的探测距离（加一）。超出探测上限时返回 slot_count_
+template <class T, class Hash, class KeyEqual>
+typename flat_hashtable<T, Hash, KeyEqual>::size_type
+flat_hashtable<T, Hash, KeyEqual>::find_insert_pos(size_type code,
+                                                   size_type& d) const {
+    size_type n = home(code);
+    for (d = 1; dist_[n] >= d; ++n, ++d) {
+    }
+    if (d > max_probe_)
+        return slot_count_;
+    // 从 n 开始到下一个空位的元素都要后移一位，不能超出探测上限
+    for (size_type e = n; dist_[e] != fht_empty; ++e) {
+        if (dist_[e] >= max_probe_)
+            return slot_count_;
+    }
+    return n;
+}
+
+// insert_value_noresize 函数
+// 把元素插入到表中，超出探测上限时不插入并返回 slot_count_
+template <class T, class Hash, class KeyEqual>
+template <class V>
+typename flat_hashtable<T, Hash, KeyEqual>::size_type
+flat_hashtable<T, Hash, KeyEqual>::insert_value_noresize(size_type code,
+                                                         V&& value) {
+    size_type d = 0;
+    const size_type pos = find_insert_pos(code, d);
+    if (pos == slot_count_)
+        return slot_count_;
+    // 把 [pos, e) 整体后移一位，空出 pos
+    size_type e = pos;
+    while (dist_[e] != fht_empty)
+        ++e;
+    for (; e != pos; --e) {
+        data_allocator::construct(slots_ + e, mystl::move(slots_[e - 1]));
+        data_allocator::destroy(slots_ + e - 1);
+        dist_[e] = static_cast<unsigned char>(dist_[e - 1] + 1);
+        dist_[e - 1] = fht_empty;
+    }
+    try {
+        data_allocator::construct(slots_ + pos, mystl::forward<V>(value));
+    } catch (...) {
+        backward_shift(pos);  // 把后移的元素移回原处
+        throw;
+    }
+    dist_[pos] = static_cast<unsigned char>(d);
+    ++size_;
+    return pos;
+}
+
+// insert_value_grow 函数
+// 把元素插入到表中，超出探测上限时扩大表格后重试
+template <class T, class Hash, class KeyEqual>
+template <class V>
+typename flat_hashtable<T, Hash, KeyEqual>::size_type
+flat_hashtable<T, Hash, KeyEqual>::insert_value_grow(size_type code,
+                                                     V&& value) {
+    for (;;) {
+        const size_type pos =
+            insert_value_noresize(code, mystl::forward<V>(value));
+        if (pos != slot_count_)
+            return pos;
+        grow();
+    }
+}
+
+// rehash_if_need 函数
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::rehash_if_need(size_type n) {
+    if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
+        rehash(mystl::max(
+            bucket_size_ * 2,
+            static_cast<size_type>((float)(size_ + n) / max_load_factor()) + 1));
+}
+
+// grow 函数，探测距离超出上限时调用
+// 负载较高时把起始位置的个数扩大一倍；负载很低时说明哈希值聚集，放宽探测上限
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::grow() {
+    if (size_ * 8 < bucket_size_) {
+        THROW_LENGTH_ERROR_IF(max_probe_ >= fht_probe_limit,
+                              "flat_hashtable's hash values are too clustered");
+        rehash_to(bucket_size_, mystl::min(max_probe_ * 2, fht_probe_limit));
+    } else {
+        const auto n = ht_next_pow2(bucket_size_ * 2);
+        rehash_to(n, mystl::max(fht_max_probe(n), max_probe_));
+    }
+}
+
+// rehash_to 函数，把所有元素移动到新的表格中
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::rehash_to(size_type bucket_count,
+                                                  size_type max_probe) {
+    flat_hashtable tmp(0, hash_, equal_);
+    tmp.mlf_ = mlf_;
+    tmp.init(bucket_count, max_probe);
+    for (size_type i = 0; i < slot_count_; ++i) {
+        if (dist_[i] != fht_empty) {
+            tmp.insert_value_grow(hash_(value_traits::get_key(slots_[i])),
+                                  mystl::move(slots_[i]));
+        }
+    }
+    swap(tmp);
+}
+
+// copy_insert
+template <class T, class Hash, class KeyEqual>
+template <class InputIter>
+void flat_hashtable<T, Hash, KeyEqual>::copy_insert_unique(
+    InputIter first,
+    InputIter last,
+    mystl::input_iterator_tag) {
+    for (; first != last; ++first)
+        insert_unique(*first);
+}
+
+template <class T, class Hash, class KeyEqual>
+template <class ForwardIter>
+void flat_hashtable<T, Hash, KeyEqual>::copy_insert_unique(
+    ForwardIter first,
+    ForwardIter last,
+    mystl::forward_iterator_tag) {
+    size_type n = mystl::distance(first, last);
+    rehash_if_need(n);
+    for (; n > 0; --n, ++first)
+        insert_unique(*first);
+}
+
+// erase_at 函数，销毁位置 n 的元素，再把后面的元素前移
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::erase_at(size_type n) {
+    data_allocator::destroy(slots_ + n);
+    backward_shift(n);
+    --size_;
+}
+
+// backward_shift 函数
+// 位置 n 已经空出，把后面探测距离大于 1 的元素逐个前移一位
+template <class T, class Hash, class KeyEqual>
+void flat_hashtable<T, Hash, KeyEqual>::backward_shift(size_type n) {
+    for (; dist_[n + 1] > 1 && dist_[n + 1] != fht_sentinel; ++n) {
+        data_allocator::construct(slots_ + n, mystl::move(slots_[n + 1]));
+        data_allocator::destroy(slots_ + n + 1);
+        dist_[n] = static_cast<unsigned char>(dist_[n + 1] - 1);
+    }
+    dist_[n] = fht_empty;
+}
+
+// 重载 mystl 的 swap
+template <class T, class Hash, class KeyEqual>
+void swap(flat_hashtable<T, Hash, KeyEqual>& lhs,
+          flat_hashtable<T, Hash, KeyEqual>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_FLAT_HASHTABLE_H_
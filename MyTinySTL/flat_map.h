@@ -0,0 +1,534 @@
+#ifndef MYTINYSTL_FLAT_MAP_H_
+#define MYTINYSTL_FLAT_MAP_H_
+
+// 这个头文件包含两个模板类 flat_map 和 flat_multimap
+// flat_map      : 有序映射，功能与用法与 map 类似，键值不允许重复
+// flat_multimap : 有序映射，功能与用法与 multimap 类似，键值允许重复
+// 二者使用 flat_table 作为底层实现机制，键值与实值分别存放在两个有序的 vector 中，
+// 适合构造后以查找、遍历为主的场景
+
+// notes:
+//
+// 与 map 的区别：
+//   * value_type 为 pair<Key, T>，迭代器解引用得到 pair<const Key&, T&>
+//   * 插入、删除为 O(n)，会使插入/删除位置之后的迭代器、指针、引用失效
+//   * 区间构造与区间插入先整体排序再归并，键值重复时保留最先出现的元素
+//   * 不接受分配器参数
+//
+// 异常保证：
+// mystl::flat_map<Key, T> / mystl::flat_multimap<Key, T> 满足基本异常保证
+
+#include "flat_table.h"
+
+namespace mystl {
+
+// 模板类 flat_map，键值不允许重复
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
+template <class Key, class T, class Compare = mystl::less<Key>>
+class flat_map {
+private:
+    // 以 mystl::flat_table 作为底层机制
+    typedef mystl::flat_table<Key, T, Compare> base_type;
+    base_type table_;
+
+public:
+    // 使用 flat_table 的型别
+    typedef typename base_type::key_type key_type;
+    typedef typename base_type::mapped_type mapped_type;
+    typedef typename base_type::value_type value_type;
+    typedef typename base_type::key_compare key_compare;
+    typedef typename base_type::key_container_type key_container_type;
+    typedef typename base_type::mapped_container_type mapped_container_type;
+
+    typedef typename base_type::pointer pointer;
+    typedef typename base_type::const_pointer const_pointer;
+    typedef typename base_type::reference reference;
+    typedef typename base_type::const_reference const_reference;
+    typedef typename base_type::iterator iterator;
+    typedef typename base_type::const_iterator const_iterator;
+    typedef typename base_type::reverse_iterator reverse_iterator;
+    typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::difference_type difference_type;
+
+    // 比较两个元素的键值
+    class value_compare {
+        friend class flat_map<Key, T, Compare>;
+
+    private:
+        Compare comp;
+        value_compare(Compare c) : comp(c) {}
+
+    public:
+        bool operator()(const const_reference& lhs,
+                        const const_reference& rhs) const {
+            return comp(lhs.first, rhs.first);
+        }
+    };
+
+public:
+    // 构造、复制、移动、赋值函数
+
+    flat_map() = default;
+
+    explicit flat_map(const key_compare& comp) : table_(comp) {}
+
+    // [first, last) 不需要有序
+    template <class InputIterator>
+    flat_map(InputIterator first,
+             InputIterator last,
+             const key_compare& comp = key_compare())
+        : table_(comp) {
+        table_.insert_unique(first, last);
+    }
+
+    flat_map(std::initializer_list<value_type> ilist,
+             const key_compare& comp = key_compare())
+        : table_(comp) {
+        table_.insert_unique(ilist.begin(), ilist.end());
+    }
+
+    flat_map(const flat_map& rhs) : table_(rhs.table_) {}
+    flat_map(flat_map&& rhs) noexcept : table_(mystl::move(rhs.table_)) {}
+
+    flat_map& operator=(const flat_map& rhs) {
+        table_ = rhs.table_;
+        return *this;
+    }
+    flat_map& operator=(flat_map&& rhs) {
+        table_ = mystl::move(rhs.table_);
+        return *this;
+    }
+
+    flat_map& operator=(std::initializer_list<value_type> ilist) {
+        table_.clear();
+        table_.insert_unique(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return table_.key_comp(); }
+    value_compare value_comp() const { return value_compare(table_.key_comp()); }
+
+    // 有序的键值数组与实值数组
+    const key_container_type& keys() const noexcept { return table_.keys(); }
+    const mapped_container_type& values() const noexcept {
+        return table_.values();
+    }
+
+    // 迭代器相关
+
+    iterator begin() noexcept { return table_.begin(); }
+    const_iterator begin() const noexcept { return table_.begin(); }
+    iterator end() noexcept { return table_.end(); }
+    const_iterator end() const noexcept { return table_.end(); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+
+    bool empty() const noexcept { return table_.empty(); }
+    size_type size() const noexcept { return table_.size(); }
+    size_type max_size() const noexcept { return table_.max_size(); }
+    size_type capacity() const noexcept { return table_.capacity(); }
+
+    void reserve(size_type n) { table_.reserve(n); }
+    void shrink_to_fit() { table_.shrink_to_fit(); }
+
+    // 访问元素相关
+
+    // 若键值不存在，at 会抛出一个异常
+    mapped_type& at(const key_type& key) {
+        iterator it = find(key);
+        THROW_OUT_OF_RANGE_IF(it == end(),
+                              "flat_map<Key, T> no such element exists");
+        return it->second;
+    }
+    const mapped_type& at(const key_type& key) const {
+        const_iterator it = find(key);
+        THROW_OUT_OF_RANGE_IF(it == end(),
+                              "flat_map<Key, T> no such element exists");
+        return it->second;
+    }
+
+    mapped_type& operator[](const key_type& key) {
+        iterator it = lower_bound(key);
+        // it->first >= key
+        if (it == end() || key_comp()(key, it->first))
+            it = emplace_hint(it, key, T{});
+        return it->second;
+    }
+    mapped_type& operator[](key_type&& key) {
+        iterator it = lower_bound(key);
+        // it->first >= key
+        if (it == end() || key_comp()(key, it->first))
+            it = emplace_hint(it, mystl::move(key), T{});
+        return it->second;
+    }
+
+    // 插入删除相关
+
+    template <class... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return table_.emplace_unique(mystl::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return table_.emplace_unique_use_hint(hint,
+                                              mystl::forward<Args>(args)...);
+    }
+
+    pair<iterator, bool> insert(const value_type& value) {
+        return table_.emplace_unique(value);
+    }
+    pair<iterator, bool> insert(value_type&& value) {
+        return table_.emplace_unique(mystl::move(value));
+    }
+
+    iterator insert(const_iterator hint, const value_type& value) {
+        return table_.emplace_unique_use_hint(hint, value);
+    }
+    iterator insert(const_iterator hint, value_type&& value) {
+        return table_.emplace_unique_use_hint(hint, mystl::move(value));
+    }
+
+    // [first, last) 不需要有序，整体排序后一次归并
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        table_.insert_unique(first, last);
+    }
+
+    iterator erase(const_iterator position) { return table_.erase(position); }
+    size_type erase(const key_type& key) { return table_.erase_unique(key); }
+    iterator erase(const_iterator first, const_iterator last) {
+        return table_.erase(first, last);
+    }
+
+    void clear() noexcept { table_.clear(); }
+
+    // flat_map 相关操作
+
+    iterator find(const key_type& key) { return table_.find(key); }
+    const_iterator find(const key_type& key) const { return table_.find(key); }
+
+    size_type count(const key_type& key) const {
+        return table_.count_unique(key);
+    }
+
+    iterator lower_bound(const key_type& key) { return table_.lower_bound(key); }
+    const_iterator lower_bound(const key_type& key) const {
+        return table_.lower_bound(key);
+    }
+
+    iterator upper_bound(const key_type& key) { return table_.upper_bound(key); }
+    const_iterator upper_bound(const key_type& key) const {
+        return table_.upper_bound(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) {
+        return table_.equal_range_unique(key);
+    }
+    pair<const_iterator, const_iterator> equal_range(
+        const key_type& key) const {
+        return table_.equal_range_unique(key);
+    }
+
+    void swap(flat_map& rhs) noexcept { table_.swap(rhs.table_); }
+
+public:
+    friend bool operator==(const flat_map& lhs, const flat_map& rhs) {
+        return lhs.table_ == rhs.table_;
+    }
+    friend bool operator<(const flat_map& lhs, const flat_map& rhs) {
+        return lhs.table_ < rhs.table_;
+    }
+};
+
+// 重载比较操作符
+template <class Key, class T, class Compare>
+bool operator!=(const flat_map<Key, T, Compare>& lhs,
+                const flat_map<Key, T, Compare>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare>
+bool operator>(const flat_map<Key, T, Compare>& lhs,
+               const flat_map<Key, T, Compare>& rhs) {
+    return rhs < lhs;
+}
+
+template <class Key, class T, class Compare>
+bool operator<=(const flat_map<Key, T, Compare>& lhs,
+                const flat_map<Key, T, Compare>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare>
+bool operator>=(const flat_map<Key, T, Compare>& lhs,
+                const flat_map<Key, T, Compare>& rhs) {
+    return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Compare>
+void swap(flat_map<Key, T, Compare>& lhs,
+          flat_map<Key, T, Compare>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+
+// 模板类 flat_multimap，键值允许重复
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
+template <class Key, class T, class Compare = mystl::less<Key>>
+class flat_multimap {
+private:
+    // 以 mystl::flat_table 作为底层机制
+    typedef mystl::flat_table<Key, T, Compare> base_type;
+    base_type table_;
+
+public:
+    // 使用 flat_table 的型别
+    typedef typename base_type::key_type key_type;
+    typedef typename base_type::mapped_type mapped_type;
+    typedef typename base_type::value_type value_type;
+    typedef typename base_type::key_compare key_compare;
+    typedef typename base_type::key_container_type key_container_type;
+    typedef typename base_type::mapped_container_type mapped_container_type;
+
+    typedef typename base_type::pointer pointer;
+    typedef typename base_type::const_pointer const_pointer;
+    typedef typename base_type::reference reference;
+    typedef typename base_type::const_reference const_reference;
+    typedef typename base_type::iterator iterator;
+    typedef typename base_type::const_iterator const_iterator;
+    typedef typename base_type::reverse_iterator reverse_iterator;
+    typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename base_type::size_type size_type;
+    typedef typename base_type::difference_type difference_type;
+
+    // 比较两个元素的键值
+    class value_compare {
+        friend class flat_multimap<Key, T, Compare>;
+
+    private:
+        Compare comp;
+        value_compare(Compare c) : comp(c) {}
+
+    public:
+        bool operator()(const const_reference& lhs,
+                        const const_reference& rhs) const {
+            return comp(lhs.first, rhs.first);
+        }
+    };
+
+public:
+    // 构造、复制、移动、赋值函数
+
+    flat_multimap() = default;
+
+    explicit flat_multimap(const key_compare& comp) : table_(comp) {}
+
+    // [first, last) 不需要有序
+    template <class InputIterator>
+    flat_multimap(InputIterator first,
+                  InputIterator last,
+                  const key_compare& comp = key_compare())
+        : table_(comp) {
+        table_.insert_multi(first, last);
+    }
+
+    flat_multimap(std::initializer_list<value_type> ilist,
+                  const key_compare& comp = key_compare())
+        : table_(comp) {
+        table_.insert_multi(ilist.begin(), ilist.end());
+    }
+
+    flat_multimap(const flat_multimap& rhs) : table_(rhs.table_) {}
+    flat_multimap(flat_multimap&& rhs) noexcept
+        : table_(mystl::move(rhs.table_)) {}
+
+    flat_multimap& operator=(const flat_multimap& rhs) {
+        table_ = rhs.table_;
+        return *this;
+    }
+    flat_multimap& operator=(flat_multimap&& rhs) {
+        table_ = mystl::move(rhs.table_);
+        return *this;
+    }
+
+    flat_multimap& operator=(std::initializer_list<value_type> ilist) {
+        table_.clear();
+        table_.insert_multi(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return table_.key_comp(); }
+    value_compare value_comp() const { return value_compare(table_.key_comp()); }
+
+    // 有序的键值数组与实值数组
+    const key_container_type& keys() const noexcept { return table_.keys(); }
+    const mapped_container_type& values() const noexcept {
+        return table_.values();
+    }
+
+    // 迭代器相关
+
+    iterator begin() noexcept { return table_.begin(); }
+    const_iterator begin() const noexcept { return table_.begin(); }
+    iterator end() noexcept { return table_.end(); }
+    const_iterator end() const noexcept { return table_.end(); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+
+    bool empty() const noexcept { return table_.empty(); }
+    size_type size() const noexcept { return table_.size(); }
+    size_type max_size() const noexcept { return table_.max_size(); }
+    size_type capacity() const noexcept { return table_.capacity(); }
+
+    void reserve(size_type n) { table_.reserve(n); }
+    void shrink_to_fit() { table_.shrink_to_fit(); }
+
+    // 插入删除相关
+
+    template <class... Args>
+    iterator emplace(Args&&... args) {
+        return table_.emplace_multi(mystl::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return table_.emplace_multi_use_hint(hint,
+                                             mystl::forward<Args>(args)...);
+    }
+
+    iterator insert(const value_type& value) {
+        return table_.emplace_multi(value);
+    }
+    iterator insert(value_type&& value) {
+        return table_.emplace_multi(mystl::move(value));
+    }
+
+    iterator insert(const_iterator hint, const value_type& value) {
+        return table_.emplace_multi_use_hint(hint, value);
+    }
+    iterator insert(const_iterator hint, value_type&& value) {
+        return table_.emplace_multi_use_hint(hint, mystl::move(value));
+    }
+
+    // [first, last) 不需要有序，整体排序后一次归并
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last) {
+        table_.insert_multi(first, last);
+    }
+
+    iterator erase(const_iterator position) { return table_.erase(position); }
+    size_type erase(const key_type& key) { return table_.erase_multi(key); }
+    iterator erase(const_iterator first, const_iterator last) {
+        return table_.erase(first, last);
+    }
+
+    void clear() noexcept { table_.clear(); }
+
+    // flat_multimap 相关操作
+
+    iterator find(const key_type& key) { return table_.find(key); }
+    const_iterator find(const key_type& key) const { return table_.find(key); }
+
+    size_type count(const key_type& key) const {
+        return table_.count_multi(key);
+    }
+
+    iterator lower_bound(const key_type& key) { return table_.lower_bound(key); }
+    const_iterator lower_bound(const key_type& key) const {
+        return table_.lower_bound(key);
+    }
+
+    iterator upper_bound(const key_type& key) { return table_.upper_bound(key); }
+    const_iterator upper_bound(const key_type& key) const {
+        return table_.upper_bound(key);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) {
+        return table_.equal_range_multi(key);
+    }
+    pair<const_iterator, const_iterator> equal_range(
+        const key_type& key) const {
+        return table_.equal_range_multi(key);
+    }
+
+    void swap(flat_multimap& rhs) noexcept { table_.swap(rhs.table_); }
+
+public:
+    friend bool operator==(const flat_multimap& lhs, const flat_multimap& rhs) {
+        return lhs.table_ == rhs.table_;
+    }
+    friend bool operator<(const flat_multimap& lhs, const flat_multimap& rhs) {
+        return lhs.table_ < rhs.table_;
+    }
+};
+
+// 重载比较操作符
+template <class Key, class T, class Compare>
+bool operator!=(const flat_multimap<Key, T, Compare>& lhs,
+                const flat_multimap<Key, T, Compare>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <class Key, class T, class Compare>
+bool operator>(const flat_multimap<Key, T, Compare>& lhs,
+               const flat_multimap<Key, T, Compare>& rhs) {
+    return rhs < lhs;
+}
+
+template <class Key, class T, class Compare>
+bool operator<=(const flat_multimap<Key, T, Compare>& lhs,
+                const flat_multimap<Key, T, Compare>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <class Key, class T, class Compare>
+bool operator>=(const flat_multimap<Key, T, Compare>& lhs,
+                const flat_multimap<Key, T, Compare>& rhs) {
+    return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class T, class Compare>
+void swap(flat_multimap<Key, T, Compare>& lhs,
+          flat_multimap<Key, T, Compare>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_FLAT_MAP_H_
@@ -0,0 +1,293 @@
+#ifndef MYTINYSTL_FLAT_SET_H_
+#define MYTINYSTL_FLAT_SET_H_
+
+// 这个头文件包含一个模板类 flat_set
+// flat_set : 有序集合，功能与用法与 set 类似，键值不允许重复
+// 元素存放在一个有序的 vector 中，适合构造后以查找、遍历为主的场景
+
+// notes:
+//
+// 与 set 的区别：
+//   * 插入、删除为 O(n)，会使插入/删除位置之后的迭代器、指针、引用失效
+//   * 区间构造与区间插入先整体排序再归并，键值重复时保留最先出现的元素
+//   * 不接受分配器参数
+//
+// 异常保证：
+// mystl::flat_set<Key> 满足基本异常保证
+
+#include <initializer_list>
+
+#include "algo.h"
+#include "functional.h"
+#include "vector.h"
+
+namespace mystl {
+
+// 模板类 flat_set，键值不允许重复
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less
+template <class Key, class Compare = mystl::less<Key>>
+class flat_set {
+public:
+    typedef Key key_type;
+    typedef Key value_type;
+    typedef Compare key_compare;
+    typedef Compare value_compare;
+    typedef mystl::vector<Key> container_type;
+
+    // 元素有序，迭代器不能写入
+    typedef const Key* pointer;
+    typedef const Key* const_pointer;
+    typedef const Key& reference;
+    typedef const Key& const_reference;
+    typedef const Key* iterator;
+    typedef const Key* const_iterator;
+    typedef mystl::reverse_iterator<iterator> reverse_iterator;
+    typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+private:
+    container_type keys_;  // 有序的键值
+    key_compare comp_;     // 键值比较的准则
+
+public:
+    // 构造、复制、移动函数
+
+    flat_set() = default;
+
+    explicit flat_set(const key_compare& comp) : keys_(), comp_(comp) {}
+
+    // [first, last) 不需要有序
+    template <class InputIterator>
+    flat_set(InputIterator first,
+             InputIterator last,
+             const key_compare& comp = key_compare())
+        : keys_(), comp_(comp) {
+        insert(first, last);
+    }
+
+    flat_set(std::initializer_list<value_type> ilist,
+             const key_compare& comp = key_compare())
+        : keys_(), comp_(comp) {
+        insert(ilist.begin(), ilist.end());
+    }
+
+    flat_set(const flat_set& rhs) = default;
+    flat_set(flat_set&& rhs) noexcept
+        : keys_(mystl::move(rhs.keys_)), comp_(rhs.comp_) {}
+
+    flat_set& operator=(const flat_set& rhs) = default;
+    flat_set& operator=(flat_set&& rhs) {
+        keys_ = mystl::move(rhs.keys_);
+        comp_ = rhs.comp_;
+        return *this;
+    }
+
+    flat_set& operator=(std::initializer_list<value_type> ilist) {
+        keys_.clear();
+        insert(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    // 相关接口
+
+    key_compare key_comp() const { return comp_; }
+    value_compare value_comp() const { return comp_; }
+
+    // 有序的键值数组
+    const container_type& keys() const noexcept { return keys_; }
+
+    // 迭代器相关
+
+    iterator begin() const noexcept { return keys_.data(); }
+    iterator end() const noexcept { return keys_.data() + keys_.size(); }
+
+    reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关
+
+    bool empty() const noexcept { return keys_.empty(); }
+    size_type size() const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept { return keys_.max_size(); }
+    size_type capacity() const noexcept { return keys_.capacity(); }
+
+    void reserve(size_type n) { keys_.reserve(n); }
+    void shrink_to_fit() { keys_.shrink_to_fit(); }
+
+    // 插入删除操作
+
+    template <class... Args>
+    pair<iterator, bool> emplace(Args&&... args) {
+        return insert(value_type(mystl::forward<Args>(args)...));
+    }
+
+    template <class... Args>
+    iterator emplace_hint(const_iterator hint, Args&&... args) {
+        return insert(hint, value_type(mystl::forward<Args>(args)...));
+    }
+
+    pair<iterator, bool> insert(const value_type& value) {
+        return insert(value_type(value));
+    }
+    pair<iterator, bool> insert(value_type&& value) {
+        auto it = lower_bound(value);
+        if (it != end() && !comp_(value, *it))
+            return mystl::make_pair(it, false);
+        return mystl::make_pair(insert_at(it, mystl::move(value)), true);
+    }
+
+    // hint 处正好是新元素的位置时不再查找，否则退化为普通的插入
+    iterator insert(const_iterator hint, const value_type& value) {
+        return insert(hint, value_type(value));
+    }
+    iterator insert(const_iterator hint, value_type&& value) {
+        if ((hint == begin() || comp_(*(hint - 1), value)) &&
+            (hint == end() || comp_(value, *hint)))
+            return insert_at(hint, mystl::move(value));
+        return insert(mystl::move(value)).first;
+    }
+
+    // [first, last) 不需要有序，整体排序后一次归并
+    template <class InputIterator>
+    void insert(InputIterator first, InputIterator last);
+
+    iterator erase(const_iterator position) {
+        return erase(position, position + 1);
+    }
+    size_type erase(const key_type& key) {
+        auto it = find(key);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        const auto i = first - begin();
+        keys_.erase(keys_.begin() + i, keys_.begin() + (last - begin()));
+        return begin() + i;
+    }
+
+    void clear() noexcept { keys_.clear(); }
+
+    // flat_set 相关操作
+
+    iterator find(const key_type& key) const {
+        auto it = lower_bound(key);
+        return (it == end() || comp_(key, *it)) ? end() : it;
+    }
+
+    size_type count(const key_type& key) const {
+        return find(key) != end() ? 1 : 0;
+    }
+
+    iterator lower_bound(const key_type& key) const {
+        return mystl::lower_bound(begin(), end(), key, comp_);
+    }
+
+    iterator upper_bound(const key_type& key) const {
+        return mystl::upper_bound(begin(), end(), key, comp_);
+    }
+
+    pair<iterator, iterator> equal_range(const key_type& key) const {
+        auto it = find(key);
+        return mystl::make_pair(it, it == end() ? it : it + 1);
+    }
+
+    void swap(flat_set& rhs) noexcept {
+        keys_.swap(rhs.keys_);
+        mystl::swap(comp_, rhs.comp_);
+    }
+
+public:
+    friend bool operator==(const flat_set& lhs, const flat_set& rhs) {
+        return lhs.keys_ == rhs.keys_;
+    }
+    friend bool operator<(const flat_set& lhs, const flat_set& rhs) {
+        return lhs.keys_ < rhs.keys_;
+    }
+
+private:
+    iterator insert_at(const_iterator pos, value_type&& value) {
+        const auto i = pos - begin();
+        keys_.insert(keys_.begin() + i, mystl::move(value));
+        return begin() + i;
+    }
+};
+
+// 区间插入：新元素稳定排序并去重后，与已有元素归并到新的数组中，键值相等时保留已有元素
+template <class Key, class Compare>
+template <class InputIterator>
+void flat_set<Key, Compare>::insert(InputIterator first, InputIterator last) {
+    container_type buf;
+    for (; first != last; ++first)
+        buf.emplace_back(*first);
+    if (buf.empty())
+        return;
+    mystl::stable_sort(buf.begin(), buf.end(), comp_);
+    const key_compare& comp = comp_;
+    buf.erase(mystl::unique(buf.begin(), buf.end(),
+                            [&comp](const Key& a, const Key& b) {
+                                return !comp(a, b);
+                            }),
+              buf.end());
+
+    const size_type n = keys_.size();
+    const size_type m = buf.size();
+    container_type keys;
+    keys.reserve(n + m);
+    size_type i = 0, j = 0;
+    while (i < n && j < m) {
+        if (comp_(buf[j], keys_[i])) {
+            keys.push_back(mystl::move(buf[j++]));
+        } else {
+            if (!comp_(keys_[i], buf[j]))
+                ++j;
+            keys.push_back(mystl::move(keys_[i++]));
+        }
+    }
+    for (; i < n; ++i)
+        keys.push_back(mystl::move(keys_[i]));
+    for (; j < m; ++j)
+        keys.push_back(mystl::move(buf[j]));
+    keys_.swap(keys);
+}
+
+// 重载比较操作符
+template <class Key, class Compare>
+bool operator!=(const flat_set<Key, Compare>& lhs,
+                const flat_set<Key, Compare>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <class Key, class Compare>
+bool operator>(const flat_set<Key, Compare>& lhs,
+               const flat_set<Key, Compare>& rhs) {
+    return rhs < lhs;
+}
+
+template <class Key, class Compare>
+bool operator<=(const flat_set<Key, Compare>& lhs,
+                const flat_set<Key, Compare>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <class Key, class Compare>
+bool operator>=(const flat_set<Key, Compare>& lhs,
+                const flat_set<Key, Compare>& rhs) {
+    return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class Key, class Compare>
+void swap(flat_set<Key, Compare>& lhs, flat_set<Key, Compare>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_FLAT_SET_H_
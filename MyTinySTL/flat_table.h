@@ -0,0 +1,471 @@
+#ifndef MYTINYSTL_FLAT_TABLE_H_
+#define MYTINYSTL_FLAT_TABLE_H_
+
+// 这个头文件包含一个模板类 flat_table
+// flat_table : 有序表，键值与实值分别存放在两个按键值有序的 vector 中，作为 flat_map 的底层实现
+
+// notes:
+//
+// 1. 第 i 个元素的键值为 keys_[i]，实值为 values_[i]；查找只访问键值数组，遍历时两个数组都是顺序访问
+// 2. 插入、删除需要移动插入位置之后的元素，复杂度为 O(n)，并使该位置之后的迭代器、指针、引用失效
+// 3. 区间插入先把新元素整体排序、去重，再与已有元素一次归并，复杂度为 O(m log m + n)
+// 4. 迭代器解引用得到 pair<const Key&, T&>，operator-> 返回一个保存这个 pair 的代理对象
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "algo.h"
+#include "exceptdef.h"
+#include "functional.h"
+#include "util.h"
+#include "vector.h"
+
+namespace mystl {
+
+// flat_table 的迭代器，同时指向键值数组与实值数组中的同一位置
+// 参数三为实值的引用类型，T& 为 iterator，const T& 为 const_iterator
+template <class Key, class T, class Ref>
+struct flat_table_iterator
+    : public mystl::iterator<mystl::random_access_iterator_tag,
+                             mystl::pair<Key, T>> {
+    typedef typename std::remove_reference<Ref>::type mapped_value;
+    typedef mystl::pair<const Key&, Ref> reference;
+    typedef ptrdiff_t difference_type;
+    typedef flat_table_iterator<Key, T, Ref> self;
+    typedef flat_table_iterator<Key, T, T&> iterator;
+
+    // operator-> 返回的代理对象
+    struct pointer {
+        reference ref;
+        reference* operator->() { return &ref; }
+    };
+
+    const Key* key;       // 指向键值
+    mapped_value* value;  // 指向实值
+
+    flat_table_iterator() noexcept : key(nullptr), value(nullptr) {}
+    flat_table_iterator(const Key* k, mapped_value* v) noexcept
+        : key(k), value(v) {}
+    // iterator 可以转换为 const_iterator；写成模板，iterator 自身仍使用隐式的复制构造与复制赋值
+    template <class R,
+              typename std::enable_if<std::is_same<R, T&>::value &&
+                                          !std::is_same<Ref, T&>::value,
+                                      int>::type = 0>
+    flat_table_iterator(const flat_table_iterator<Key, T, R>& rhs) noexcept
+        : key(rhs.key), value(rhs.value) {}
+
+    reference operator*() const { return reference(*key, *value); }
+    pointer operator->() const { return pointer{operator*()}; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    self& operator++() {
+        ++key, ++value;
+        return *this;
+    }
+    self operator++(int) {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    self& operator--() {
+        --key, --value;
+        return *this;
+    }
+    self operator--(int) {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    self& operator+=(difference_type n) {
+        key += n, value += n;
+        return *this;
+    }
+    self& operator-=(difference_type n) { return *this += -n; }
+    self operator+(difference_type n) const {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self operator-(difference_type n) const {
+        self tmp = *this;
+        return tmp -= n;
+    }
+    friend self operator+(difference_type n, const self& x) { return x + n; }
+    difference_type operator-(const self& rhs) const { return key - rhs.key; }
+
+    bool operator==(const self& rhs) const { return key == rhs.key; }
+    bool operator!=(const self& rhs) const { return key != rhs.key; }
+    bool operator<(const self& rhs) const { return key < rhs.key; }
+    bool operator>(const self& rhs) const { return rhs < *this; }
+    bool operator<=(const self& rhs) const { return !(rhs < *this); }
+    bool operator>=(const self& rhs) const { return !(*this < rhs); }
+};
+
+// 模板类 flat_table
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式
+template <class Key, class T, class Compare>
+class flat_table {
+public:
+    // flat_table 的型别定义
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef mystl::pair<Key, T> value_type;
+    typedef Compare key_compare;
+
+    typedef mystl::vector<Key> key_container_type;
+    typedef mystl::vector<T> mapped_container_type;
+
+    typedef flat_table_iterator<Key, T, T&> iterator;
+    typedef flat_table_iterator<Key, T, const T&> const_iterator;
+    typedef mystl::reverse_iterator<iterator> reverse_iterator;
+    typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    typedef typename iterator::reference reference;
+    typedef typename const_iterator::reference const_reference;
+    typedef typename iterator::pointer pointer;
+    typedef typename const_iterator::pointer const_pointer;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+private:
+    // 用以下三个数据表现 flat_table
+    key_container_type keys_;       // 有序的键值
+    mapped_container_type values_;  // 与键值一一对应的实值
+    key_compare comp_;              // 键值比较的准则
+
+public:
+    // 构造、复制、移动函数
+
+    flat_table() = default;
+    explicit flat_table(const key_compare& comp) : keys_(), values_(), comp_(comp) {}
+
+    flat_table(const flat_table& rhs) = default;
+    flat_table(flat_table&& rhs) noexcept
+        : keys_(mystl::move(rhs.keys_)),
+          values_(mystl::move(rhs.values_)),
+          comp_(rhs.comp_) {}
+
+    flat_table& operator=(const flat_table& rhs) = default;
+    flat_table& operator=(flat_table&& rhs) {
+        keys_ = mystl::move(rhs.keys_);
+        values_ = mystl::move(rhs.values_);
+        comp_ = rhs.comp_;
+        return *this;
+    }
+
+    key_compare key_comp() const { return comp_; }
+
+    const key_container_type& keys() const noexcept { return keys_; }
+    const mapped_container_type& values() const noexcept { return values_; }
+
+    // 迭代器相关操作
+
+    iterator begin() noexcept { return iterator(keys_.data(), values_.data()); }
+    const_iterator begin() const noexcept {
+        return const_iterator(keys_.data(), values_.data());
+    }
+    iterator end() noexcept { return begin() + keys_.size(); }
+    const_iterator end() const noexcept { return begin() + keys_.size(); }
+
+    // 容量相关操作
+
+    bool empty() const noexcept { return keys_.empty(); }
+    size_type size() const noexcept { return keys_.size(); }
+    size_type max_size() const noexcept {
+        return mystl::min(keys_.max_size(), values_.max_size());
+    }
+    size_type capacity() const noexcept { return keys_.capacity(); }
+
+    void reserve(size_type n) {
+        keys_.reserve(n);
+        values_.reserve(n);
+    }
+    void shrink_to_fit() {
+        keys_.shrink_to_fit();
+        values_.shrink_to_fit();
+    }
+
+    // 插入删除操作
+
+    template <class... Args>
+    iterator emplace_multi(Args&&... args);
+    template <class... Args>
+    mystl::pair<iterator, bool> emplace_unique(Args&&... args);
+
+    template <class... Args>
+    iterator emplace_multi_use_hint(const_iterator hint, Args&&... args);
+    template <class... Args>
+    iterator emplace_unique_use_hint(const_iterator hint, Args&&... args);
+
+    template <class InputIter>
+    void insert_multi(InputIter first, InputIter last) {
+        insert_range(first, last, false);
+    }
+    template <class InputIter>
+    void insert_unique(InputIter first, InputIter last) {
+        insert_range(first, last, true);
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last);
+
+    size_type erase_multi(const key_type& key);
+    size_type erase_unique(const key_type& key);
+
+    void clear() noexcept {
+        keys_.clear();
+        values_.clear();
+    }
+
+    // 查找相关操作
+
+    iterator find(const key_type& key) { return begin() + find_index(key); }
+    const_iterator find(const key_type& key) const {
+        return begin() + find_index(key);
+    }
+
+    size_type count_multi(const key_type& key) const {
+        auto p = equal_range_multi(key);
+        return static_cast<size_type>(p.second - p.first);
+    }
+    size_type count_unique(const key_type& key) const {
+        return find_index(key) != size() ? 1 : 0;
+    }
+
+    iterator lower_bound(const key_type& key) {
+        return begin() + lower_index(key);
+    }
+    const_iterator lower_bound(const key_type& key) const {
+        return begin() + lower_index(key);
+    }
+
+    iterator upper_bound(const key_type& key) {
+        return begin() + upper_index(key);
+    }
+    const_iterator upper_bound(const key_type& key) const {
+        return begin() + upper_index(key);
+    }
+
+    mystl::pair<iterator, iterator> equal_range_multi(const key_type& key) {
+        return mystl::pair<iterator, iterator>(lower_bound(key),
+                                               upper_bound(key));
+    }
+    mystl::pair<const_iterator, const_iterator> equal_range_multi(
+        const key_type& key) const {
+        return mystl::pair<const_iterator, const_iterator>(lower_bound(key),
+                                                           upper_bound(key));
+    }
+
+    mystl::pair<iterator, iterator> equal_range_unique(const key_type& key) {
+        auto it = find(key);
+        return mystl::pair<iterator, iterator>(it, it == end() ? it : it + 1);
+    }
+    mystl::pair<const_iterator, const_iterator> equal_range_unique(
+        const key_type& key) const {
+        auto it = find(key);
+        return mystl::pair<const_iterator, const_iterator>(
+            it, it == end() ? it : it + 1);
+    }
+
+    void swap(flat_table& rhs) noexcept {
+        keys_.swap(rhs.keys_);
+        values_.swap(rhs.values_);
+        mystl::swap(comp_, rhs.comp_);
+    }
+
+    // 比较操作
+
+    bool operator==(const flat_table& rhs) const {
+        return keys_ == rhs.keys_ && values_ == rhs.values_;
+    }
+    bool operator<(const flat_table& rhs) const {
+        return mystl::lexicographical_compare(begin(), end(), rhs.begin(),
+                                              rhs.end(), value_less);
+    }
+
+private:
+    // 查找的下标，找不到时为 size()
+    size_type lower_index(const key_type& key) const {
+        return static_cast<size_type>(
+            mystl::lower_bound(keys_.begin(), keys_.end(), key, comp_) -
+            keys_.begin());
+    }
+    size_type upper_index(const key_type& key) const {
+        return static_cast<size_type>(
+            mystl::upper_bound(keys_.begin(), keys_.end(), key, comp_) -
+            keys_.begin());
+    }
+    size_type find_index(const key_type& key) const {
+        const auto i = lower_index(key);
+        return (i == size() || comp_(key, keys_[i])) ? size() : i;
+    }
+
+    static bool value_less(const const_reference& lhs,
+                           const const_reference& rhs) {
+        return lhs < rhs;
+    }
+
+    iterator insert_at(size_type i, value_type&& value);
+
+    template <class InputIter>
+    void insert_range(InputIter first, InputIter last, bool unique);
+};
+
+/*****************************************************************************************/
+
+// 在下标 i 处插入一个元素，两个数组的插入中任一个失败时，保持两者的长度一致
+template <class Key, class T, class Compare>
+typename flat_table<Key, T, Compare>::iterator
+flat_table<Key, T, Compare>::insert_at(size_type i, value_type&& value) {
+    keys_.insert(keys_.begin() + i, mystl::move(value.first));
+    try {
+        values_.insert(values_.begin() + i, mystl::move(value.second));
+    } catch (...) {
+        keys_.erase(keys_.begin() + i);
+        throw;
+    }
+    return begin() + i;
+}
+
+// 就地构造元素并插入，允许键值重复，新元素放在相等元素之后
+template <class Key, class T, class Compare>
+template <class... Args>
+typename flat_table<Key, T, Compare>::iterator
+flat_table<Key, T, Compare>::emplace_multi(Args&&... args) {
+    value_type value(mystl::forward<Args>(args)...);
+    return insert_at(upper_index(value.first), mystl::move(value));
+}
+
+// 就地构造元素并插入，键值不允许重复
+template <class Key, class T, class Compare>
+template <class... Args>
+mystl::pair<typename flat_table<Key, T, Compare>::iterator, bool>
+flat_table<Key, T, Compare>::emplace_unique(Args&&... args) {
+    value_type value(mystl::forward<Args>(args)...);
+    const auto i = lower_index(value.first);
+    if (i != size() && !comp_(value.first, keys_[i]))
+        return mystl::make_pair(begin() + i, false);
+    return mystl::make_pair(insert_at(i, mystl::move(value)), true);
+}
+
+// 使用 hint 插入：hint 处正好是新元素的位置时不再查找，否则退化为普通的插入
+template <class Key, class T, class Compare>
+template <class... Args>
+typename flat_table<Key, T, Compare>::iterator
+flat_table<Key, T, Compare>::emplace_multi_use_hint(const_iterator hint,
+                                                    Args&&... args) {
+    value_type value(mystl::forward<Args>(args)...);
+    const auto i = static_cast<size_type>(hint - begin());
+    if ((i == 0 || !comp_(value.first, keys_[i - 1])) &&
+        (i == size() || !comp_(keys_[i], value.first)))
+        return insert_at(i, mystl::move(value));
+    return insert_at(upper_index(value.first), mystl::move(value));
+}
+
+template <class Key, class T, class Compare>
+template <class... Args>
+typename flat_table<Key, T, Compare>::iterator
+flat_table<Key, T, Compare>::emplace_unique_use_hint(const_iterator hint,
+                                                     Args&&... args) {
+    value_type value(mystl::forward<Args>(args)...);
+    auto i = static_cast<size_type>(hint - begin());
+    if (!((i == 0 || comp_(keys_[i - 1], value.first)) &&
+          (i == size() || comp_(value.first, keys_[i])))) {
+        i = lower_index(value.first);
+        if (i != size() && !comp_(value.first, keys_[i]))
+            return begin() + i;
+    }
+    return insert_at(i, mystl::move(value));
+}
+
+// 删除 [first, last) 内的元素
+template <class Key, class T, class Compare>
+typename flat_table<Key, T, Compare>::iterator
+flat_table<Key, T, Compare>::erase(const_iterator first, const_iterator last) {
+    const auto i = static_cast<size_type>(first - begin());
+    const auto j = static_cast<size_type>(last - begin());
+    keys_.erase(keys_.begin() + i, keys_.begin() + j);
+    values_.erase(values_.begin() + i, values_.begin() + j);
+    return begin() + i;
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <class Key, class T, class Compare>
+typename flat_table<Key, T, Compare>::size_type
+flat_table<Key, T, Compare>::erase_multi(const key_type& key) {
+    auto p = equal_range_multi(key);
+    const auto n = static_cast<size_type>(p.second - p.first);
+    erase(p.first, p.second);
+    return n;
+}
+
+template <class Key, class T, class Compare>
+typename flat_table<Key, T, Compare>::size_type
+flat_table<Key, T, Compare>::erase_unique(const key_type& key) {
+    const auto i = find_index(key);
+    if (i == size())
+        return 0;
+    erase(begin() + i);
+    return 1;
+}
+
+// 区间插入：把新元素整体按键值稳定排序，unique 时去掉重复的键值，只保留最先出现的一个，
+// 再与已有元素归并到新的数组中。键值相等时已有元素在前，unique 时丢弃新元素
+template <class Key, class T, class Compare>
+template <class InputIter>
+void flat_table<Key, T, Compare>::insert_range(InputIter first,
+                                               InputIter last,
+                                               bool unique) {
+    mystl::vector<value_type> buf;
+    for (; first != last; ++first)
+        buf.emplace_back(*first);
+    if (buf.empty())
+        return;
+    const key_compare& comp = comp_;
+    mystl::stable_sort(buf.begin(), buf.end(),
+                       [&comp](const value_type& a, const value_type& b) {
+                           return comp(a.first, b.first);
+                       });
+    if (unique) {
+        buf.erase(mystl::unique(buf.begin(), buf.end(),
+                                [&comp](const value_type& a,
+                                        const value_type& b) {
+                                    return !comp(a.first, b.first);
+                                }),
+                  buf.end());
+    }
+
+    const size_type n = keys_.size();
+    const size_type m = buf.size();
+    key_container_type keys;
+    mapped_container_type values;
+    keys.reserve(n + m);
+    values.reserve(n + m);
+    size_type i = 0, j = 0;
+    while (i < n && j < m) {
+        if (comp_(buf[j].first, keys_[i])) {
+            keys.push_back(mystl::move(buf[j].first));
+            values.push_back(mystl::move(buf[j].second));
+            ++j;
+        } else {
+            if (unique && !comp_(keys_[i], buf[j].first))
+                ++j;
+            keys.push_back(mystl::move(keys_[i]));
+            values.push_back(mystl::move(values_[i]));
+            ++i;
+        }
+    }
+    for (; i < n; ++i) {
+        keys.push_back(mystl::move(keys_[i]));
+        values.push_back(mystl::move(values_[i]));
+    }
+    for (; j < m; ++j) {
+        keys.push_back(mystl::move(buf[j].first));
+        values.push_back(mystl::move(buf[j].second));
+    }
+    keys_.swap(keys);
+    values_.swap(values);
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_FLAT_TABLE_H_
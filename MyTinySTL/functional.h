@@ -2,7 +2,15 @@
 #define MYTINYSTL_FUNCTIONAL_H_
 
 // 这个头文件包含了mystl函数对象和哈希函数
+#include <cfloat>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#include "type_traits.h"
 
 namespace mystl {
 
@@ -233,28 +241,114 @@ MYSTL_TRIVIAL_HASH_FCN(unsigned long long)
 
 #undef MYSTL_TRIVIAL_HASH_FCN
 
-// 对于浮点数，逐位哈希，对浮点数的每一位都进行哈希操作
-// 哈希是一种将任意长度的消息压缩到某一固定长度的消息摘要的函数。
-inline size_t bitwise_hash(const unsigned char* first, size_t count) {
-#if (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) && __SIZEOF_POINTER__ == 8)
-    const size_t fnv_offset = 14695981039346656037ull;
-    const size_t fnv_prime = 1099511628211ull;
+// 字节序列的哈希函数，算法取自 wyhash
+// 每一步读入 8 / 16 个字节，用一次 64 位乘法得到 128 位乘积，再把高低两半异或混合；
+// 长输入使用三条互不依赖的链同时处理，每轮 48 个字节，便于处理器并行执行乘法
+// 字符串、浮点数的哈希都通过它计算，结果与平台字节序有关
+
+// 64 位乘法，a、b 分别返回 128 位乘积的低 64 位与高 64 位
+inline void bitwise_hash_mum(uint64_t& a, uint64_t& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    a = _umul128(a, b, &b);
 #else
-    const size_t fnv_offset = 2166136261u;
-    const size_t fnv_prime = 16777619u;
+    const uint64_t ha = a >> 32, hb = b >> 32;
+    const uint64_t la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    const uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
 #endif
-    size_t result = fnv_offset;
-    for (size_t i = 0; i < count; ++i) {
-        // 对每个字节进行异或操作，然后乘以一个质数
-        result ^= (size_t)first[i];
-        result *= fnv_prime;
+}
+
+inline uint64_t bitwise_hash_mix(uint64_t a, uint64_t b) noexcept {
+    bitwise_hash_mum(a, b);
+    return a ^ b;
+}
+
+inline uint64_t bitwise_hash_read8(const unsigned char* p) noexcept {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t bitwise_hash_read4(const unsigned char* p) noexcept {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+// 读入 1 ~ 3 个字节
+inline uint64_t bitwise_hash_read3(const unsigned char* p, size_t k) noexcept {
+    return (static_cast<uint64_t>(p[0]) << 16) |
+           (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+
+inline size_t bitwise_hash(const unsigned char* first,
+                           size_t count,
+                           uint64_t seed = 0) noexcept {
+    static constexpr uint64_t secret[4] = {
+        0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+        0x4d5a2da51de1aa47ull};
+    const unsigned char* p = first;
+    seed ^= bitwise_hash_mix(seed ^ secret[0], secret[1]);
+    uint64_t a, b;
+    if (count <= 16) {
+        if (count >= 4) {
+            // 4 ~ 16 个字节：读入首尾各两个可能重叠的 4 字节
+            const size_t off = (count >> 3) << 2;
+            a = (bitwise_hash_read4(p) << 32) | bitwise_hash_read4(p + off);
+            b = (bitwise_hash_read4(p + count - 4) << 32) |
+                bitwise_hash_read4(p + count - 4 - off);
+        } else if (count > 0) {
+            a = bitwise_hash_read3(p, count);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = count;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = bitwise_hash_mix(bitwise_hash_read8(p) ^ secret[1],
+                                        bitwise_hash_read8(p + 8) ^ seed);
+                see1 = bitwise_hash_mix(bitwise_hash_read8(p + 16) ^ secret[2],
+                                        bitwise_hash_read8(p + 24) ^ see1);
+                see2 = bitwise_hash_mix(bitwise_hash_read8(p + 32) ^ secret[3],
+                                        bitwise_hash_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = bitwise_hash_mix(bitwise_hash_read8(p) ^ secret[1],
+                                    bitwise_hash_read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        // 最后 16 个字节，可能与已处理的部分重叠
+        a = bitwise_hash_read8(p + i - 16);
+        b = bitwise_hash_read8(p + i - 8);
     }
-    return result;
+    a ^= secret[1];
+    b ^= seed;
+    bitwise_hash_mum(a, b);
+    return static_cast<size_t>(
+        bitwise_hash_mix(a ^ secret[0] ^ count, b ^ secret[1]));
 }
 
+// 对于浮点数，逐位哈希；+0.0 与 -0.0 相等，哈希值都为 0
 template <>
 struct hash<float> {
-    size_t operator()(const float& val) {
+    size_t operator()(const float& val) const noexcept {
         return val == 0.0f
                    ? 0
                    : bitwise_hash((const unsigned char*)&val, sizeof(float));
@@ -263,22 +357,38 @@ struct hash<float> {
 
 template <>
 struct hash<double> {
-    size_t operator()(const double& val) {
-        return val == 0.0f
+    size_t operator()(const double& val) const noexcept {
+        return val == 0.0
                    ? 0
                    : bitwise_hash((const unsigned char*)&val, sizeof(double));
     }
 };
 
+// x87 的 80 位 long double 按 12 或 16 字节存放，只对有效的 10 个字节做哈希，
+// 避免填充字节中的随机内容影响结果
 template <>
 struct hash<long double> {
-    size_t operator()(const long double& val) {
-        return val == 0.0f ? 0
+    size_t operator()(const long double& val) const noexcept {
+        return val == 0.0L ? 0
                            : bitwise_hash((const unsigned char*)&val,
-                                          sizeof(long double));
+                                          LDBL_MANT_DIG == 64
+                                              ? 10
+                                              : sizeof(long double));
     }
 };
 
+// 是否在 hashtable 的节点中缓存完整的哈希值
+// 缺省不缓存；对于计算代价较高的哈希函数（如字符串哈希）可以特化为 true，
+// 此时 hashtable 在迭代和 rehash 时直接使用缓存值，查找时先比较哈希值再比较键值
+template <class Hash>
+struct cache_hash_code : public mystl::m_false_type {};
+
+// hashtable 的 bucket 数量是否取 2 的幂次
+// 缺省使用质数个 bucket，用取模定位；特化为 true 时 bucket 数量取 2 的幂次，
+// 哈希值经过混合函数后用位与定位，省去查找路径上的除法
+template <class Hash>
+struct pow2_bucket_count : public mystl::m_false_type {};
+
 }  // namespace mystl
 
 #endif  // !MYTINYSTL_FUNCTIONAL_H_
\ No newline at end of file
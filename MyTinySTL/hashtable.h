@@ -16,7 +16,8 @@
 namespace mystl {
 
 // hashtable 的节点定义
-template <class T>
+// 参数二表示是否在节点中缓存完整的哈希值，由 mystl::cache_hash_code 决定
+template <class T, bool CacheHash = false>
 struct hashtable_node {
     hashtable_node* next;  // 指向下一个节点
     T value;               // 储存实值
@@ -32,6 +33,26 @@ struct hashtable_node {
     }
 };
 
+// 缓存哈希值的节点
+template <class T>
+struct hashtable_node<T, true> {
+    hashtable_node* next;  // 指向下一个节点
+    size_t hash_code;      // 缓存的完整哈希值（未对 bucket 数取模）
+    T value;               // 储存实值
+
+    hashtable_node() = default;
+    hashtable_node(const T& n) : next(nullptr), hash_code(0), value(n) {}
+
+    hashtable_node(const hashtable_node& node)
+        : next(node.next), hash_code(node.hash_code), value(node.value) {}
+    hashtable_node(hashtable_node&& node)
+        : next(node.next),
+          hash_code(node.hash_code),
+          value(mystl::move(node.value)) {
+        node.next = nullptr;
+    }
+};
+
 // value traits
 // ht_value_traits_imp可以看作是ht_value_traits的默认实现。
 // 在使用哈希表时，如果用户没有提供自定义的 ht_value_traits 类型，那么就会使用
@@ -93,31 +114,34 @@ struct ht_value_traits {
 
 // forward declaration
 
-template <class T, class HashFun, class KeyEqual>
+template <class T,
+          class HashFun,
+          class KeyEqual,
+          class Alloc = mystl::allocator<T>>
 class hashtable;
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc>
 struct ht_iterator;
 
-template <class T, class HashFun, class KeyEqual>
+template <class T, class HashFun, class KeyEqual, class Alloc>
 struct ht_const_iterator;
 
-template <class T>
+template <class T, bool CacheHash>
 struct ht_local_iterator;
 
-template <class T>
+template <class T, bool CacheHash>
 struct ht_const_local_iterator;
 
 // ht_iterator
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 struct ht_iterator_base
     : public mystl::iterator<mystl::forward_iterator_tag, T> {
-    typedef mystl::hashtable<T, Hash, KeyEqual> hashtable;
-    typedef ht_iterator_base<T, Hash, KeyEqual> base;
-    typedef mystl::ht_iterator<T, Hash, KeyEqual> iterator;
-    typedef mystl::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
-    typedef hashtable_node<T>* node_ptr;
+    typedef mystl::hashtable<T, Hash, KeyEqual, Alloc> hashtable;
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc> base;
+    typedef mystl::ht_iterator<T, Hash, KeyEqual, Alloc> iterator;
+    typedef mystl::ht_const_iterator<T, Hash, KeyEqual, Alloc> const_iterator;
+    typedef hashtable_node<T, mystl::cache_hash_code<Hash>::value>* node_ptr;
     typedef hashtable* contain_ptr;
     typedef const node_ptr const_node_ptr;
     typedef const contain_ptr const_contain_ptr;
@@ -134,9 +158,9 @@ struct ht_iterator_base
     bool operator!=(const base& rhs) const { return node != rhs.node; }
 };
 
-template <class T, class Hash, class KeyEqual>
-struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual> {
-    typedef ht_iterator_base<T, Hash, KeyEqual> base;
+template <class T, class Hash, class KeyEqual, class Alloc>
+struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual, Alloc> {
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc> base;
     typedef typename base::hashtable hashtable;
     typedef typename base::iterator iterator;
     typedef typename base::const_iterator const_iterator;
@@ -189,7 +213,7 @@ struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual> {
         node = node->next;
         if (node ==
             nullptr) {  // 如果下一个位置为空，跳到下一个 bucket 的起始处
-            auto index = ht->hash(value_traits::get_key(old->value));
+            auto index = ht->node_bucket(old);
             while (!node && ++index < ht->bucket_size_)
                 node = ht->buckets_[index];
         }
@@ -202,9 +226,9 @@ struct ht_iterator : public ht_iterator_base<T, Hash, KeyEqual> {
     }
 };
 
-template <class T, class Hash, class KeyEqual>
-struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual> {
-    typedef ht_iterator_base<T, Hash, KeyEqual> base;
+template <class T, class Hash, class KeyEqual, class Alloc>
+struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual, Alloc> {
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc> base;
     typedef typename base::hashtable hashtable;
     typedef typename base::iterator iterator;
     typedef typename base::const_iterator const_iterator;
@@ -257,7 +281,7 @@ struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual> {
         node = node->next;
         if (node ==
             nullptr) {  // 如果下一个位置为空，跳到下一个 bucket 的起始处
-            auto index = ht->hash(value_traits::get_key(old->value));
+            auto index = ht->node_bucket(old);
             while (!node && ++index < ht->bucket_size_) {
                 node = ht->buckets_[index];
             }
@@ -272,7 +296,7 @@ struct ht_const_iterator : public ht_iterator_base<T, Hash, KeyEqual> {
 };
 
 // local iterator
-template <class T>
+template <class T, bool CacheHash>
 struct ht_local_iterator
     : public mystl::iterator<mystl::forward_iterator_tag, T> {
     typedef T value_type;
@@ -280,11 +304,11 @@ struct ht_local_iterator
     typedef value_type& reference;
     typedef size_t size_type;
     typedef ptrdiff_t difference_type;
-    typedef hashtable_node<T>* node_ptr;
+    typedef hashtable_node<T, CacheHash>* node_ptr;
 
-    typedef ht_local_iterator<T> self;
-    typedef ht_local_iterator<T> local_iterator;
-    typedef ht_const_local_iterator<T> const_local_iterator;
+    typedef ht_local_iterator<T, CacheHash> self;
+    typedef ht_local_iterator<T, CacheHash> local_iterator;
+    typedef ht_const_local_iterator<T, CacheHash> const_local_iterator;
     node_ptr node;
 
     ht_local_iterator(node_ptr n) : node(n) {}
@@ -310,7 +334,7 @@ struct ht_local_iterator
     bool operator!=(const self& other) const { return node != other.node; }
 };
 
-template <class T>
+template <class T, bool CacheHash>
 struct ht_const_local_iterator
     : public mystl::iterator<mystl::forward_iterator_tag, T> {
     typedef T value_type;
@@ -318,11 +342,11 @@ struct ht_const_local_iterator
     typedef const value_type& reference;
     typedef size_t size_type;
     typedef ptrdiff_t difference_type;
-    typedef const hashtable_node<T>* node_ptr;
+    typedef const hashtable_node<T, CacheHash>* node_ptr;
 
-    typedef ht_const_local_iterator<T> self;
-    typedef ht_local_iterator<T> local_iterator;
-    typedef ht_const_local_iterator<T> const_local_iterator;
+    typedef ht_const_local_iterator<T, CacheHash> self;
+    typedef ht_local_iterator<T, CacheHash> local_iterator;
+    typedef ht_const_local_iterator<T, CacheHash> const_local_iterator;
 
     node_ptr node;
 
@@ -494,12 +518,58 @@ inline size_t ht_next_prime(size_t n) {
     return pos == last ? *(last - 1) : *pos;
 }
 
+// 找出大于等于 n 的最小的 2 的幂次，至少为 8，最大为 ht_pow2_max
+static constexpr size_t ht_pow2_max = (static_cast<size_t>(-1) >> 1) + 1;
+
+inline size_t ht_next_pow2(size_t n) {
+    if (n > ht_pow2_max)
+        return ht_pow2_max;
+    size_t result = 8;
+    while (result < n)
+        result <<= 1;
+    return result;
+}
+
+// 哈希值的混合函数，取自 MurmurHash3 的 fmix
+// mystl::hash 对整数直接返回原值，在用低位定位之前需要把高位的信息混合进来
+inline size_t ht_hash_mix(size_t h) noexcept {
+#ifdef SYSTEM_64
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+#else
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+#endif
+    return h;
+}
+
+// 较轻量的哈希值混合函数，用于 2 的幂次个 bucket 的链式 hashtable
+// 只需要低位分布均匀：先把高位折叠到低位，乘以黄金分割常数，再把乘积的高位折叠回来
+inline size_t ht_hash_fold(size_t h) noexcept {
+#ifdef SYSTEM_64
+    h ^= h >> 32;
+    h *= 0x9e3779b97f4a7c15ull;
+    h ^= h >> 32;
+#else
+    h ^= h >> 16;
+    h *= 0x9e3779b9u;
+    h ^= h >> 16;
+#endif
+    return h;
+}
+
 // 模板类 hashtable
-// 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数
-template <class T, class Hash, class KeyEqual>
+// 参数一代表数据类型，参数二代表哈希函数，参数三代表键值相等的比较函数，参数四代表分配器
+template <class T, class Hash, class KeyEqual, class Alloc>
 class hashtable {
-    friend struct mystl::ht_iterator<T, Hash, KeyEqual>;
-    friend struct mystl::ht_const_iterator<T, Hash, KeyEqual>;
+    friend struct mystl::ht_iterator<T, Hash, KeyEqual, Alloc>;
+    friend struct mystl::ht_const_iterator<T, Hash, KeyEqual, Alloc>;
 
 public:
     // hashtable 的型别定义
@@ -510,13 +580,21 @@ public:
     typedef Hash hasher;
     typedef KeyEqual key_equal;
 
-    typedef hashtable_node<T> node_type;
+    // 是否在节点中缓存哈希值
+    static constexpr bool cache_hash = mystl::cache_hash_code<Hash>::value;
+    typedef std::integral_constant<bool, cache_hash> cache_hash_tag;
+
+    // bucket 数量的策略：质数取模，或 2 的幂次配合哈希值混合后取低位
+    static constexpr bool pow2_bucket = mystl::pow2_bucket_count<Hash>::value;
+    typedef std::integral_constant<bool, pow2_bucket> pow2_bucket_tag;
+
+    typedef hashtable_node<T, cache_hash> node_type;
     typedef node_type* node_ptr;
     typedef mystl::vector<node_ptr> bucket_type;
 
-    typedef mystl::allocator<T> allocator_type;
-    typedef mystl::allocator<T> data_allocator;
-    typedef mystl::allocator<node_type> node_allocator;
+    typedef Alloc allocator_type;
+    typedef mystl::allocator_traits<Alloc> alloc_traits;
+    typedef typename alloc_traits::template rebind_alloc<node_type> node_allocator;
 
     typedef typename allocator_type::pointer pointer;
     typedef typename allocator_type::const_pointer const_pointer;
@@ -525,14 +603,16 @@ public:
     typedef typename allocator_type::size_type size_type;
     typedef typename allocator_type::difference_type difference_type;
 
-    typedef mystl::ht_iterator<T, Hash, KeyEqual> iterator;
-    typedef mystl::ht_const_iterator<T, Hash, KeyEqual> const_iterator;
-    typedef mystl::ht_local_iterator<T> local_iterator;
-    typedef mystl::ht_const_local_iterator<T> const_local_iterator;
+    typedef mystl::ht_iterator<T, Hash, KeyEqual, Alloc> iterator;
+    typedef mystl::ht_const_iterator<T, Hash, KeyEqual, Alloc> const_iterator;
+    typedef mystl::ht_local_iterator<T, cache_hash> local_iterator;
+    typedef mystl::ht_const_local_iterator<T, cache_hash> const_local_iterator;
 
-    allocator_type get_allocator() const { return allocator_type(); }
+    allocator_type get_allocator() const { return allocator_type(alloc_); }
 
 private:
+    node_allocator alloc_;  // 节点的分配器
+
     // 用以下六个参数来表现 hashtable
     bucket_type buckets_;
     size_type bucket_size_;
@@ -550,6 +630,74 @@ private:
         return equal_(key1, key2);
     }
 
+    // 节点的完整哈希值：开启缓存时直接读取，否则重新计算
+    size_type node_hash(const node_type* np) const {
+        return node_hash(np, cache_hash_tag());
+    }
+    size_type node_hash(const node_type* np, std::true_type) const {
+        return np->hash_code;
+    }
+    size_type node_hash(const node_type* np, std::false_type) const {
+        return hash_(value_traits::get_key(np->value));
+    }
+
+    // 哈希值在 n 个 bucket 中的位置
+    size_type bucket_index(size_type code) const {
+        return bucket_index(code, bucket_size_);
+    }
+    size_type bucket_index(size_type code, size_type n) const {
+        return bucket_index(code, n, pow2_bucket_tag());
+    }
+    size_type bucket_index(size_type code, size_type n, std::true_type) const {
+        return ht_hash_fold(code) & (n - 1);
+    }
+    size_type bucket_index(size_type code, size_type n, std::false_type) const {
+        return code % n;
+    }
+
+    // 节点所在的 bucket
+    size_type node_bucket(const node_type* np) const {
+        return bucket_index(node_hash(np));
+    }
+
+    // 把哈希值保存到节点中，不缓存时什么也不做
+    void set_hash(node_ptr np, size_type code) {
+        set_hash(np, code, cache_hash_tag());
+    }
+    void set_hash(node_ptr np, size_type code, std::true_type) {
+        np->hash_code = code;
+    }
+    void set_hash(node_ptr, size_type, std::false_type) {}
+
+    void copy_hash(node_ptr to, const node_type* from) {
+        copy_hash(to, from, cache_hash_tag());
+    }
+    void copy_hash(node_ptr to, const node_type* from, std::true_type) {
+        to->hash_code = from->hash_code;
+    }
+    void copy_hash(node_ptr, const node_type*, std::false_type) {}
+
+    // 用缓存的哈希值预先筛选，哈希值不同的节点一定不相等；不缓存时总是返回 true
+    bool hash_may_equal(const node_type* np, size_type code) const {
+        return hash_may_equal(np, code, cache_hash_tag());
+    }
+    bool hash_may_equal(const node_type* np,
+                        size_type code,
+                        std::true_type) const {
+        return np->hash_code == code;
+    }
+    bool hash_may_equal(const node_type*, size_type, std::false_type) const {
+        return true;
+    }
+
+    // 先比较哈希值，再比较键值
+    bool is_node_equal(const node_type* np,
+                       size_type code,
+                       const key_type& key) const {
+        return hash_may_equal(np, code) &&
+               is_equal(value_traits::get_key(np->value), key);
+    }
+
     const_iterator M_cit(node_ptr node) const noexcept {
         return const_iterator(node, const_cast<hashtable*>(this));
     }
@@ -574,8 +722,9 @@ public:
     // 构造、复制、移动、析构函数
     explicit hashtable(size_type bucket_count,
                        const Hash& hash = Hash(),
-                       const KeyEqual& equal = KeyEqual())
-        : size_(0), mlf_(1.0f), hash_(hash), equal_(equal) {
+                       const KeyEqual& equal = KeyEqual(),
+                       const allocator_type& alloc = allocator_type())
+        : alloc_(alloc), size_(0), mlf_(1.0f), hash_(hash), equal_(equal) {
         init(bucket_count);
     }
 
@@ -586,8 +735,10 @@ public:
               Iter last,
               size_type bucket_count,
               const Hash& hash = Hash(),
-              const KeyEqual& equal = KeyEqual())
-        : size_(mystl::distance(first, last)),
+              const KeyEqual& equal = KeyEqual(),
+              const allocator_type& alloc = allocator_type())
+        : alloc_(alloc),
+          size_(mystl::distance(first, last)),
           mlf_(1.0f),
           hash_(hash),
           equal_(equal) {
@@ -595,11 +746,20 @@ public:
                         static_cast<size_type>(mystl::distance(first, last))));
     }
 
-    hashtable(const hashtable& rhs) : hash_(rhs.hash_), equal_(rhs.equal_) {
+    hashtable(const hashtable& rhs)
+        : alloc_(alloc_traits::select_on_container_copy_construction(
+              rhs.get_allocator())),
+          hash_(rhs.hash_),
+          equal_(rhs.equal_) {
+        copy_init(rhs);
+    }
+    hashtable(const hashtable& rhs, const allocator_type& alloc)
+        : alloc_(alloc), hash_(rhs.hash_), equal_(rhs.equal_) {
         copy_init(rhs);
     }
     hashtable(hashtable&& rhs) noexcept
-        : bucket_size_(rhs.bucket_size_),
+        : alloc_(mystl::move(rhs.alloc_)),
+          bucket_size_(rhs.bucket_size_),
           size_(rhs.size_),
           mlf_(rhs.mlf_),
           hash_(rhs.hash_),
@@ -611,7 +771,9 @@ public:
     }
 
     hashtable& operator=(const hashtable& rhs);
-    hashtable& operator=(hashtable&& rhs) noexcept;
+    hashtable& operator=(hashtable&& rhs) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value);
 
     ~hashtable() { clear(); }
 
@@ -728,6 +890,21 @@ public:
     pair<const_iterator, const_iterator> equal_range_unique(
         const key_type& key) const;
 
+    // 批量查找：对 [first, last) 中的每个键值依次向 result 写入 find 的结果
+    // 先计算一组键值的哈希值并预取 bucket，再统一遍历链表，使各次查找的缓存缺失重叠
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter result);
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first,
+                          ForwardIter last,
+                          OutputIter result) const;
+
+    // 批量查找：对每个键值依次向 result 写入一个 bool，表示是否存在
+    template <class ForwardIter, class OutputIter>
+    OutputIter contains_batch(ForwardIter first,
+                              ForwardIter last,
+                              OutputIter result) const;
+
     // bucket interface
 
     local_iterator begin(size_type n) noexcept {
@@ -758,7 +935,7 @@ public:
 
     size_type bucket_count() const noexcept { return bucket_size_; }
     size_type max_bucket_count() const noexcept {
-        return ht_prime_list[PRIME_NUM - 1];
+        return pow2_bucket ? ht_pow2_max : ht_prime_list[PRIME_NUM - 1];
     }
 
     size_type bucket_size(size_type n) const noexcept;
@@ -792,6 +969,15 @@ private:
     void init(size_type n);
     void copy_init(const hashtable& ht);
 
+    // allocator propagation
+    void swap_data(hashtable& rhs) noexcept;
+    void move_assign(hashtable& rhs, m_true_type);
+    void move_assign(hashtable& rhs, m_false_type);
+    void swap_alloc(hashtable& rhs, m_true_type) {
+        mystl::swap(alloc_, rhs.alloc_);
+    }
+    void swap_alloc(hashtable&, m_false_type) {}
+
     // node
     template <class... Args>
     node_ptr create_node(Args&&... args);
@@ -799,10 +985,23 @@ private:
 
     // hash
     size_type next_size(size_type n) const;
+    size_type next_size(size_type n, std::true_type) const {
+        return ht_next_pow2(n);
+    }
+    size_type next_size(size_type n, std::false_type) const {
+        return ht_next_prime(n);
+    }
     size_type hash(const key_type& key, size_type n) const;
     size_type hash(const key_type& key) const;
     void rehash_if_need(size_type n);
 
+    // batch lookup
+    static constexpr size_type batch_size = 16;  // 一组同时查找的键值个数
+    template <class ForwardIter>
+    size_type find_group(ForwardIter& first,
+                         ForwardIter last,
+                         node_ptr* nodes) const;
+
     // insert
     template <class InputIter>
     void copy_insert_multi(InputIter first,
@@ -830,39 +1029,75 @@ private:
     void erase_bucket(size_type n, node_ptr first, node_ptr last);
     void erase_bucket(size_type n, node_ptr last);
 
+public:
     // comparision
-    bool equal_to_multi(const hashtable& other);
-    bool equal_to_unique(const hashtable& other);
+    bool equal_to_multi(const hashtable& other) const;
+    bool equal_to_unique(const hashtable& other) const;
 };
 
 /*****************************************************************************************/
 
 // 复制赋值运算符
-template <class T, class Hash, class KeyEqual>
-hashtable<T, Hash, KeyEqual>& hashtable<T, Hash, KeyEqual>::operator=(
-    const hashtable& rhs) {
+// 分配器不传播时，副本使用自己的分配器，再连同分配器一起与副本交换
+template <class T, class Hash, class KeyEqual, class Alloc>
+hashtable<T, Hash, KeyEqual, Alloc>&
+hashtable<T, Hash, KeyEqual, Alloc>::operator=(const hashtable& rhs) {
     if (this != &rhs) {
-        hashtable tmp(rhs);
-        swap(tmp);
+        hashtable tmp(rhs, alloc_traits::propagate_on_container_copy_assignment::value
+                               ? rhs.get_allocator()
+                               : get_allocator());
+        swap_alloc(tmp, m_true_type());
+        swap_data(tmp);
     }
     return *this;
 }
 
 // 移动赋值运算符
-template <class T, class Hash, class KeyEqual>
-hashtable<T, Hash, KeyEqual>& hashtable<T, Hash, KeyEqual>::operator=(
-    hashtable&& rhs) noexcept {
-    hashtable tmp(mystl::move(rhs));
-    swap(tmp);
+template <class T, class Hash, class KeyEqual, class Alloc>
+hashtable<T, Hash, KeyEqual, Alloc>&
+hashtable<T, Hash, KeyEqual, Alloc>::operator=(hashtable&& rhs) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value ||
+    alloc_traits::is_always_equal::value) {
+    if (this != &rhs) {
+        move_assign(rhs, typename alloc_traits::
+                             propagate_on_container_move_assignment());
+    }
     return *this;
 }
 
+// 分配器随元素传播：接管 rhs 的节点与分配器，旧的节点随临时对象由旧的分配器释放
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::move_assign(hashtable& rhs,
+                                                      m_true_type) {
+    hashtable tmp(mystl::move(rhs));
+    swap_alloc(tmp, m_true_type());
+    swap_data(tmp);
+}
+
+// 分配器不传播时，只有两个分配器相等才能直接接管节点，否则逐个移动元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::move_assign(hashtable& rhs,
+                                                      m_false_type) {
+    if (alloc_traits::equal(alloc_, rhs.alloc_)) {
+        hashtable tmp(mystl::move(rhs));
+        swap_data(tmp);
+    } else {
+        clear();
+        hash_ = rhs.hash_;
+        equal_ = rhs.equal_;
+        mlf_ = rhs.mlf_;
+        for (auto it = rhs.begin(); it != rhs.end(); ++it)
+            emplace_multi(mystl::move(*it));
+        rhs.clear();
+    }
+}
+
 // 就地构造元素，键值允许重复
 // 强异常安全保证
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class... Args>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::emplace_multi(Args&&... args) {
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Alloc>::emplace_multi(Args&&... args) {
     auto np = create_node(mystl::forward<Args>(args)...);
     try {
         if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
@@ -876,10 +1111,10 @@ hashtable<T, Hash, KeyEqual>::emplace_multi(Args&&... args) {
 
 // 就地构造元素，键值允许重复
 // 强异常安全保证
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class... Args>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-hashtable<T, Hash, KeyEqual>::emplace_unique(Args&&... args) {
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc>::emplace_unique(Args&&... args) {
     auto np = create_node(mystl::forward<Args>(args)...);
     try {
         if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
@@ -892,18 +1127,19 @@ hashtable<T, Hash, KeyEqual>::emplace_unique(Args&&... args) {
 }
 
 // 在不需要重建表格的情况下插入新节点，键值不允许重复
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-hashtable<T, Hash, KeyEqual>::insert_unique_noresize(const value_type& value) {
-    const auto n = hash(value_traits::get_key(value));
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc>::insert_unique_noresize(const value_type& value) {
+    const auto code = hash_(value_traits::get_key(value));
+    const auto n = bucket_index(code);
     auto first = buckets_[n];
     for (auto cur = first; cur; cur = cur->next) {
-        if (is_equal(value_traits::get_key(cur->value),
-                     value_traits::get_key(value)))
+        if (is_node_equal(cur, code, value_traits::get_key(value)))
             return mystl::make_pair(iterator(cur, this), false);
     }
     // 让新节点成为链表的第一个节点
     auto tmp = create_node(value);
+    set_hash(tmp, code);
     tmp->next = first;
     buckets_[n] = tmp;
     ++size_;
@@ -911,15 +1147,17 @@ hashtable<T, Hash, KeyEqual>::insert_unique_noresize(const value_type& value) {
 }
 
 // 在不需要重建表格的情况下插入新节点，键值允许重复
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::insert_multi_noresize(const value_type& value) {
-    const auto n = hash(value_traits::get_key(value));
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Alloc>::insert_multi_noresize(const value_type& value) {
+    const auto code = hash_(value_traits::get_key(value));
+    const auto n = bucket_index(code);
     auto first = buckets_[n];
     auto tmp = create_node(value);
+    set_hash(tmp, code);
     for (auto cur = first; cur; cur = cur->next) {
-        if (is_equal(
-                value_traits::get_key(cur->value),
+        if (is_node_equal(
+                cur, code,
                 value_traits::get_key(
                     value))) {  // 如果链表中存在相同键值的节点就马上插入，然后返回
             tmp->next = cur->next;
@@ -936,11 +1174,11 @@ hashtable<T, Hash, KeyEqual>::insert_multi_noresize(const value_type& value) {
 }
 
 // 删除迭代器所指的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::erase(const_iterator position) {
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::erase(const_iterator position) {
     auto p = position.node;
     if (p) {
-        const auto n = hash(value_traits::get_key(p->value));
+        const auto n = node_bucket(p);
         auto cur = buckets_[n];
         if (cur == p) {  // p 位于链表头部
             buckets_[n] = cur->next;
@@ -964,16 +1202,13 @@ void hashtable<T, Hash, KeyEqual>::erase(const_iterator position) {
 }
 
 // 删除[first, last)内的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::erase(const_iterator first,
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::erase(const_iterator first,
                                          const_iterator last) {
     if (first.node == last.node)
         return;
-    auto first_bucket = first.node
-                            ? hash(value_traits::get_key(first.node->value))
-                            : bucket_size_;
-    auto last_bucket = last.node ? hash(value_traits::get_key(last.node->value))
-                                 : bucket_size_;
+    auto first_bucket = first.node ? node_bucket(first.node) : bucket_size_;
+    auto last_bucket = last.node ? node_bucket(last.node) : bucket_size_;
     if (first_bucket == last_bucket) {  // 如果在 bucket 在同一个位置
         erase_bucket(first_bucket, first.node, last.node);
     } else {
@@ -989,24 +1224,27 @@ void hashtable<T, Hash, KeyEqual>::erase(const_iterator first,
 }
 
 // 删除键值为 key 的节点
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::erase_multi(const key_type& key) {
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::erase_multi(const key_type& key) {
     auto p = equal_range_multi(key);
     if (p.first.node != nullptr) {
+        // 先计算个数，删除之后迭代器就失效了
+        const size_type n = mystl::distance(p.first, p.second);
         erase(p.first, p.second);
-        return mystl::distance(p.first, p.second);
+        return n;
     }
     return 0;
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::erase_unique(const key_type& key) {
-    const auto n = hash(key);
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::erase_unique(const key_type& key) {
+    const auto code = hash_(key);
+    const auto n = bucket_index(code);
     auto first = buckets_[n];
     if (first) {
-        if (is_equal(value_traits::get_key(first->value), key)) {
+        if (is_node_equal(first, code, key)) {
             buckets_[n] = first->next;
             destroy_node(first);
             --size_;
@@ -1014,7 +1252,7 @@ hashtable<T, Hash, KeyEqual>::erase_unique(const key_type& key) {
         } else {
             auto next = first->next;
             while (next) {
-                if (is_equal(value_traits::get_key(next->value), key)) {
+                if (is_node_equal(next, code, key)) {
                     first->next = next->next;
                     destroy_node(next);
                     --size_;
@@ -1029,8 +1267,8 @@ hashtable<T, Hash, KeyEqual>::erase_unique(const key_type& key) {
 }
 
 // 清空 hashtable
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::clear() {
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::clear() {
     if (size_ != 0) {
         for (size_type i = 0; i < bucket_size_; ++i) {
             node_ptr cur = buckets_[i];
@@ -1046,9 +1284,9 @@ void hashtable<T, Hash, KeyEqual>::clear() {
 }
 
 // 在某个 bucket 节点的个数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::bucket_size(size_type n) const noexcept {
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::bucket_size(size_type n) const noexcept {
     size_type result = 0;
     for (auto cur = buckets_[n]; cur; cur = cur->next) {
         ++result;
@@ -1057,9 +1295,9 @@ hashtable<T, Hash, KeyEqual>::bucket_size(size_type n) const noexcept {
 }
 
 // 重新对元素进行一遍哈希，插入到新的位置
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::rehash(size_type count) {
-    auto n = ht_next_prime(count);
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::rehash(size_type count) {
+    auto n = next_size(count);
     if (n > bucket_size_) {
         replace_bucket(n);
     } else {
@@ -1072,52 +1310,96 @@ void hashtable<T, Hash, KeyEqual>::rehash(size_type count) {
 }
 
 // 查找键值为 key 的节点，返回其迭代器
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::find(const key_type& key) {
-    const auto n = hash(key);
-    node_ptr first = buckets_[n];
-    for (; first && !is_equal(value_traits::get_key(first->value), key);
-         first = first->next) {
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Alloc>::find(const key_type& key) {
+    const auto code = hash_(key);
+    node_ptr first = buckets_[bucket_index(code)];
+    for (; first && !is_node_equal(first, code, key); first = first->next) {
     }
     return iterator(first, this);
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::const_iterator
-hashtable<T, Hash, KeyEqual>::find(const key_type& key) const {
-    const auto n = hash(key);
-    node_ptr first = buckets_[n];
-    for (; first && !is_equal(value_traits::get_key(first->value), key);
-         first = first->next) {
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator
+hashtable<T, Hash, KeyEqual, Alloc>::find(const key_type& key) const {
+    const auto code = hash_(key);
+    node_ptr first = buckets_[bucket_index(code)];
+    for (; first && !is_node_equal(first, code, key); first = first->next) {
     }
     return M_cit(first);
 }
 
 // 查找键值为 key 出现的次数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::count(const key_type& key) const {
-    const auto n = hash(key);
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::count(const key_type& key) const {
+    const auto code = hash_(key);
     size_type result = 0;
-    for (node_ptr cur = buckets_[n]; cur; cur = cur->next) {
-        if (is_equal(value_traits::get_key(cur->value), key))
+    for (node_ptr cur = buckets_[bucket_index(code)]; cur; cur = cur->next) {
+        if (is_node_equal(cur, code, key))
             ++result;
     }
     return result;
 }
 
+// 批量查找，每个键值写入一个迭代器，返回 result 的尾部
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class ForwardIter, class OutputIter>
+OutputIter hashtable<T, Hash, KeyEqual, Alloc>::find_batch(ForwardIter first,
+                                                           ForwardIter last,
+                                                           OutputIter result) {
+    node_ptr nodes[batch_size];
+    while (first != last) {
+        const auto n = find_group(first, last, nodes);
+        for (size_type i = 0; i < n; ++i, ++result)
+            *result = iterator(nodes[i], this);
+    }
+    return result;
+}
+
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class ForwardIter, class OutputIter>
+OutputIter hashtable<T, Hash, KeyEqual, Alloc>::find_batch(
+    ForwardIter first,
+    ForwardIter last,
+    OutputIter result) const {
+    node_ptr nodes[batch_size];
+    while (first != last) {
+        const auto n = find_group(first, last, nodes);
+        for (size_type i = 0; i < n; ++i, ++result)
+            *result = M_cit(nodes[i]);
+    }
+    return result;
+}
+
+// 批量判断键值是否存在，每个键值写入一个 bool，返回 result 的尾部
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class ForwardIter, class OutputIter>
+OutputIter hashtable<T, Hash, KeyEqual, Alloc>::contains_batch(
+    ForwardIter first,
+    ForwardIter last,
+    OutputIter result) const {
+    node_ptr nodes[batch_size];
+    while (first != last) {
+        const auto n = find_group(first, last, nodes);
+        for (size_type i = 0; i < n; ++i, ++result)
+            *result = nodes[i] != nullptr;
+    }
+    return result;
+}
+
 // 查找与键值 key 相等的区间，返回一个 pair，指向相等区间的首尾
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator,
-     typename hashtable<T, Hash, KeyEqual>::iterator>
-hashtable<T, Hash, KeyEqual>::equal_range_multi(const key_type& key) {
-    const auto n = hash(key);
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator,
+     typename hashtable<T, Hash, KeyEqual, Alloc>::iterator>
+hashtable<T, Hash, KeyEqual, Alloc>::equal_range_multi(const key_type& key) {
+    const auto code = hash_(key);
+    const auto n = bucket_index(code);
     for (node_ptr first = buckets_[n]; first; first = first->next) {
-        if (is_equal(value_traits::get_key(first->value),
-                     key)) {  // 如果出现相等的键值
+        if (is_node_equal(first, code, key)) {  // 如果出现相等的键值
             for (node_ptr second = first->next; second; second = second->next) {
-                if (!is_equal(value_traits::get_key(second->value), key))
+                if (!is_node_equal(second, code, key))
                     return mystl::make_pair(iterator(first, this),
                                             iterator(second, this));
             }
@@ -1133,15 +1415,16 @@ hashtable<T, Hash, KeyEqual>::equal_range_multi(const key_type& key) {
     return mystl::make_pair(end(), end());
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
-     typename hashtable<T, Hash, KeyEqual>::const_iterator>
-hashtable<T, Hash, KeyEqual>::equal_range_multi(const key_type& key) const {
-    const auto n = hash(key);
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator,
+     typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator>
+hashtable<T, Hash, KeyEqual, Alloc>::equal_range_multi(const key_type& key) const {
+    const auto code = hash_(key);
+    const auto n = bucket_index(code);
     for (node_ptr first = buckets_[n]; first; first = first->next) {
-        if (is_equal(value_traits::get_key(first->value), key)) {
+        if (is_node_equal(first, code, key)) {
             for (node_ptr second = first->next; second; second = second->next) {
-                if (!is_equal(value_traits::get_key(second->value), key))
+                if (!is_node_equal(second, code, key))
                     return mystl::make_pair(M_cit(first), M_cit(second));
             }
             for (auto m = n + 1; m < bucket_size_;
@@ -1155,13 +1438,14 @@ hashtable<T, Hash, KeyEqual>::equal_range_multi(const key_type& key) const {
     return mystl::make_pair(cend(), cend());
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator,
-     typename hashtable<T, Hash, KeyEqual>::iterator>
-hashtable<T, Hash, KeyEqual>::equal_range_unique(const key_type& key) {
-    const auto n = hash(key);
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator,
+     typename hashtable<T, Hash, KeyEqual, Alloc>::iterator>
+hashtable<T, Hash, KeyEqual, Alloc>::equal_range_unique(const key_type& key) {
+    const auto code = hash_(key);
+    const auto n = bucket_index(code);
     for (node_ptr first = buckets_[n]; first; first = first->next) {
-        if (is_equal(value_traits::get_key(first->value), key)) {
+        if (is_node_equal(first, code, key)) {
             if (first->next)
                 return mystl::make_pair(iterator(first, this),
                                         iterator(first->next, this));
@@ -1177,13 +1461,14 @@ hashtable<T, Hash, KeyEqual>::equal_range_unique(const key_type& key) {
     return mystl::make_pair(end(), end());
 }
 
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
-     typename hashtable<T, Hash, KeyEqual>::const_iterator>
-hashtable<T, Hash, KeyEqual>::equal_range_unique(const key_type& key) const {
-    const auto n = hash(key);
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator,
+     typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator>
+hashtable<T, Hash, KeyEqual, Alloc>::equal_range_unique(const key_type& key) const {
+    const auto code = hash_(key);
+    const auto n = bucket_index(code);
     for (node_ptr first = buckets_[n]; first; first = first->next) {
-        if (is_equal(value_traits::get_key(first->value), key)) {
+        if (is_node_equal(first, code, key)) {
             if (first->next)
                 return mystl::make_pair(M_cit(first), M_cit(first->next));
             for (auto m = n + 1; m < bucket_size_;
@@ -1197,9 +1482,18 @@ hashtable<T, Hash, KeyEqual>::equal_range_unique(const key_type& key) const {
     return mystl::make_pair(cend(), cend());
 }
 
-// 交换 hashtable
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::swap(hashtable& rhs) noexcept {
+// 交换 hashtable，分配器不传播时，两个容器的分配器必须相等
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::swap(hashtable& rhs) noexcept {
+    if (this != &rhs) {
+        swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
+        swap_data(rhs);
+    }
+}
+
+// 交换除分配器以外的所有成员
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::swap_data(hashtable& rhs) noexcept {
     if (this != &rhs) {
         buckets_.swap(rhs.buckets_);
         mystl::swap(bucket_size_, rhs.bucket_size_);
@@ -1214,8 +1508,8 @@ void hashtable<T, Hash, KeyEqual>::swap(hashtable& rhs) noexcept {
 // helper function
 
 // init 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::init(size_type n) {
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::init(size_type n) {
     const auto bucket_nums = next_size(n);
     try {
         buckets_.reserve(bucket_nums);
@@ -1229,8 +1523,8 @@ void hashtable<T, Hash, KeyEqual>::init(size_type n) {
 }
 
 // copy_init 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::copy_init(const hashtable& ht) {
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::copy_init(const hashtable& ht) {
     bucket_size_ = 0;
     buckets_.reserve(ht.bucket_size_);
     buckets_.assign(ht.bucket_size_, nullptr);
@@ -1239,11 +1533,13 @@ void hashtable<T, Hash, KeyEqual>::copy_init(const hashtable& ht) {
             node_ptr cur = ht.buckets_[i];
             if (cur) {  // 如果某 bucket 存在链表
                 auto copy = create_node(cur->value);
+                copy_hash(copy, cur);
                 buckets_[i] = copy;
                 for (auto next = cur->next; next;
                      cur = next, next = cur->next) {  // 复制链表
                     copy->next = create_node(next->value);
                     copy = copy->next;
+                    copy_hash(copy, next);
                 }
                 copy->next = nullptr;
             }
@@ -1257,61 +1553,97 @@ void hashtable<T, Hash, KeyEqual>::copy_init(const hashtable& ht) {
 }
 
 // create_node 函数
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class... Args>
-typename hashtable<T, Hash, KeyEqual>::node_ptr
-hashtable<T, Hash, KeyEqual>::create_node(Args&&... args) {
-    node_ptr tmp = node_allocator::allocate(1);
+typename hashtable<T, Hash, KeyEqual, Alloc>::node_ptr
+hashtable<T, Hash, KeyEqual, Alloc>::create_node(Args&&... args) {
+    node_ptr tmp = alloc_.allocate(1);
     try {
-        data_allocator::construct(mystl::address_of(tmp->value),
-                                  mystl::forward<Args>(args)...);
+        mystl::construct(mystl::address_of(tmp->value),
+                         mystl::forward<Args>(args)...);
         tmp->next = nullptr;
     } catch (...) {
-        node_allocator::deallocate(tmp);
+        alloc_.deallocate(tmp, 1);
         throw;
     }
     return tmp;
 }
 
 // destroy_node 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::destroy_node(node_ptr node) {
-    data_allocator::destroy(mystl::address_of(node->value));
-    node_allocator::deallocate(node);
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::destroy_node(node_ptr node) {
+    mystl::destroy(mystl::address_of(node->value));
+    alloc_.deallocate(node, 1);
     node = nullptr;
 }
 
 // next_size 函数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::next_size(size_type n) const {
-    return ht_next_prime(n);
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::next_size(size_type n) const {
+    return next_size(n, pow2_bucket_tag());
 }
 
 // hash 函数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::hash(const key_type& key, size_type n) const {
-    return hash_(key) % n;
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::hash(const key_type& key, size_type n) const {
+    return bucket_index(hash_(key), n);
 }
 
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
-hashtable<T, Hash, KeyEqual>::hash(const key_type& key) const {
-    return hash_(key) % bucket_size_;
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::hash(const key_type& key) const {
+    return bucket_index(hash_(key));
+}
+
+// find_group 函数
+// 从 first 开始查找至多 batch_size 个键值，结果依次存入 nodes，first 前进到下一组的开头
+// 分三趟进行：计算哈希值并预取 bucket，读取链表头并预取首个节点，最后逐个比较
+template <class T, class Hash, class KeyEqual, class Alloc>
+template <class ForwardIter>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type
+hashtable<T, Hash, KeyEqual, Alloc>::find_group(ForwardIter& first,
+                                                ForwardIter last,
+                                                node_ptr* nodes) const {
+    static_assert(
+        std::is_same<typename std::decay<decltype(*first)>::type,
+                     key_type>::value,
+        "the key sequence of a batch lookup must hold key_type");
+    const key_type* keys[batch_size];
+    size_type codes[batch_size];
+    size_type slots[batch_size];
+    size_type n = 0;
+    for (; n < batch_size && first != last; ++n, ++first) {
+        keys[n] = mystl::address_of(*first);
+        codes[n] = hash_(*keys[n]);
+        slots[n] = bucket_index(codes[n]);
+        mystl::prefetch(buckets_.data() + slots[n]);
+    }
+    for (size_type i = 0; i < n; ++i) {
+        nodes[i] = buckets_[slots[i]];
+        mystl::prefetch(nodes[i]);
+    }
+    for (size_type i = 0; i < n; ++i) {
+        node_ptr cur = nodes[i];
+        for (; cur && !is_node_equal(cur, codes[i], *keys[i]); cur = cur->next) {
+        }
+        nodes[i] = cur;
+    }
+    return n;
 }
 
 // rehash_if_need 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::rehash_if_need(size_type n) {
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::rehash_if_need(size_type n) {
     if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
         rehash(size_ + n);
 }
 
 // copy_insert
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class InputIter>
-void hashtable<T, Hash, KeyEqual>::copy_insert_multi(
+void hashtable<T, Hash, KeyEqual, Alloc>::copy_insert_multi(
     InputIter first,
     InputIter last,
     mystl::input_iterator_tag) {
@@ -1320,9 +1652,9 @@ void hashtable<T, Hash, KeyEqual>::copy_insert_multi(
         insert_multi_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class ForwardIter>
-void hashtable<T, Hash, KeyEqual>::copy_insert_multi(
+void hashtable<T, Hash, KeyEqual, Alloc>::copy_insert_multi(
     ForwardIter first,
     ForwardIter last,
     mystl::forward_iterator_tag) {
@@ -1332,9 +1664,9 @@ void hashtable<T, Hash, KeyEqual>::copy_insert_multi(
         insert_multi_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class InputIter>
-void hashtable<T, Hash, KeyEqual>::copy_insert_unique(
+void hashtable<T, Hash, KeyEqual, Alloc>::copy_insert_unique(
     InputIter first,
     InputIter last,
     mystl::input_iterator_tag) {
@@ -1343,9 +1675,9 @@ void hashtable<T, Hash, KeyEqual>::copy_insert_unique(
         insert_unique_noresize(*first);
 }
 
-template <class T, class Hash, class KeyEqual>
+template <class T, class Hash, class KeyEqual, class Alloc>
 template <class ForwardIter>
-void hashtable<T, Hash, KeyEqual>::copy_insert_unique(
+void hashtable<T, Hash, KeyEqual, Alloc>::copy_insert_unique(
     ForwardIter first,
     ForwardIter last,
     mystl::forward_iterator_tag) {
@@ -1356,10 +1688,12 @@ void hashtable<T, Hash, KeyEqual>::copy_insert_unique(
 }
 
 // insert_node 函数
-template <class T, class Hash, class KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::insert_node_multi(node_ptr np) {
-    const auto n = hash(value_traits::get_key(np->value));
+template <class T, class Hash, class KeyEqual, class Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Alloc>::insert_node_multi(node_ptr np) {
+    const auto code = hash_(value_traits::get_key(np->value));
+    const auto n = bucket_index(code);
+    set_hash(np, code);
     auto cur = buckets_[n];
     if (cur == nullptr) {
         buckets_[n] = np;
@@ -1367,8 +1701,7 @@ hashtable<T, Hash, KeyEqual>::insert_node_multi(node_ptr np) {
         return iterator(np, this);
     }
     for (; cur; cur = cur->next) {
-        if (is_equal(value_traits::get_key(cur->value),
-                     value_traits::get_key(np->value))) {
+        if (is_node_equal(cur, code, value_traits::get_key(np->value))) {
             np->next = cur->next;
             cur->next = np;
             ++size_;
@@ -1382,10 +1715,12 @@ hashtable<T, Hash, KeyEqual>::insert_node_multi(node_ptr np) {
 }
 
 // insert_node_unique 函数
-template <class T, class Hash, class KeyEqual>
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
-hashtable<T, Hash, KeyEqual>::insert_node_unique(node_ptr np) {
-    const auto n = hash(value_traits::get_key(np->value));
+template <class T, class Hash, class KeyEqual, class Alloc>
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>
+hashtable<T, Hash, KeyEqual, Alloc>::insert_node_unique(node_ptr np) {
+    const auto code = hash_(value_traits::get_key(np->value));
+    const auto n = bucket_index(code);
+    set_hash(np, code);
     auto cur = buckets_[n];
     if (cur == nullptr) {
         buckets_[n] = np;
@@ -1393,8 +1728,8 @@ hashtable<T, Hash, KeyEqual>::insert_node_unique(node_ptr np) {
         return mystl::make_pair(iterator(np, this), true);
     }
     for (; cur; cur = cur->next) {
-        if (is_equal(value_traits::get_key(cur->value),
-                     value_traits::get_key(np->value))) {
+        if (is_node_equal(cur, code, value_traits::get_key(np->value))) {
+            destroy_node(np);  // 键值已存在，释放新建的节点
             return mystl::make_pair(iterator(cur, this), false);
         }
     }
@@ -1405,31 +1740,37 @@ hashtable<T, Hash, KeyEqual>::insert_node_unique(node_ptr np) {
 }
 
 // replace_bucket 函数
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::replace_bucket(size_type bucket_count) {
+// 把旧 bucket 中的节点逐个摘下，直接链接到新 bucket 中，
+// 不分配新节点，也不复制元素
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::replace_bucket(size_type bucket_count) {
     bucket_type bucket(bucket_count);
     if (size_ != 0) {
         for (size_type i = 0; i < bucket_size_; ++i) {
-            for (auto first = buckets_[i]; first; first = first->next) {
-                auto tmp = create_node(first->value);
-                const auto n =
-                    hash(value_traits::get_key(first->value), bucket_count);
+            node_ptr first = buckets_[i];
+            while (first) {
+                node_ptr next = first->next;
+                const auto code = node_hash(first);
+                const auto n = bucket_index(code, bucket_count);
                 auto f = bucket[n];
                 bool is_inserted = false;
                 for (auto cur = f; cur; cur = cur->next) {
-                    if (is_equal(value_traits::get_key(cur->value),
-                                 value_traits::get_key(first->value))) {
-                        tmp->next = cur->next;
-                        cur->next = tmp;
+                    // 键值相同的节点保持相邻
+                    if (is_node_equal(cur, code,
+                                      value_traits::get_key(first->value))) {
+                        first->next = cur->next;
+                        cur->next = first;
                         is_inserted = true;
                         break;
                     }
                 }
                 if (!is_inserted) {
-                    tmp->next = f;
-                    bucket[n] = tmp;
+                    first->next = f;
+                    bucket[n] = first;
                 }
+                first = next;
             }
+            buckets_[i] = nullptr;
         }
     }
     buckets_.swap(bucket);
@@ -1438,8 +1779,8 @@ void hashtable<T, Hash, KeyEqual>::replace_bucket(size_type bucket_count) {
 
 // erase_bucket 函数
 // 在第 n 个 bucket 内，删除 [first, last) 的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::erase_bucket(size_type n,
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::erase_bucket(size_type n,
                                                 node_ptr first,
                                                 node_ptr last) {
     auto cur = buckets_[n];
@@ -1460,8 +1801,8 @@ void hashtable<T, Hash, KeyEqual>::erase_bucket(size_type n,
 
 // erase_bucket 函数
 // 在第 n 个 bucket 内，删除 [buckets_[n], last) 的节点
-template <class T, class Hash, class KeyEqual>
-void hashtable<T, Hash, KeyEqual>::erase_bucket(size_type n, node_ptr last) {
+template <class T, class Hash, class KeyEqual, class Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::erase_bucket(size_type n, node_ptr last) {
     auto cur = buckets_[n];
     while (cur != last) {
         auto next = cur->next;
@@ -1473,24 +1814,24 @@ void hashtable<T, Hash, KeyEqual>::erase_bucket(size_type n, node_ptr last) {
 }
 
 // equal_to 函数
-template <class T, class Hash, class KeyEqual>
-bool hashtable<T, Hash, KeyEqual>::equal_to_multi(const hashtable& other) {
+template <class T, class Hash, class KeyEqual, class Alloc>
+bool hashtable<T, Hash, KeyEqual, Alloc>::equal_to_multi(
+    const hashtable& other) const {
     if (size_ != other.size_)
         return false;
     for (auto f = begin(), l = end(); f != l;) {
         auto p1 = equal_range_multi(value_traits::get_key(*f));
         auto p2 = other.equal_range_multi(value_traits::get_key(*f));
-        if (mystl::distance(p1.first, p1.last) !=
-                mystl::distance(p2.first, p2.last) ||
-            !mystl::is_permutation(p1.first, p2.last, p2.first, p2.last))
+        if (!mystl::is_permutation(p1.first, p1.second, p2.first, p2.second))
             return false;
-        f = p1.last;
+        f = p1.second;
     }
     return true;
 }
 
-template <class T, class Hash, class KeyEqual>
-bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other) {
+template <class T, class Hash, class KeyEqual, class Alloc>
+bool hashtable<T, Hash, KeyEqual, Alloc>::equal_to_unique(
+    const hashtable& other) const {
     if (size_ != other.size_)
         return false;
     for (auto f = begin(), l = end(); f != l; ++f) {
@@ -1502,9 +1843,9 @@ bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other) {
 }
 
 // 重载 mystl 的 swap
-template <class T, class Hash, class KeyEqual>
-void swap(hashtable<T, Hash, KeyEqual>& lhs,
-          hashtable<T, Hash, KeyEqual>& rhs) noexcept {
+template <class T, class Hash, class KeyEqual, class Alloc>
+void swap(hashtable<T, Hash, KeyEqual, Alloc>& lhs,
+          hashtable<T, Hash, KeyEqual, Alloc>& rhs) noexcept {
     lhs.swap(rhs);
 }
 
@@ -128,8 +128,8 @@ template <class T>
 struct iterator_traits<const T*> {
     typedef random_access_iterator_tag iterator_category;
     typedef T value_type;
-    typedef T* pointer;
-    typedef T& reference;
+    typedef const T* pointer;
+    typedef const T& reference;
     typedef ptrdiff_t difference_type;
 };
 
@@ -351,7 +351,8 @@ public:
     因此，这个函数返回了一个指向 operator*()
     所返回的对象的指针，以便对其成员进行访问。需要注意的是，这个函数是 const
     成员函数，因此不能修改对象的状态。 */
-    pointer operator->() const { return &(operator*()); }
+    // 正向迭代器不是指针时转交给它的 operator->，使解引用得到代理对象的迭代器也能使用
+    pointer operator->() const { return arrow(std::is_pointer<Iterator>()); }
 
     // 前进(++)变为后退(--)
     self& operator++() {
@@ -402,6 +403,13 @@ public:
     此外，这个函数中的 difference_type
     是一个整数类型，表示两个迭代器之间的距离。 */
     reference operator[](difference_type n) const { return *(*this + n); }
+
+private:
+    pointer arrow(std::true_type) const { return &(operator*()); }
+    pointer arrow(std::false_type) const {
+        auto tmp = current;
+        return (--tmp).operator->();
+    }
 };
 
 // 重载 operator-
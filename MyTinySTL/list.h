@@ -168,15 +168,17 @@ struct list_const_iterator : public iterator<bidirectional_iterator_tag, T> {
 };
 
 // 模板类: list
-// 模板参数 T 代表数据类型
-template <class T>
+// 模板参数 T 代表数据类型，Alloc 代表分配器，缺省使用 mystl::allocator
+template <class T, class Alloc = mystl::allocator<T>>
 class list {
 public:
     // list 的嵌套型别定义
-    typedef mystl::allocator<T> allocator_type;
-    typedef mystl::allocator<T> data_allocator;
-    typedef mystl::allocator<list_node_base<T>> base_allocator;
-    typedef mystl::allocator<list_node<T>> node_allocator;
+    typedef Alloc allocator_type;
+    typedef mystl::allocator_traits<Alloc> alloc_traits;
+    typedef typename alloc_traits::template rebind_alloc<list_node_base<T>>
+        base_allocator;
+    typedef typename alloc_traits::template rebind_alloc<list_node<T>>
+        node_allocator;
 
     typedef typename allocator_type::value_type value_type;
     typedef typename allocator_type::pointer pointer;
@@ -194,53 +196,79 @@ public:
     typedef typename node_traits<T>::base_ptr base_ptr;
     typedef typename node_traits<T>::node_ptr node_ptr;
 
-    allocator_type get_allocator() { return node_allocator(); }
+    allocator_type get_allocator() const { return allocator_type(alloc_); }
 
 private:
-    base_ptr node_;   // 指向当前节点
-    size_type size_;  // 大小
+    node_allocator alloc_;  // 节点的分配器
+    base_ptr node_;         // 指向当前节点
+    size_type size_;        // 大小
 
 public:
     // 构造、复制、移动、析构函数
-    list() { fill_init(0, value_type()); }
+    list() : alloc_(allocator_type()) { fill_init(0, value_type()); }
 
-    explicit list(size_type n) { fill_init(n, value_type()); }
+    explicit list(const allocator_type& alloc) : alloc_(alloc) {
+        fill_init(0, value_type());
+    }
 
-    list(size_type n, const T& value) { fill_init(n, value); }
+    explicit list(size_type n, const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        fill_init(n, value_type());
+    }
+
+    list(size_type n,
+         const T& value,
+         const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        fill_init(n, value);
+    }
 
     template <class Iter,
               typename std::enable_if<mystl::is_input_iterator<Iter>::value,
                                       int>::type = 0>
-    list(Iter first, Iter last) {
+    list(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
         copy_init(first, last);
     }
 
-    list(std::initializer_list<T> ilist) {
+    list(std::initializer_list<T> ilist,
+         const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
         copy_init(ilist.begin(), ilist.end());
     }
 
-    list(const list& rhs) { copy_init(rhs.cbegin(), rhs.cend()); }
+    list(const list& rhs)
+        : alloc_(alloc_traits::select_on_container_copy_construction(
+              rhs.get_allocator())) {
+        copy_init(rhs.cbegin(), rhs.cend());
+    }
 
-    list(list&& rhs) noexcept : node_(rhs.node_), size_(rhs.size_) {
+    list(list&& rhs) noexcept
+        : alloc_(mystl::move(rhs.alloc_)), node_(rhs.node_), size_(rhs.size_) {
         rhs.node_ = nullptr;
         rhs.size_ = 0;
     }
 
     list& operator=(const list& rhs) {
         if (this != &rhs) {
+            copy_alloc(rhs, typename alloc_traits::
+                                propagate_on_container_copy_assignment());
             assign(rhs.begin(), rhs.end());
         }
         return *this;
     }
 
-    list& operator=(list&& rhs) noexcept {
+    list& operator=(list&& rhs) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value) {
         clear();
-        splice(end(), rhs);
+        move_assign(rhs, typename alloc_traits::
+                             propagate_on_container_move_assignment());
         return *this;
     }
 
     list& operator=(std::initializer_list<T> ilist) {
-        list tmp(ilist.begin(), ilist.end());
+        list tmp(ilist.begin(), ilist.end(), get_allocator());
         swap(tmp);
         return *this;
     }
@@ -248,7 +276,7 @@ public:
     ~list() {
         if (node_) {
             clear();
-            base_allocator::deallocate(node_);
+            base_allocator(alloc_).deallocate(node_, 1);
             node_ = nullptr;
             size_ = 0;
         }
@@ -427,7 +455,9 @@ public:
     void resize(size_type new_size) { resize(new_size, value_type()); }
     void resize(size_type new_size, const value_type& value);
 
+    // 分配器不传播时，两个容器的分配器必须相等
     void swap(list& rhs) noexcept {
+        swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
         mystl::swap(node_, rhs.node_);
         mystl::swap(size_, rhs.size_);
     }
@@ -471,6 +501,14 @@ private:
     node_ptr create_node(Args&&... agrs);
     void destroy_node(node_ptr p);
 
+    // allocator propagation
+    void copy_alloc(const list& rhs, m_true_type);
+    void copy_alloc(const list&, m_false_type) {}
+    void move_assign(list& rhs, m_true_type);
+    void move_assign(list& rhs, m_false_type);
+    void swap_alloc(list& rhs, m_true_type) { mystl::swap(alloc_, rhs.alloc_); }
+    void swap_alloc(list&, m_false_type) {}
+
     // initialize
     void fill_init(size_type n, const value_type& value);
     template <class Iter>
@@ -506,8 +544,8 @@ private:
 /*****************************************************************************************/
 
 // 删除 pos 处的元素
-template <class T>
-typename list<T>::iterator list<T>::erase(const_iterator pos) {
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator list<T, Alloc>::erase(const_iterator pos) {
     // 已经到达链表末尾，无法删除，抛出异常
     MYSTL_DEBUG(pos != cend());
     // 获取要删除节点的指针 n，以及它的下一个节点指针 next
@@ -523,8 +561,8 @@ typename list<T>::iterator list<T>::erase(const_iterator pos) {
 }
 
 // 删除 [first, last) 内的元素
-template <class T>
-typename list<T>::iterator list<T>::erase(const_iterator first,
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator list<T, Alloc>::erase(const_iterator first,
                                           const_iterator last) {
     if (first != last) {
         // 取消链接
@@ -542,8 +580,8 @@ typename list<T>::iterator list<T>::erase(const_iterator first,
 }
 
 // 清空 list
-template <class T>
-void list<T>::clear() {
+template <class T, class Alloc>
+void list<T, Alloc>::clear() {
     if (size_ != 0) {
         auto cur = node_->next;
         for (base_ptr next = cur->next; cur != node_;
@@ -556,8 +594,8 @@ void list<T>::clear() {
 }
 
 // 重置容器大小
-template <class T>
-void list<T>::resize(size_type new_size, const value_type& value) {
+template <class T, class Alloc>
+void list<T, Alloc>::resize(size_type new_size, const value_type& value) {
     auto i = begin();
     size_type len = 0;
     while (i != end() && len < new_size) {
@@ -576,8 +614,8 @@ void list<T>::resize(size_type new_size, const value_type& value) {
 }
 
 // 将 list x 接合于 pos 之前
-template <class T>
-void list<T>::splice(const_iterator pos, list& x) {
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x) {
     // 不能将一个 list 插入到自身中
     MYSTL_DEBUG(this != &x);
     if (!x.empty()) {
@@ -601,8 +639,8 @@ void list<T>::splice(const_iterator pos, list& x) {
 
 // 将 it 所指的节点接合于 pos 之前
 // 只一个结点
-template <class T>
-void list<T>::splice(const_iterator pos, list& x, const_iterator it) {
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& x, const_iterator it) {
     if (pos.node_ != it.node_ && pos.node_ != it.node_->next) {
         THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "list<T>'s size too big");
 
@@ -617,8 +655,8 @@ void list<T>::splice(const_iterator pos, list& x, const_iterator it) {
 }
 
 // 将 list x 的 [first, last) 内的节点接合于 pos 之前
-template <class T>
-void list<T>::splice(const_iterator pos,
+template <class T, class Alloc>
+void list<T, Alloc>::splice(const_iterator pos,
                      list& x,
                      const_iterator first,
                      const_iterator last) {
@@ -638,9 +676,9 @@ void list<T>::splice(const_iterator pos,
 
 // 将另一元操作 pred 为 true 的所有元素移除
 // 接受一个一元谓词pred，用于判断列表中的元素是否需要被一处
-template <class T>
+template <class T, class Alloc>
 template <class UnaryPredicate>
-void list<T>::remove_if(UnaryPredicate pred) {
+void list<T, Alloc>::remove_if(UnaryPredicate pred) {
     auto f = begin();
     auto l = end();
     for (auto next = f; f != l; f = next) {
@@ -656,9 +694,9 @@ void list<T>::remove_if(UnaryPredicate pred) {
 // 可以用于去除链表中相邻的重复元素
 // 接受一个二元谓词 pred，用于判断两个元素是否相等。
 // 函数会遍历链表，如果相邻的两个元素相等，则删除后面的元素，直到链表中不存在相邻的重复元素为止
-template <class T>
+template <class T, class Alloc>
 template <class BinaryPredicate>
-void list<T>::unique(BinaryPredicate pred) {
+void list<T, Alloc>::unique(BinaryPredicate pred) {
     // 指向链表的第一个元素
     auto i = begin();
     auto e = end();
@@ -679,9 +717,9 @@ void list<T>::unique(BinaryPredicate pred) {
 }
 
 // 与另一个 list 合并，按照 comp 为 true 的顺序
-template <class T>
+template <class T, class Alloc>
 template <class Compare>
-void list<T>::merge(list& x, Compare comp) {
+void list<T, Alloc>::merge(list& x, Compare comp) {
     if (this != &x) {
         THROW_LENGTH_ERROR_IF(size_ > max_size() - x.size_,
                               "list<T>'s size too big");
@@ -724,8 +762,8 @@ void list<T>::merge(list& x, Compare comp) {
 }
 
 // 将 list 反转
-template <class T>
-void list<T>::reverse() {
+template <class T, class Alloc>
+void list<T, Alloc>::reverse() {
     if (size_ <= 1) {
         return;
     }
@@ -742,35 +780,70 @@ void list<T>::reverse() {
 // helper function
 
 // 创建结点
-template <class T>
+template <class T, class Alloc>
 template <class... Args>
-typename list<T>::node_ptr list<T>::create_node(Args&&... args) {
-    node_ptr p = node_allocator::allocate(1);
+typename list<T, Alloc>::node_ptr list<T, Alloc>::create_node(Args&&... args) {
+    node_ptr p = alloc_.allocate(1);
     try {
-        data_allocator::construct(mystl::address_of(p->value),
-                                  mystl::forward<Args>(args)...);
+        mystl::construct(mystl::address_of(p->value),
+                         mystl::forward<Args>(args)...);
         p->prev = nullptr;
         p->next = nullptr;
     } catch (...) {
-        node_allocator::deallocate(p);
+        alloc_.deallocate(p, 1);
         throw;
     }
     return p;
 }
 
 // 销毁结点
-template <class T>
-void list<T>::destroy_node(node_ptr p) {
+template <class T, class Alloc>
+void list<T, Alloc>::destroy_node(node_ptr p) {
     // 销毁
-    data_allocator::destroy(mystl::address_of(p->value));
+    mystl::destroy(mystl::address_of(p->value));
     // 就是delete p
-    node_allocator::deallocate(p);
+    alloc_.deallocate(p, 1);
+}
+
+// 复制赋值时传播分配器：旧的头节点由旧的分配器释放，再用新的分配器分配
+template <class T, class Alloc>
+void list<T, Alloc>::copy_alloc(const list& rhs, m_true_type) {
+    if (alloc_ == rhs.alloc_)
+        return;
+    clear();
+    base_allocator(alloc_).deallocate(node_, 1);
+    node_ = nullptr;
+    alloc_ = rhs.alloc_;
+    node_ = base_allocator(alloc_).allocate(1);
+    node_->unlink();
+}
+
+// 移动赋值，调用前已经 clear
+// 分配器随元素传播时，与 rhs 交换头节点与分配器，各自的节点仍由分配它的分配器释放
+template <class T, class Alloc>
+void list<T, Alloc>::move_assign(list& rhs, m_true_type) {
+    mystl::swap(alloc_, rhs.alloc_);
+    mystl::swap(node_, rhs.node_);
+    mystl::swap(size_, rhs.size_);
+}
+
+// 分配器不传播时，只有两个分配器相等才能直接接管节点，否则逐个移动元素
+template <class T, class Alloc>
+void list<T, Alloc>::move_assign(list& rhs, m_false_type) {
+    if (alloc_traits::equal(alloc_, rhs.alloc_)) {
+        mystl::swap(node_, rhs.node_);
+        mystl::swap(size_, rhs.size_);
+    } else {
+        for (auto it = rhs.begin(); it != rhs.end(); ++it)
+            emplace_back(mystl::move(*it));
+        rhs.clear();
+    }
 }
 
 // 用 n 个元素初始化容器
-template <class T>
-void list<T>::fill_init(size_type n, const value_type& value) {
-    node_ = base_allocator::allocate(1);
+template <class T, class Alloc>
+void list<T, Alloc>::fill_init(size_type n, const value_type& value) {
+    node_ = base_allocator(alloc_).allocate(1);
     node_->unlink();
     size_ = n;
     try {
@@ -780,17 +853,17 @@ void list<T>::fill_init(size_type n, const value_type& value) {
         }
     } catch (...) {
         clear();
-        base_allocator::deallocate(node_);
+        base_allocator(alloc_).deallocate(node_, 1);
         node_ = nullptr;
         throw;
     }
 }
 
 // 以 [first, last) 初始化容器
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-void list<T>::copy_init(Iter first, Iter last) {
-    node_ = base_allocator::allocate(1);
+void list<T, Alloc>::copy_init(Iter first, Iter last) {
+    node_ = base_allocator(alloc_).allocate(1);
     node_->unlink();
     size_type n = mystl::distance(first, last);
     size_ = n;
@@ -801,15 +874,15 @@ void list<T>::copy_init(Iter first, Iter last) {
         }
     } catch (...) {
         clear();
-        base_allocator::deallocate(node_);
+        base_allocator(alloc_).deallocate(node_, 1);
         node_ = nullptr;
         throw;
     }
 }
 
 // 在 pos 处连接一个节点
-template <class T>
-typename list<T>::iterator list<T>::link_iter_node(const_iterator pos,
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator list<T, Alloc>::link_iter_node(const_iterator pos,
                                                    base_ptr link_node) {
     if (pos == node_->next) {
         link_nodes_at_front(link_node, link_node);
@@ -822,8 +895,8 @@ typename list<T>::iterator list<T>::link_iter_node(const_iterator pos,
 }
 
 // 在 pos 处连接 [first, last] 的结点
-template <class T>
-void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) {
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) {
     pos->prev->next = first;
     first->prev = pos->prev;
     pos->prev = last;
@@ -831,8 +904,8 @@ void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) {
 }
 
 // 在头部连接 [first, last] 结点
-template <class T>
-void list<T>::link_nodes_at_front(base_ptr first, base_ptr last) {
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes_at_front(base_ptr first, base_ptr last) {
     first->prev = node_;
     last->next = node_->next;
     last->next->prev = last;
@@ -840,8 +913,8 @@ void list<T>::link_nodes_at_front(base_ptr first, base_ptr last) {
 }
 
 // 在尾部连接 [first, last] 结点
-template <class T>
-void list<T>::link_nodes_at_back(base_ptr first, base_ptr last) {
+template <class T, class Alloc>
+void list<T, Alloc>::link_nodes_at_back(base_ptr first, base_ptr last) {
     last->next = node_;
     first->prev = node_->prev;
     first->prev->next = first;
@@ -850,15 +923,15 @@ void list<T>::link_nodes_at_back(base_ptr first, base_ptr last) {
 
 // 容器与 [first, last] 结点断开连接
 // 没有任何指针再指向first至last的结点
-template <class T>
-void list<T>::unlink_nodes(base_ptr first, base_ptr last) {
+template <class T, class Alloc>
+void list<T, Alloc>::unlink_nodes(base_ptr first, base_ptr last) {
     first->prev->next = last->next;
     last->next->prev = first->prev;
 }
 
 // 用 n 个元素为容器赋值
-template <class T>
-void list<T>::fill_assign(size_type n, const value_type& value) {
+template <class T, class Alloc>
+void list<T, Alloc>::fill_assign(size_type n, const value_type& value) {
     auto i = begin();
     auto e = end();
     for (; n > 0 && i != e; --n, ++i) {
@@ -872,9 +945,9 @@ void list<T>::fill_assign(size_type n, const value_type& value) {
 }
 
 // 复制[f2, l2)为容器赋值
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-void list<T>::copy_assign(Iter f2, Iter l2) {
+void list<T, Alloc>::copy_assign(Iter f2, Iter l2) {
     auto f1 = begin();
     auto l1 = end();
     for (; f1 != l1 && f2 != l2; ++f1, ++f2) {
@@ -888,8 +961,8 @@ void list<T>::copy_assign(Iter f2, Iter l2) {
 }
 
 // 在 pos 处插入 n 个元素
-template <class T>
-typename list<T>::iterator list<T>::fill_insert(const_iterator pos,
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator list<T, Alloc>::fill_insert(const_iterator pos,
                                                 size_type n,
                                                 const value_type& value) {
     iterator r(pos.node_);
@@ -924,9 +997,9 @@ typename list<T>::iterator list<T>::fill_insert(const_iterator pos,
 }
 
 // 在 pos 处插入 [first, last) 的元素
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
-typename list<T>::iterator list<T>::copy_insert(const_iterator pos,
+typename list<T, Alloc>::iterator list<T, Alloc>::copy_insert(const_iterator pos,
                                                 size_type n,
                                                 Iter first) {
     iterator r(pos.node_);
@@ -960,9 +1033,9 @@ typename list<T>::iterator list<T>::copy_insert(const_iterator pos,
 }
 
 // 对 list 进行归并排序，返回一个迭代器指向区间最小元素的位置
-template <class T>
+template <class T, class Alloc>
 template <class Compared>
-typename list<T>::iterator list<T>::list_sort(iterator f1,
+typename list<T, Alloc>::iterator list<T, Alloc>::list_sort(iterator f1,
                                               iterator l2,
                                               size_type n,
                                               Compared comp) {
@@ -1029,8 +1102,8 @@ typename list<T>::iterator list<T>::list_sort(iterator f1,
 }
 
 // 重载比较操作符
-template <class T>
-bool operator==(const list<T>& lhs, const list<T>& rhs) {
+template <class T, class Alloc>
+bool operator==(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
     auto f1 = lhs.cbegin();
     auto f2 = rhs.cbegin();
     auto l1 = lhs.cend();
@@ -1040,37 +1113,42 @@ bool operator==(const list<T>& lhs, const list<T>& rhs) {
     return f1 == l1 && f2 == l2;
 }
 
-template <class T>
-bool operator<(const list<T>& lhs, const list<T>& rhs) {
+template <class T, class Alloc>
+bool operator<(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
     return mystl::lexicographical_compare(lhs.cbegin(), lhs.cend(),
                                           rhs.cbegin(), rhs.cend());
 }
 
-template <class T>
-bool operator!=(const list<T>& lhs, const list<T>& rhs) {
+template <class T, class Alloc>
+bool operator!=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
     return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const list<T>& lhs, const list<T>& rhs) {
+template <class T, class Alloc>
+bool operator>(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
     return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const list<T>& lhs, const list<T>& rhs) {
+template <class T, class Alloc>
+bool operator<=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
     return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const list<T>& lhs, const list<T>& rhs) {
+template <class T, class Alloc>
+bool operator>=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
     return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T>
-void swap(list<T>& lhs, list<T>& rhs) noexcept {
+template <class T, class Alloc>
+void swap(list<T, Alloc>& lhs, list<T, Alloc>& rhs) noexcept {
     lhs.swap(rhs);
 }
 
+// 哨兵节点在堆上，节点中不保存指向 list 对象本身的指针，可以按位搬移
+template <class T, class Alloc>
+struct is_trivially_relocatable<list<T, Alloc>>
+    : is_trivially_relocatable<Alloc> {};
+
 }  // namespace mystl
 #endif  // !MYTINYSTL_LIST_H_
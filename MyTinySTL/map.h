@@ -20,7 +20,11 @@ namespace mystl
 
 // 模板类 map，键值不允许重复
 // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
-template <class Key, class T, class Compare = mystl::less<Key>>
+// 参数四代表分配器，缺省使用 mystl::allocator
+// 参数五代表是否在节点中维护子树大小，为 true 时支持 select / rank，缺省为 false
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>,
+          bool Ranked = false>
 class map
 {
 public:
@@ -33,7 +37,7 @@ public:
   // 定义一个 functor，用来进行元素比较
   class value_compare : public binary_function <value_type, value_type, bool>
   {
-    friend class map<Key, T, Compare>;
+    friend class map<Key, T, Compare, Alloc, Ranked>;
   private:
     Compare comp;
     value_compare(Compare c) : comp(c) {}
@@ -46,7 +50,7 @@ public:
 
 private:
   // 以 mystl::rb_tree 作为底层机制
-  typedef mystl::rb_tree<value_type, key_compare>  base_type;
+  typedef mystl::rb_tree<value_type, key_compare, Alloc, Ranked>  base_type;
   base_type tree_;
 
 public:
@@ -69,13 +73,20 @@ public:
 
   map() = default;
 
+  explicit map(const allocator_type& alloc)
+    :tree_(alloc)
+  {
+  }
+
   template <class InputIterator>
-  map(InputIterator first, InputIterator last)
-    :tree_()
+  map(InputIterator first, InputIterator last,
+      const allocator_type& alloc = allocator_type())
+    :tree_(alloc)
   { tree_.insert_unique(first, last); }
 
-  map(std::initializer_list<value_type> ilist) 
-    :tree_()
+  map(std::initializer_list<value_type> ilist,
+      const allocator_type& alloc = allocator_type()) 
+    :tree_(alloc)
   { tree_.insert_unique(ilist.begin(), ilist.end()); }
 
   map(const map& rhs) 
@@ -231,6 +242,17 @@ public:
   iterator       find(const key_type& key)              { return tree_.find(key); }
   const_iterator find(const key_type& key)        const { return tree_.find(key); }
 
+  // 批量查找，对每个键值依次写入 find 的结果或是否存在
+  template <class ForwardIter, class OutputIter>
+  OutputIter     find_batch(ForwardIter first, ForwardIter last, OutputIter result)
+  { return tree_.find_batch(first, last, result); }
+  template <class ForwardIter, class OutputIter>
+  OutputIter     find_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+  { return tree_.find_batch(first, last, result); }
+  template <class ForwardIter, class OutputIter>
+  OutputIter     contains_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+  { return tree_.contains_batch(first, last, result); }
+
   size_type      count(const key_type& key)       const { return tree_.count_unique(key); }
 
   iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
@@ -247,6 +269,15 @@ public:
     equal_range(const key_type& key) const 
   { return tree_.equal_range_unique(key); }
 
+  // 顺序统计，需要 Ranked 为 true
+  iterator       select(size_type k)                    { return tree_.select(k); }
+  const_iterator select(size_type k)              const { return tree_.select(k); }
+  size_type      rank(const key_type& key)        const { return tree_.rank(key); }
+
+  // 集合运算，O(n + m)，结果保存在本容器中，键值相等时保留本容器的元素
+  void           union_with(const map& rhs)     { tree_.union_with(rhs.tree_); }
+  void           intersect_with(const map& rhs) { tree_.intersect_with(rhs.tree_); }
+
   void           swap(map& rhs) noexcept
   { tree_.swap(rhs.tree_); }
 
@@ -256,45 +287,45 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator==(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator<(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator!=(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator>(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator<=(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator>=(const map<Key, T, Compare, Alloc, Ranked>& lhs, const map<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Compare>
-void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+void swap(map<Key, T, Compare, Alloc, Ranked>& lhs, map<Key, T, Compare, Alloc, Ranked>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
@@ -303,7 +334,11 @@ void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept
 
 // 模板类 multimap，键值允许重复
 // 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
-template <class Key, class T, class Compare = mystl::less<Key>>
+// 参数四代表分配器，缺省使用 mystl::allocator
+// 参数五代表是否在节点中维护子树大小，为 true 时支持 select / rank，缺省为 false
+template <class Key, class T, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>,
+          bool Ranked = false>
 class multimap
 {
 public:
@@ -316,7 +351,7 @@ public:
   // 定义一个 functor，用来进行元素比较
   class value_compare : public binary_function <value_type, value_type, bool>
   {
-    friend class multimap<Key, T, Compare>;
+    friend class multimap<Key, T, Compare, Alloc, Ranked>;
   private:
     Compare comp;
     value_compare(Compare c) : comp(c) {}
@@ -329,7 +364,7 @@ public:
 
 private:
   // 用 mystl::rb_tree 作为底层机制
-  typedef mystl::rb_tree<value_type, key_compare>  base_type;
+  typedef mystl::rb_tree<value_type, key_compare, Alloc, Ranked>  base_type;
   base_type tree_;
 
 public:
@@ -352,12 +387,19 @@ public:
 
   multimap() = default;
 
+  explicit multimap(const allocator_type& alloc)
+    :tree_(alloc)
+  {
+  }
+
   template <class InputIterator>
-  multimap(InputIterator first, InputIterator last) 
-    :tree_() 
+  multimap(InputIterator first, InputIterator last,
+      const allocator_type& alloc = allocator_type()) 
+    :tree_(alloc) 
   { tree_.insert_multi(first, last); }
-  multimap(std::initializer_list<value_type> ilist) 
-    :tree_() 
+  multimap(std::initializer_list<value_type> ilist,
+      const allocator_type& alloc = allocator_type()) 
+    :tree_(alloc) 
   { tree_.insert_multi(ilist.begin(), ilist.end()); }
 
   multimap(const multimap& rhs)
@@ -476,6 +518,17 @@ public:
   iterator       find(const key_type& key)              { return tree_.find(key); }
   const_iterator find(const key_type& key)        const { return tree_.find(key); }
 
+  // 批量查找，对每个键值依次写入 find 的结果或是否存在
+  template <class ForwardIter, class OutputIter>
+  OutputIter     find_batch(ForwardIter first, ForwardIter last, OutputIter result)
+  { return tree_.find_batch(first, last, result); }
+  template <class ForwardIter, class OutputIter>
+  OutputIter     find_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+  { return tree_.find_batch(first, last, result); }
+  template <class ForwardIter, class OutputIter>
+  OutputIter     contains_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+  { return tree_.contains_batch(first, last, result); }
+
   size_type      count(const key_type& key)       const { return tree_.count_multi(key); }
 
   iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
@@ -492,6 +545,15 @@ public:
     equal_range(const key_type& key) const 
   { return tree_.equal_range_multi(key); }
 
+  // 顺序统计，需要 Ranked 为 true
+  iterator       select(size_type k)                    { return tree_.select(k); }
+  const_iterator select(size_type k)              const { return tree_.select(k); }
+  size_type      rank(const key_type& key)        const { return tree_.rank(key); }
+
+  // 集合运算，O(n + m)，结果保存在本容器中，键值相等时保留本容器的元素
+  void           union_with(const multimap& rhs)     { tree_.union_with(rhs.tree_); }
+  void           intersect_with(const multimap& rhs) { tree_.intersect_with(rhs.tree_); }
+
   void swap(multimap& rhs) noexcept
   { tree_.swap(rhs.tree_); }
 
@@ -501,45 +563,45 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class T, class Compare>
-bool operator==(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator==(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator<(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return lhs < rhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator!=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator!=(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return !(lhs == rhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator>(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return rhs < lhs;
 }
 
-template <class Key, class T, class Compare>
-bool operator<=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator<=(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return !(rhs < lhs);
 }
 
-template <class Key, class T, class Compare>
-bool operator>=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs)
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+bool operator>=(const multimap<Key, T, Compare, Alloc, Ranked>& lhs, const multimap<Key, T, Compare, Alloc, Ranked>& rhs)
 {
   return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Compare>
-void swap(multimap<Key, T, Compare>& lhs, multimap<Key, T, Compare>& rhs) noexcept
+template <class Key, class T, class Compare, class Alloc, bool Ranked>
+void swap(multimap<Key, T, Compare, Alloc, Ranked>& lhs, multimap<Key, T, Compare, Alloc, Ranked>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
@@ -13,6 +13,11 @@
 #include "construct.h"
 #include "uninitialized.h"
 
+#if defined(_MSC_VER) && !defined(__clang__) && \
+    (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
 namespace mystl {
 
 // 获取对象地址
@@ -21,6 +26,17 @@ constexpr Tp* address_of(Tp& value) noexcept {
     return &value;
 }
 
+// 提示 CPU 把 p 所在的缓存行预先读入缓存，不会访问 p，p 可以是任意地址
+inline void prefetch(const void* p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
 // 获取/释放 临时缓冲区
 // `len` 表示需要申请的内存大小，`T*` 表示指向类型 `T` 的指针
 template <class T>
@@ -110,7 +126,8 @@ private:
 // 构造函数
 template <class ForwardIterator, class T>
 temporary_buffer<ForwardIterator, T>::
-    temporary_buffer(ForwardIterator first, ForwardIterator last) {
+    temporary_buffer(ForwardIterator first, ForwardIterator last)
+    : original_len(0), len(0), buffer(nullptr) {
     try {
         len = mystl::distance(first, last);
         allocate_buffer();
@@ -0,0 +1,346 @@
+#ifndef MYTINYSTL_PARALLEL_ALGO_H_
+#define MYTINYSTL_PARALLEL_ALGO_H_
+
+// 这个头文件包含并行算法，放在 mystl::parallel 命名空间中
+// thread_pool : 固定数量工作线程的线程池，等待任务的线程也会帮助执行任务
+// sort        : 并行的内省式排序
+
+// notes:
+//
+// parallel::sort 在每个线程至少分到 grain 个元素时先做一轮样本排序(samplesort)：
+// 随机抽取 (桶数 * 16) 个元素排序后选出分割元素，各线程并行地给自己那一块元素分类、
+// 再搬到缓冲区中对应的桶，最后每个桶作为一个任务搬回原区间并排序，
+// 与分割元素等价的元素单独成桶，不用再排序，大量重复元素时也能分得开。
+// 串行的部分只剩抽样与前缀和，与 n 无关；代价是一个 n 个元素的缓冲区与两趟搬移，
+// 线程数较多时会先受内存带宽限制
+//
+// 桶内(以及缓冲区申请失败、数据量不够时)沿用 mystl::sort 的 median / unchecked_partition
+// 分割区间，每次分割后把右半部分作为新任务交给线程池，当前线程继续分割左半部分，
+// 区间小于 grain 后用 mystl::sort 串行排序；分割深度超过限制时改用 heap sort。
+// 这种方式第 k 层只有 2^k 个任务，顶层几次分割基本是串行的，关键路径约为 2n 次比较，
+// 不论线程多少加速比都不超过约 log2(n)/3，1e7 个元素时约为 7 倍
+// 比较函数在多个线程中同时调用，不能修改共享的状态；任务中抛出的异常会导致 std::terminate
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "algo.h"
+#include "deque.h"
+#include "memory.h"
+#include "vector.h"
+
+namespace mystl {
+namespace parallel {
+
+// 并行排序的最小区间，不超过这个大小的区间直接串行排序
+constexpr size_t kParallelSortGrain = 1 << 14;
+
+// 样本排序的分割元素个数上限，桶号(含相等元素的桶)用 unsigned char 保存
+constexpr size_t kSampleSortMaxSplitters = 127;
+
+// 每个桶抽取的样本数
+constexpr size_t kSampleSortOversampling = 16;
+
+/*****************************************************************************************/
+// thread_pool
+// concurrency 个线程参与执行任务：concurrency - 1 个工作线程，加上调用 help_while 的线程
+/*****************************************************************************************/
+class thread_pool {
+private:
+    mystl::vector<std::thread> workers_;
+    mystl::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;  // 有新任务或有任务完成时通知
+    bool stop_;
+
+public:
+    explicit thread_pool(size_t concurrency = hardware_concurrency())
+        : stop_(false) {
+        if (concurrency == 0)
+            concurrency = 1;
+        workers_.reserve(concurrency - 1);
+        for (size_t i = 1; i < concurrency; ++i)
+            workers_.emplace_back(&thread_pool::worker_loop, this);
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_)
+            t.join();
+    }
+
+    size_t concurrency() const noexcept { return workers_.size() + 1; }
+
+    static size_t hardware_concurrency() noexcept {
+        const size_t n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(mystl::move(task));
+        }
+        cv_.notify_all();
+    }
+
+    // 在 busy() 为 true 期间帮助执行队列中的任务，队列为空时等待
+    // busy() 的结果只能在某个任务完成时改变
+    template <class Busy>
+    void help_while(Busy busy) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (busy()) {
+            if (tasks_.empty()) {
+                cv_.wait(lock);
+                continue;
+            }
+            auto task = mystl::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+private:
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty())
+                return;
+            auto task = mystl::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            cv_.notify_all();
+        }
+    }
+};
+
+// 缺省的线程池，线程数为硬件支持的并发线程数
+inline thread_pool& default_pool() {
+    static thread_pool pool;
+    return pool;
+}
+
+/*****************************************************************************************/
+// sort
+// 将[first, last)内的元素以递增的方式排序，结果与 mystl::sort 相同
+/*****************************************************************************************/
+struct psort_state {
+    thread_pool* pool;
+    size_t grain;
+    std::atomic<size_t> pending;  // 尚未完成的任务数
+};
+
+template <class RandomIter, class Compared>
+void psort_task(psort_state* st,
+                RandomIter first,
+                RandomIter last,
+                size_t depth_limit,
+                Compared comp) {
+    while (static_cast<size_t>(last - first) > st->grain) {
+        if (depth_limit == 0) {  // 到达最大分割深度限制
+            mystl::partial_sort(first, last, last, comp);  // 改用 heap_sort
+            first = last;
+            break;
+        }
+        --depth_limit;
+        auto mid = mystl::median(*first, *(first + (last - first) / 2),
+                                 *(last - 1), comp);
+        auto cut = mystl::unchecked_partition(first, last, mid, comp);
+        // 右半部分交给线程池，当前线程继续处理左半部分
+        st->pending.fetch_add(1, std::memory_order_relaxed);
+        st->pool->submit([st, cut, last, depth_limit, comp] {
+            mystl::parallel::psort_task(st, cut, last, depth_limit, comp);
+        });
+        last = cut;
+    }
+    mystl::sort(first, last, comp);
+    st->pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+// 并行执行 fn(0), fn(1), ..., fn(count - 1)，当前线程执行 fn(0) 后帮助执行其余任务
+template <class Fn>
+void pfor_run(Fn& fn, size_t i) noexcept {
+    fn(i);
+}
+
+template <class Fn>
+void parallel_for(thread_pool& pool, size_t count, Fn fn) {
+    std::atomic<size_t> pending(count);
+    for (size_t i = 1; i < count; ++i) {
+        pool.submit([&pending, &fn, i] {
+            mystl::parallel::pfor_run(fn, i);
+            pending.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+    mystl::parallel::pfor_run(fn, 0);
+    pending.fetch_sub(1, std::memory_order_acq_rel);
+    pool.help_while([&pending] {
+        return pending.load(std::memory_order_acquire) != 0;
+    });
+}
+
+// 样本排序，缓冲区申请失败时返回 false，此时区间没有被改动
+// 第 2j 个桶放 (s[j-1], s[j]) 内的元素，第 2j+1 个桶放与 s[j] 等价的元素
+template <class RandomIter, class Compared>
+bool psample_sort(psort_state* st,
+                  RandomIter first,
+                  RandomIter last,
+                  size_t depth_limit,
+                  Compared comp) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t blocks = st->pool->concurrency();
+    temporary_buffer<RandomIter, value_type> buf(first, last);
+    if (static_cast<size_t>(buf.size()) != n)
+        return false;
+
+    // 抽样并选出互不等价的分割元素
+    size_t buckets = blocks * 4;
+    if (buckets > kSampleSortMaxSplitters + 1)
+        buckets = kSampleSortMaxSplitters + 1;
+    const size_t sample_size = buckets * kSampleSortOversampling;
+    mystl::vector<value_type> sample;
+    sample.reserve(sample_size);
+    uint64_t seed = n;
+    for (size_t i = 0; i < sample_size; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        sample.push_back(*(first + static_cast<size_t>((seed >> 16) % n)));
+    }
+    mystl::sort(sample.begin(), sample.end(), comp);
+    mystl::vector<value_type> splitters;
+    splitters.reserve(buckets - 1);
+    for (size_t i = 1; i < buckets; ++i) {
+        const value_type& s = sample[i * kSampleSortOversampling];
+        if (splitters.empty() || comp(splitters.back(), s))
+            splitters.push_back(s);
+    }
+    const size_t k = splitters.size();
+    const size_t nb = 2 * k + 1;
+
+    // 各块并行分类，记下每个元素的桶号与每块各个桶的元素个数
+    mystl::vector<unsigned char> ids(n);
+    mystl::vector<size_t> counts(blocks * nb, 0);
+    mystl::parallel::parallel_for(*st->pool, blocks, [&](size_t b) {
+        size_t* cnt = counts.data() + b * nb;
+        const size_t lo = n * b / blocks, hi = n * (b + 1) / blocks;
+        for (size_t i = lo; i < hi; ++i) {
+            const value_type& x = *(first + i);
+            const size_t j = static_cast<size_t>(
+                mystl::lower_bound(splitters.begin(), splitters.end(), x, comp) -
+                splitters.begin());
+            const size_t id = 2 * j + (j < k && !comp(x, splitters[j]) ? 1 : 0);
+            ids[i] = static_cast<unsigned char>(id);
+            ++cnt[id];
+        }
+    });
+
+    // 桶在前、块在后做前缀和，得到每块每个桶在缓冲区中的起始位置
+    mystl::vector<size_t> bucket_begin(nb + 1, 0);
+    size_t sum = 0;
+    for (size_t id = 0; id < nb; ++id) {
+        bucket_begin[id] = sum;
+        for (size_t b = 0; b < blocks; ++b) {
+            const size_t c = counts[b * nb + id];
+            counts[b * nb + id] = sum;
+            sum += c;
+        }
+    }
+    bucket_begin[nb] = sum;
+
+    value_type* out = buf.begin();
+    mystl::parallel::parallel_for(*st->pool, blocks, [&](size_t b) {
+        size_t* pos = counts.data() + b * nb;
+        const size_t lo = n * b / blocks, hi = n * (b + 1) / blocks;
+        for (size_t i = lo; i < hi; ++i)
+            out[pos[ids[i]]++] = mystl::move(*(first + i));
+    });
+
+    // 每个非空的桶作为一个任务搬回原区间，不相等的桶接着排序
+    size_t tasks = 0;
+    for (size_t id = 0; id < nb; ++id)
+        if (bucket_begin[id] != bucket_begin[id + 1])
+            ++tasks;
+    st->pending.store(tasks, std::memory_order_relaxed);
+    const size_t* bounds = bucket_begin.data();
+    for (size_t id = 0; id < nb; ++id) {
+        const size_t lo = bounds[id], hi = bounds[id + 1];
+        if (lo == hi)
+            continue;
+        st->pool->submit([st, out, first, lo, hi, id, depth_limit, comp] {
+            mystl::move(out + lo, out + hi, first + lo);
+            if (id % 2 == 0) {
+                mystl::parallel::psort_task(st, first + lo, first + hi,
+                                            depth_limit, comp);
+            } else {
+                st->pending.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        });
+    }
+    st->pool->help_while([st] {
+        return st->pending.load(std::memory_order_acquire) != 0;
+    });
+    return true;
+}
+
+template <class RandomIter, class Compared>
+void sort(thread_pool& pool, RandomIter first, RandomIter last, Compared comp) {
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t threads = pool.concurrency();
+    // 每个线程大约分到 16 个任务，以平衡各个区间大小的差异
+    size_t grain = n / (threads * 16);
+    if (grain < kParallelSortGrain)
+        grain = kParallelSortGrain;
+    if (threads == 1 || n <= grain) {
+        mystl::sort(first, last, comp);
+        return;
+    }
+    psort_state st;
+    st.pool = &pool;
+    st.grain = grain;
+    const size_t depth_limit = mystl::slg2(n) * 2;
+    if (n / threads >= kParallelSortGrain &&
+        mystl::parallel::psample_sort(&st, first, last, depth_limit, comp))
+        return;
+    st.pending.store(1, std::memory_order_relaxed);
+    mystl::parallel::psort_task(&st, first, last, depth_limit, comp);
+    pool.help_while([&st] {
+        return st.pending.load(std::memory_order_acquire) != 0;
+    });
+}
+
+template <class RandomIter>
+void sort(thread_pool& pool, RandomIter first, RandomIter last) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    mystl::parallel::sort(pool, first, last, mystl::less<value_type>());
+}
+
+// 使用缺省的线程池
+template <class RandomIter, class Compared>
+void sort(RandomIter first, RandomIter last, Compared comp) {
+    mystl::parallel::sort(default_pool(), first, last, comp);
+}
+
+template <class RandomIter>
+void sort(RandomIter first, RandomIter last) {
+    mystl::parallel::sort(default_pool(), first, last);
+}
+
+}  // namespace parallel
+}  // namespace mystl
+#endif  // !MYTINYSTL_PARALLEL_ALGO_H_
@@ -0,0 +1,209 @@
+#ifndef MYTINYSTL_POOL_ALLOCATOR_H_
+#define MYTINYSTL_POOL_ALLOCATOR_H_
+
+// 这个头文件包含一个模板类 pool_allocator，按大小分级的内存池分配器
+// 适合 list、map、unordered_map 等每次只分配一个节点的容器
+
+// notes:
+//
+// 小于等于 pool_max_bytes 的请求按 8 字节对齐分成若干级，每一级维护一条自由链表，
+// 链表为空时从一块 slab 中一次切出多个块补充；更大的请求直接交给 ::operator new
+// 每个线程拥有自己的自由链表，分配与回收不需要加锁；一个线程释放的块会进入该线程的链表
+// 线程退出时，它的自由链表与 slab 交给一个加锁的全局池，之后其他线程补充链表时先从全局池中取，
+// 所以块可以在分配它的线程退出后继续使用；slab 在程序结束前不会归还给系统
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+#include "allocator.h"
+
+namespace mystl {
+
+// 内存池的参数
+constexpr size_t pool_align = 8;        // 块大小的对齐单位
+constexpr size_t pool_max_bytes = 256;  // 由内存池管理的最大块
+constexpr size_t pool_class_count = pool_max_bytes / pool_align;
+constexpr size_t pool_slab_bytes = 16 * 1024;  // 每次向系统申请的 slab 大小
+
+// node_pool : 每个线程一份的分级自由链表
+class node_pool {
+private:
+    union block {
+        block* next;
+        char data[1];
+    };
+
+    // slab 的头部，把所有 slab 串起来，使它们在程序结束时仍然可达
+    struct slab {
+        slab* next;
+        alignas(std::max_align_t) char data[1];
+    };
+
+    // 线程退出时交回的块与 slab
+    struct shared_state {
+        std::mutex lock;
+        block* free_list[pool_class_count];
+        slab* slabs;
+    };
+
+    struct state {
+        block* free_list[pool_class_count];
+        slab* slabs;
+
+        // 线程退出时把自由链表与 slab 接到全局池的前面
+        ~state() {
+            shared_state& g = shared();
+            std::lock_guard<std::mutex> guard(g.lock);
+            for (size_t i = 0; i < pool_class_count; ++i) {
+                block* b = free_list[i];
+                if (b == nullptr)
+                    continue;
+                while (b->next != nullptr)
+                    b = b->next;
+                b->next = g.free_list[i];
+                g.free_list[i] = free_list[i];
+            }
+            if (slabs != nullptr) {
+                slab* sl = slabs;
+                while (sl->next != nullptr)
+                    sl = sl->next;
+                sl->next = g.slabs;
+                g.slabs = slabs;
+            }
+        }
+    };
+
+    static state& local() noexcept {
+        static thread_local state s;  // 零初始化，不需要动态初始化
+        return s;
+    }
+
+    // 全局池不析构，程序结束时仍在运行的线程退出时还会用到
+    static shared_state& shared() {
+        static shared_state* g = new shared_state();
+        return *g;
+    }
+
+    static size_t class_index(size_t bytes) noexcept {
+        return (bytes + pool_align - 1) / pool_align - 1;
+    }
+
+    // 自由链表为空时，先取走全局池中 index 级的整条链表，全局池也为空时
+    // 申请一个 slab 并切分成 index 级的块
+    static block* refill(state& s, size_t index) {
+        {
+            shared_state& g = shared();
+            std::lock_guard<std::mutex> guard(g.lock);
+            block* b = g.free_list[index];
+            if (b != nullptr) {
+                g.free_list[index] = nullptr;
+                return b;
+            }
+        }
+        const size_t size = (index + 1) * pool_align;
+        const size_t head = offsetof(slab, data);
+        const size_t count = (pool_slab_bytes - head) / size;
+        slab* sl = static_cast<slab*>(::operator new(head + count * size));
+        sl->next = s.slabs;
+        s.slabs = sl;
+        char* p = sl->data;
+        block* first = reinterpret_cast<block*>(p);
+        for (size_t i = 1; i < count; ++i) {
+            reinterpret_cast<block*>(p)->next = reinterpret_cast<block*>(p + size);
+            p += size;
+        }
+        reinterpret_cast<block*>(p)->next = nullptr;
+        return first;
+    }
+
+public:
+    // bytes 必须在 (0, pool_max_bytes] 之内
+    static void* allocate(size_t bytes) {
+        state& s = local();
+        block*& head = s.free_list[class_index(bytes)];
+        block* b = head;
+        if (b == nullptr)
+            b = refill(s, class_index(bytes));
+        head = b->next;
+        return b;
+    }
+
+    static void deallocate(void* p, size_t bytes) noexcept {
+        block*& head = local().free_list[class_index(bytes)];
+        block* b = static_cast<block*>(p);
+        b->next = head;
+        head = b;
+    }
+};
+
+// 模板类：pool_allocator
+// 无状态，所有实例共享当前线程的内存池
+template <class T>
+class pool_allocator {
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    typedef m_true_type is_always_equal;
+
+    template <class U>
+    struct rebind {
+        typedef pool_allocator<U> other;
+    };
+
+public:
+    pool_allocator() noexcept = default;
+    template <class U>
+    pool_allocator(const pool_allocator<U>&) noexcept {}
+
+    static T* allocate() { return allocate(1); }
+    static T* allocate(size_type n) {
+        if (n == 0)
+            return nullptr;
+        if (!use_pool(n))
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(node_pool::allocate(n * sizeof(T)));
+    }
+
+    static void deallocate(T* ptr) { deallocate(ptr, 1); }
+    static void deallocate(T* ptr, size_type n) {
+        if (ptr == nullptr)
+            return;
+        if (!use_pool(n))
+            ::operator delete(ptr);
+        else
+            node_pool::deallocate(ptr, n * sizeof(T));
+    }
+
+    template <class... Args>
+    static void construct(T* ptr, Args&&... args) {
+        mystl::construct(ptr, mystl::forward<Args>(args)...);
+    }
+
+    static void destroy(T* ptr) { mystl::destroy(ptr); }
+    static void destroy(T* first, T* last) { mystl::destroy(first, last); }
+
+private:
+    static bool use_pool(size_type n) noexcept {
+        return alignof(T) <= pool_align && n <= pool_max_bytes / sizeof(T);
+    }
+};
+
+template <class T, class U>
+bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) noexcept {
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) noexcept {
+    return false;
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_POOL_ALLOCATOR_H_
@@ -0,0 +1,378 @@
+#ifndef MYTINYSTL_RADIX_SORT_H_
+#define MYTINYSTL_RADIX_SORT_H_
+
+// 这个头文件包含基数排序 radix_sort
+// radix_sort(first, last)      : 按元素本身排序
+// radix_sort(first, last, key) : 按 key(元素) 的结果排序
+
+// notes:
+//
+// 1. 键为整数或 IEEE 浮点数时，有符号整数翻转符号位，浮点数为负时翻转全部位、为正时翻转符号位，
+//    使无符号比较的结果与 < 一致（-0.0 排在 0.0 之前，NaN 按位排列在两端）
+//    不超过 32 位的键使用 LSD 基数排序，每趟处理 8 或 11 位，
+//    所有趟的计数在第一遍扫描中完成，所有元素该位相同的趟直接跳过
+//    64 位的键用 LSD 要 6 趟，随机数据时比 mystl::sort 还慢，改为从最高的不全相同的字节开始，
+//    按字节做 MSD 基数排序，随机数据两三层后桶就小到可以插入排序
+//    需要一个与区间等长的临时缓冲区，申请不到时改用 mystl::stable_sort；结果是稳定的
+// 2. 键为 mystl::basic_string<char> 时使用 MSD 基数排序（American flag sort），
+//    原地交换元素，不需要临时缓冲区；小区间改用插入排序；结果不稳定
+// 3. 元素个数不超过 kRadixSortThreshold 时直接使用插入排序，同样是稳定的
+// 4. key 会被多次调用，键为字符串时应返回引用
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "algo.h"
+#include "basic_string.h"
+#include "functional.h"
+#include "memory.h"
+#include "vector.h"
+
+namespace mystl {
+
+// 不超过这个大小的区间使用插入排序
+constexpr size_t kRadixSortThreshold = 256;
+// MSD 基数排序中，不超过这个大小的桶使用插入排序
+constexpr size_t kRadixInsertionCutoff = 32;
+
+// 基数排序的方式
+struct radix_lsd_tag {};
+struct radix_msd_tag {};
+
+// radix_key_traits : 把键转换为无符号整数，使无符号整数的顺序与键的 < 一致
+template <class Key, class = void>
+struct radix_key_traits {};
+
+// 无符号整数
+template <class Key>
+struct radix_key_traits<
+    Key,
+    typename std::enable_if<std::is_integral<Key>::value &&
+                            std::is_unsigned<Key>::value>::type> {
+    typedef radix_lsd_tag category;
+    typedef Key unsigned_type;
+    static unsigned_type to_unsigned(Key k) noexcept { return k; }
+};
+
+// 有符号整数，翻转符号位
+template <class Key>
+struct radix_key_traits<
+    Key,
+    typename std::enable_if<std::is_integral<Key>::value &&
+                            std::is_signed<Key>::value>::type> {
+    typedef radix_lsd_tag category;
+    typedef typename std::make_unsigned<Key>::type unsigned_type;
+    static unsigned_type to_unsigned(Key k) noexcept {
+        return static_cast<unsigned_type>(k) ^
+               (static_cast<unsigned_type>(1)
+                << (sizeof(Key) * CHAR_BIT - 1));
+    }
+};
+
+// IEEE 浮点数，为负时翻转全部位，否则翻转符号位
+template <class Key>
+struct radix_key_traits<
+    Key,
+    typename std::enable_if<std::is_floating_point<Key>::value>::type> {
+    static_assert(std::numeric_limits<Key>::is_iec559 &&
+                      (sizeof(Key) == 4 || sizeof(Key) == 8),
+                  "radix_sort supports only 32-bit and 64-bit IEEE floats");
+    typedef radix_lsd_tag category;
+    typedef typename std::conditional<sizeof(Key) == 4, uint32_t,
+                                      uint64_t>::type unsigned_type;
+    static unsigned_type to_unsigned(Key k) noexcept {
+        unsigned_type u;
+        std::memcpy(&u, &k, sizeof(u));
+        const unsigned_type sign = static_cast<unsigned_type>(1)
+                                   << (sizeof(Key) * CHAR_BIT - 1);
+        return (u & sign) ? ~u : (u | sign);
+    }
+};
+
+// 字符串按字节比较，只有 char 与 mystl::char_traits<char> 的组合满足
+template <class Alloc>
+struct radix_key_traits<basic_string<char, char_traits<char>, Alloc>> {
+    typedef radix_msd_tag category;
+};
+
+/*****************************************************************************************/
+// radix_sort 的辅助函数
+/*****************************************************************************************/
+
+// 按 key 比较两个元素
+template <class KeyExtractor>
+struct radix_key_less {
+    KeyExtractor key;
+    template <class T>
+    bool operator()(const T& lhs, const T& rhs) const {
+        return key(lhs) < key(rhs);
+    }
+};
+
+// LSD 基数排序每趟处理的位数：16 位及以下的键为 8 位，32 位的键为 11 位，需要 3 趟
+template <class Unsigned>
+struct radix_lsd_digit {
+    static constexpr size_t bits = sizeof(Unsigned) <= 2 ? 8 : 11;
+    static constexpr size_t buckets = static_cast<size_t>(1) << bits;
+    static constexpr size_t passes =
+        (sizeof(Unsigned) * CHAR_BIT + bits - 1) / bits;
+};
+
+// LSD 基数排序，每趟按一个数位把元素在 [first, last) 与 buffer 之间来回分配
+template <class RandomIter, class T, class KeyExtractor>
+void radix_sort_lsd(RandomIter first,
+                    RandomIter last,
+                    T* buffer,
+                    KeyExtractor key) {
+    typedef typename std::decay<decltype(key(*first))>::type key_type;
+    typedef radix_key_traits<key_type> traits;
+    typedef typename traits::unsigned_type unsigned_type;
+    typedef radix_lsd_digit<unsigned_type> digit;
+    constexpr size_t mask = digit::buckets - 1;
+
+    const size_t n = static_cast<size_t>(last - first);
+    // 一次扫描得到每一趟的计数
+    mystl::vector<size_t> counts(digit::passes * digit::buckets, 0);
+    for (auto it = first; it != last; ++it) {
+        const unsigned_type u = traits::to_unsigned(key(*it));
+        for (size_t p = 0; p < digit::passes; ++p)
+            ++counts[p * digit::buckets + ((u >> (p * digit::bits)) & mask)];
+    }
+
+    bool in_buffer = false;  // 当前数据是否在 buffer 中
+    const unsigned_type u0 = traits::to_unsigned(key(*first));
+    for (size_t p = 0; p < digit::passes; ++p) {
+        size_t* c = counts.data() + p * digit::buckets;
+        const size_t shift = p * digit::bits;
+        if (c[(u0 >> shift) & mask] == n)
+            continue;  // 所有元素这一位都相同
+        // 计数转换为每个桶的起始位置
+        size_t sum = 0;
+        for (size_t b = 0; b < digit::buckets; ++b) {
+            const size_t tmp = c[b];
+            c[b] = sum;
+            sum += tmp;
+        }
+        if (in_buffer) {
+            for (size_t i = 0; i < n; ++i) {
+                const unsigned_type u = traits::to_unsigned(key(buffer[i]));
+                *(first + c[(u >> shift) & mask]++) = mystl::move(buffer[i]);
+            }
+        } else {
+            for (auto it = first; it != last; ++it) {
+                const unsigned_type u = traits::to_unsigned(key(*it));
+                buffer[c[(u >> shift) & mask]++] = mystl::move(*it);
+            }
+        }
+        in_buffer = !in_buffer;
+    }
+    if (in_buffer)
+        mystl::move(buffer, buffer + n, first);
+}
+
+// 不为 0 的 diff 中最高的非 0 字节的起始位
+template <class Unsigned>
+size_t radix_top_byte_shift(Unsigned diff) noexcept {
+    size_t shift = 0;
+    while (shift + 8 < sizeof(Unsigned) * CHAR_BIT && (diff >> (shift + 8)) != 0)
+        shift += 8;
+    return shift;
+}
+
+// 64 位的键按字节做 MSD 基数排序，[first, last) 中的键在第 shift 位起的字节上不全相同，
+// 更高的位全部相同
+// 每层按这个字节把元素稳定地分配到 buffer 再搬回，同时记下每个桶中键的按位与、按位或，
+// 桶内直接从下一个不全相同的字节开始，键全部相同的桶不再处理
+template <class RandomIter, class T, class KeyExtractor>
+void radix_sort_msd_bytes(RandomIter first,
+                          RandomIter last,
+                          T* buffer,
+                          size_t shift,
+                          KeyExtractor key) {
+    typedef typename std::decay<decltype(key(*first))>::type key_type;
+    typedef radix_key_traits<key_type> traits;
+    typedef typename traits::unsigned_type unsigned_type;
+    const size_t n = static_cast<size_t>(last - first);
+    if (n <= kRadixInsertionCutoff) {
+        mystl::insertion_sort(first, last, radix_key_less<KeyExtractor>{key});
+        return;
+    }
+    size_t count[256];
+    std::memset(count, 0, sizeof(count));
+    for (auto it = first; it != last; ++it)
+        ++count[(traits::to_unsigned(key(*it)) >> shift) & 0xff];
+
+    size_t pos[256];
+    unsigned_type and_bits[256], or_bits[256];
+    size_t sum = 0;
+    for (size_t b = 0; b < 256; ++b) {
+        pos[b] = sum;
+        sum += count[b];
+        and_bits[b] = ~static_cast<unsigned_type>(0);
+        or_bits[b] = 0;
+    }
+    for (auto it = first; it != last; ++it) {
+        const unsigned_type u = traits::to_unsigned(key(*it));
+        const size_t d = (u >> shift) & 0xff;
+        and_bits[d] &= u;
+        or_bits[d] |= u;
+        buffer[pos[d]++] = mystl::move(*it);
+    }
+    mystl::move(buffer, buffer + n, first);
+
+    // 分配后 pos[b] 为桶 b 的末尾
+    size_t begin = 0;
+    for (size_t b = 0; b < 256; ++b) {
+        const unsigned_type diff = and_bits[b] ^ or_bits[b];
+        if (pos[b] - begin > 1 && diff != 0)
+            mystl::radix_sort_msd_bytes(first + begin, first + pos[b], buffer,
+                                        mystl::radix_top_byte_shift(diff), key);
+        begin = pos[b];
+    }
+}
+
+// 不超过 32 位的键使用 LSD 基数排序
+template <class RandomIter, class T, class KeyExtractor>
+void radix_sort_integral(RandomIter first,
+                         RandomIter last,
+                         T* buffer,
+                         KeyExtractor key,
+                         std::false_type) {
+    mystl::radix_sort_lsd(first, last, buffer, key);
+}
+
+// 64 位的键从最高的、不是所有元素都相同的字节开始做 MSD 基数排序
+template <class RandomIter, class T, class KeyExtractor>
+void radix_sort_integral(RandomIter first,
+                         RandomIter last,
+                         T* buffer,
+                         KeyExtractor key,
+                         std::true_type) {
+    typedef typename std::decay<decltype(key(*first))>::type key_type;
+    typedef radix_key_traits<key_type> traits;
+    typedef typename traits::unsigned_type unsigned_type;
+    const unsigned_type u0 = traits::to_unsigned(key(*first));
+    unsigned_type diff = 0;
+    for (auto it = first; it != last; ++it)
+        diff |= traits::to_unsigned(key(*it)) ^ u0;
+    if (diff == 0)
+        return;
+    mystl::radix_sort_msd_bytes(first, last, buffer,
+                                mystl::radix_top_byte_shift(diff), key);
+}
+
+template <class RandomIter, class KeyExtractor>
+void radix_sort_dispatch(RandomIter first,
+                         RandomIter last,
+                         KeyExtractor key,
+                         radix_lsd_tag) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    typedef typename std::decay<decltype(key(*first))>::type key_type;
+    typedef typename radix_key_traits<key_type>::unsigned_type unsigned_type;
+    temporary_buffer<RandomIter, value_type> buf(first, last);
+    if (buf.size() != last - first) {  // 空间不足，保持稳定
+        mystl::stable_sort(first, last, radix_key_less<KeyExtractor>{key});
+        return;
+    }
+    mystl::radix_sort_integral(
+        first, last, buf.begin(), key,
+        std::integral_constant<bool, (sizeof(unsigned_type) > 4)>());
+}
+
+// MSD 基数排序取第 depth 个字符，字符串在 depth 之前结束时为 0
+template <class String>
+size_t radix_digit(const String& s, size_t depth) noexcept {
+    return depth < s.size()
+               ? static_cast<size_t>(static_cast<unsigned char>(s[depth])) + 1
+               : 0;
+}
+
+// MSD 基数排序，[first, last) 中所有键的前 depth 个字符都相同
+template <class RandomIter, class KeyExtractor>
+void radix_sort_msd(RandomIter first,
+                    RandomIter last,
+                    size_t depth,
+                    KeyExtractor key) {
+    while (static_cast<size_t>(last - first) > kRadixInsertionCutoff) {
+        size_t count[257];
+        std::memset(count, 0, sizeof(count));
+        for (auto it = first; it != last; ++it)
+            ++count[mystl::radix_digit(key(*it), depth)];
+
+        const size_t n = static_cast<size_t>(last - first);
+        if (count[0] == n)
+            return;  // 所有键都在 depth 之前结束，已经相等
+        // 所有键这一位都相同，继续比较下一位
+        const size_t d0 = mystl::radix_digit(key(*first), depth);
+        if (count[d0] == n) {
+            ++depth;
+            continue;
+        }
+
+        // 原地分配：head[b] 为桶 b 中下一个待确定的位置，tail[b] 为桶 b 的末尾
+        size_t head[257], tail[257];
+        size_t sum = 0;
+        for (size_t b = 0; b < 257; ++b) {
+            head[b] = sum;
+            sum += count[b];
+            tail[b] = sum;
+        }
+        for (size_t b = 0; b < 257; ++b) {
+            while (head[b] < tail[b]) {
+                auto cur = first + head[b];
+                size_t d = mystl::radix_digit(key(*cur), depth);
+                // 把 cur 上的元素换到它的桶中，直到换来一个属于桶 b 的元素
+                while (d != b) {
+                    mystl::iter_swap(cur, first + head[d]++);
+                    d = mystl::radix_digit(key(*cur), depth);
+                }
+                ++head[b];
+            }
+        }
+
+        // 桶 0 中的键已经相等，对其余的桶递归排序
+        for (size_t b = 1; b < 257; ++b) {
+            const size_t begin = tail[b] - count[b];
+            if (count[b] > 1)
+                mystl::radix_sort_msd(first + begin, first + tail[b], depth + 1,
+                                      key);
+        }
+        return;
+    }
+    mystl::insertion_sort(first, last, radix_key_less<KeyExtractor>{key});
+}
+
+template <class RandomIter, class KeyExtractor>
+void radix_sort_dispatch(RandomIter first,
+                         RandomIter last,
+                         KeyExtractor key,
+                         radix_msd_tag) {
+    mystl::radix_sort_msd(first, last, 0, key);
+}
+
+/*****************************************************************************************/
+// radix_sort
+// 将[first, last)内的元素按 key(元素) 递增的方式排序
+// 键可以是整数、IEEE 浮点数或 mystl::basic_string<char>
+/*****************************************************************************************/
+template <class RandomIter, class KeyExtractor>
+void radix_sort(RandomIter first, RandomIter last, KeyExtractor key) {
+    typedef typename std::decay<decltype(key(*first))>::type key_type;
+    typedef typename radix_key_traits<key_type>::category category;
+    if (static_cast<size_t>(last - first) <= kRadixSortThreshold) {
+        mystl::insertion_sort(first, last, radix_key_less<KeyExtractor>{key});
+        return;
+    }
+    mystl::radix_sort_dispatch(first, last, key, category());
+}
+
+template <class RandomIter>
+void radix_sort(RandomIter first, RandomIter last) {
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    mystl::radix_sort(first, last, mystl::identity<value_type>());
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_RADIX_SORT_H_
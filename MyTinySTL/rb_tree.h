@@ -140,6 +140,49 @@ struct rb_tree_node : public rb_tree_node_base<T> {
     node_ptr get_node_ptr() { return &*this; }
 };
 
+/*! 维护子树大小的数据节点 用于支持按位次查找的 rb tree */
+template <class T>
+struct rb_tree_ranked_node : public rb_tree_node<T> {
+    size_t size;  // 以本节点为根的子树中的节点数
+};
+
+// rb tree 的子树大小维护
+// Ranked 为 false 时所有操作都为空，节点中也不保存子树大小
+template <class T, bool Ranked>
+struct rb_tree_size_traits {
+    static constexpr bool ranked = false;
+
+    template <class NodePtr>
+    static void update(NodePtr) noexcept {}
+    template <class NodePtr>
+    static void set(NodePtr, size_t) noexcept {}
+    template <class NodePtr>
+    static size_t size(NodePtr) noexcept {
+        return 0;
+    }
+};
+
+template <class T>
+struct rb_tree_size_traits<T, true> {
+    static constexpr bool ranked = true;
+
+    typedef rb_tree_node_base<T>* base_ptr;
+    typedef rb_tree_ranked_node<T>* ranked_ptr;
+
+    static size_t size(base_ptr x) noexcept {
+        return x == nullptr ? 0 : static_cast<ranked_ptr>(x)->size;
+    }
+
+    // 由左右子树重新计算 x 的子树大小
+    static void update(base_ptr x) noexcept {
+        static_cast<ranked_ptr>(x)->size = 1 + size(x->left) + size(x->right);
+    }
+
+    static void set(base_ptr x, size_t n) noexcept {
+        static_cast<ranked_ptr>(x)->size = n;
+    }
+};
+
 // rb tree traits
 
 template <class T>
@@ -234,7 +277,7 @@ struct rb_tree_iterator : public rb_tree_iterator_base<T> {
     rb_tree_iterator() {}
     rb_tree_iterator(base_ptr x) { node = x; }
     rb_tree_iterator(node_ptr x) { node = x; }
-    rb_tree_iterator(const iterator& rhs) { node = rhs.node; }
+    rb_tree_iterator(const iterator&) = default;
     rb_tree_iterator(const const_iterator& rhs) { node = rhs.node; }
 
     // 重载操作符
@@ -282,7 +325,7 @@ struct rb_tree_const_iterator : public rb_tree_iterator_base<T> {
     rb_tree_const_iterator(base_ptr x) { node = x; }
     rb_tree_const_iterator(node_ptr x) { node = x; }
     rb_tree_const_iterator(const iterator& rhs) { node = rhs.node; }
-    rb_tree_const_iterator(const const_iterator& rhs) { node = rhs.node; }
+    rb_tree_const_iterator(const const_iterator&) = default;
 
     // 重载操作符
     reference operator*() const { return node->get_node_ptr()->value; }
@@ -363,7 +406,8 @@ NodePtr rb_tree_next(NodePtr node) noexcept {
 |     b   c                 a   b         |
 \*---------------------------------------*/
 // 左旋，参数一为左旋点，参数二为根节点
-template <class NodePtr>
+// SizeTraits 用于在旋转后更新 x 与 y 的子树大小
+template <class SizeTraits = rb_tree_size_traits<void, false>, class NodePtr>
 void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept {
     auto y = x->right;  // y 为 x 的右子节点
     x->right = y->left;
@@ -381,6 +425,8 @@ void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept {
     // 调整 x 与 y 的关系
     y->left = x;
     x->parent = y;
+    SizeTraits::update(x);
+    SizeTraits::update(y);
 }
 
 /*----------------------------------------*\
@@ -393,7 +439,7 @@ void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept {
 |   b   c                         c   a    |
 \*----------------------------------------*/
 // 右旋，参数一为右旋点，参数二为根节点
-template <class NodePtr>
+template <class SizeTraits = rb_tree_size_traits<void, false>, class NodePtr>
 void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept {
     auto y = x->left;
     x->left = y->right;
@@ -411,6 +457,8 @@ void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept {
     // 调整 x 与 y 的关系
     y->right = x;
     x->parent = y;
+    SizeTraits::update(x);
+    SizeTraits::update(y);
 }
 
 // 插入节点后使 rb tree 重新平衡，参数一为新增节点，参数二为根节点
@@ -428,8 +476,12 @@ void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept {
 //
 // 参考博客: http://blog.csdn.net/v_JULY_v/article/details/6105630
 //          http://blog.csdn.net/v_JULY_v/article/details/6109153
-template <class NodePtr>
+template <class SizeTraits = rb_tree_size_traits<void, false>, class NodePtr>
 void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept {
+    if (SizeTraits::ranked) {  // 新增节点及其祖先的子树大小加一
+        for (auto p = x; p != root->parent; p = p->parent)
+            SizeTraits::update(p);
+    }
     rb_tree_set_red(x);  // 新增节点为红色
     while (x != root && rb_tree_is_red(x->parent)) {
         if (rb_tree_is_lchild(x->parent)) {  // 如果父节点是左子节点
@@ -443,12 +495,12 @@ void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept {
             } else {  // 无叔叔节点或叔叔节点为黑
                 if (!rb_tree_is_lchild(x)) {  // case 4: 当前节点 x 为右子节点
                     x = x->parent;
-                    rb_tree_rotate_left(x, root);
+                    rb_tree_rotate_left<SizeTraits>(x, root);
                 }
                 // 都转换成 case 5： 当前节点为左子节点
                 rb_tree_set_black(x->parent);
                 rb_tree_set_red(x->parent->parent);
-                rb_tree_rotate_right(x->parent->parent, root);
+                rb_tree_rotate_right<SizeTraits>(x->parent->parent, root);
                 break;
             }
         } else  // 如果父节点是右子节点，对称处理
@@ -464,12 +516,12 @@ void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept {
             } else {  // 无叔叔节点或叔叔节点为黑
                 if (rb_tree_is_lchild(x)) {  // case 4: 当前节点 x 为左子节点
                     x = x->parent;
-                    rb_tree_rotate_right(x, root);
+                    rb_tree_rotate_right<SizeTraits>(x, root);
                 }
                 // 都转换成 case 5： 当前节点为左子节点
                 rb_tree_set_black(x->parent);
                 rb_tree_set_red(x->parent->parent);
-                rb_tree_rotate_left(x->parent->parent, root);
+                rb_tree_rotate_left<SizeTraits>(x->parent->parent, root);
                 break;
             }
         }
@@ -482,7 +534,7 @@ void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept {
 //
 // 参考博客: http://blog.csdn.net/v_JULY_v/article/details/6105630
 //          http://blog.csdn.net/v_JULY_v/article/details/6109153
-template <class NodePtr>
+template <class SizeTraits = rb_tree_size_traits<void, false>, class NodePtr>
 NodePtr rb_tree_erase_rebalance(NodePtr z,
                                 NodePtr& root,
                                 NodePtr& leftmost,
@@ -545,6 +597,12 @@ NodePtr rb_tree_erase_rebalance(NodePtr z,
             rightmost = x == nullptr ? xp : rb_tree_max(x);
     }
 
+    // 被删除位置的祖先（包括顶替 z 的 y）的子树大小减一，之后的旋转会自行维护
+    if (SizeTraits::ranked && root != nullptr) {
+        for (auto p = xp; p != root->parent; p = p->parent)
+            SizeTraits::update(p);
+    }
+
     // 此时，y 指向要删除的节点，x 为替代节点，从 x 节点开始调整。
     // 如果删除的节点为红色，树的性质没有被破坏，否则按照以下情况调整（x
     // 为左子节点为例）： case 1:
@@ -563,7 +621,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z,
                 if (rb_tree_is_red(brother)) {  // case 1
                     rb_tree_set_black(brother);
                     rb_tree_set_red(xp);
-                    rb_tree_rotate_left(xp, root);
+                    rb_tree_rotate_left<SizeTraits>(xp, root);
                     brother = xp->right;
                 }
                 // case 1 转为为了 case 2、3、4 中的一种
@@ -580,7 +638,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z,
                         if (brother->left != nullptr)
                             rb_tree_set_black(brother->left);
                         rb_tree_set_red(brother);
-                        rb_tree_rotate_right(brother, root);
+                        rb_tree_rotate_right<SizeTraits>(brother, root);
                         brother = xp->right;
                     }
                     // 转为 case 4
@@ -588,7 +646,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z,
                     rb_tree_set_black(xp);
                     if (brother->right != nullptr)
                         rb_tree_set_black(brother->right);
-                    rb_tree_rotate_left(xp, root);
+                    rb_tree_rotate_left<SizeTraits>(xp, root);
                     break;
                 }
             } else  // x 为右子节点，对称处理
@@ -597,7 +655,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z,
                 if (rb_tree_is_red(brother)) {  // case 1
                     rb_tree_set_black(brother);
                     rb_tree_set_red(xp);
-                    rb_tree_rotate_right(xp, root);
+                    rb_tree_rotate_right<SizeTraits>(xp, root);
                     brother = xp->left;
                 }
                 if ((brother->left == nullptr ||
@@ -613,7 +671,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z,
                         if (brother->right != nullptr)
                             rb_tree_set_black(brother->right);
                         rb_tree_set_red(brother);
-                        rb_tree_rotate_left(brother, root);
+                        rb_tree_rotate_left<SizeTraits>(brother, root);
                         brother = xp->left;
                     }
                     // 转为 case 4
@@ -621,7 +679,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z,
                     rb_tree_set_black(xp);
                     if (brother->left != nullptr)
                         rb_tree_set_black(brother->left);
-                    rb_tree_rotate_right(xp, root);
+                    rb_tree_rotate_right<SizeTraits>(xp, root);
                     break;
                 }
             }
@@ -633,8 +691,12 @@ NodePtr rb_tree_erase_rebalance(NodePtr z,
 }
 
 // 模板类 rb_tree
-// 参数一代表数据类型，参数二代表键值比较类型
-template <class T, class Compare>
+// 参数一代表数据类型，参数二代表键值比较类型，参数三代表分配器
+// 参数四为 true 时每个节点额外维护子树大小，支持 O(log n) 的 select 与 rank
+template <class T,
+          class Compare,
+          class Alloc = mystl::allocator<T>,
+          bool Ranked = false>
 class rb_tree {
 public:
     // rb_tree 的嵌套型别定义
@@ -645,7 +707,12 @@ public:
 
     typedef typename tree_traits::base_type base_type; 
     typedef typename tree_traits::base_ptr base_ptr; 
-    typedef typename tree_traits::node_type node_type; 
+    /*! 子树大小维护，Ranked 为 false 时不做任何事 */
+    typedef rb_tree_size_traits<T, Ranked> size_traits;
+    typedef typename std::conditional<Ranked,
+                                      rb_tree_ranked_node<T>,
+                                      typename tree_traits::node_type>::type
+        node_type;
     typedef typename tree_traits::node_ptr node_ptr; 
     typedef typename tree_traits::key_type key_type;
     typedef typename tree_traits::mapped_type mapped_type;
@@ -653,10 +720,10 @@ public:
     typedef Compare key_compare;
 
     /*! 数据分配器 */
-    typedef mystl::allocator<T> allocator_type;
-    typedef mystl::allocator<T> data_allocator;
-    typedef mystl::allocator<base_type> base_allocator;
-    typedef mystl::allocator<node_type> node_allocator;
+    typedef Alloc allocator_type;
+    typedef mystl::allocator_traits<Alloc> alloc_traits;
+    typedef typename alloc_traits::template rebind_alloc<base_type> base_allocator;
+    typedef typename alloc_traits::template rebind_alloc<node_type> node_allocator;
 
     typedef typename allocator_type::pointer pointer;
     typedef typename allocator_type::const_pointer const_pointer;
@@ -670,10 +737,12 @@ public:
     typedef mystl::reverse_iterator<iterator> reverse_iterator;
     typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
 
-    allocator_type get_allocator() const { return node_allocator(); }
+    allocator_type get_allocator() const { return allocator_type(alloc_); }
     key_compare key_comp() const { return key_comp_; }
 
 private:
+    node_allocator alloc_;  // 节点的分配器
+
     // 用以下三个数据表现 rb tree
     base_ptr header_;  // 特殊节点，与根节点互为对方的父节点
     size_type node_count_;  // 节点数
@@ -687,15 +756,25 @@ private:
 
 public:
     // 构造、复制、析构函数
-    rb_tree() { rb_tree_init(); }
+    rb_tree() : alloc_(allocator_type()) { rb_tree_init(); }
+
+    explicit rb_tree(const allocator_type& alloc) : alloc_(alloc) {
+        rb_tree_init();
+    }
 
     rb_tree(const rb_tree& rhs);
     rb_tree(rb_tree&& rhs) noexcept;
 
     rb_tree& operator=(const rb_tree& rhs);
-    rb_tree& operator=(rb_tree&& rhs);
+    rb_tree& operator=(rb_tree&& rhs) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value);
 
-    ~rb_tree() { clear(); }
+    ~rb_tree() {
+        clear();
+        if (header_ != nullptr)
+            base_allocator(alloc_).deallocate(header_, 1);
+    }
 
 public:
     // 迭代器相关操作
@@ -755,11 +834,16 @@ public:
         return emplace_multi_use_hint(hint, mystl::move(value));
     }
 
+    // 树为空时先把元素串成一条链，有序则 O(n) 直接建成平衡树，否则逐个插入
     template <class InputIterator>
     void insert_multi(InputIterator first, InputIterator last) {
         size_type n = mystl::distance(first, last);
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n,
                               "rb_tree<T, Comp>'s size too big");
+        if (empty()) {
+            build_from(first, last, false);
+            return;
+        }
         for (; n > 0; --n, ++first)
             insert_multi(end(), *first);
     }
@@ -781,6 +865,10 @@ public:
         size_type n = mystl::distance(first, last);
         THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n,
                               "rb_tree<T, Comp>'s size too big");
+        if (empty()) {
+            build_from(first, last, true);
+            return;
+        }
         for (; n > 0; --n, ++first)
             insert_unique(end(), *first);
     }
@@ -825,6 +913,32 @@ public:
                                                            upper_bound(key));
     }
 
+    // 批量查找：对 [first, last) 中的每个键值依次向 result 写入 find 的结果
+    // 一组键值交替地从根向下走一层并预取下一层的节点，使各次查找的缓存缺失重叠
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first, ForwardIter last, OutputIter result);
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first,
+                          ForwardIter last,
+                          OutputIter result) const;
+
+    // 批量查找：对每个键值依次向 result 写入一个 bool，表示是否存在
+    template <class ForwardIter, class OutputIter>
+    OutputIter contains_batch(ForwardIter first,
+                              ForwardIter last,
+                              OutputIter result) const;
+
+    // 按位次查找，仅在 Ranked 为 true 时可用
+
+    // 第 k 个元素（从 0 开始），k 不小于 size() 时返回 end()
+    iterator select(size_type k) { return iterator(select_node(k)); }
+    const_iterator select(size_type k) const {
+        return const_iterator(select_node(k));
+    }
+
+    // 键值小于 key 的元素个数，即 lower_bound(key) 之前的元素个数
+    size_type rank(const key_type& key) const;
+
     mystl::pair<iterator, iterator> equal_range_unique(const key_type& key) {
         iterator it = find(key);
         auto next = it;
@@ -839,6 +953,14 @@ public:
                            : mystl::make_pair(it, ++next);
     }
 
+    // 集合运算，O(n + m)：两棵树同时中序归并，结果重新建成一颗平衡树
+    // 本树的节点原样复用，union_with 只为 rhs 独有的元素复制节点，
+    // intersect_with 不分配节点。键值相等时保留本树的元素，对重复键值按 set_union /
+    // set_intersection 的规则保留较多 / 较少的个数
+    // 复制节点时抛出异常，树被清空
+    void union_with(const rb_tree& rhs);
+    void intersect_with(const rb_tree& rhs);
+
     void swap(rb_tree& rhs) noexcept;
 
 private:
@@ -848,6 +970,14 @@ private:
     node_ptr clone_node(base_ptr x);
     void destroy_node(node_ptr p);
 
+    // allocator propagation
+    void copy_alloc(const rb_tree& rhs, m_true_type);
+    void copy_alloc(const rb_tree&, m_false_type) {}
+    void move_assign(rb_tree& rhs, m_true_type);
+    void move_assign(rb_tree& rhs, m_false_type);
+    void swap_alloc(rb_tree& rhs, m_true_type) { mystl::swap(alloc_, rhs.alloc_); }
+    void swap_alloc(rb_tree&, m_false_type) {}
+
     // init / reset
     void rb_tree_init();
     void reset();
@@ -867,16 +997,40 @@ private:
     iterator insert_multi_use_hint(iterator hint, key_type key, node_ptr node);
     iterator insert_unique_use_hint(iterator hint, key_type key, node_ptr node);
 
+    // select
+    base_ptr select_node(size_type k) const;
+
     // copy tree / erase tree
     base_ptr copy_from(base_ptr x, base_ptr p);
     void erase_since(base_ptr x);
+
+    // bulk build
+    // 以下函数中的链（vine）指经 right 按中序相连的一串节点，left 无意义
+    template <class InputIterator>
+    void build_from(InputIterator first, InputIterator last, bool unique);
+    base_ptr tree_to_vine();
+    void vine_to_tree(base_ptr vine, size_type n);
+    base_ptr build_balanced(base_ptr& vine,
+                            size_type n,
+                            size_type level,
+                            size_type red_level);
+    void destroy_vine(base_ptr vine);
+
+    // batch lookup
+    static constexpr size_type batch_size = 16;  // 一组同时查找的键值个数
+    template <class ForwardIter>
+    size_type find_group(ForwardIter& first,
+                         ForwardIter last,
+                         base_ptr* nodes) const;
 };
 
 /*****************************************************************************************/
 
 // 复制构造函数
-template <class T, class Compare>
-rb_tree<T, Compare>::rb_tree(const rb_tree& rhs) {
+template <class T, class Compare, class Alloc, bool Ranked>
+rb_tree<T, Compare, Alloc, Ranked>::rb_tree(const rb_tree& rhs)
+    : alloc_(alloc_traits::select_on_container_copy_construction(
+          rhs.get_allocator())) {
     rb_tree_init();
     if (rhs.node_count_ != 0) {
         root() = copy_from(rhs.root(), header_);
@@ -888,19 +1042,22 @@ rb_tree<T, Compare>::rb_tree(const rb_tree& rhs) {
 }
 
 // 移动构造函数
-template <class T, class Compare>
-rb_tree<T, Compare>::rb_tree(rb_tree&& rhs) noexcept
-    : header_(mystl::move(rhs.header_)),
+template <class T, class Compare, class Alloc, bool Ranked>
+rb_tree<T, Compare, Alloc, Ranked>::rb_tree(rb_tree&& rhs) noexcept
+    : alloc_(mystl::move(rhs.alloc_)),
+      header_(mystl::move(rhs.header_)),
       node_count_(rhs.node_count_),
       key_comp_(rhs.key_comp_) {
     rhs.reset();
 }
 
 // 复制赋值操作符
-template <class T, class Compare>
-rb_tree<T, Compare>& rb_tree<T, Compare>::operator=(const rb_tree& rhs) {
+template <class T, class Compare, class Alloc, bool Ranked>
+rb_tree<T, Compare, Alloc, Ranked>& rb_tree<T, Compare, Alloc, Ranked>::operator=(const rb_tree& rhs) {
     if (this != &rhs) {
         clear();
+        copy_alloc(rhs, typename alloc_traits::
+                            propagate_on_container_copy_assignment());
 
         if (rhs.node_count_ != 0) {
             root() = copy_from(rhs.root(), header_);
@@ -915,20 +1072,24 @@ rb_tree<T, Compare>& rb_tree<T, Compare>::operator=(const rb_tree& rhs) {
 }
 
 // 移动赋值操作符
-template <class T, class Compare>
-rb_tree<T, Compare>& rb_tree<T, Compare>::operator=(rb_tree&& rhs) {
-    clear();
-    header_ = mystl::move(rhs.header_);
-    node_count_ = rhs.node_count_;
-    key_comp_ = rhs.key_comp_;
-    rhs.reset();
+template <class T, class Compare, class Alloc, bool Ranked>
+rb_tree<T, Compare, Alloc, Ranked>& rb_tree<T, Compare, Alloc, Ranked>::operator=(
+    rb_tree&& rhs) noexcept(alloc_traits::propagate_on_container_move_assignment::
+                                value ||
+                            alloc_traits::is_always_equal::value) {
+    if (this != &rhs) {
+        clear();
+        key_comp_ = rhs.key_comp_;
+        move_assign(rhs, typename alloc_traits::
+                             propagate_on_container_move_assignment());
+    }
     return *this;
 }
 
 // 就地插入元素，键值允许重复
-template <class T, class Compare>
+template <class T, class Compare, class Alloc, bool Ranked>
 template <class... Args>
-typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::emplace_multi(
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator rb_tree<T, Compare, Alloc, Ranked>::emplace_multi(
     Args&&... args) {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1,
                           "rb_tree<T, Comp>'s size too big");
@@ -938,10 +1099,10 @@ typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::emplace_multi(
 }
 
 // 就地插入元素，键值不允许重复
-template <class T, class Compare>
+template <class T, class Compare, class Alloc, bool Ranked>
 template <class... Args>
-mystl::pair<typename rb_tree<T, Compare>::iterator, bool>
-rb_tree<T, Compare>::emplace_unique(Args&&... args) {
+mystl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::iterator, bool>
+rb_tree<T, Compare, Alloc, Ranked>::emplace_unique(Args&&... args) {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1,
                           "rb_tree<T, Comp>'s size too big");
     node_ptr np = create_node(mystl::forward<Args>(args)...);
@@ -956,10 +1117,10 @@ rb_tree<T, Compare>::emplace_unique(Args&&... args) {
 
 // 就地插入元素，键值允许重复，当 hint
 // 位置与插入位置接近时，插入操作的时间复杂度可以降低
-template <class T, class Compare>
+template <class T, class Compare, class Alloc, bool Ranked>
 template <class... Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::emplace_multi_use_hint(iterator hint, Args&&... args) {
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::emplace_multi_use_hint(iterator hint, Args&&... args) {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1,
                           "rb_tree<T, Comp>'s size too big");
     node_ptr np = create_node(mystl::forward<Args>(args)...);
@@ -988,10 +1149,10 @@ rb_tree<T, Compare>::emplace_multi_use_hint(iterator hint, Args&&... args) {
 
 // 就地插入元素，键值不允许重复，当 hint
 // 位置与插入位置接近时，插入操作的时间复杂度可以降低
-template <class T, class Compare>
+template <class T, class Compare, class Alloc, bool Ranked>
 template <class... Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::emplace_unique_use_hint(iterator hint, Args&&... args) {
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::emplace_unique_use_hint(iterator hint, Args&&... args) {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1,
                           "rb_tree<T, Comp>'s size too big");
     node_ptr np = create_node(mystl::forward<Args>(args)...);
@@ -1027,8 +1188,8 @@ rb_tree<T, Compare>::emplace_unique_use_hint(iterator hint, Args&&... args) {
 }
 
 // 插入元素，节点键值允许重复
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::insert_multi(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator rb_tree<T, Compare, Alloc, Ranked>::insert_multi(
     const value_type& value) {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1,
                           "rb_tree<T, Comp>'s size too big");
@@ -1038,9 +1199,9 @@ typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::insert_multi(
 
 // 插入新值，节点键值不允许重复，返回一个 pair，若插入成功，pair 的第二参数为
 // true，否则为 false
-template <class T, class Compare>
-mystl::pair<typename rb_tree<T, Compare>::iterator, bool>
-rb_tree<T, Compare>::insert_unique(const value_type& value) {
+template <class T, class Compare, class Alloc, bool Ranked>
+mystl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::iterator, bool>
+rb_tree<T, Compare, Alloc, Ranked>::insert_unique(const value_type& value) {
     THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1,
                           "rb_tree<T, Comp>'s size too big");
     auto res = get_insert_unique_pos(value_traits::get_key(value));
@@ -1052,22 +1213,23 @@ rb_tree<T, Compare>::insert_unique(const value_type& value) {
 }
 
 // 删除 hint 位置的节点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::erase(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator rb_tree<T, Compare, Alloc, Ranked>::erase(
     iterator hint) {
     auto node = hint.node->get_node_ptr();
     iterator next(node);
     ++next;
 
-    rb_tree_erase_rebalance(hint.node, root(), leftmost(), rightmost());
+    rb_tree_erase_rebalance<size_traits>(hint.node, root(), leftmost(),
+                                         rightmost());
     destroy_node(node);
     --node_count_;
     return next;
 }
 
 // 删除键值等于 key 的元素，返回删除的个数
-template <class T, class Compare>
-typename rb_tree<T, Compare>::size_type rb_tree<T, Compare>::erase_multi(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::size_type rb_tree<T, Compare, Alloc, Ranked>::erase_multi(
     const key_type& key) {
     auto p = equal_range_multi(key);
     size_type n = mystl::distance(p.first, p.second);
@@ -1076,8 +1238,8 @@ typename rb_tree<T, Compare>::size_type rb_tree<T, Compare>::erase_multi(
 }
 
 // 删除键值等于 key 的元素，返回删除的个数
-template <class T, class Compare>
-typename rb_tree<T, Compare>::size_type rb_tree<T, Compare>::erase_unique(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::size_type rb_tree<T, Compare, Alloc, Ranked>::erase_unique(
     const key_type& key) {
     auto it = find(key);
     if (it != end()) {
@@ -1088,8 +1250,8 @@ typename rb_tree<T, Compare>::size_type rb_tree<T, Compare>::erase_unique(
 }
 
 // 删除[first, last)区间内的元素
-template <class T, class Compare>
-void rb_tree<T, Compare>::erase(iterator first, iterator last) {
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::erase(iterator first, iterator last) {
     if (first == begin() && last == end()) {
         clear();
     } else {
@@ -1099,8 +1261,8 @@ void rb_tree<T, Compare>::erase(iterator first, iterator last) {
 }
 
 // 清空 rb tree
-template <class T, class Compare>
-void rb_tree<T, Compare>::clear() {
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::clear() {
     if (node_count_ != 0) {
         erase_since(root());
         leftmost() = header_;
@@ -1111,8 +1273,8 @@ void rb_tree<T, Compare>::clear() {
 }
 
 // 查找键值为 k 的节点，返回指向它的迭代器
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::find(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator rb_tree<T, Compare, Alloc, Ranked>::find(
     const key_type& key) {
     auto y = header_;  // 最后一个不小于 key 的节点
     auto x = root();
@@ -1129,8 +1291,8 @@ typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::find(
                                                                      : j;
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator rb_tree<T, Compare>::find(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::const_iterator rb_tree<T, Compare, Alloc, Ranked>::find(
     const key_type& key) const {
     auto y = header_;  // 最后一个不小于 key 的节点
     auto x = root();
@@ -1148,8 +1310,8 @@ typename rb_tree<T, Compare>::const_iterator rb_tree<T, Compare>::find(
 }
 
 // 键值不小于 key 的第一个位置
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::lower_bound(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator rb_tree<T, Compare, Alloc, Ranked>::lower_bound(
     const key_type& key) {
     auto y = header_;
     auto x = root();
@@ -1164,8 +1326,8 @@ typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::lower_bound(
     return iterator(y);
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator rb_tree<T, Compare>::lower_bound(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::const_iterator rb_tree<T, Compare, Alloc, Ranked>::lower_bound(
     const key_type& key) const {
     auto y = header_;
     auto x = root();
@@ -1181,8 +1343,8 @@ typename rb_tree<T, Compare>::const_iterator rb_tree<T, Compare>::lower_bound(
 }
 
 // 键值不小于 key 的最后一个位置
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::upper_bound(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator rb_tree<T, Compare, Alloc, Ranked>::upper_bound(
     const key_type& key) {
     auto y = header_;
     auto x = root();
@@ -1197,8 +1359,8 @@ typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::upper_bound(
     return iterator(y);
 }
 
-template <class T, class Compare>
-typename rb_tree<T, Compare>::const_iterator rb_tree<T, Compare>::upper_bound(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::const_iterator rb_tree<T, Compare, Alloc, Ranked>::upper_bound(
     const key_type& key) const {
     auto y = header_;
     auto x = root();
@@ -1213,10 +1375,55 @@ typename rb_tree<T, Compare>::const_iterator rb_tree<T, Compare>::upper_bound(
     return const_iterator(y);
 }
 
+// 批量查找，每个键值写入一个迭代器，返回 result 的尾部
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class ForwardIter, class OutputIter>
+OutputIter rb_tree<T, Compare, Alloc, Ranked>::find_batch(ForwardIter first,
+                                                  ForwardIter last,
+                                                  OutputIter result) {
+    base_ptr nodes[batch_size];
+    while (first != last) {
+        const auto n = find_group(first, last, nodes);
+        for (size_type i = 0; i < n; ++i, ++result)
+            *result = iterator(nodes[i]);
+    }
+    return result;
+}
+
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class ForwardIter, class OutputIter>
+OutputIter rb_tree<T, Compare, Alloc, Ranked>::find_batch(ForwardIter first,
+                                                  ForwardIter last,
+                                                  OutputIter result) const {
+    base_ptr nodes[batch_size];
+    while (first != last) {
+        const auto n = find_group(first, last, nodes);
+        for (size_type i = 0; i < n; ++i, ++result)
+            *result = const_iterator(nodes[i]);
+    }
+    return result;
+}
+
+// 批量判断键值是否存在，每个键值写入一个 bool，返回 result 的尾部
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class ForwardIter, class OutputIter>
+OutputIter rb_tree<T, Compare, Alloc, Ranked>::contains_batch(ForwardIter first,
+                                                      ForwardIter last,
+                                                      OutputIter result) const {
+    base_ptr nodes[batch_size];
+    while (first != last) {
+        const auto n = find_group(first, last, nodes);
+        for (size_type i = 0; i < n; ++i, ++result)
+            *result = nodes[i] != header_;
+    }
+    return result;
+}
+
 // 交换 rb tree
-template <class T, class Compare>
-void rb_tree<T, Compare>::swap(rb_tree& rhs) noexcept {
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::swap(rb_tree& rhs) noexcept {
     if (this != &rhs) {
+        swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
         mystl::swap(header_, rhs.header_);
         mystl::swap(node_count_, rhs.node_count_);
         mystl::swap(key_comp_, rhs.key_comp_);
@@ -1226,47 +1433,131 @@ void rb_tree<T, Compare>::swap(rb_tree& rhs) noexcept {
 /*****************************************************************************************/
 // helper function
 
+// 从 first 开始查找至多 batch_size 个键值，结果依次存入 nodes，找不到时为 header_
+// first 前进到下一组的开头。每一轮让所有未结束的查找各走一层，与 find 的走法相同
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class ForwardIter>
+typename rb_tree<T, Compare, Alloc, Ranked>::size_type
+rb_tree<T, Compare, Alloc, Ranked>::find_group(ForwardIter& first,
+                                       ForwardIter last,
+                                       base_ptr* nodes) const {
+    static_assert(
+        std::is_same<typename std::decay<decltype(*first)>::type,
+                     key_type>::value,
+        "the key sequence of a batch lookup must hold key_type");
+    const key_type* keys[batch_size];
+    base_ptr cur[batch_size];  // 每个查找当前所在的节点
+    size_type n = 0;
+    for (; n < batch_size && first != last; ++n, ++first) {
+        keys[n] = mystl::address_of(*first);
+        cur[n] = root();
+        nodes[n] = header_;  // 最后一个不小于 key 的节点
+    }
+    for (bool active = root() != nullptr; active;) {
+        active = false;
+        for (size_type i = 0; i < n; ++i) {
+            auto x = cur[i];
+            if (x == nullptr)
+                continue;
+            if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value),
+                           *keys[i])) {  // key 小于等于 x 键值，向左走
+                nodes[i] = x, x = x->left;
+            } else {  // key 大于 x 键值，向右走
+                x = x->right;
+            }
+            if (x != nullptr) {
+                mystl::prefetch(x);
+                active = true;
+            }
+            cur[i] = x;
+        }
+    }
+    for (size_type i = 0; i < n; ++i) {
+        if (nodes[i] != header_ &&
+            key_comp_(*keys[i],
+                      value_traits::get_key(nodes[i]->get_node_ptr()->value)))
+            nodes[i] = header_;
+    }
+    return n;
+}
+
 // 创建一个结点
-template <class T, class Compare>
+template <class T, class Compare, class Alloc, bool Ranked>
 template <class... Args>
-typename rb_tree<T, Compare>::node_ptr rb_tree<T, Compare>::create_node(
+typename rb_tree<T, Compare, Alloc, Ranked>::node_ptr rb_tree<T, Compare, Alloc, Ranked>::create_node(
     Args&&... args) {
-    auto tmp = node_allocator::allocate(1);
+    auto tmp = alloc_.allocate(1);
     try {
-        data_allocator::construct(mystl::address_of(tmp->value),
-                                  mystl::forward<Args>(args)...);
+        mystl::construct(mystl::address_of(tmp->value),
+                         mystl::forward<Args>(args)...);
         tmp->left = nullptr;
         tmp->right = nullptr;
         tmp->parent = nullptr;
+        size_traits::set(tmp, 1);
     } catch (...) {
-        node_allocator::deallocate(tmp);
+        alloc_.deallocate(tmp, 1);
         throw;
     }
     return tmp;
 }
 
 // 复制一个结点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::node_ptr rb_tree<T, Compare>::clone_node(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::node_ptr rb_tree<T, Compare, Alloc, Ranked>::clone_node(
     base_ptr x) {
     node_ptr tmp = create_node(x->get_node_ptr()->value);
     tmp->color = x->color;
+    size_traits::set(tmp, size_traits::size(x));
     tmp->left = nullptr;
     tmp->right = nullptr;
     return tmp;
 }
 
 // 销毁一个结点
-template <class T, class Compare>
-void rb_tree<T, Compare>::destroy_node(node_ptr p) {
-    data_allocator::destroy(&p->value);
-    node_allocator::deallocate(p);
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::destroy_node(node_ptr p) {
+    mystl::destroy(&p->value);
+    alloc_.deallocate(static_cast<node_type*>(p), 1);
+}
+
+// 复制赋值时传播分配器，调用前已经 clear
+// 旧的头节点由旧的分配器释放，再用新的分配器重新初始化
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::copy_alloc(const rb_tree& rhs, m_true_type) {
+    if (alloc_ == rhs.alloc_)
+        return;
+    base_allocator(alloc_).deallocate(header_, 1);
+    header_ = nullptr;
+    alloc_ = rhs.alloc_;
+    rb_tree_init();
+}
+
+// 移动赋值，调用前已经 clear
+// 分配器随元素传播时，与 rhs 交换头节点与分配器，rhs 留下一棵空树
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::move_assign(rb_tree& rhs, m_true_type) {
+    mystl::swap(alloc_, rhs.alloc_);
+    mystl::swap(header_, rhs.header_);
+    mystl::swap(node_count_, rhs.node_count_);
+}
+
+// 分配器不传播时，只有两个分配器相等才能直接接管节点，否则逐个移动元素
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::move_assign(rb_tree& rhs, m_false_type) {
+    if (alloc_traits::equal(alloc_, rhs.alloc_)) {
+        mystl::swap(header_, rhs.header_);
+        mystl::swap(node_count_, rhs.node_count_);
+    } else {
+        for (auto it = rhs.begin(); it != rhs.end(); ++it)
+            emplace_multi_use_hint(end(), mystl::move(*it));
+        rhs.clear();
+    }
 }
 
 // 初始化容器
-template <class T, class Compare>
-void rb_tree<T, Compare>::rb_tree_init() {
-    header_ = base_allocator::allocate(1);
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::rb_tree_init() {
+    header_ = base_allocator(alloc_).allocate(1);
     header_->color = rb_tree_red;  // header_ 节点颜色为红，与 root 区分
     root() = nullptr;
     leftmost() = header_;
@@ -1275,17 +1566,17 @@ void rb_tree<T, Compare>::rb_tree_init() {
 }
 
 // reset 函数
-template <class T, class Compare>
-void rb_tree<T, Compare>::reset() {
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::reset() {
     header_ = nullptr;
     node_count_ = 0;
 }
 
 // get_insert_multi_pos 函数
 /*! 获取可重复插入位置 */
-template <class T, class Compare>
-mystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>
-rb_tree<T, Compare>::get_insert_multi_pos(const key_type& key) {
+template <class T, class Compare, class Alloc, bool Ranked>
+mystl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr, bool>
+rb_tree<T, Compare, Alloc, Ranked>::get_insert_multi_pos(const key_type& key) {
     auto x = root();
     auto y = header_;
     bool add_to_left = true; // 是否在左边
@@ -1299,9 +1590,9 @@ rb_tree<T, Compare>::get_insert_multi_pos(const key_type& key) {
 }
 
 // get_insert_unique_pos 函数
-template <class T, class Compare>
-mystl::pair<mystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>, bool>
-rb_tree<T, Compare>::get_insert_unique_pos(
+template <class T, class Compare, class Alloc, bool Ranked>
+mystl::pair<mystl::pair<typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr, bool>, bool>
+rb_tree<T, Compare, Alloc, Ranked>::get_insert_unique_pos(
     const key_type&
         key) {  // 返回一个 pair，第一个值为一个 pair，包含插入点的父节点和一个
                 // bool 表示是否在左边插入，
@@ -1334,8 +1625,8 @@ rb_tree<T, Compare>::get_insert_unique_pos(
 
 // insert_value_at 函数
 // x 为插入点的父节点， value 为要插入的值，add_to_left 表示是否在左边插入
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::insert_value_at(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator rb_tree<T, Compare, Alloc, Ranked>::insert_value_at(
     base_ptr x,
     const value_type& value,
     bool add_to_left) {
@@ -1355,15 +1646,15 @@ typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::insert_value_at(
         if (rightmost() == x)
             rightmost() = base_node;
     }
-    rb_tree_insert_rebalance(base_node, root());
+    rb_tree_insert_rebalance<size_traits>(base_node, root());
     ++node_count_;
     return iterator(node);
 }
 
 // 在 x 节点处插入新的节点
 // x 为插入点的父节点， node 为要插入的节点，add_to_left 表示是否在左边插入
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::insert_node_at(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator rb_tree<T, Compare, Alloc, Ranked>::insert_node_at(
     base_ptr x,
     node_ptr node,
     bool add_to_left) {
@@ -1382,15 +1673,15 @@ typename rb_tree<T, Compare>::iterator rb_tree<T, Compare>::insert_node_at(
         if (rightmost() == x)
             rightmost() = base_node;
     }
-    rb_tree_insert_rebalance(base_node, root());
+    rb_tree_insert_rebalance<size_traits>(base_node, root());
     ++node_count_;
     return iterator(node);
 }
 
 // 插入元素，键值允许重复，使用 hint
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_multi_use_hint(iterator hint,
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::insert_multi_use_hint(iterator hint,
                                            key_type key,
                                            node_ptr node) {
     // 在 hint 附近寻找可插入的位置
@@ -1412,9 +1703,9 @@ rb_tree<T, Compare>::insert_multi_use_hint(iterator hint,
 }
 
 // 插入元素，键值不允许重复，使用 hint
-template <class T, class Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::insert_unique_use_hint(iterator hint,
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::iterator
+rb_tree<T, Compare, Alloc, Ranked>::insert_unique_use_hint(iterator hint,
                                             key_type key,
                                             node_ptr node) {
     // 在 hint 附近寻找可插入的位置
@@ -1438,10 +1729,51 @@ rb_tree<T, Compare>::insert_unique_use_hint(iterator hint,
     return insert_node_at(pos.first.first, node, pos.first.second);
 }
 
+// select_node 函数
+// 左子树的大小即根节点的位次，据此决定向左还是向右走
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::select_node(size_type k) const {
+    static_assert(Ranked, "select requires a ranked rb_tree");
+    if (k >= node_count_)
+        return header_;
+    auto x = root();
+    for (;;) {
+        const size_type left = size_traits::size(x->left);
+        if (k < left) {
+            x = x->left;
+        } else if (k == left) {
+            return x;
+        } else {
+            k -= left + 1;
+            x = x->right;
+        }
+    }
+}
+
+// rank 函数
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::size_type
+rb_tree<T, Compare, Alloc, Ranked>::rank(const key_type& key) const {
+    static_assert(Ranked, "rank requires a ranked rb_tree");
+    size_type result = 0;
+    auto x = root();
+    while (x != nullptr) {
+        if (key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) {
+            // x 与其左子树都小于 key
+            result += size_traits::size(x->left) + 1;
+            x = x->right;
+        } else {
+            x = x->left;
+        }
+    }
+    return result;
+}
+
 // copy_from 函数
 // 递归复制一颗树，节点从 x 开始，p 为 x 的父节点
-template <class T, class Compare>
-typename rb_tree<T, Compare>::base_ptr rb_tree<T, Compare>::copy_from(
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr rb_tree<T, Compare, Alloc, Ranked>::copy_from(
     base_ptr x,
     base_ptr p) {
     auto top = clone_node(x);
@@ -1469,8 +1801,8 @@ typename rb_tree<T, Compare>::base_ptr rb_tree<T, Compare>::copy_from(
 
 // erase_since 函数
 // 从 x 节点开始删除该节点及其子树
-template <class T, class Compare>
-void rb_tree<T, Compare>::erase_since(base_ptr x) {
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::erase_since(base_ptr x) {
     while (x != nullptr) {
         erase_since(x->right);
         auto y = x->left;
@@ -1479,46 +1811,301 @@ void rb_tree<T, Compare>::erase_since(base_ptr x) {
     }
 }
 
+// build_from 函数
+// 树为空时使用：先为 [first, last) 的元素依次创建节点并串成链，unique 为 true
+// 时跳过与前一个相等的元素。元素有序时由链直接建成平衡树，否则把链上的节点逐个插入
+template <class T, class Compare, class Alloc, bool Ranked>
+template <class InputIterator>
+void rb_tree<T, Compare, Alloc, Ranked>::build_from(InputIterator first,
+                                                    InputIterator last,
+                                                    bool unique) {
+    base_ptr head = nullptr;
+    base_ptr tail = nullptr;
+    size_type n = 0;
+    bool sorted = true;
+    try {
+        for (; first != last; ++first) {
+            node_ptr np = create_node(*first);
+            if (tail != nullptr) {
+                const auto& prev = value_traits::get_key(tail->get_node_ptr()->value);
+                const auto& key = value_traits::get_key(np->value);
+                if (unique && !key_comp_(prev, key) && !key_comp_(key, prev)) {
+                    destroy_node(np);
+                    continue;
+                }
+                if (key_comp_(key, prev))
+                    sorted = false;
+                tail->right = np;
+            } else {
+                head = np;
+            }
+            tail = np;
+            ++n;
+        }
+    } catch (...) {
+        destroy_vine(head);
+        throw;
+    }
+    if (sorted) {
+        vine_to_tree(head, n);
+        return;
+    }
+    while (head != nullptr) {
+        auto np = head->get_node_ptr();
+        head = head->right;
+        np->right = nullptr;
+        const auto& key = value_traits::get_key(np->value);
+        if (unique) {
+            auto res = get_insert_unique_pos(key);
+            if (res.second)
+                insert_node_at(res.first.first, np, res.first.second);
+            else
+                destroy_node(np);
+        } else {
+            auto res = get_insert_multi_pos(key);
+            insert_node_at(res.first, np, res.second);
+        }
+    }
+}
+
+// tree_to_vine 函数
+// 把整棵树按中序右旋成一条链并从树上摘下，树变为空树，返回链头
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::tree_to_vine() {
+    base_ptr head = nullptr;
+    base_ptr* link = &head;  // 链上最后一个节点的 right
+    auto x = root();
+    while (x != nullptr) {
+        if (x->left == nullptr) {
+            *link = x;
+            link = &x->right;
+            x = x->right;
+        } else {  // 右旋，把左子节点提上来
+            auto y = x->left;
+            x->left = y->right;
+            y->right = x;
+            x = y;
+        }
+    }
+    root() = nullptr;
+    leftmost() = header_;
+    rightmost() = header_;
+    node_count_ = 0;
+    return head;
+}
+
+// vine_to_tree 函数
+// 树为空时使用：由 n 个节点的有序链建成一颗完全平衡的树
+// 除最深一层外的层都是满的，最深一层的节点染红，其余染黑
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::vine_to_tree(base_ptr vine,
+                                                      size_type n) {
+    if (n == 0)
+        return;
+    size_type red_level = 0;  // 最深一层的深度，根为 0
+    for (size_type m = n; m > 1; m >>= 1)
+        ++red_level;
+    auto top = build_balanced(vine, n, 0, red_level);
+    top->parent = header_;
+    rb_tree_set_black(top);
+    root() = top;
+    leftmost() = rb_tree_min(top);
+    rightmost() = rb_tree_max(top);
+    node_count_ = n;
+}
+
+// build_balanced 函数
+// 从链头取 n 个节点，按中序建成一颗子树，返回子树的根，level 为子树根的深度
+template <class T, class Compare, class Alloc, bool Ranked>
+typename rb_tree<T, Compare, Alloc, Ranked>::base_ptr
+rb_tree<T, Compare, Alloc, Ranked>::build_balanced(base_ptr& vine,
+                                                   size_type n,
+                                                   size_type level,
+                                                   size_type red_level) {
+    if (n == 0)
+        return nullptr;
+    const size_type left_count = (n - 1) / 2;
+    auto left = build_balanced(vine, left_count, level + 1, red_level);
+    auto top = vine;
+    vine = vine->right;
+    top->left = left;
+    if (left != nullptr)
+        left->parent = top;
+    auto right = build_balanced(vine, n - 1 - left_count, level + 1, red_level);
+    top->right = right;
+    if (right != nullptr)
+        right->parent = top;
+    top->color = level == red_level ? rb_tree_red : rb_tree_black;
+    size_traits::set(top, n);
+    return top;
+}
+
+// destroy_vine 函数
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::destroy_vine(base_ptr vine) {
+    while (vine != nullptr) {
+        auto next = vine->right;
+        destroy_node(vine->get_node_ptr());
+        vine = next;
+    }
+}
+
+// union_with 函数
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::union_with(const rb_tree& rhs) {
+    if (this == &rhs || rhs.empty())
+        return;
+    THROW_LENGTH_ERROR_IF(node_count_ > max_size() - rhs.node_count_,
+                          "rb_tree<T, Comp>'s size too big");
+    auto a = tree_to_vine();
+    auto b = rhs.begin();
+    const auto b_last = rhs.end();
+    base_ptr head = nullptr;
+    base_ptr tail = nullptr;
+    size_type n = 0;
+    try {
+        while (a != nullptr || b != b_last) {
+            base_ptr x;
+            // 链上不用 parent，借它区分复制出的节点，供异常时恢复本树
+            if (b == b_last) {
+                x = a;
+                x->parent = header_;
+                a = a->right;
+            } else if (a == nullptr ||
+                       key_comp_(value_traits::get_key(*b),
+                                 value_traits::get_key(a->get_node_ptr()->value))) {
+                x = clone_node(b.node);
+                x->parent = nullptr;
+                ++b;
+            } else {
+                if (!key_comp_(value_traits::get_key(a->get_node_ptr()->value),
+                               value_traits::get_key(*b)))
+                    ++b;  // 键值相等，保留本树的元素
+                x = a;
+                x->parent = header_;
+                a = a->right;
+            }
+            if (tail != nullptr)
+                tail->right = x;
+            else
+                head = x;
+            tail = x;
+            ++n;
+        }
+    } catch (...) {
+        // 销毁复制出的节点，本树原有的节点仍按顺序相连，接上 a 后重建本树
+        if (tail != nullptr)
+            tail->right = nullptr;
+        base_ptr* link = &head;
+        n = 0;
+        for (auto x = head; x != nullptr;) {
+            auto next = x->right;
+            if (x->parent == nullptr) {
+                destroy_node(x->get_node_ptr());
+            } else {
+                *link = x;
+                link = &x->right;
+                ++n;
+            }
+            x = next;
+        }
+        *link = a;
+        for (; a != nullptr; a = a->right)
+            ++n;
+        vine_to_tree(head, n);
+        throw;
+    }
+    tail->right = nullptr;
+    vine_to_tree(head, n);
+}
+
+// intersect_with 函数
+template <class T, class Compare, class Alloc, bool Ranked>
+void rb_tree<T, Compare, Alloc, Ranked>::intersect_with(const rb_tree& rhs) {
+    if (this == &rhs)
+        return;
+    auto a = tree_to_vine();
+    auto b = rhs.begin();
+    const auto b_last = rhs.end();
+    base_ptr head = nullptr;
+    base_ptr tail = nullptr;
+    size_type n = 0;
+    try {
+        while (a != nullptr) {
+            auto next = a->right;
+            const auto& key = value_traits::get_key(a->get_node_ptr()->value);
+            while (b != b_last && key_comp_(value_traits::get_key(*b), key))
+                ++b;
+            if (b != b_last && !key_comp_(key, value_traits::get_key(*b))) {
+                ++b;
+                if (tail != nullptr)
+                    tail->right = a;
+                else
+                    head = a;
+                tail = a;
+                ++n;
+            } else {
+                destroy_node(a->get_node_ptr());
+            }
+            a = next;
+        }
+    } catch (...) {
+        // 已经删去的元素无法恢复，其余节点仍按顺序相连，接上 a 后重建本树
+        if (tail != nullptr)
+            tail->right = a;
+        else
+            head = a;
+        for (; a != nullptr; a = a->right)
+            ++n;
+        vine_to_tree(head, n);
+        throw;
+    }
+    if (tail != nullptr)
+        tail->right = nullptr;
+    vine_to_tree(head, n);
+}
+
 // 重载比较操作符
-template <class T, class Compare>
-bool operator==(const rb_tree<T, Compare>& lhs,
-                const rb_tree<T, Compare>& rhs) {
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator==(const rb_tree<T, Compare, Alloc, Ranked>& lhs,
+                const rb_tree<T, Compare, Alloc, Ranked>& rhs) {
     return lhs.size() == rhs.size() &&
            mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T, class Compare>
-bool operator<(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs) {
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator<(const rb_tree<T, Compare, Alloc, Ranked>& lhs, const rb_tree<T, Compare, Alloc, Ranked>& rhs) {
     return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
                                           rhs.end());
 }
 
-template <class T, class Compare>
-bool operator!=(const rb_tree<T, Compare>& lhs,
-                const rb_tree<T, Compare>& rhs) {
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator!=(const rb_tree<T, Compare, Alloc, Ranked>& lhs,
+                const rb_tree<T, Compare, Alloc, Ranked>& rhs) {
     return !(lhs == rhs);
 }
 
-template <class T, class Compare>
-bool operator>(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs) {
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator>(const rb_tree<T, Compare, Alloc, Ranked>& lhs, const rb_tree<T, Compare, Alloc, Ranked>& rhs) {
     return rhs < lhs;
 }
 
-template <class T, class Compare>
-bool operator<=(const rb_tree<T, Compare>& lhs,
-                const rb_tree<T, Compare>& rhs) {
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator<=(const rb_tree<T, Compare, Alloc, Ranked>& lhs,
+                const rb_tree<T, Compare, Alloc, Ranked>& rhs) {
     return !(rhs < lhs);
 }
 
-template <class T, class Compare>
-bool operator>=(const rb_tree<T, Compare>& lhs,
-                const rb_tree<T, Compare>& rhs) {
+template <class T, class Compare, class Alloc, bool Ranked>
+bool operator>=(const rb_tree<T, Compare, Alloc, Ranked>& lhs,
+                const rb_tree<T, Compare, Alloc, Ranked>& rhs) {
     return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T, class Compare>
-void swap(rb_tree<T, Compare>& lhs, rb_tree<T, Compare>& rhs) noexcept {
+template <class T, class Compare, class Alloc, bool Ranked>
+void swap(rb_tree<T, Compare, Alloc, Ranked>& lhs, rb_tree<T, Compare, Alloc, Ranked>& rhs) noexcept {
     lhs.swap(rhs);
 }
 
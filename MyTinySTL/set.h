@@ -20,7 +20,11 @@ namespace mystl {
 
 // 模板类 set，键值不允许重复
 // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less
-template <class Key, class Compare = mystl::less<Key>>
+// 参数三代表分配器，缺省使用 mystl::allocator
+// 参数四代表是否在节点中维护子树大小，为 true 时支持 select / rank，缺省为 false
+template <class Key, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<Key>,
+          bool Ranked = false>
 class set {
 public:
     typedef Key key_type;
@@ -30,7 +34,7 @@ public:
 
 private:
     // 以 mystl::rb_tree 作为底层机制
-    typedef mystl::rb_tree<value_type, key_compare> base_type;
+    typedef mystl::rb_tree<value_type, key_compare, Alloc, Ranked> base_type;
     base_type tree_;
 
 public:
@@ -55,15 +59,22 @@ public:
     // 构造、复制、移动函数
     set() = default;
 
+    explicit set(const allocator_type& alloc) : tree_(alloc) {}
+
     // allocation / deallocation
     // 注意, set一定使用RB-tree 的 insert_unique()而非insert_equal ()
     // multiset 才使用RB-tree 的insert_equal ()
     // 因为set不允许相同键值存在，multiset才允许相同键值存在
     template <class InputIterator>
-    set(InputIterator first, InputIterator last) : tree_() {
+    set(InputIterator first,
+        InputIterator last,
+        const allocator_type& alloc = allocator_type())
+        : tree_(alloc) {
         tree_.insert_unique(first, last);
     }
-    set(std::initializer_list<value_type> ilist) : tree_() {
+    set(std::initializer_list<value_type> ilist,
+        const allocator_type& alloc = allocator_type())
+        : tree_(alloc) {
         tree_.insert_unique(ilist.begin(), ilist.end());
     }
 
@@ -159,6 +170,20 @@ public:
     iterator find(const key_type& key) { return tree_.find(key); }
     const_iterator find(const key_type& key) const { return tree_.find(key); }
 
+    // 批量查找，对每个键值依次写入 find 的结果或是否存在
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first,
+                          ForwardIter last,
+                          OutputIter result) const {
+        return tree_.find_batch(first, last, result);
+    }
+    template <class ForwardIter, class OutputIter>
+    OutputIter contains_batch(ForwardIter first,
+                              ForwardIter last,
+                              OutputIter result) const {
+        return tree_.contains_batch(first, last, result);
+    }
+
     size_type count(const key_type& key) const {
         return tree_.count_unique(key);
     }
@@ -182,6 +207,15 @@ public:
         return tree_.equal_range_unique(key);
     }
 
+    // 顺序统计，需要 Ranked 为 true
+    iterator select(size_type k) { return tree_.select(k); }
+    const_iterator select(size_type k) const { return tree_.select(k); }
+    size_type rank(const key_type& key) const { return tree_.rank(key); }
+
+    // 集合运算，O(n + m)，结果保存在本容器中
+    void union_with(const set& rhs) { tree_.union_with(rhs.tree_); }
+    void intersect_with(const set& rhs) { tree_.intersect_with(rhs.tree_); }
+
     void swap(set& rhs) noexcept { tree_.swap(rhs.tree_); }
 
 public:
@@ -194,39 +228,39 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Compare>
-bool operator==(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator==(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs) {
     return lhs == rhs;
 }
 
-template <class Key, class Compare>
-bool operator<(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator<(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs) {
     return lhs < rhs;
 }
 
-template <class Key, class Compare>
-bool operator!=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator!=(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs) {
     return !(lhs == rhs);
 }
 
-template <class Key, class Compare>
-bool operator>(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator>(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs) {
     return rhs < lhs;
 }
 
-template <class Key, class Compare>
-bool operator<=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator<=(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs) {
     return !(rhs < lhs);
 }
 
-template <class Key, class Compare>
-bool operator>=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator>=(const set<Key, Compare, Alloc, Ranked>& lhs, const set<Key, Compare, Alloc, Ranked>& rhs) {
     return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class Compare>
-void swap(set<Key, Compare>& lhs, set<Key, Compare>& rhs) noexcept {
+template <class Key, class Compare, class Alloc, bool Ranked>
+void swap(set<Key, Compare, Alloc, Ranked>& lhs, set<Key, Compare, Alloc, Ranked>& rhs) noexcept {
     lhs.swap(rhs);
 }
 
@@ -234,7 +268,11 @@ void swap(set<Key, Compare>& lhs, set<Key, Compare>& rhs) noexcept {
 
 // 模板类 multiset，键值允许重复
 // 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less
-template <class Key, class Compare = mystl::less<Key>>
+// 参数三代表分配器，缺省使用 mystl::allocator
+// 参数四代表是否在节点中维护子树大小，为 true 时支持 select / rank，缺省为 false
+template <class Key, class Compare = mystl::less<Key>,
+          class Alloc = mystl::allocator<Key>,
+          bool Ranked = false>
 class multiset {
 public:
     typedef Key key_type;
@@ -244,7 +282,7 @@ public:
 
 private:
     // 以 mystl::rb_tree 作为底层机制
-    typedef mystl::rb_tree<value_type, key_compare> base_type;
+    typedef mystl::rb_tree<value_type, key_compare, Alloc, Ranked> base_type;
     base_type tree_;  // 以 rb_tree 表现 multiset
 
 public:
@@ -266,11 +304,18 @@ public:
     // 构造、复制、移动函数
     multiset() = default;
 
+    explicit multiset(const allocator_type& alloc) : tree_(alloc) {}
+
     template <class InputIterator>
-    multiset(InputIterator first, InputIterator last) : tree_() {
+    multiset(InputIterator first,
+        InputIterator last,
+        const allocator_type& alloc = allocator_type())
+        : tree_(alloc) {
         tree_.insert_multi(first, last);
     }
-    multiset(std::initializer_list<value_type> ilist) : tree_() {
+    multiset(std::initializer_list<value_type> ilist,
+        const allocator_type& alloc = allocator_type())
+        : tree_(alloc) {
         tree_.insert_multi(ilist.begin(), ilist.end());
     }
 
@@ -366,6 +411,20 @@ public:
     iterator find(const key_type& key) { return tree_.find(key); }
     const_iterator find(const key_type& key) const { return tree_.find(key); }
 
+    // 批量查找，对每个键值依次写入 find 的结果或是否存在
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first,
+                          ForwardIter last,
+                          OutputIter result) const {
+        return tree_.find_batch(first, last, result);
+    }
+    template <class ForwardIter, class OutputIter>
+    OutputIter contains_batch(ForwardIter first,
+                              ForwardIter last,
+                              OutputIter result) const {
+        return tree_.contains_batch(first, last, result);
+    }
+
     size_type count(const key_type& key) const {
         return tree_.count_multi(key);
     }
@@ -389,6 +448,15 @@ public:
         return tree_.equal_range_multi(key);
     }
 
+    // 顺序统计，需要 Ranked 为 true
+    iterator select(size_type k) { return tree_.select(k); }
+    const_iterator select(size_type k) const { return tree_.select(k); }
+    size_type rank(const key_type& key) const { return tree_.rank(key); }
+
+    // 集合运算，O(n + m)，结果保存在本容器中
+    void union_with(const multiset& rhs) { tree_.union_with(rhs.tree_); }
+    void intersect_with(const multiset& rhs) { tree_.intersect_with(rhs.tree_); }
+
     void swap(multiset& rhs) noexcept { tree_.swap(rhs.tree_); }
 
 public:
@@ -401,45 +469,45 @@ public:
 };
 
 // 重载比较操作符
-template <class Key, class Compare>
-bool operator==(const multiset<Key, Compare>& lhs,
-                const multiset<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator==(const multiset<Key, Compare, Alloc, Ranked>& lhs,
+                const multiset<Key, Compare, Alloc, Ranked>& rhs) {
     return lhs == rhs;
 }
 
-template <class Key, class Compare>
-bool operator<(const multiset<Key, Compare>& lhs,
-               const multiset<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator<(const multiset<Key, Compare, Alloc, Ranked>& lhs,
+               const multiset<Key, Compare, Alloc, Ranked>& rhs) {
     return lhs < rhs;
 }
 
-template <class Key, class Compare>
-bool operator!=(const multiset<Key, Compare>& lhs,
-                const multiset<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator!=(const multiset<Key, Compare, Alloc, Ranked>& lhs,
+                const multiset<Key, Compare, Alloc, Ranked>& rhs) {
     return !(lhs == rhs);
 }
 
-template <class Key, class Compare>
-bool operator>(const multiset<Key, Compare>& lhs,
-               const multiset<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator>(const multiset<Key, Compare, Alloc, Ranked>& lhs,
+               const multiset<Key, Compare, Alloc, Ranked>& rhs) {
     return rhs < lhs;
 }
 
-template <class Key, class Compare>
-bool operator<=(const multiset<Key, Compare>& lhs,
-                const multiset<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator<=(const multiset<Key, Compare, Alloc, Ranked>& lhs,
+                const multiset<Key, Compare, Alloc, Ranked>& rhs) {
     return !(rhs < lhs);
 }
 
-template <class Key, class Compare>
-bool operator>=(const multiset<Key, Compare>& lhs,
-                const multiset<Key, Compare>& rhs) {
+template <class Key, class Compare, class Alloc, bool Ranked>
+bool operator>=(const multiset<Key, Compare, Alloc, Ranked>& lhs,
+                const multiset<Key, Compare, Alloc, Ranked>& rhs) {
     return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class Key, class Compare>
-void swap(multiset<Key, Compare>& lhs, multiset<Key, Compare>& rhs) noexcept {
+template <class Key, class Compare, class Alloc, bool Ranked>
+void swap(multiset<Key, Compare, Alloc, Ranked>& lhs, multiset<Key, Compare, Alloc, Ranked>& rhs) noexcept {
     lhs.swap(rhs);
 }
 
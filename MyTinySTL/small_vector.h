@@ -0,0 +1,658 @@
+#ifndef MYTINYSTL_SMALL_VECTOR_H_
+#define MYTINYSTL_SMALL_VECTOR_H_
+
+// 这个头文件包含一个模板类 small_vector
+// small_vector : 带内联存储的向量，元素不超过 N 个时存放在对象内部，超过后才向分配器申请空间
+
+// notes:
+//
+// 与 vector 的区别：
+//   * 容量最少为 N，且前 N 个元素不需要分配内存
+//   * 元素存放在内联存储中时，移动构造、移动赋值与 swap 需要逐个移动元素，
+//     原有的迭代器、指针、引用随之失效
+//   * shrink_to_fit 在元素不超过 N 个时把元素移回内联存储并释放堆空间
+//   * 分配器不随赋值与交换传播
+//
+// 异常保证：
+// mystl::small_vector<T, N> 满足基本异常保证，并对以下函数做强异常安全保证：
+//   * emplace_back
+//   * push_back
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "algo.h"
+#include "exceptdef.h"
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+
+namespace mystl {
+
+// 模板类 small_vector
+// 参数一代表数据类型，参数二代表内联存储的元素个数，参数三代表分配器，缺省使用
+// mystl::allocator
+template <class T, size_t N, class Alloc = mystl::allocator<T>>
+class small_vector {
+    static_assert(N > 0, "small_vector needs room for at least one element");
+
+public:
+    // small_vector 的嵌套型别定义
+    typedef Alloc allocator_type;
+    typedef mystl::allocator_traits<Alloc> alloc_traits;
+
+    typedef typename allocator_type::value_type value_type;
+    typedef typename allocator_type::pointer pointer;
+    typedef typename allocator_type::const_pointer const_pointer;
+    typedef typename allocator_type::reference reference;
+    typedef typename allocator_type::const_reference const_reference;
+    typedef typename allocator_type::size_type size_type;
+    typedef typename allocator_type::difference_type difference_type;
+
+    typedef value_type* iterator;
+    typedef const value_type* const_iterator;
+    typedef mystl::reverse_iterator<iterator> reverse_iterator;
+    typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    allocator_type get_allocator() const { return alloc_; }
+
+private:
+    allocator_type alloc_;  // 分配器
+    iterator begin_;        // 表示目前使用空间的头部
+    iterator end_;          // 表示目前使用空间的尾部
+    iterator cap_;          // 表示目前储存空间的尾部
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type
+        buf_;  // 内联存储
+
+public:
+    // 构造、复制、移动、析构函数
+    small_vector() noexcept : alloc_() { init_inline(); }
+
+    explicit small_vector(const allocator_type& alloc) noexcept
+        : alloc_(alloc) {
+        init_inline();
+    }
+
+    explicit small_vector(size_type n,
+                          const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        init_inline();
+        fill_insert(end_, n, value_type());
+    }
+
+    small_vector(size_type n,
+                 const value_type& value,
+                 const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        init_inline();
+        fill_insert(end_, n, value);
+    }
+
+    template <class Iter,
+              typename std::enable_if<mystl::is_input_iterator<Iter>::value,
+                                      int>::type = 0>
+    small_vector(Iter first,
+                 Iter last,
+                 const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        MYSTL_DEBUG(!(last < first));
+        init_inline();
+        copy_insert(end_, first, last, iterator_category(first));
+    }
+
+    small_vector(const small_vector& rhs)
+        : alloc_(alloc_traits::select_on_container_copy_construction(
+              rhs.alloc_)) {
+        init_inline();
+        copy_insert(end_, rhs.begin_, rhs.end_, forward_iterator_tag{});
+    }
+
+    // 元素在堆上时直接接管 rhs 的空间，否则逐个移动元素
+    small_vector(small_vector&& rhs) noexcept(
+        std::is_nothrow_move_constructible<T>::value)
+        : alloc_(mystl::move(rhs.alloc_)) {
+        init_inline();
+        take(rhs);
+    }
+
+    small_vector(std::initializer_list<value_type> ilist,
+                 const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        init_inline();
+        copy_insert(end_, ilist.begin(), ilist.end(), forward_iterator_tag{});
+    }
+
+    small_vector& operator=(const small_vector& rhs) {
+        if (this != &rhs)
+            assign(rhs.begin_, rhs.end_);
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& rhs) {
+        if (this != &rhs) {
+            clear();
+            take(rhs);
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<value_type> ilist) {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    ~small_vector() {
+        mystl::destroy(begin_, end_);
+        release();
+    }
+
+public:
+    // 迭代器相关操作
+    iterator begin() noexcept { return begin_; }
+    const_iterator begin() const noexcept { return begin_; }
+    iterator end() noexcept { return end_; }
+    const_iterator end() const noexcept { return end_; }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // 容量相关操作
+    bool empty() const noexcept { return begin_ == end_; }
+    size_type size() const noexcept {
+        return static_cast<size_type>(end_ - begin_);
+    }
+    size_type max_size() const noexcept {
+        return static_cast<size_type>(-1) / sizeof(T);
+    }
+    size_type capacity() const noexcept {
+        return static_cast<size_type>(cap_ - begin_);
+    }
+    // 元素是否存放在内联存储中
+    bool is_inline() const noexcept { return begin_ == inline_data(); }
+    static constexpr size_type inline_capacity() noexcept { return N; }
+
+    void reserve(size_type n) {
+        if (capacity() < n) {
+            THROW_LENGTH_ERROR_IF(n > max_size(),
+                                  "n can not larger than max_size() in "
+                                  "small_vector<T, N>::reserve(n)");
+            reallocate(n);
+        }
+    }
+    void shrink_to_fit();
+
+    // 访问元素相关操作
+    reference operator[](size_type n) {
+        MYSTL_DEBUG(n < size());
+        return *(begin_ + n);
+    }
+    const_reference operator[](size_type n) const {
+        MYSTL_DEBUG(n < size());
+        return *(begin_ + n);
+    }
+    reference at(size_type n) {
+        THROW_OUT_OF_RANGE_IF(!(n < size()),
+                              "small_vector<T, N>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const {
+        THROW_OUT_OF_RANGE_IF(!(n < size()),
+                              "small_vector<T, N>::at() subscript out of range");
+        return (*this)[n];
+    }
+    reference front() {
+        MYSTL_DEBUG(!empty());
+        return *begin_;
+    }
+    const_reference front() const {
+        MYSTL_DEBUG(!empty());
+        return *begin_;
+    }
+    reference back() {
+        MYSTL_DEBUG(!empty());
+        return *(end_ - 1);
+    }
+    const_reference back() const {
+        MYSTL_DEBUG(!empty());
+        return *(end_ - 1);
+    }
+    pointer data() noexcept { return begin_; }
+    const_pointer data() const noexcept { return begin_; }
+
+    // 修改容器相关操作
+    // assign
+
+    void assign(size_type n, const value_type& value) {
+        const value_type value_copy = value;  // value 可能是容器中的元素
+        clear();
+        fill_insert(end_, n, value_copy);
+    }
+
+    template <class Iter,
+              typename std::enable_if<mystl::is_input_iterator<Iter>::value,
+                                      int>::type = 0>
+    void assign(Iter first, Iter last) {
+        MYSTL_DEBUG(!(last < first));
+        clear();
+        copy_insert(end_, first, last, iterator_category(first));
+    }
+
+    void assign(std::initializer_list<value_type> ilist) {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    // emplace / emplace_back
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args);
+
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        if (end_ != cap_) {
+            mystl::construct(mystl::address_of(*end_),
+                             mystl::forward<Args>(args)...);
+            ++end_;
+        } else {
+            reallocate_emplace(end_, mystl::forward<Args>(args)...);
+        }
+    }
+
+    // push_back / pop_back
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(mystl::move(value)); }
+
+    void pop_back() {
+        MYSTL_DEBUG(!empty());
+        mystl::destroy(end_ - 1);
+        --end_;
+    }
+
+    // insert
+    iterator insert(const_iterator pos, const value_type& value) {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, value_type&& value) {
+        return emplace(pos, mystl::move(value));
+    }
+
+    iterator insert(const_iterator pos, size_type n, const value_type& value) {
+        MYSTL_DEBUG(pos >= begin() && pos <= end());
+        return fill_insert(const_cast<iterator>(pos), n, value);
+    }
+
+    template <class Iter,
+              typename std::enable_if<mystl::is_input_iterator<Iter>::value,
+                                      int>::type = 0>
+    void insert(const_iterator pos, Iter first, Iter last) {
+        MYSTL_DEBUG(pos >= begin() && pos <= end() && !(last < first));
+        copy_insert(const_cast<iterator>(pos), first, last,
+                    iterator_category(first));
+    }
+
+    // erase / clear
+    iterator erase(const_iterator pos) {
+        MYSTL_DEBUG(pos >= begin() && pos < end());
+        return erase(pos, pos + 1);
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+        iterator r = begin_ + (first - begin_);
+        auto new_end = mystl::move(r + (last - first), end_, r);
+        mystl::destroy(new_end, end_);
+        end_ = new_end;
+        return r;
+    }
+    void clear() noexcept {
+        mystl::destroy(begin_, end_);
+        end_ = begin_;
+    }
+
+    // resize / reverse
+    void resize(size_type new_size) { resize(new_size, value_type()); }
+    void resize(size_type new_size, const value_type& value) {
+        if (new_size < size())
+            erase(begin_ + new_size, end_);
+        else
+            fill_insert(end_, new_size - size(), value);
+    }
+
+    void reverse() { mystl::reverse(begin(), end()); }
+
+    // swap
+    void swap(small_vector& rhs);
+
+private:
+    // helper functions
+
+    // 内联存储
+    iterator inline_data() noexcept { return reinterpret_cast<iterator>(&buf_); }
+    const_iterator inline_data() const noexcept {
+        return reinterpret_cast<const_iterator>(&buf_);
+    }
+    void init_inline() noexcept {
+        begin_ = end_ = inline_data();
+        cap_ = begin_ + N;
+    }
+
+    // 释放堆空间，不析构元素
+    void release() noexcept {
+        if (!is_inline())
+            alloc_.deallocate(begin_, cap_ - begin_);
+    }
+
+    // 取得 rhs 的元素，调用前本容器为空，之后 rhs 为空
+    void take(small_vector& rhs);
+
+    // calculate the growth size
+    size_type get_new_cap(size_type add_size) const;
+
+    // reallocate
+    // 把元素移到容量为 new_cap 的空间中，new_cap 不超过 N 时移回内联存储
+    void reallocate(size_type new_cap);
+    template <class... Args>
+    void reallocate_emplace(iterator pos, Args&&... args);
+
+    // insert
+    iterator fill_insert(iterator pos, size_type n, const value_type& value);
+    template <class IIter>
+    void copy_insert(iterator pos, IIter first, IIter last, input_iterator_tag);
+    template <class FIter>
+    void copy_insert(iterator pos,
+                     FIter first,
+                     FIter last,
+                     forward_iterator_tag);
+};
+
+/*****************************************************************************************/
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::shrink_to_fit() {
+    if (is_inline())
+        return;
+    if (size() <= N)
+        reallocate(N);
+    else if (end_ != cap_)
+        reallocate(size());
+}
+
+// 在 pos 处就地构造元素
+template <class T, size_t N, class Alloc>
+template <class... Args>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::emplace(const_iterator pos, Args&&... args) {
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    iterator xpos = const_cast<iterator>(pos);
+    const size_type n = xpos - begin_;
+    if (end_ == cap_) {
+        reallocate_emplace(xpos, mystl::forward<Args>(args)...);
+    } else if (xpos == end_) {
+        mystl::construct(mystl::address_of(*end_),
+                         mystl::forward<Args>(args)...);
+        ++end_;
+    } else {
+        value_type tmp(mystl::forward<Args>(args)...);  // args 可能引用容器中的元素
+        mystl::construct(mystl::address_of(*end_), mystl::move(*(end_ - 1)));
+        ++end_;
+        mystl::move_backward(xpos, end_ - 2, end_ - 1);
+        *xpos = mystl::move(tmp);
+    }
+    return begin_ + n;
+}
+
+// 与 rhs 交换元素，两边都在堆上时交换指针，否则逐个移动元素
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::swap(small_vector& rhs) {
+    if (this == &rhs)
+        return;
+    if (!is_inline() && !rhs.is_inline() &&
+        alloc_traits::equal(alloc_, rhs.alloc_)) {
+        mystl::swap(begin_, rhs.begin_);
+        mystl::swap(end_, rhs.end_);
+        mystl::swap(cap_, rhs.cap_);
+        return;
+    }
+    small_vector tmp(mystl::move(rhs));
+    rhs = mystl::move(*this);
+    *this = mystl::move(tmp);
+}
+
+/*****************************************************************************************/
+// helper function
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::take(small_vector& rhs) {
+    if (!rhs.is_inline() && alloc_traits::equal(alloc_, rhs.alloc_)) {
+        release();
+        begin_ = rhs.begin_;
+        end_ = rhs.end_;
+        cap_ = rhs.cap_;
+        rhs.init_inline();
+        return;
+    }
+    reserve(rhs.size());
+    end_ = mystl::uninitialized_move(rhs.begin_, rhs.end_, begin_);
+    rhs.clear();
+}
+
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::size_type
+small_vector<T, N, Alloc>::get_new_cap(size_type add_size) const {
+    const auto old_size = capacity();
+    THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size,
+                          "small_vector<T, N>'s size too big");
+    if (old_size > max_size() - old_size / 2)
+        return old_size + add_size;
+    // 第一次分配堆空间时与 vector 一样至少 16 个元素
+    return mystl::max(mystl::max(old_size + old_size / 2, size() + add_size),
+                      static_cast<size_type>(16));
+}
+
+template <class T, size_t N, class Alloc>
+void small_vector<T, N, Alloc>::reallocate(size_type new_cap) {
+    const bool to_inline = new_cap <= N;
+    if (to_inline)
+        new_cap = N;
+    auto new_begin = to_inline ? inline_data() : alloc_.allocate(new_cap);
+    iterator new_end;
+    try {
+        new_end = mystl::uninitialized_move(begin_, end_, new_begin);
+    } catch (...) {
+        if (!to_inline)
+            alloc_.deallocate(new_begin, new_cap);
+        throw;
+    }
+    mystl::destroy(begin_, end_);
+    release();
+    begin_ = new_begin;
+    end_ = new_end;
+    cap_ = new_begin + new_cap;
+}
+
+// 空间不足时在 pos 处构造元素：先在新空间中构造新元素，再移动原有元素
+template <class T, size_t N, class Alloc>
+template <class... Args>
+void small_vector<T, N, Alloc>::reallocate_emplace(iterator pos,
+                                                   Args&&... args) {
+    const auto new_cap = get_new_cap(1);
+    const size_type n = pos - begin_;
+    auto new_begin = alloc_.allocate(new_cap);
+    try {
+        mystl::construct(mystl::address_of(*(new_begin + n)),
+                         mystl::forward<Args>(args)...);
+    } catch (...) {
+        alloc_.deallocate(new_begin, new_cap);
+        throw;
+    }
+    auto new_end = new_begin + n + 1;
+    try {
+        mystl::uninitialized_move(begin_, pos, new_begin);
+        new_end = mystl::uninitialized_move(pos, end_, new_end);
+    } catch (...) {
+        mystl::destroy(new_begin + n);
+        alloc_.deallocate(new_begin, new_cap);
+        throw;
+    }
+    mystl::destroy(begin_, end_);
+    release();
+    begin_ = new_begin;
+    end_ = new_end;
+    cap_ = new_begin + new_cap;
+}
+
+template <class T, size_t N, class Alloc>
+typename small_vector<T, N, Alloc>::iterator
+small_vector<T, N, Alloc>::fill_insert(iterator pos,
+                                       size_type n,
+                                       const value_type& value) {
+    const size_type xpos = pos - begin_;
+    if (n == 0)
+        return pos;
+    const value_type value_copy = value;  // 避免被覆盖
+    if (static_cast<size_type>(cap_ - end_) >= n) {
+        const size_type after_elems = end_ - pos;
+        auto old_end = end_;
+        if (after_elems > n) {
+            end_ = mystl::uninitialized_move(end_ - n, end_, end_);
+            mystl::move_backward(pos, old_end - n, old_end);
+            mystl::fill_n(pos, n, value_copy);
+        } else {
+            end_ = mystl::uninitialized_fill_n(end_, n - after_elems,
+                                               value_copy);
+            end_ = mystl::uninitialized_move(pos, old_end, end_);
+            mystl::fill(pos, old_end, value_copy);
+        }
+    } else {
+        const auto new_cap = get_new_cap(n);
+        auto new_begin = alloc_.allocate(new_cap);
+        auto new_end = new_begin;
+        try {
+            new_end = mystl::uninitialized_move(begin_, pos, new_begin);
+            new_end = mystl::uninitialized_fill_n(new_end, n, value_copy);
+            new_end = mystl::uninitialized_move(pos, end_, new_end);
+        } catch (...) {
+            mystl::destroy(new_begin, new_end);
+            alloc_.deallocate(new_begin, new_cap);
+            throw;
+        }
+        mystl::destroy(begin_, end_);
+        release();
+        begin_ = new_begin;
+        end_ = new_end;
+        cap_ = new_begin + new_cap;
+    }
+    return begin_ + xpos;
+}
+
+template <class T, size_t N, class Alloc>
+template <class IIter>
+void small_vector<T, N, Alloc>::copy_insert(iterator pos,
+                                            IIter first,
+                                            IIter last,
+                                            input_iterator_tag) {
+    for (; first != last; ++first, ++pos)
+        pos = emplace(pos, *first);
+}
+
+template <class T, size_t N, class Alloc>
+template <class FIter>
+void small_vector<T, N, Alloc>::copy_insert(iterator pos,
+                                            FIter first,
+                                            FIter last,
+                                            forward_iterator_tag) {
+    if (first == last)
+        return;
+    const size_type n = mystl::distance(first, last);
+    if (static_cast<size_type>(cap_ - end_) >= n) {
+        const size_type after_elems = end_ - pos;
+        auto old_end = end_;
+        if (after_elems > n) {
+            end_ = mystl::uninitialized_move(end_ - n, end_, end_);
+            mystl::move_backward(pos, old_end - n, old_end);
+            mystl::copy(first, last, pos);
+        } else {
+            auto mid = first;
+            mystl::advance(mid, after_elems);
+            end_ = mystl::uninitialized_copy(mid, last, end_);
+            end_ = mystl::uninitialized_move(pos, old_end, end_);
+            mystl::copy(first, mid, pos);
+        }
+    } else {
+        const auto new_cap = get_new_cap(n);
+        auto new_begin = alloc_.allocate(new_cap);
+        auto new_end = new_begin;
+        try {
+            new_end = mystl::uninitialized_move(begin_, pos, new_begin);
+            new_end = mystl::uninitialized_copy(first, last, new_end);
+            new_end = mystl::uninitialized_move(pos, end_, new_end);
+        } catch (...) {
+            mystl::destroy(new_begin, new_end);
+            alloc_.deallocate(new_begin, new_cap);
+            throw;
+        }
+        mystl::destroy(begin_, end_);
+        release();
+        begin_ = new_begin;
+        end_ = new_end;
+        cap_ = new_begin + new_cap;
+    }
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <class T, size_t N, class Alloc>
+bool operator==(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs) {
+    return lhs.size() == rhs.size() &&
+           mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<(const small_vector<T, N, Alloc>& lhs,
+               const small_vector<T, N, Alloc>& rhs) {
+    return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
+                                          rhs.end());
+}
+
+template <class T, size_t N, class Alloc>
+bool operator!=(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>(const small_vector<T, N, Alloc>& lhs,
+               const small_vector<T, N, Alloc>& rhs) {
+    return rhs < lhs;
+}
+
+template <class T, size_t N, class Alloc>
+bool operator<=(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <class T, size_t N, class Alloc>
+bool operator>=(const small_vector<T, N, Alloc>& lhs,
+                const small_vector<T, N, Alloc>& rhs) {
+    return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <class T, size_t N, class Alloc>
+void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs) {
+    lhs.swap(rhs);
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_SMALL_VECTOR_H_
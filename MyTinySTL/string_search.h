@@ -0,0 +1,661 @@
+#ifndef MYTINYSTL_STRING_SEARCH_H_
+#define MYTINYSTL_STRING_SEARCH_H_
+
+// 这个头文件包含 basic_string 与 char_traits 查找、比较操作使用的底层函数
+// 对 char 类型使用 SSE2 / AVX2 指令一次比较 16 / 32 个字符，AVX2 在运行时
+// 检测 CPU 是否支持；char16_t / char32_t 使用 SSE2；其他字符类型或平台
+// 逐个字符比较
+
+// notes:
+//
+// 所有函数在 [s, s + n) 上查找，找到时返回指向该字符的指针，否则返回 nullptr
+// 向量版本只读取 [s, s + n) 以内的字符，剩余不足一组的字符逐个比较
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+#define MYSTL_STR_SSE2 1
+#define MYSTL_STR_AVX2 1
+#define MYSTL_STR_AVX2_FN __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && \
+    (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MYSTL_STR_SSE2 1
+#include <intrin.h>
+#endif
+
+namespace mystl {
+
+/*****************************************************************************************/
+// 通用版本，逐个字符比较
+
+template <class CharType>
+const CharType* str_find_char(const CharType* s,
+                              size_t n,
+                              CharType ch) noexcept {
+    for (; n != 0; --n, ++s) {
+        if (*s == ch)
+            return s;
+    }
+    return nullptr;
+}
+
+template <class CharType>
+const CharType* str_rfind_char(const CharType* s,
+                               size_t n,
+                               CharType ch) noexcept {
+    for (; n != 0; --n) {
+        if (s[n - 1] == ch)
+            return s + n - 1;
+    }
+    return nullptr;
+}
+
+// 查找 [p, p + m) 第一次出现的位置，m 不为 0
+template <class CharType>
+const CharType* str_find(const CharType* s,
+                         size_t n,
+                         const CharType* p,
+                         size_t m) noexcept {
+    if (m > n)
+        return nullptr;
+    const CharType* last = s + (n - m);
+    for (; s <= last; ++s) {
+        if (*s == *p) {
+            size_t j = 1;
+            while (j < m && s[j] == p[j])
+                ++j;
+            if (j == m)
+                return s;
+        }
+    }
+    return nullptr;
+}
+
+// 查找 [p, p + m) 最后一次出现的位置，m 不为 0
+template <class CharType>
+const CharType* str_rfind(const CharType* s,
+                          size_t n,
+                          const CharType* p,
+                          size_t m) noexcept {
+    if (m > n)
+        return nullptr;
+    for (size_t i = n - m + 1; i != 0; --i) {
+        const CharType* cur = s + i - 1;
+        if (*cur == *p) {
+            size_t j = 1;
+            while (j < m && cur[j] == p[j])
+                ++j;
+            if (j == m)
+                return cur;
+        }
+    }
+    return nullptr;
+}
+
+template <class CharType>
+bool str_in_set(CharType ch, const CharType* set, size_t m) noexcept {
+    for (size_t i = 0; i < m; ++i) {
+        if (set[i] == ch)
+            return true;
+    }
+    return false;
+}
+
+// 查找第一个属于（match 为 true）或不属于（match 为 false）[set, set + m)
+// 的字符
+template <class CharType>
+const CharType* str_find_first_of(const CharType* s,
+                                  size_t n,
+                                  const CharType* set,
+                                  size_t m,
+                                  bool match) noexcept {
+    for (; n != 0; --n, ++s) {
+        if (str_in_set(*s, set, m) == match)
+            return s;
+    }
+    return nullptr;
+}
+
+// 查找最后一个属于（match 为 true）或不属于（match 为 false）[set, set + m)
+// 的字符
+template <class CharType>
+const CharType* str_find_last_of(const CharType* s,
+                                 size_t n,
+                                 const CharType* set,
+                                 size_t m,
+                                 bool match) noexcept {
+    for (; n != 0; --n) {
+        if (str_in_set(s[n - 1], set, m) == match)
+            return s + n - 1;
+    }
+    return nullptr;
+}
+
+/*****************************************************************************************/
+// char 版本
+
+// 字符集合的查找表
+// bits 是 256 位的位图，逐个字符查找时使用
+// nibble[k][lo] 的第 h 位表示集合中含有字符 ((k * 8 + h) << 4) | lo，
+// 向量版本用 pshufb 按字符的高低 4 位查表，一次判断 32 个字符
+struct str_char_set {
+    uint64_t bits[4];
+    unsigned char nibble[2][16];
+
+    str_char_set(const char* set, size_t m) noexcept : bits(), nibble() {
+        for (size_t i = 0; i < m; ++i) {
+            const auto c = static_cast<unsigned char>(set[i]);
+            bits[c >> 6] |= uint64_t(1) << (c & 63);
+            nibble[c >> 7][c & 15] |=
+                static_cast<unsigned char>(1u << ((c >> 4) & 7));
+        }
+    }
+
+    bool contains(char ch) const noexcept {
+        const auto c = static_cast<unsigned char>(ch);
+        return (bits[c >> 6] >> (c & 63)) & 1;
+    }
+};
+
+inline const char* str_find_first_of_scalar(const char* s,
+                                            size_t n,
+                                            const str_char_set& cs,
+                                            bool match) noexcept {
+    for (; n != 0; --n, ++s) {
+        if (cs.contains(*s) == match)
+            return s;
+    }
+    return nullptr;
+}
+
+inline const char* str_find_last_of_scalar(const char* s,
+                                           size_t n,
+                                           const str_char_set& cs,
+                                           bool match) noexcept {
+    for (; n != 0; --n) {
+        if (cs.contains(s[n - 1]) == match)
+            return s + n - 1;
+    }
+    return nullptr;
+}
+
+#if MYSTL_STR_SSE2
+
+// 最低位 / 最高位的 1 所在的位置，x 不为 0
+inline unsigned str_ctz(uint32_t x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long r;
+    _BitScanForward(&r, x);
+    return static_cast<unsigned>(r);
+#else
+    return static_cast<unsigned>(__builtin_ctz(x));
+#endif
+}
+
+inline unsigned str_bsr(uint32_t x) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long r;
+    _BitScanReverse(&r, x);
+    return static_cast<unsigned>(r);
+#else
+    return 31u - static_cast<unsigned>(__builtin_clz(x));
+#endif
+}
+
+// 比较 16 个字符，返回相等位置的位掩码
+inline uint32_t str_eq_mask16(const char* s, __m128i c) noexcept {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, c)));
+}
+
+inline const char* str_find_char_sse2(const char* s,
+                                      size_t n,
+                                      char ch) noexcept {
+    const __m128i c = _mm_set1_epi8(ch);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const uint32_t mask = str_eq_mask16(s + i, c);
+        if (mask != 0)
+            return s + i + str_ctz(mask);
+    }
+    return static_cast<const char*>(std::memchr(s + i, ch, n - i));
+}
+
+inline const char* str_rfind_char_sse2(const char* s,
+                                       size_t n,
+                                       char ch) noexcept {
+    const __m128i c = _mm_set1_epi8(ch);
+    for (; n >= 16; n -= 16) {
+        const uint32_t mask = str_eq_mask16(s + n - 16, c);
+        if (mask != 0)
+            return s + n - 16 + str_bsr(mask);
+    }
+    return str_rfind_char<char>(s, n, ch);
+}
+
+// 先比较子串的首尾两个字符，都相等的位置才比较整个子串，m 至少为 2
+inline const char* str_find_sse2(const char* s,
+                                 size_t n,
+                                 const char* p,
+                                 size_t m) noexcept {
+    const __m128i first = _mm_set1_epi8(p[0]);
+    const __m128i last = _mm_set1_epi8(p[m - 1]);
+    size_t i = 0;
+    for (; i + m + 15 <= n; i += 16) {
+        uint32_t mask = str_eq_mask16(s + i, first) &
+                        str_eq_mask16(s + i + m - 1, last);
+        while (mask != 0) {
+            const unsigned bit = str_ctz(mask);
+            if (std::memcmp(s + i + bit + 1, p + 1, m - 2) == 0)
+                return s + i + bit;
+            mask &= mask - 1;
+        }
+    }
+    return str_find<char>(s + i, n - i, p, m);
+}
+
+inline const char* str_rfind_sse2(const char* s,
+                                  size_t n,
+                                  const char* p,
+                                  size_t m) noexcept {
+    const __m128i first = _mm_set1_epi8(p[0]);
+    const __m128i last = _mm_set1_epi8(p[m - 1]);
+    // 可能的起始位置为 [0, end)
+    size_t end = n - m + 1;
+    for (; end >= 16; end -= 16) {
+        const char* cur = s + end - 16;
+        uint32_t mask =
+            str_eq_mask16(cur, first) & str_eq_mask16(cur + m - 1, last);
+        while (mask != 0) {
+            const unsigned bit = str_bsr(mask);
+            if (std::memcmp(cur + bit + 1, p + 1, m - 2) == 0)
+                return cur + bit;
+            mask &= ~(uint32_t(1) << bit);
+        }
+    }
+    return str_rfind<char>(s, end + m - 1, p, m);
+}
+
+#endif  // MYSTL_STR_SSE2
+
+#if MYSTL_STR_AVX2
+
+// 运行时检测 CPU 是否支持 AVX2，结果只计算一次
+inline bool str_has_avx2() noexcept {
+    static const bool has = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return has;
+}
+
+MYSTL_STR_AVX2_FN
+inline uint32_t str_eq_mask32(const char* s, __m256i c) noexcept {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, c)));
+}
+
+// n 至少为 32
+MYSTL_STR_AVX2_FN
+inline const char* str_find_char_avx2(const char* s,
+                                      size_t n,
+                                      char ch) noexcept {
+    const __m256i c = _mm256_set1_epi8(ch);
+    size_t i = 0;
+    // 每次先粗略检查 128 个字符，有相等的再逐组定位
+    for (; i + 128 <= n; i += 128) {
+        const auto v = reinterpret_cast<const __m256i*>(s + i);
+        const __m256i e0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(v), c);
+        const __m256i e1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(v + 1), c);
+        const __m256i e2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(v + 2), c);
+        const __m256i e3 = _mm256_cmpeq_epi8(_mm256_loadu_si256(v + 3), c);
+        const __m256i any = _mm256_or_si256(_mm256_or_si256(e0, e1),
+                                            _mm256_or_si256(e2, e3));
+        if (!_mm256_testz_si256(any, any))
+            break;
+    }
+    for (; i + 32 <= n; i += 32) {
+        const uint32_t mask = str_eq_mask32(s + i, c);
+        if (mask != 0)
+            return s + i + str_ctz(mask);
+    }
+    // 剩余不足 32 个字符，读取以最后一个字符结尾的 32 个字符，
+    // 前面重叠的部分已经确认不相等
+    if (i < n) {
+        const uint32_t mask = str_eq_mask32(s + n - 32, c);
+        if (mask != 0)
+            return s + n - 32 + str_ctz(mask);
+    }
+    return nullptr;
+}
+
+MYSTL_STR_AVX2_FN
+inline const char* str_rfind_char_avx2(const char* s,
+                                       size_t n,
+                                       char ch) noexcept {
+    const __m256i c = _mm256_set1_epi8(ch);
+    for (; n >= 32; n -= 32) {
+        const uint32_t mask = str_eq_mask32(s + n - 32, c);
+        if (mask != 0)
+            return s + n - 32 + str_bsr(mask);
+    }
+    return str_rfind_char_sse2(s, n, ch);
+}
+
+MYSTL_STR_AVX2_FN
+inline const char* str_find_avx2(const char* s,
+                                 size_t n,
+                                 const char* p,
+                                 size_t m) noexcept {
+    const __m256i first = _mm256_set1_epi8(p[0]);
+    const __m256i last = _mm256_set1_epi8(p[m - 1]);
+    size_t i = 0;
+    for (; i + m + 31 <= n; i += 32) {
+        uint32_t mask = str_eq_mask32(s + i, first) &
+                        str_eq_mask32(s + i + m - 1, last);
+        while (mask != 0) {
+            const unsigned bit = str_ctz(mask);
+            if (std::memcmp(s + i + bit + 1, p + 1, m - 2) == 0)
+                return s + i + bit;
+            mask &= mask - 1;
+        }
+    }
+    return str_find_sse2(s + i, n - i, p, m);
+}
+
+MYSTL_STR_AVX2_FN
+inline const char* str_rfind_avx2(const char* s,
+                                  size_t n,
+                                  const char* p,
+                                  size_t m) noexcept {
+    const __m256i first = _mm256_set1_epi8(p[0]);
+    const __m256i last = _mm256_set1_epi8(p[m - 1]);
+    size_t end = n - m + 1;
+    for (; end >= 32; end -= 32) {
+        const char* cur = s + end - 32;
+        uint32_t mask =
+            str_eq_mask32(cur, first) & str_eq_mask32(cur + m - 1, last);
+        while (mask != 0) {
+            const unsigned bit = str_bsr(mask);
+            if (std::memcmp(cur + bit + 1, p + 1, m - 2) == 0)
+                return cur + bit;
+            mask &= ~(uint32_t(1) << bit);
+        }
+    }
+    return str_rfind_sse2(s, end + m - 1, p, m);
+}
+
+// 用 str_char_set 的 nibble 表判断 32 个字符是否属于集合
+struct str_set_avx2 {
+    __m256i lo_tbl;   // 高 4 位为 0~7 的字符
+    __m256i hi_tbl;   // 高 4 位为 8~15 的字符
+    __m256i lo_bit;   // 高 4 位 h < 8 时为 1 << h
+    __m256i hi_bit;   // 高 4 位 h >= 8 时为 1 << (h - 8)
+    __m256i low4;
+
+    MYSTL_STR_AVX2_FN
+    explicit str_set_avx2(const str_char_set& cs) noexcept {
+        lo_tbl = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(cs.nibble[0])));
+        hi_tbl = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(cs.nibble[1])));
+        lo_bit = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0,
+                                  0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128, 0, 0,
+                                  0, 0, 0, 0, 0, 0);
+        hi_bit = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32,
+                                  64, -128, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8,
+                                  16, 32, 64, -128);
+        low4 = _mm256_set1_epi8(0x0f);
+    }
+
+    // 返回属于集合的位置的位掩码
+    MYSTL_STR_AVX2_FN
+    uint32_t match(const char* s) const noexcept {
+        const __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+        const __m256i lo = _mm256_and_si256(v, low4);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low4);
+        const __m256i a = _mm256_and_si256(_mm256_shuffle_epi8(lo_tbl, lo),
+                                           _mm256_shuffle_epi8(lo_bit, hi));
+        const __m256i b = _mm256_and_si256(_mm256_shuffle_epi8(hi_tbl, lo),
+                                           _mm256_shuffle_epi8(hi_bit, hi));
+        const __m256i miss = _mm256_cmpeq_epi8(_mm256_or_si256(a, b),
+                                               _mm256_setzero_si256());
+        return ~static_cast<uint32_t>(_mm256_movemask_epi8(miss));
+    }
+};
+
+MYSTL_STR_AVX2_FN
+inline const char* str_find_first_of_avx2(const char* s,
+                                          size_t n,
+                                          const str_char_set& cs,
+                                          bool match) noexcept {
+    const str_set_avx2 vs(cs);
+    const uint32_t flip = match ? 0u : ~0u;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const uint32_t mask = vs.match(s + i) ^ flip;
+        if (mask != 0)
+            return s + i + str_ctz(mask);
+    }
+    return str_find_first_of_scalar(s + i, n - i, cs, match);
+}
+
+MYSTL_STR_AVX2_FN
+inline const char* str_find_last_of_avx2(const char* s,
+                                         size_t n,
+                                         const str_char_set& cs,
+                                         bool match) noexcept {
+    const str_set_avx2 vs(cs);
+    const uint32_t flip = match ? 0u : ~0u;
+    for (; n >= 32; n -= 32) {
+        const uint32_t mask = vs.match(s + n - 32) ^ flip;
+        if (mask != 0)
+            return s + n - 32 + str_bsr(mask);
+    }
+    return str_find_last_of_scalar(s, n, cs, match);
+}
+
+#endif  // MYSTL_STR_AVX2
+
+inline const char* str_find_char(const char* s, size_t n, char ch) noexcept {
+#if MYSTL_STR_AVX2
+    if (n >= 32 && str_has_avx2())
+        return str_find_char_avx2(s, n, ch);
+#endif
+#if MYSTL_STR_SSE2
+    return str_find_char_sse2(s, n, ch);
+#else
+    return static_cast<const char*>(std::memchr(s, ch, n));
+#endif
+}
+
+inline const char* str_rfind_char(const char* s, size_t n, char ch) noexcept {
+#if MYSTL_STR_AVX2
+    if (n >= 32 && str_has_avx2())
+        return str_rfind_char_avx2(s, n, ch);
+#endif
+#if MYSTL_STR_SSE2
+    return str_rfind_char_sse2(s, n, ch);
+#else
+    return str_rfind_char<char>(s, n, ch);
+#endif
+}
+
+inline const char* str_find(const char* s,
+                            size_t n,
+                            const char* p,
+                            size_t m) noexcept {
+    if (m > n)
+        return nullptr;
+    if (m == 1)
+        return str_find_char(s, n, *p);
+#if MYSTL_STR_AVX2
+    if (n >= 32 && str_has_avx2())
+        return str_find_avx2(s, n, p, m);
+#endif
+#if MYSTL_STR_SSE2
+    return str_find_sse2(s, n, p, m);
+#else
+    return str_find<char>(s, n, p, m);
+#endif
+}
+
+inline const char* str_rfind(const char* s,
+                             size_t n,
+                             const char* p,
+                             size_t m) noexcept {
+    if (m > n)
+        return nullptr;
+    if (m == 1)
+        return str_rfind_char(s, n, *p);
+#if MYSTL_STR_AVX2
+    if (n >= 32 && str_has_avx2())
+        return str_rfind_avx2(s, n, p, m);
+#endif
+#if MYSTL_STR_SSE2
+    return str_rfind_sse2(s, n, p, m);
+#else
+    return str_rfind<char>(s, n, p, m);
+#endif
+}
+
+inline const char* str_find_first_of(const char* s,
+                                     size_t n,
+                                     const char* set,
+                                     size_t m,
+                                     bool match) noexcept {
+    if (match && m == 1)
+        return str_find_char(s, n, *set);
+    const str_char_set cs(set, m);
+#if MYSTL_STR_AVX2
+    if (n >= 32 && str_has_avx2())
+        return str_find_first_of_avx2(s, n, cs, match);
+#endif
+    return str_find_first_of_scalar(s, n, cs, match);
+}
+
+inline const char* str_find_last_of(const char* s,
+                                    size_t n,
+                                    const char* set,
+                                    size_t m,
+                                    bool match) noexcept {
+    if (match && m == 1)
+        return str_rfind_char(s, n, *set);
+    const str_char_set cs(set, m);
+#if MYSTL_STR_AVX2
+    if (n >= 32 && str_has_avx2())
+        return str_find_last_of_avx2(s, n, cs, match);
+#endif
+    return str_find_last_of_scalar(s, n, cs, match);
+}
+
+/*****************************************************************************************/
+// char16_t / char32_t 版本
+// libc 没有对应的 mem* 函数，用 SSE2 一次比较 8 / 4 个字符
+
+// 比较 [s1, s1 + n) 与 [s2, s2 + n)，返回 -1、0 或 1
+template <class CharType>
+int str_compare(const CharType* s1, const CharType* s2, size_t n) noexcept {
+    for (; n != 0; --n, ++s1, ++s2) {
+        if (*s1 != *s2)
+            return *s1 < *s2 ? -1 : 1;
+    }
+    return 0;
+}
+
+#if MYSTL_STR_SSE2
+
+// 比较 16 字节，返回相等的字节的位掩码
+inline uint32_t str_eq_bytes16(const void* a, __m128i b, int width) noexcept {
+    const __m128i v = _mm_loadu_si128(static_cast<const __m128i*>(a));
+    const __m128i eq =
+        width == 2 ? _mm_cmpeq_epi16(v, b) : _mm_cmpeq_epi32(v, b);
+    return static_cast<uint32_t>(_mm_movemask_epi8(eq));
+}
+
+template <class CharType>
+const CharType* str_find_wide_sse2(const CharType* s,
+                                   size_t n,
+                                   CharType ch) noexcept {
+    constexpr size_t lanes = 16 / sizeof(CharType);
+    const __m128i c = sizeof(CharType) == 2
+                          ? _mm_set1_epi16(static_cast<short>(ch))
+                          : _mm_set1_epi32(static_cast<int>(ch));
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        const uint32_t mask =
+            str_eq_bytes16(s + i, c, static_cast<int>(sizeof(CharType)));
+        if (mask != 0)
+            return s + i + str_ctz(mask) / sizeof(CharType);
+    }
+    return str_find_char<CharType>(s + i, n - i, ch);
+}
+
+template <class CharType>
+int str_compare_wide_sse2(const CharType* s1,
+                          const CharType* s2,
+                          size_t n) noexcept {
+    constexpr size_t lanes = 16 / sizeof(CharType);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        const __m128i b =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + i));
+        const uint32_t mask =
+            str_eq_bytes16(s1 + i, b, static_cast<int>(sizeof(CharType)));
+        if (mask != 0xffff) {
+            // 第一个不相等的字符
+            const size_t j = i + str_ctz(~mask) / sizeof(CharType);
+            return s1[j] < s2[j] ? -1 : 1;
+        }
+    }
+    return str_compare<CharType>(s1 + i, s2 + i, n - i);
+}
+
+#endif  // MYSTL_STR_SSE2
+
+inline const char16_t* str_find_char(const char16_t* s,
+                                     size_t n,
+                                     char16_t ch) noexcept {
+#if MYSTL_STR_SSE2
+    return str_find_wide_sse2(s, n, ch);
+#else
+    return str_find_char<char16_t>(s, n, ch);
+#endif
+}
+
+inline const char32_t* str_find_char(const char32_t* s,
+                                     size_t n,
+                                     char32_t ch) noexcept {
+#if MYSTL_STR_SSE2
+    return str_find_wide_sse2(s, n, ch);
+#else
+    return str_find_char<char32_t>(s, n, ch);
+#endif
+}
+
+inline int str_compare(const char16_t* s1,
+                       const char16_t* s2,
+                       size_t n) noexcept {
+#if MYSTL_STR_SSE2
+    return str_compare_wide_sse2(s1, s2, n);
+#else
+    return str_compare<char16_t>(s1, s2, n);
+#endif
+}
+
+inline int str_compare(const char32_t* s1,
+                       const char32_t* s2,
+                       size_t n) noexcept {
+#if MYSTL_STR_SSE2
+    return str_compare_wide_sse2(s1, s2, n);
+#else
+    return str_compare<char32_t>(s1, s2, n);
+#endif
+}
+
+}  // namespace mystl
+#endif  // !MYTINYSTL_STRING_SEARCH_H_
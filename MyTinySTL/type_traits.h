@@ -51,6 +51,20 @@ struct is_pair:mystl::m_false_type{};
 template <class T1, class T2>
 struct is_pair<mystl::pair<T1,T2>>:mystl::m_true_type{};
 
+// is_trivially_relocatable
+// 判断一个类型的对象能否按位搬移：用 memcpy 把对象复制到新的地址，并且不再对原来的对象
+// 调用析构函数，结果与“移动构造到新地址，再析构原来的对象”相同。
+// 平凡可复制的类型都满足这个条件。对象内没有指向自身的指针的类型（例如只保存堆上空间
+// 指针的容器）通常也满足，但编译器无法推断，需要特化这个模板来声明，
+// mystl 的 basic_string、vector、deque、list 已经特化。用户类型可以同样特化来启用
+template <class T>
+struct is_trivially_relocatable
+    : mystl::m_bool_constant<std::is_trivially_copyable<T>::value> {};
+
+template <class T1, class T2>
+struct is_trivially_relocatable<mystl::pair<T1, T2>>
+    : mystl::m_bool_constant<is_trivially_relocatable<T1>::value &&
+                             is_trivially_relocatable<T2>::value> {};
 
 } // namespace mystl
 
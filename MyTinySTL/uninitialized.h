@@ -3,6 +3,8 @@
 
 // 这个头文件用于对未初始化空间构造元素
 
+#include <cstring>
+
 #include "algobase.h"
 #include "construct.h"
 #include "iterator.h"
@@ -221,6 +223,44 @@ ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T& value) {
             typename iterator_traits<ForwardIter>::value_type>{});
 }
 
+/*******************************************/
+// uninitialized_default_construct_n
+// 从 first 位置开始默认初始化 n 个元素，返回结束的位置。平凡类型不做任何初始化，
+// 空间中保留原来的内容
+/*******************************************/
+template <class ForwardIter, class Size>
+ForwardIter unchecked_uninit_default_construct_n(ForwardIter first,
+                                                 Size n,
+                                                 std::true_type) {
+    mystl::advance(first, n);
+    return first;
+}
+
+template <class ForwardIter, class Size>
+ForwardIter unchecked_uninit_default_construct_n(ForwardIter first,
+                                                 Size n,
+                                                 std::false_type) {
+    typedef typename iterator_traits<ForwardIter>::value_type value_type;
+    auto cur = first;
+    try {
+        for (; n > 0; --n, ++cur) {
+            ::new (static_cast<void*>(&*cur)) value_type;
+        }
+    } catch (...) {
+        mystl::destroy(first, cur);
+        throw;
+    }
+    return cur;
+}
+
+template <class ForwardIter, class Size>
+ForwardIter uninitialized_default_construct_n(ForwardIter first, Size n) {
+    return mystl::unchecked_uninit_default_construct_n(
+        first, n,
+        std::is_trivially_default_constructible<
+            typename iterator_traits<ForwardIter>::value_type>{});
+}
+
 /*******************************************/
 // uninitialized_move
 // 把[first, last)上的内容移动到以 result 为起始处的空间，返回移动结束的位置
@@ -309,6 +349,43 @@ ForwardIter uninitialized_move_n(InputIter first, Size n, ForwardIter result) {
         std::is_trivially_move_assignable<
             typename iterator_traits<InputIter>::value_type>{});
 }
+
+/******************************************/
+// uninitialized_relocate
+// 把[first, last)上的元素搬移到以 result 为起始处的未初始化空间，返回搬移结束的位置。
+// 搬移之后原来的元素已经结束生命期，调用者只需释放原来的空间，不能再析构它们
+/******************************************/
+template <class T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, m_true_type) noexcept {
+    const auto n = static_cast<size_t>(last - first);
+    if (n != 0) {
+        std::memcpy(static_cast<void*>(result), static_cast<const void*>(first),
+                    n * sizeof(T));
+    }
+    return result + n;
+}
+
+// 不能按位搬移时，逐个移动构造再析构原来的元素
+template <class T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, m_false_type) {
+    auto cur = result;
+    try {
+        for (auto p = first; p != last; ++p, ++cur) {
+            mystl::construct(cur, mystl::move(*p));
+        }
+    } catch (...) {
+        mystl::destroy(result, cur);
+        throw;
+    }
+    mystl::destroy(first, last);
+    return cur;
+}
+
+template <class T>
+T* uninitialized_relocate(T* first, T* last, T* result) {
+    return mystl::unchecked_uninit_relocate(
+        first, last, result, mystl::is_trivially_relocatable<T>{});
+}
 }  // namespace mystl
 
 #endif
\ No newline at end of file
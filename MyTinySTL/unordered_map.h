@@ -20,14 +20,16 @@ namespace mystl {
 // 模板类 unordered_map，键值不允许重复
 // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用
 // mystl::hash 参数四代表键值比较方式，缺省使用 mystl::equal_to
+// 参数五代表分配器，缺省使用 mystl::allocator
 template <class Key,
           class T,
           class Hash = mystl::hash<Key>,
-          class KeyEqual = mystl::equal_to<Key>>
+          class KeyEqual = mystl::equal_to<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
 class unordered_map {
 private:
     // 使用 hashtable 作为底层机制
-    typedef hashtable<mystl::pair<const Key, T>, Hash, KeyEqual> base_type;
+    typedef hashtable<mystl::pair<const Key, T>, Hash, KeyEqual, Alloc> base_type;
     base_type ht_;
 
 public:
@@ -56,21 +58,27 @@ public:
 
     unordered_map() : ht_(100, Hash(), KeyEqual()) {}
 
+    explicit unordered_map(const allocator_type& alloc)
+        : ht_(100, Hash(), KeyEqual(), alloc) {}
+
     explicit unordered_map(size_type bucket_count,
                            const Hash& hash = Hash(),
-                           const KeyEqual& equal = KeyEqual())
-        : ht_(bucket_count, hash, equal) {}
+                           const KeyEqual& equal = KeyEqual(),
+                           const allocator_type& alloc = allocator_type())
+        : ht_(bucket_count, hash, equal, alloc) {}
 
     template <class InputIterator>
     unordered_map(InputIterator first,
                   InputIterator last,
                   const size_type bucket_count = 100,
                   const Hash& hash = Hash(),
-                  const KeyEqual& equal = KeyEqual())
+                  const KeyEqual& equal = KeyEqual(),
+                  const allocator_type& alloc = allocator_type())
         : ht_(mystl::max(bucket_count,
                          static_cast<size_type>(mystl::distance(first, last))),
               hash,
-              equal) {
+              equal,
+              alloc) {
         for (; first != last; ++first)
             ht_.insert_unique_noresize(*first);
     }
@@ -78,10 +86,12 @@ public:
     unordered_map(std::initializer_list<value_type> ilist,
                   const size_type bucket_count = 100,
                   const Hash& hash = Hash(),
-                  const KeyEqual& equal = KeyEqual())
+                  const KeyEqual& equal = KeyEqual(),
+                  const allocator_type& alloc = allocator_type())
         : ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())),
               hash,
-              equal) {
+              equal,
+              alloc) {
         for (auto first = ilist.begin(), last = ilist.end(); first != last;
              ++first)
             ht_.insert_unique_noresize(*first);
@@ -201,6 +211,26 @@ public:
     iterator find(const key_type& key) { return ht_.find(key); }
     const_iterator find(const key_type& key) const { return ht_.find(key); }
 
+    // 批量查找，对每个键值依次写入 find 的结果或是否存在
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first,
+                          ForwardIter last,
+                          OutputIter result) {
+        return ht_.find_batch(first, last, result);
+    }
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first,
+                          ForwardIter last,
+                          OutputIter result) const {
+        return ht_.find_batch(first, last, result);
+    }
+    template <class ForwardIter, class OutputIter>
+    OutputIter contains_batch(ForwardIter first,
+                              ForwardIter last,
+                              OutputIter result) const {
+        return ht_.contains_batch(first, last, result);
+    }
+
     pair<iterator, iterator> equal_range(const key_type& key) {
         return ht_.equal_range_unique(key);
     }
@@ -251,32 +281,32 @@ public:
 
 public:
     friend bool operator==(const unordered_map& lhs, const unordered_map& rhs) {
-        return lhs.ht_.equal_range_unique(rhs.ht_);
+        return lhs.ht_.equal_to_unique(rhs.ht_);
     }
     friend bool operator!=(const unordered_map& lhs, const unordered_map& rhs) {
-        return !lhs.ht_.equal_range_unique(rhs.th_);
+        return !lhs.ht_.equal_to_unique(rhs.ht_);
     }
 };
 
 // 重载比较操作符
 
 // 重载比较操作符
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator==(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_map<Key, T, Hash, KeyEqual>& rhs) {
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool operator==(const unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs) {
     return lhs == rhs;
 }
 
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator!=(const unordered_map<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_map<Key, T, Hash, KeyEqual>& rhs) {
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool operator!=(const unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs) {
     return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Hash, class KeyEqual>
-void swap(unordered_map<Key, T, Hash, KeyEqual>& lhs,
-          unordered_map<Key, T, Hash, KeyEqual>& rhs) {
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void swap(unordered_map<Key, T, Hash, KeyEqual, Alloc>& lhs,
+          unordered_map<Key, T, Hash, KeyEqual, Alloc>& rhs) {
     lhs.swap(rhs);
 }
 
@@ -285,12 +315,14 @@ void swap(unordered_map<Key, T, Hash, KeyEqual>& lhs,
 // 模板类 unordered_multimap，键值允许重复
 // 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用
 // mystl::hash 参数四代表键值比较方式，缺省使用 mystl::equal_to
-template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>>
+// 参数五代表分配器，缺省使用 mystl::allocator
+template <class Key, class T, class Hash = mystl::hash<Key>, class KeyEqual = mystl::equal_to<Key>,
+          class Alloc = mystl::allocator<mystl::pair<const Key, T>>>
 class unordered_multimap
 {
 private:
   // 使用 hashtable 作为底层机制
-  typedef hashtable<pair<const Key, T>, Hash, KeyEqual> base_type;
+  typedef hashtable<pair<const Key, T>, Hash, KeyEqual, Alloc> base_type;
   base_type ht_;
 
 public:
@@ -324,10 +356,16 @@ public:
   {
   }
 
+  explicit unordered_multimap(const allocator_type& alloc)
+    :ht_(100, Hash(), KeyEqual(), alloc)
+  {
+  }
+
   explicit unordered_multimap(size_type bucket_count,
                               const Hash& hash = Hash(),
-                              const KeyEqual& equal = KeyEqual())
-    :ht_(bucket_count, hash, equal) 
+                              const KeyEqual& equal = KeyEqual(),
+                              const allocator_type& alloc = allocator_type())
+    :ht_(bucket_count, hash, equal, alloc) 
   {
   }
 
@@ -335,8 +373,9 @@ public:
   unordered_multimap(InputIterator first, InputIterator last,
                      const size_type bucket_count = 100,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))), hash, equal, alloc)
   {
     for (; first != last; ++first)
       ht_.insert_multi_noresize(*first);
@@ -345,8 +384,9 @@ public:
   unordered_multimap(std::initializer_list<value_type> ilist,
                      const size_type bucket_count = 100,
                      const Hash& hash = Hash(),
-                     const KeyEqual& equal = KeyEqual())
-    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal)
+                     const KeyEqual& equal = KeyEqual(),
+                     const allocator_type& alloc = allocator_type())
+    :ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())), hash, equal, alloc)
   {
     for (auto first = ilist.begin(), last = ilist.end(); first != last; ++first)
       ht_.insert_multi_noresize(*first);
@@ -459,6 +499,17 @@ public:
   const_iterator find(const key_type& key)  const 
   { return ht_.find(key); }
 
+  // 批量查找，对每个键值依次写入 find 的结果或是否存在
+  template <class ForwardIter, class OutputIter>
+  OutputIter     find_batch(ForwardIter first, ForwardIter last, OutputIter result)
+  { return ht_.find_batch(first, last, result); }
+  template <class ForwardIter, class OutputIter>
+  OutputIter     find_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+  { return ht_.find_batch(first, last, result); }
+  template <class ForwardIter, class OutputIter>
+  OutputIter     contains_batch(ForwardIter first, ForwardIter last, OutputIter result) const
+  { return ht_.contains_batch(first, last, result); }
+
   pair<iterator, iterator> equal_range(const key_type& key) 
   { return ht_.equal_range_multi(key); }
   pair<const_iterator, const_iterator> equal_range(const key_type& key) const 
@@ -506,33 +557,33 @@ public:
 public:
   friend bool operator==(const unordered_multimap& lhs, const unordered_multimap& rhs)
   {
-    return lhs.ht_.equal_range_multi(rhs.ht_);
+    return lhs.ht_.equal_to_multi(rhs.ht_);
   }
   friend bool operator!=(const unordered_multimap& lhs, const unordered_multimap& rhs)
   {
-    return !lhs.ht_.equal_range_multi(rhs.ht_);
+    return !lhs.ht_.equal_to_multi(rhs.ht_);
   }
 };
 
 // 重载比较操作符
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator==(const unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool operator==(const unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& rhs)
 {
   return lhs == rhs;
 }
 
-template <class Key, class T, class Hash, class KeyEqual>
-bool operator!=(const unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-                const unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+bool operator!=(const unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& rhs)
 {
   return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
-template <class Key, class T, class Hash, class KeyEqual>
-void swap(unordered_multimap<Key, T, Hash, KeyEqual>& lhs,
-          unordered_multimap<Key, T, Hash, KeyEqual>& rhs)
+template <class Key, class T, class Hash, class KeyEqual, class Alloc>
+void swap(unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& lhs,
+          unordered_multimap<Key, T, Hash, KeyEqual, Alloc>& rhs)
 {
   lhs.swap(rhs);
 }
@@ -21,13 +21,15 @@ namespace mystl {
 // 模板类 unordered_set，键值不允许重复
 // 参数一代表键值类型，参数二代表哈希函数，缺省使用 mystl::hash，
 // 参数三代表键值比较方式，缺省使用 mystl::equal_to
+// 参数四代表分配器，缺省使用 mystl::allocator
 template <class Key,
           class Hash = mystl::hash<Key>,
-          class KeyEqual = mystl::equal_to<Key>>
+          class KeyEqual = mystl::equal_to<Key>,
+          class Alloc = mystl::allocator<Key>>
 class unordered_set {
 private:
     // 使用 hashtable 作为底层机制
-    typedef hashtable<Key, Hash, KeyEqual> base_type;
+    typedef hashtable<Key, Hash, KeyEqual, Alloc> base_type;
     base_type ht_;
 
 public:
@@ -57,21 +59,27 @@ public:
 
     unordered_set() : ht_(100, Hash(), KeyEqual()) {}
 
+    explicit unordered_set(const allocator_type& alloc)
+        : ht_(100, Hash(), KeyEqual(), alloc) {}
+
     explicit unordered_set(size_type bucket_count,
                            const Hash& hash = Hash(),
-                           const KeyEqual& equal = KeyEqual())
-        : ht_(bucket_count, hash, equal) {}
+                           const KeyEqual& equal = KeyEqual(),
+                           const allocator_type& alloc = allocator_type())
+        : ht_(bucket_count, hash, equal, alloc) {}
 
     template <class InputIterator>
     unordered_set(InputIterator first,
                   InputIterator last,
                   const size_type bucket_count = 100,
                   const Hash& hash = Hash(),
-                  const KeyEqual& equal = KeyEqual())
+                  const KeyEqual& equal = KeyEqual(),
+                  const allocator_type& alloc = allocator_type())
         : ht_(mystl::max(bucket_count,
                          static_cast<size_type>(mystl::distance(first, last))),
               hash,
-              equal) {
+              equal,
+              alloc) {
         for (; first != last; ++first)
             ht_.insert_unique_noresize(*first);
     }
@@ -79,10 +87,12 @@ public:
     unordered_set(std::initializer_list<value_type> ilist,
                   const size_type bucket_count = 100,
                   const Hash& hash = Hash(),
-                  const KeyEqual& equal = KeyEqual())
+                  const KeyEqual& equal = KeyEqual(),
+                  const allocator_type& alloc = allocator_type())
         : ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())),
               hash,
-              equal) {
+              equal,
+              alloc) {
         for (auto first = ilist.begin(), last = ilist.end(); first != last;
              ++first)
             ht_.insert_unique_noresize(*first);
@@ -180,6 +190,20 @@ public:
     iterator find(const key_type& key) { return ht_.find(key); }
     const_iterator find(const key_type& key) const { return ht_.find(key); }
 
+    // 批量查找，对每个键值依次写入 find 的结果或是否存在
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first,
+                          ForwardIter last,
+                          OutputIter result) const {
+        return ht_.find_batch(first, last, result);
+    }
+    template <class ForwardIter, class OutputIter>
+    OutputIter contains_batch(ForwardIter first,
+                              ForwardIter last,
+                              OutputIter result) const {
+        return ht_.contains_batch(first, last, result);
+    }
+
     pair<iterator, iterator> equal_range(const key_type& key) {
         return ht_.equal_range_unique(key);
     }
@@ -229,30 +253,30 @@ public:
 
 public:
     friend bool operator==(const unordered_set& lhs, const unordered_set& rhs) {
-        return lhs.ht_.equal_range_unique(rhs.ht_);
+        return lhs.ht_.equal_to_unique(rhs.ht_);
     }
     friend bool operator!=(const unordered_set& lhs, const unordered_set& rhs) {
-        return !lhs.ht_.equal_range_unique(rhs.ht_);
+        return !lhs.ht_.equal_to_unique(rhs.ht_);
     }
 };
 
 // 重载比较操作符
 template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator==(const unordered_set<Key, Hash, KeyEqual>& lhs,
-                const unordered_set<Key, Hash, KeyEqual>& rhs) {
+bool operator==(const unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_set<Key, Hash, KeyEqual, Alloc>& rhs) {
     return lhs == rhs;
 }
 
 template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator!=(const unordered_set<Key, Hash, KeyEqual>& lhs,
-                const unordered_set<Key, Hash, KeyEqual>& rhs) {
+bool operator!=(const unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_set<Key, Hash, KeyEqual, Alloc>& rhs) {
     return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
 template <class Key, class Hash, class KeyEqual, class Alloc>
-void swap(unordered_set<Key, Hash, KeyEqual>& lhs,
-          unordered_set<Key, Hash, KeyEqual>& rhs) {
+void swap(unordered_set<Key, Hash, KeyEqual, Alloc>& lhs,
+          unordered_set<Key, Hash, KeyEqual, Alloc>& rhs) {
     lhs.swap(rhs);
 }
 
@@ -261,13 +285,15 @@ void swap(unordered_set<Key, Hash, KeyEqual>& lhs,
 // 模板类 unordered_multiset，键值允许重复
 // 参数一代表键值类型，参数二代表哈希函数，缺省使用 mystl::hash，
 // 参数三代表键值比较方式，缺省使用 mystl::equal_to
+// 参数四代表分配器，缺省使用 mystl::allocator
 template <class Key,
           class Hash = mystl::hash<Key>,
-          class KeyEqual = mystl::equal_to<Key>>
+          class KeyEqual = mystl::equal_to<Key>,
+          class Alloc = mystl::allocator<Key>>
 class unordered_multiset {
 private:
     // 使用 hashtable 作为底层机制
-    typedef hashtable<Key, Hash, KeyEqual> base_type;
+    typedef hashtable<Key, Hash, KeyEqual, Alloc> base_type;
     base_type ht_;
 
 public:
@@ -297,21 +323,27 @@ public:
 
     unordered_multiset() : ht_(100, Hash(), KeyEqual()) {}
 
+    explicit unordered_multiset(const allocator_type& alloc)
+        : ht_(100, Hash(), KeyEqual(), alloc) {}
+
     explicit unordered_multiset(size_type bucket_count,
                                 const Hash& hash = Hash(),
-                                const KeyEqual& equal = KeyEqual())
-        : ht_(bucket_count, hash, equal) {}
+                                const KeyEqual& equal = KeyEqual(),
+                                const allocator_type& alloc = allocator_type())
+        : ht_(bucket_count, hash, equal, alloc) {}
 
     template <class InputIterator>
     unordered_multiset(InputIterator first,
                        InputIterator last,
                        const size_type bucket_count = 100,
                        const Hash& hash = Hash(),
-                       const KeyEqual& equal = KeyEqual())
+                       const KeyEqual& equal = KeyEqual(),
+                       const allocator_type& alloc = allocator_type())
         : ht_(mystl::max(bucket_count,
                          static_cast<size_type>(mystl::distance(first, last))),
               hash,
-              equal) {
+              equal,
+              alloc) {
         for (; first != last; ++first)
             ht_.insert_multi_noresize(*first);
     }
@@ -319,10 +351,12 @@ public:
     unordered_multiset(std::initializer_list<value_type> ilist,
                        const size_type bucket_count = 100,
                        const Hash& hash = Hash(),
-                       const KeyEqual& equal = KeyEqual())
+                       const KeyEqual& equal = KeyEqual(),
+                       const allocator_type& alloc = allocator_type())
         : ht_(mystl::max(bucket_count, static_cast<size_type>(ilist.size())),
               hash,
-              equal) {
+              equal,
+              alloc) {
         for (auto first = ilist.begin(), last = ilist.end(); first != last;
              ++first)
             ht_.insert_multi_noresize(*first);
@@ -419,6 +453,20 @@ public:
     iterator find(const key_type& key) { return ht_.find(key); }
     const_iterator find(const key_type& key) const { return ht_.find(key); }
 
+    // 批量查找，对每个键值依次写入 find 的结果或是否存在
+    template <class ForwardIter, class OutputIter>
+    OutputIter find_batch(ForwardIter first,
+                          ForwardIter last,
+                          OutputIter result) const {
+        return ht_.find_batch(first, last, result);
+    }
+    template <class ForwardIter, class OutputIter>
+    OutputIter contains_batch(ForwardIter first,
+                              ForwardIter last,
+                              OutputIter result) const {
+        return ht_.contains_batch(first, last, result);
+    }
+
     pair<iterator, iterator> equal_range(const key_type& key) {
         return ht_.equal_range_multi(key);
     }
@@ -469,31 +517,31 @@ public:
 public:
     friend bool operator==(const unordered_multiset& lhs,
                            const unordered_multiset& rhs) {
-        return lhs.ht_.equal_range_multi(rhs.ht_);
+        return lhs.ht_.equal_to_multi(rhs.ht_);
     }
     friend bool operator!=(const unordered_multiset& lhs,
                            const unordered_multiset& rhs) {
-        return !lhs.ht_.equal_range_multi(rhs.ht_);
+        return !lhs.ht_.equal_to_multi(rhs.ht_);
     }
 };
 
 // 重载比较操作符
 template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator==(const unordered_multiset<Key, Hash, KeyEqual>& lhs,
-                const unordered_multiset<Key, Hash, KeyEqual>& rhs) {
+bool operator==(const unordered_multiset<Key, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_multiset<Key, Hash, KeyEqual, Alloc>& rhs) {
     return lhs == rhs;
 }
 
 template <class Key, class Hash, class KeyEqual, class Alloc>
-bool operator!=(const unordered_multiset<Key, Hash, KeyEqual>& lhs,
-                const unordered_multiset<Key, Hash, KeyEqual>& rhs) {
+bool operator!=(const unordered_multiset<Key, Hash, KeyEqual, Alloc>& lhs,
+                const unordered_multiset<Key, Hash, KeyEqual, Alloc>& rhs) {
     return lhs != rhs;
 }
 
 // 重载 mystl 的 swap
 template <class Key, class Hash, class KeyEqual, class Alloc>
-void swap(unordered_multiset<Key, Hash, KeyEqual>& lhs,
-          unordered_multiset<Key, Hash, KeyEqual>& rhs) {
+void swap(unordered_multiset<Key, Hash, KeyEqual, Alloc>& lhs,
+          unordered_multiset<Key, Hash, KeyEqual, Alloc>& rhs) {
     lhs.swap(rhs);
 }
 
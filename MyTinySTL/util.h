@@ -68,6 +68,13 @@ void swap(Tp& lhs, Tp& rhs) {
     rhs = mystl::move(tmp);
 }
 
+// --- forward declaration begin
+// vector<bool> 的代理引用，定义见 bit_vector.h。解引用得到的是右值，上面的 swap
+// 无法绑定，在这里声明按值交换的重载，swap_range、iter_swap 等模板才能找到它
+class bit_reference;
+inline void swap(bit_reference x, bit_reference y) noexcept;
+// --- forward declaration end
+
 /* 这是一个模板函数 `swap_range`，它接受两个迭代器范围 `[first1, last1)` 和
 `[first2, ...)`, 并交换它们之间的元素。 它返回迭代器
 `first2`，指向交换后的第一个元素。这个函数实现了一种通用的交换算法，可以用于交换两个数组、两个容器或两个
@@ -248,6 +255,7 @@ struct pair {
             first = mystl::move(rhs.first);
             second = mystl::move(rhs.second);
         }
+        return *this;
     }
 
     // copy assign for other pair
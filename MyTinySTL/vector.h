@@ -17,8 +17,20 @@
 //   * reserve
 //   * resize
 //   * insert
+//
+// 元素可以按位搬移并使用默认分配器时，不小于 MYSTL_VECTOR_MMAP_THRESHOLD 字节的
+// 空间直接向操作系统映射页面（仅限 Linux），在末尾插入导致扩容时用 mremap 调整映射，
+// 不复制元素，也不会同时持有新旧两块空间
+//
+// vector<bool> 按位压缩储存，特化版本见 bit_vector.h
 
 #include <initializer_list>
+#include <new>
+#include <type_traits>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 #include "algo.h"
 #include "exceptdef.h"
 #include "iterator.h"
@@ -27,6 +39,11 @@
 
 namespace mystl {
 
+// 使用映射页面作为储存空间的最小字节数
+#ifndef MYSTL_VECTOR_MMAP_THRESHOLD
+#define MYSTL_VECTOR_MMAP_THRESHOLD (1 << 20)
+#endif
+
 #ifdef max
 #pragma message("#undefing marco max")
 #undef max
@@ -38,16 +55,13 @@ namespace mystl {
 #endif  // min
 
 // 模板类
-// 模板参数 T 代表类型
-template <class T>
+// 模板参数 T 代表类型，Alloc 代表分配器，缺省使用 mystl::allocator
+template <class T, class Alloc = mystl::allocator<T>>
 class vector {
-    static_assert(!std::is_same<bool, T>::value,
-                  "vector<bool> is abandoned in mystl");
-
 public:
     // vector 的嵌套型别定义
-    typedef mystl::allocator<T> allocator_type;
-    typedef mystl::allocator<T> data_allocator;
+    typedef Alloc allocator_type;
+    typedef mystl::allocator_traits<Alloc> alloc_traits;
 
     typedef typename allocator_type::value_type value_type;
     typedef typename allocator_type::pointer pointer;
@@ -62,30 +76,48 @@ public:
     typedef mystl::reverse_iterator<iterator> reverse_iterator;
     typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
 
-    allocator_type get_allocator() { return data_allocator(); }
+    allocator_type get_allocator() const { return alloc_; }
 
 private:
+    allocator_type alloc_;  // 分配器
     iterator begin_;  // 表示目前使用空间的头部
     iterator end_;    // 表示目前使用空间的尾部
     iterator cap_;    // 表示目前储存空间的尾部
 
 public:
     // 构造、复制、移动、析构函数
-    vector() noexcept { try_init(); }
+    vector() noexcept : alloc_() { try_init(); }
 
-    explicit vector(size_type n) { fill_init(n, value_type()); }
+    explicit vector(const allocator_type& alloc) noexcept : alloc_(alloc) {
+        try_init();
+    }
 
-    vector(size_type n, const value_type& value) { fill_init(n, value); }
+    explicit vector(size_type n, const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        fill_init(n, value_type());
+    }
+
+    vector(size_type n,
+           const value_type& value,
+           const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
+        fill_init(n, value);
+    }
 
     template <class Iter,
               typename std::enable_if<mystl::is_input_iterator<Iter>::value,
                                       int>::type = 0>
-    vector(Iter first, Iter last) {
+    vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
         MYSTL_DEBUG(!(last < first));
         range_init(first, last);
     }
 
-    vector(const vector& rhs) { range_init(rhs.begin_, rhs.end_); }
+    vector(const vector& rhs)
+        : alloc_(alloc_traits::select_on_container_copy_construction(
+              rhs.alloc_)) {
+        range_init(rhs.begin_, rhs.end_);
+    }
 
     /* 这是一个移动构造函数，用于将一个右值引用的 `vector`
     对象的资源（即存储空间）移动到当前的对象中。
@@ -99,21 +131,28 @@ public:
     保证了在移动构造函数中不会发生异常抛出，这使得编译器可以在某些情况下对代码进行优化，提高程序的性能
   */
     vector(vector&& rhs) noexcept
-        : begin_(rhs.begin_), end_(rhs.end_), cap_(rhs.cap_) {
+        : alloc_(mystl::move(rhs.alloc_)),
+          begin_(rhs.begin_),
+          end_(rhs.end_),
+          cap_(rhs.cap_) {
         rhs.begin_ = nullptr;
         rhs.end_ = nullptr;
         rhs.cap_ = nullptr;
     }
 
-    vector(std::initializer_list<value_type> ilist) {
+    vector(std::initializer_list<value_type> ilist,
+           const allocator_type& alloc = allocator_type())
+        : alloc_(alloc) {
         range_init(ilist.begin(), ilist.end());
     }
 
     vector& operator=(const vector& rhs);
-    vector& operator=(vector&& rhs) noexcept;
+    vector& operator=(vector&& rhs) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value ||
+        alloc_traits::is_always_equal::value);
 
     vector& operator=(std::initializer_list<value_type> ilist) {
-        vector tmp(ilist.begin(), ilist.end());
+        vector tmp(ilist.begin(), ilist.end(), alloc_);
         swap(tmp);
         return *this;
     }
@@ -266,6 +305,20 @@ public:
     void resize(size_type new_size) { return resize(new_size, value_type()); }
     void resize(size_type new_size, const value_type& value);
 
+    // 新增的元素只做默认初始化，平凡类型不会被清零，适合随后马上被覆盖写入的场合
+    void resize_default_init(size_type new_size);
+
+    // 末尾追加，返回指向第一个新元素的位置
+    template <class Iter,
+              typename std::enable_if<mystl::is_input_iterator<Iter>::value,
+                                      int>::type = 0>
+    iterator append_range(Iter first, Iter last) {
+        return append_range_aux(first, last, iterator_category(first));
+    }
+
+    // 末尾追加 n 个默认初始化的元素，返回写入位置，调用者直接在 [p, p + n) 中填充
+    iterator append_uninitialized(size_type n) { return default_append(n); }
+
     void reverse() { mystl::reverse(begin(), end()); }
 
     // swap
@@ -283,6 +336,22 @@ private:
 
     void destroy_and_recover(iterator first, iterator last, size_type n);
 
+    // storage
+    static bool is_mapped(size_type n) noexcept;
+    iterator allocate_storage(size_type n);
+    void deallocate_storage(iterator p, size_type n) noexcept;
+    void remap_storage(size_type new_cap);
+    template <class... Args>
+    void remap_emplace_back(size_type new_cap, Args&&... args);
+
+    // allocator propagation
+    void copy_alloc(const vector& rhs, m_true_type);
+    void copy_alloc(const vector&, m_false_type) {}
+    void move_assign(vector& rhs, m_true_type) noexcept;
+    void move_assign(vector& rhs, m_false_type);
+    void swap_alloc(vector& rhs, m_true_type) { mystl::swap(alloc_, rhs.alloc_); }
+    void swap_alloc(vector&, m_false_type) {}
+
     // calculate the growth size
     size_type get_new_cap(size_type add_size);
 
@@ -295,10 +364,21 @@ private:
     template <class FIter>
     void copy_assign(FIter first, FIter last, forward_iterator_tag);
 
+    // append
+    iterator default_append(size_type n);
+    template <class IIter>
+    iterator append_range_aux(IIter first, IIter last, input_iterator_tag);
+    template <class FIter>
+    iterator append_range_aux(FIter first, FIter last, forward_iterator_tag);
+
     // reallocate
     template <class... Args>
     void reallocate_emplace(iterator pos, Args&&... args);
     void reallocate_insert(iterator pos, const value_type& value);
+    void relocate_around(iterator pos,
+                         size_type n,
+                         iterator new_begin,
+                         size_type new_size) noexcept;
 
     // insert
     iterator fill_insert(iterator pos, size_type n, const value_type& value);
@@ -330,21 +410,23 @@ private:
 类模板，不能用于其他类型的容器。此外，该函数的实现中使用了 `mystl`
 命名空间中的函数和类型，这些函数和类型不是标准库中的内容，可能是该类模板的作者自己实现的。
 */
-template <class T>
-vector<T>& vector<T>::operator=(const vector& rhs) {
+template <class T, class Alloc>
+vector<T, Alloc>& vector<T, Alloc>::operator=(const vector& rhs) {
     if (this != &rhs) {
+        copy_alloc(rhs, typename alloc_traits::
+                            propagate_on_container_copy_assignment());
         const auto len = rhs.size();
         // 大于当前的容量
         if (len > capacity()) {
             // 创建新的vector对象tmp
-            vector tmp(rhs.begin(), rhs.end());
+            vector tmp(rhs.begin(), rhs.end(), alloc_);
             // swap函数交换当前对象和tmp的内容
             // 使当前对象的长度和容量都等于rhs的长度
             swap(tmp);
         } else if (size() >= len) {
             // rhs小于等于当前对象的长度，复制到当前对象中，并销毁多余的元素
             auto i = mystl::copy(rhs.begin(), rhs.end(), begin());
-            data_allocator::destroy(i, end_);
+            mystl::destroy(i, end_);
             end_ = begin_ + len;
         } else {
             //  `rhs` 的长度大于当前对象的长度但小于当前对象的容量，
@@ -352,7 +434,7 @@ vector<T>& vector<T>::operator=(const vector& rhs) {
             mystl::copy(rhs.begin(), rhs.begin() + size(), begin_);
             // 从当前对象的end_开始，一直到然后到rhs.end()
             mystl::uninitialized_copy(rhs.begin() + size(), rhs.end(), end_);
-            cap_ = end_ = begin_ + len;
+            end_ = begin_ + len;
         }
     }
     return *this;
@@ -360,29 +442,80 @@ vector<T>& vector<T>::operator=(const vector& rhs) {
 
 // 移动赋值操作符
 // 移动赋值原队形的值会被销毁或置为默认值
-template <class T>
-vector<T>& vector<T>::operator=(vector&& rhs) noexcept {
+template <class T, class Alloc>
+vector<T, Alloc>& vector<T, Alloc>::operator=(vector&& rhs) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value ||
+    alloc_traits::is_always_equal::value) {
+    if (this != &rhs) {
+        move_assign(rhs, typename alloc_traits::
+                             propagate_on_container_move_assignment());
+    }
+    return *this;
+}
+
+// 复制赋值时传播分配器：旧的空间由旧的分配器释放
+template <class T, class Alloc>
+void vector<T, Alloc>::copy_alloc(const vector& rhs, m_true_type) {
+    if (alloc_ == rhs.alloc_)
+        return;
+    destroy_and_recover(begin_, end_, cap_ - begin_);
+    begin_ = end_ = cap_ = nullptr;
+    alloc_ = rhs.alloc_;
+}
+
+// 分配器随元素传播，直接接管 rhs 的空间
+template <class T, class Alloc>
+void vector<T, Alloc>::move_assign(vector& rhs, m_true_type) noexcept {
     destroy_and_recover(begin_, end_, cap_ - begin_);
+    alloc_ = mystl::move(rhs.alloc_);
     begin_ = rhs.begin_;
     end_ = rhs.end_;
     cap_ = rhs.cap_;
     rhs.begin_ = nullptr;
     rhs.end_ = nullptr;
     rhs.cap_ = nullptr;
-    return *this;
+}
+
+// 分配器不传播时，只有两个分配器相等才能直接接管空间，否则逐个移动元素
+template <class T, class Alloc>
+void vector<T, Alloc>::move_assign(vector& rhs, m_false_type) {
+    if (alloc_traits::equal(alloc_, rhs.alloc_)) {
+        destroy_and_recover(begin_, end_, cap_ - begin_);
+        begin_ = rhs.begin_;
+        end_ = rhs.end_;
+        cap_ = rhs.cap_;
+        rhs.begin_ = nullptr;
+        rhs.end_ = nullptr;
+        rhs.cap_ = nullptr;
+    } else {
+        clear();
+        reserve(rhs.size());
+        for (auto it = rhs.begin_; it != rhs.end_; ++it, ++end_)
+            mystl::construct(end_, mystl::move(*it));
+        rhs.clear();
+    }
 }
 
 // 预留空间大小，当原容量小于要求大小时，才会重新分配
-template <class T>
-void vector<T>::reserve(size_type n) {
+template <class T, class Alloc>
+void vector<T, Alloc>::reserve(size_type n) {
     if (capacity() < n) {
         THROW_LENGTH_ERROR_IF(
             n > max_size(),
-            "n can not larger than max_size() in vector<T>::reserve<n");
+            "n can not larger than max_size() in vector<T, Alloc>::reserve<n");
+        if (is_mapped(capacity())) {
+            remap_storage(n);
+            return;
+        }
         const auto old_size = size();
-        auto tmp = data_allocator::allocate(n);
-        mystl::uninitialized_move(begin_, end_, tmp);
-        data_allocator::deallocate(begin_, cap_ - begin_);
+        auto tmp = allocate_storage(n);
+        try {
+            mystl::uninitialized_relocate(begin_, end_, tmp);
+        } catch (...) {
+            deallocate_storage(tmp, n);
+            throw;
+        }
+        deallocate_storage(begin_, cap_ - begin_);
         begin_ = tmp;
         end_ = tmp + old_size;
         cap_ = begin_ + n;
@@ -390,17 +523,17 @@ void vector<T>::reserve(size_type n) {
 }
 
 // 放弃多余的容量
-template <class T>
-void vector<T>::shrink_to_fit() {
+template <class T, class Alloc>
+void vector<T, Alloc>::shrink_to_fit() {
     if (end_ < cap_) {
         reinsert(size());
     }
 }
 
 // 在pos位置就地构造元素，避免额外的赋值或移动开销
-template <class T>
+template <class T, class Alloc>
 template <class... Args>
-typename vector<T>::iterator vector<T>::emplace(const_iterator pos,
+typename vector<T, Alloc>::iterator vector<T, Alloc>::emplace(const_iterator pos,
                                                 Args&&... args) {
     // 检查传入的迭代器是否在 `vector` 的有效范围内
     MYSTL_DEBUG(pos >= begin() && pos <= end());
@@ -411,15 +544,15 @@ typename vector<T>::iterator vector<T>::emplace(const_iterator pos,
     // 如果 `end_` 没有达到 `cap_` 并且 `xpos` 恰好指向 `end_`
     if (end_ != cap_ && xpos == end_) {
         // 在 `end_` 处构造一个新元素，并将 `end_` 后移一位
-        data_allocator::construct(mystl::address_of(*end_),
-                                  mystl::forward<Args>(args)...);
+        mystl::construct(mystl::address_of(*end_),
+                         mystl::forward<Args>(args)...);
         ++end_;
     }
     // 如果 `end_` 没有达到 `cap_`
     else if (end_ != cap_) {
         auto new_end = end_;
         // 将 `end_-1` 处的元素复制到 `end_` 处
-        data_allocator::construct(mystl::address_of(*end_), *(end_ - 1));
+        mystl::construct(mystl::address_of(*end_), *(end_ - 1));
         ++new_end;
         // 将 `[pos, end_-1]` 区间内的元素向后移动一位，以为新元素腾出位置
         mystl::copy_backward(xpos, end_ - 1, end_);
@@ -437,13 +570,13 @@ typename vector<T>::iterator vector<T>::emplace(const_iterator pos,
 }
 
 // 在尾部就地构造元素，避免额外的复制或移动开销
-template <class T>
+template <class T, class Alloc>
 template <class... Args>
-void vector<T>::emplace_back(Args&&... args) {
+void vector<T, Alloc>::emplace_back(Args&&... args) {
     if (end_ < cap_) {
         // 直接在end_处构造元素
-        data_allocator::construct(mystl::address_of(*end_),
-                                  mystl::forward<Args>(args)...);
+        mystl::construct(mystl::address_of(*end_),
+                         mystl::forward<Args>(args)...);
         // 然后end_++
         ++end_;
     } else {
@@ -454,10 +587,10 @@ void vector<T>::emplace_back(Args&&... args) {
 }
 
 // 在尾部插入元素
-template <class T>
-void vector<T>::push_back(const value_type& value) {
+template <class T, class Alloc>
+void vector<T, Alloc>::push_back(const value_type& value) {
     if (end_ != cap_) {
-        data_allocator::construct(mystl::address_of(*end_), value);
+        mystl::construct(mystl::address_of(*end_), value);
         ++end_;
     } else {
         // 重新分配空间，并作插入
@@ -466,26 +599,26 @@ void vector<T>::push_back(const value_type& value) {
 }
 
 // 弹出尾部元素
-template <class T>
-void vector<T>::pop_back() {
+template <class T, class Alloc>
+void vector<T, Alloc>::pop_back() {
     MYSTL_DEBUG(!empty());
-    data_allocator::destroy(end_ - 1);
+    mystl::destroy(end_ - 1);
     --end_;
 }
 
 // 在pos处插入元素
-template <class T>
-typename vector<T>::iterator vector<T>::insert(const_iterator pos,
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator vector<T, Alloc>::insert(const_iterator pos,
                                                const value_type& value) {
     MYSTL_DEBUG(pos >= begin() && pos <= end());
     iterator xpos = const_cast<iterator>(pos);
     const size_type n = pos - begin_;
     if (end_ != cap_ && xpos == end_) {
-        data_allocator::construct(mystl::address_of(*end_), value);
+        mystl::construct(mystl::address_of(*end_), value);
         ++end_;
     } else if (end_ != cap_) {
         auto new_end = end_;
-        data_allocator::construct(mystl::address_of(*end_), *(end_ - 1));
+        mystl::construct(mystl::address_of(*end_), *(end_ - 1));
         ++new_end;
         auto value_copy = value;  // 避免元素因以下复制操作而被改变
         mystl::copy_backward(xpos, end_ - 1, end_);
@@ -500,17 +633,17 @@ typename vector<T>::iterator vector<T>::insert(const_iterator pos,
 
 // 删除pos位置上的元素
 // `pos` 是一个常量迭代器，指向要删除的元素。
-template <class T>
-typename vector<T>::iterator vector<T>::erase(const_iterator pos) {
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator vector<T, Alloc>::erase(const_iterator pos) {
     MYSTL_DEBUG(pos >= begin() && pos <= end());
     // 将参数 `pos` 转换为一个普通迭代器 `xpos`，这是为了方便后面的操作
     iterator xpos = begin_ + (pos - begin());
     // 函数调用 `mystl::move` 算法将 `xpos`
     // 后面的所有元素向前移动一个位置，覆盖掉要删除的元素。这样，要删除的元素就被“删除”了，实际上是被覆盖掉了
     mystl::move(xpos + 1, end_, xpos);
-    // `data_allocator::destroy`
+    // `mystl::destroy`
     // 函数销毁最后一个元素（即原来的最后一个元素已经被覆盖掉了，现在成为了倒数第二个元素）
-    data_allocator::destroy(end_ - 1);
+    mystl::destroy(end_ - 1);
     // `end_` 指针向前移动一个位置，表示容器中的元素数量减少了一个
     --end_;
     // 函数返回一个迭代器
@@ -519,9 +652,9 @@ typename vector<T>::iterator vector<T>::erase(const_iterator pos) {
 }
 
 // 删除[first, last)上的元素
-template <class T>
+template <class T, class Alloc>
 // `first` 和 `last` 分别指定了要删除的范围
-typename vector<T>::iterator vector<T>::erase(const_iterator first,
+typename vector<T, Alloc>::iterator vector<T, Alloc>::erase(const_iterator first,
                                               const_iterator last) {
     // 参数检查
     MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
@@ -529,10 +662,10 @@ typename vector<T>::iterator vector<T>::erase(const_iterator first,
     const auto n = first - begin();
     // 将 `first` 转换为一个普通迭代器 `r`
     iterator r = begin_ + (first - begin());
-    // 使用 `data_allocator::destroy` 函数销毁范围 `[r + (last - first), end_)`
+    // 使用 `mystl::destroy` 函数销毁范围 `[r + (last - first), end_)`
     // 内的元素 （注意，这里使用了 `mystl::move`
     // 函数，将要销毁的元素移动到了容器的末尾）
-    data_allocator::destroy(mystl::move(r + (last - first), end_, r), end_);
+    mystl::destroy(mystl::move(r + (last - first), end_, r), end_);
     // 更新 `end_`，使其指向删除操作后的新末尾位置
     end_ = end_ - (last - first);
     // 并返回指向删除操作后的第一个元素的迭代器 `begin_ + n`
@@ -540,8 +673,8 @@ typename vector<T>::iterator vector<T>::erase(const_iterator first,
 }
 
 // 重置容器大小
-template <class T>
-void vector<T>::resize(size_type new_size, const value_type& value) {
+template <class T, class Alloc>
+void vector<T, Alloc>::resize(size_type new_size, const value_type& value) {
     if (new_size < size()) {
         // 少了就删
         erase(begin() + new_size, end());
@@ -551,10 +684,21 @@ void vector<T>::resize(size_type new_size, const value_type& value) {
     }
 }
 
+// 与 resize 相同，但新增的元素默认初始化
+template <class T, class Alloc>
+void vector<T, Alloc>::resize_default_init(size_type new_size) {
+    if (new_size < size()) {
+        erase(begin() + new_size, end());
+    } else {
+        default_append(new_size - size());
+    }
+}
+
 // 与另一个vector交换
-template <class T>
-void vector<T>::swap(vector<T>& rhs) noexcept {
+template <class T, class Alloc>
+void vector<T, Alloc>::swap(vector<T, Alloc>& rhs) noexcept {
     if (this != &rhs) {
+        swap_alloc(rhs, typename alloc_traits::propagate_on_container_swap());
         mystl::swap(begin_, rhs.begin_);
         mystl::swap(end_, rhs.end_);
         mystl::swap(cap_, rhs.cap_);
@@ -564,10 +708,10 @@ void vector<T>::swap(vector<T>& rhs) noexcept {
 /**************************************/
 // helper function
 // try_init函数, 若分配失败则忽略, 不抛出异常
-template <class T>
-void vector<T>::try_init() noexcept {
+template <class T, class Alloc>
+void vector<T, Alloc>::try_init() noexcept {
     try {
-        begin_ = data_allocator::allocate(16);
+        begin_ = allocate_storage(16);
         end_ = begin_;
         cap_ = begin_ + 16;  // 容量最少为16
     } catch (...) {
@@ -579,13 +723,13 @@ void vector<T>::try_init() noexcept {
 
 // init_space函数
 // 初始化空间函数，用于在创建 vector 对象时分配存储空间
-template <class T>
+template <class T, class Alloc>
 //  `size` 和 `cap`，分别表示要分配的初始元素个数和容量大小
-void vector<T>::init_space(size_type size, size_type cap) {
+void vector<T, Alloc>::init_space(size_type size, size_type cap) {
     try {
-        // 首先使用 `data_allocator::allocate(cap)` 分配了 `cap`
+        // 首先使用 `allocate_storage(cap)` 分配了 `cap`
         // 个元素的存储空间，并将其指针保存在 `begin_` 中
-        begin_ = data_allocator::allocate(cap);
+        begin_ = allocate_storage(cap);
         // 将 `end_` 指针指向 `begin_ + size`，表示 `vector` 中已经存储了 `size`
         // 个元素
         end_ = begin_ + size;
@@ -602,10 +746,10 @@ void vector<T>::init_space(size_type size, size_type cap) {
 }
 
 // fill_init函数
-template <class T>
+template <class T, class Alloc>
 // 在 `vector` 对象中填充指定数量的元素，并对它们进行初始化
 // `n` 和 `value`，分别表示要填充的元素数量和要填充的值。
-void vector<T>::fill_init(size_type n, const value_type& value) {
+void vector<T, Alloc>::fill_init(size_type n, const value_type& value) {
     // 计算出初始大小 `init_size`，其值为 `16` 和 `n` 中的较大者，
     const size_type init_size = mystl::max(static_cast<size_type>(16), n);
     // 然后调用 `init_space` 函数来初始化 `vector`
@@ -630,10 +774,10 @@ void vector<T>::fill_init(size_type n, const value_type& value) {
 需要注意的是，该函数是 `vector` 类模板的成员函数，因此在调用时需要使用 `vector`
 对象的成员函数语法来调用 */
 // range_init函数
-template <class T>
+template <class T, class Alloc>
 template <class Iter>
 // 两个迭代器参数 `first` 和 `last`，用于指定要初始化的元素范围
-void vector<T>::range_init(Iter first, Iter last) {
+void vector<T, Alloc>::range_init(Iter first, Iter last) {
     // 计算要初始化的元素个数 `len`，通过 `mystl::distance` 函数计算 `first` 和
     // `last` 之间的距离
     const size_type len = mystl::distance(first, last);
@@ -647,24 +791,105 @@ void vector<T>::range_init(Iter first, Iter last) {
 }
 
 // destroy_and_recover函数
-template <class T>
-void vector<T>::destroy_and_recover(iterator first,
+template <class T, class Alloc>
+void vector<T, Alloc>::destroy_and_recover(iterator first,
                                     iterator last,
                                     size_type n) {
-    data_allocator::destroy(first, last);
-    data_allocator::deallocate(first, n);
+    mystl::destroy(first, last);
+    deallocate_storage(first, n);
+}
+
+// is_mapped 函数
+// 容量为 n 的空间是否使用映射的页面，只由 n 决定，分配与释放时的判断总是一致
+template <class T, class Alloc>
+bool vector<T, Alloc>::is_mapped(size_type n) noexcept {
+#if defined(__linux__)
+    return std::is_same<Alloc, mystl::allocator<T>>::value &&
+           mystl::is_trivially_relocatable<T>::value &&
+           n * sizeof(T) >= MYSTL_VECTOR_MMAP_THRESHOLD;
+#else
+    (void)n;
+    return false;
+#endif
+}
+
+// allocate_storage 函数
+// 分配容量为 n 的空间，大块空间直接映射匿名页面，页面在第一次写入时才占用物理内存
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator vector<T, Alloc>::allocate_storage(
+    size_type n) {
+#if defined(__linux__)
+    if (is_mapped(n)) {
+        void* p = ::mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            throw std::bad_alloc();
+        return static_cast<iterator>(p);
+    }
+#endif
+    return alloc_.allocate(n);
+}
+
+// deallocate_storage 函数
+template <class T, class Alloc>
+void vector<T, Alloc>::deallocate_storage(iterator p, size_type n) noexcept {
+#if defined(__linux__)
+    if (is_mapped(n)) {
+        ::munmap(p, n * sizeof(T));
+        return;
+    }
+#endif
+    alloc_.deallocate(p, n);
+}
+
+// remap_storage 函数
+// 把映射的空间调整为 new_cap 个元素，要求调整前后都使用映射的页面。
+// 内核只移动页表，元素随页面一起按位搬移，失败时原来的空间不受影响
+template <class T, class Alloc>
+void vector<T, Alloc>::remap_storage(size_type new_cap) {
+#if defined(__linux__)
+    const size_type old_size = size();
+    void* p = ::mremap(begin_, capacity() * sizeof(T), new_cap * sizeof(T),
+                       MREMAP_MAYMOVE);
+    if (p == MAP_FAILED)
+        throw std::bad_alloc();
+    begin_ = static_cast<iterator>(p);
+    end_ = begin_ + old_size;
+    cap_ = begin_ + new_cap;
+#else
+    (void)new_cap;
+#endif
+}
+
+// remap_emplace_back 函数
+// 映射的空间已满时扩展到 new_cap 并在末尾构造元素。args 可能引用原来的元素，而 mremap 之后原来的地址
+// 失效，所以先在临时空间中构造新元素，扩展映射后再按位搬到末尾
+template <class T, class Alloc>
+template <class... Args>
+void vector<T, Alloc>::remap_emplace_back(size_type new_cap,
+                                          Args&&... args) {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type tmp;
+    auto p = reinterpret_cast<T*>(&tmp);
+    mystl::construct(p, mystl::forward<Args>(args)...);
+    try {
+        remap_storage(new_cap);
+    } catch (...) {
+        mystl::destroy(p);
+        throw;
+    }
+    end_ = mystl::unchecked_uninit_relocate(p, p + 1, end_, m_true_type());
 }
 
 // get_new_cap函数
 // 获取新容量的函数，在插入元素时，根据当前的容量和需要插入的元素个数，计算出一个新的合适的容量大小
-template <class T>
-typename vector<T>::size_type vector<T>::get_new_cap(size_type add_size) {
+template <class T, class Alloc>
+typename vector<T, Alloc>::size_type vector<T, Alloc>::get_new_cap(size_type add_size) {
     // 1. 首先获取当前容量 `old_size`
     const auto old_size = capacity();
     // 2. 如果当前容量加上要插入的元素个数 `add_size` 大于
     // `max_size()`，则抛出一个 `length_error` 异常
     THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size,
-                          "vector<T>'s size too big");
+                          "vector<T, Alloc>'s size too big");
     // 3. 如果当前容量大于 `max_size()` 减去当前容量的一半
     if (old_size > max_size() - old_size / 2) {
         // 至少16，16是为了避免频繁的分配和释放内存
@@ -681,12 +906,12 @@ typename vector<T>::size_type vector<T>::get_new_cap(size_type add_size) {
 }
 
 // fill_assign函数
-template <class T>
-void vector<T>::fill_assign(size_type n, const value_type& value) {
+template <class T, class Alloc>
+void vector<T, Alloc>::fill_assign(size_type n, const value_type& value) {
     if (n > capacity()) {
         // 判断需要填充的元素数量是否大于当前容器的容量，如果是，就创建一个新的容量为
         // `n` 的 `vector` 对象，将其与当前对象交换，以扩展容量
-        vector tmp(n, value);
+        vector tmp(n, value, alloc_);
         swap(tmp);
     } else if (n > size()) {
         // 否则，如果需要填充的元素数量大于当前容器的大小，但小于等于当前容器的容量，就使用
@@ -704,15 +929,15 @@ void vector<T>::fill_assign(size_type n, const value_type& value) {
 }
 
 // copy_assign函数
-template <class T>
+template <class T, class Alloc>
 template <class IIter>
-void vector<T>::copy_assign(IIter first, IIter last, input_iterator_tag) {
+void vector<T, Alloc>::copy_assign(IIter first, IIter last, input_iterator_tag) {
     auto cur = begin_;
     for (; first != last && cur != end_; ++first, ++cur) {
         *cur = *first;
     }
     if (first == last) {
-        erase(cur, end);
+        erase(cur, end_);
     } else {
         insert(end_, first, last);
     }
@@ -720,21 +945,21 @@ void vector<T>::copy_assign(IIter first, IIter last, input_iterator_tag) {
 
 // 用 [first, last) 为容器赋值
 // 用于将一个迭代器范围内的元素赋值给 `vector` 容器
-template <class T>
+template <class T, class Alloc>
 template <class FIter>
-void vector<T>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
+void vector<T, Alloc>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
     const size_type len = mystl::distance(first, last);
     // 扩展容量
     if (len > capacity()) {
-        vector tmp(first, last);
+        vector tmp(first, last, alloc_);
         swap(tmp);
     } else if (size() >= len) {
         // 需要复制的元素数量小于等于当前容器的大小
         // 如果需要复制的元素数量小于等于当前容器的大小，就使用 `mystl::copy`
         // 函数将迭代器范围内的元素复制到当前容器中
         auto new_end = mystl::copy(first, last, begin_);
-        // 然后使用 `data_allocator::destroy` 函数销毁多余的元素
-        data_allocator::destroy(new_end, end_);
+        // 然后使用 `mystl::destroy` 函数销毁多余的元素
+        mystl::destroy(new_end, end_);
         // 更改为新的end_
         end_ = new_end;
     } else {
@@ -750,32 +975,88 @@ void vector<T>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
     }
 }
 
+// default_append 函数
+// 在末尾默认初始化 n 个元素，空间不足时按 get_new_cap 扩容，映射的空间用 mremap 扩展
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator vector<T, Alloc>::default_append(
+    size_type n) {
+    if (static_cast<size_type>(cap_ - end_) < n) {
+        reserve(get_new_cap(n));
+    }
+    const auto old_end = end_;
+    end_ = mystl::uninitialized_default_construct_n(end_, n);
+    return old_end;
+}
+
+// append_range_aux 函数
+// 输入迭代器只能遍历一次，逐个追加
+template <class T, class Alloc>
+template <class IIter>
+typename vector<T, Alloc>::iterator vector<T, Alloc>::append_range_aux(
+    IIter first,
+    IIter last,
+    input_iterator_tag) {
+    const size_type xpos = size();
+    for (; first != last; ++first)
+        emplace_back(*first);
+    return begin_ + xpos;
+}
+
+// 前向迭代器先算出长度，最多扩容一次
+template <class T, class Alloc>
+template <class FIter>
+typename vector<T, Alloc>::iterator vector<T, Alloc>::append_range_aux(
+    FIter first,
+    FIter last,
+    forward_iterator_tag) {
+    const size_type xpos = size();
+    copy_insert(end_, first, last);
+    return begin_ + xpos;
+}
+
 // 重新分配空间并在pos处就地构造元素
-template <class T>
+template <class T, class Alloc>
 template <class... Args>
-void vector<T>::reallocate_emplace(iterator pos, Args&&... args) {
+void vector<T, Alloc>::reallocate_emplace(iterator pos, Args&&... args) {
     // 调用 `get_new_cap`
     // 函数来计算新的容量大小，这个函数会根据需要插入的元素数量来计算新的容量大小
     const auto new_size = get_new_cap(1);
+    if (pos == end_ && is_mapped(capacity())) {
+        remap_emplace_back(new_size, mystl::forward<Args>(args)...);
+        return;
+    }
     // 用新的容量大小来分配一块新的内存空间，这块内存空间的起始地址被赋值给
     // `new_begin`
-    auto new_begin = data_allocator::allocate(new_size);
+    auto new_begin = allocate_storage(new_size);
+    if (mystl::is_trivially_relocatable<T>::value) {
+        // 元素可以按位搬移时，先在新空间中构造新元素，构造失败时原来的元素不受影响，
+        // 之后的搬移不会抛出异常
+        try {
+            mystl::construct(mystl::address_of(*(new_begin + (pos - begin_))),
+                             mystl::forward<Args>(args)...);
+        } catch (...) {
+            deallocate_storage(new_begin, new_size);
+            throw;
+        }
+        relocate_around(pos, 1, new_begin, new_size);
+        return;
+    }
     auto new_end = new_begin;
     try {
         // 使用 `mystl::uninitialized_move` 函数将 `begin_` 到 `pos`
         // 之间的元素移动到新的内存空间中，这个函数会返回一个迭代器，这个迭代器指向新的内存空间中最后一个被移动的元素
         new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-        // 使用 `data_allocator::construct` 函数在 `new_end`
+        // 使用 `mystl::construct` 函数在 `new_end`
         // 指向的位置构造一个新的元素，这个函数会调用元素类型的构造函数来构造这个新的元素
-        data_allocator::construct(mystl::address_of(*new_end),
-                                  mystl::forward<Args>(args)...);
+        mystl::construct(mystl::address_of(*new_end),
+                         mystl::forward<Args>(args)...);
         // 将 `new_end` 向后移动一个位置，使其指向新插入的元素之后的位置。
         ++new_end;
         // 使用 `mystl::uninitialized_move` 函数将 `pos` 到 `end_`
         // 之间的元素移动到新的内存空间中，这个函数会返回一个迭代器，这个迭代器指向新的内存空间中最后一个被移动的元素之后的位置
         new_end = mystl::uninitialized_move(pos, end_, new_end);
     } catch (...) {
-        data_allocator::deallocate(new_begin, new_size);
+        deallocate_storage(new_begin, new_size);
         throw;
     }
     // 使用 `destroy_and_recover` 函数销毁原来的元素，并释放原来的内存空间
@@ -788,19 +1069,34 @@ void vector<T>::reallocate_emplace(iterator pos, Args&&... args) {
 }
 
 // 重新分配空间并在pos处插入元素
-template <class T>
-void vector<T>::reallocate_insert(iterator pos, const value_type& value) {
+template <class T, class Alloc>
+void vector<T, Alloc>::reallocate_insert(iterator pos, const value_type& value) {
     const auto new_size = get_new_cap(1);
-    auto new_begin = data_allocator::allocate(new_size);
+    if (pos == end_ && is_mapped(capacity())) {
+        remap_emplace_back(new_size, value);
+        return;
+    }
+    auto new_begin = allocate_storage(new_size);
+    if (mystl::is_trivially_relocatable<T>::value) {
+        try {
+            mystl::construct(mystl::address_of(*(new_begin + (pos - begin_))),
+                             value);
+        } catch (...) {
+            deallocate_storage(new_begin, new_size);
+            throw;
+        }
+        relocate_around(pos, 1, new_begin, new_size);
+        return;
+    }
     auto new_end = new_begin;
     const value_type& value_copy = value;
     try {
         new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-        data_allocator::construct(mystl::address_of(*new_end), value_copy);
+        mystl::construct(mystl::address_of(*new_end), value_copy);
         ++new_end;
         new_end = mystl::uninitialized_move(pos, end_, new_end);
     } catch (...) {
-        data_allocator::deallocate(new_begin, new_size);
+        deallocate_storage(new_begin, new_size);
         throw;
     }
     destroy_and_recover(begin_, end_, cap_ - begin_);
@@ -809,10 +1105,27 @@ void vector<T>::reallocate_insert(iterator pos, const value_type& value) {
     cap_ = new_begin + new_size;
 }
 
+// relocate_around 函数
+// 把原来的元素按位搬移到新空间，pos 处留出已经构造好的 n 个元素，然后释放原来的空间
+template <class T, class Alloc>
+void vector<T, Alloc>::relocate_around(iterator pos,
+                                       size_type n,
+                                       iterator new_begin,
+                                       size_type new_size) noexcept {
+    auto new_end = mystl::unchecked_uninit_relocate(begin_, pos, new_begin,
+                                                    m_true_type());
+    new_end = mystl::unchecked_uninit_relocate(pos, end_, new_end + n,
+                                               m_true_type());
+    deallocate_storage(begin_, cap_ - begin_);
+    begin_ = new_begin;
+    end_ = new_end;
+    cap_ = new_begin + new_size;
+}
+
 // fill_insert函数
 // 在指定位置插入指定数量的元素，每个元素的值都为指定的值
-template <class T>
-typename vector<T>::iterator vector<T>::fill_insert(iterator pos,
+template <class T, class Alloc>
+typename vector<T, Alloc>::iterator vector<T, Alloc>::fill_insert(iterator pos,
                                                     size_type n,
                                                     const value_type& value) {
     // 如果要插入的元素数量为 0，则直接返回插入位置
@@ -841,7 +1154,7 @@ typename vector<T>::iterator vector<T>::fill_insert(iterator pos,
             end_ =
                 mystl::uninitialized_fill_n(end_, n - after_elems, value_copy);
             // 再将插入位置后面的元素移动到新的空间中
-            end_ = mystl::unchecked_move(pos, old_end, end_);
+            end_ = mystl::uninitialized_move(pos, old_end, end_);
             // 最后在插入位置处插入 `after_elems` 个元素
             mystl::uninitialized_fill_n(pos, after_elems, value_copy);
         }
@@ -850,7 +1163,18 @@ typename vector<T>::iterator vector<T>::fill_insert(iterator pos,
         // a. 计算出需要分配的新空间大小（即 `get_new_cap(n)`）。
         const auto new_size = get_new_cap(n);
         // b. 分配新的内存空间，并将原有元素拷贝到新的内存空间中
-        auto new_begin = data_allocator::allocate(new_size);
+        auto new_begin = allocate_storage(new_size);
+        if (mystl::is_trivially_relocatable<T>::value) {
+            // 先填充新元素，再把原来的元素按位搬移到两侧
+            try {
+                mystl::uninitialized_fill_n(new_begin + xpos, n, value_copy);
+            } catch (...) {
+                deallocate_storage(new_begin, new_size);
+                throw;
+            }
+            relocate_around(pos, n, new_begin, new_size);
+            return begin_ + xpos;
+        }
         auto new_end = new_begin;
         try {
             new_end = mystl::uninitialized_move(begin_, pos, new_begin);
@@ -862,7 +1186,7 @@ typename vector<T>::iterator vector<T>::fill_insert(iterator pos,
         }
         // b. 释放原有的内存空间，并将 `begin_`、`end_` 和 `cap_`
         // 指向新的内存空间的起始位置、末尾位置和尾后位置
-        data_allocator::deallocate(begin_, cap_ - begin_);
+        deallocate_storage(begin_, cap_ - begin_);
         begin_ = new_begin;
         end_ = new_end;
         cap_ = begin_ + new_size;
@@ -871,9 +1195,9 @@ typename vector<T>::iterator vector<T>::fill_insert(iterator pos,
 }
 
 // / copy_insert 函数
-template <class T>
+template <class T, class Alloc>
 template <class IIter>
-void vector<T>::copy_insert(iterator pos, IIter first, IIter last) {
+void vector<T, Alloc>::copy_insert(iterator pos, IIter first, IIter last) {
     if (first == last)
         return;
     const auto n = mystl::distance(first, last);
@@ -893,7 +1217,18 @@ void vector<T>::copy_insert(iterator pos, IIter first, IIter last) {
         }
     } else {  // 备用空间不足
         const auto new_size = get_new_cap(n);
-        auto new_begin = data_allocator::allocate(new_size);
+        auto new_begin = allocate_storage(new_size);
+        if (mystl::is_trivially_relocatable<T>::value) {
+            try {
+                mystl::uninitialized_copy(first, last,
+                                          new_begin + (pos - begin_));
+            } catch (...) {
+                deallocate_storage(new_begin, new_size);
+                throw;
+            }
+            relocate_around(pos, n, new_begin, new_size);
+            return;
+        }
         auto new_end = new_begin;
         try {
             new_end = mystl::uninitialized_move(begin_, pos, new_begin);
@@ -903,7 +1238,7 @@ void vector<T>::copy_insert(iterator pos, IIter first, IIter last) {
             destroy_and_recover(new_begin, new_end, new_size);
             throw;
         }
-        data_allocator::deallocate(begin_, cap_ - begin_);
+        deallocate_storage(begin_, cap_ - begin_);
         begin_ = new_begin;
         end_ = new_end;
         cap_ = begin_ + new_size;
@@ -914,13 +1249,13 @@ void vector<T>::copy_insert(iterator pos, IIter first, IIter last) {
 // `reinsert`。这个函数的作用是重新分配内存空间，将 `vector`
 // 中存储的元素拷贝到新的内存空间中，并释放旧的内存空间。
 
-// 具体来说，这个函数首先使用 `data_allocator::allocate`
+// 具体来说，这个函数首先使用 `alloc_.allocate`
 // 函数分配一块新的内存空间，大小为 `size`。然后，使用
 // `mystl::uninitialized_move`
 // 函数，将旧的内存空间中的元素拷贝到新的内存空间中。如果在拷贝过程中出现异常，就需要使用
-// `data_allocator::deallocate` 函数释放新的内存空间，并将异常继续抛出。
+// `alloc_.deallocate` 函数释放新的内存空间，并将异常继续抛出。
 
-// 如果拷贝操作成功完成，就使用 `data_allocator::deallocate`
+// 如果拷贝操作成功完成，就使用 `alloc_.deallocate`
 // 函数释放旧的内存空间，并将 `begin_` 指向新的内存空间的起始位置，将 `end_`
 // 指向新的内存空间中存储的最后一个元素的下一个位置，将 `cap_`
 // 指向新的内存空间的末尾位置。
@@ -929,21 +1264,25 @@ void vector<T>::copy_insert(iterator pos, IIter first, IIter last) {
 // 类模板的扩容操作和重新插入操作都需要使用到这个函数。 reinsert函数
 // 函数的作用是重新分配内存空间，将 `vector`
 // 中存储的元素拷贝到新的内存空间中，并释放旧的内存空间
-template <class T>
-void vector<T>::reinsert(size_type size) {
-    // 使用 `data_allocator::allocate` 函数分配一块新的内存空间，大小为 `size`
-    auto new_begin = data_allocator::allocate(size);
+template <class T, class Alloc>
+void vector<T, Alloc>::reinsert(size_type size) {
+    if (is_mapped(capacity()) && is_mapped(size)) {
+        remap_storage(size);
+        return;
+    }
+    // 使用 `alloc_.allocate` 函数分配一块新的内存空间，大小为 `size`
+    auto new_begin = allocate_storage(size);
     try {
-        // 然后，使用 `mystl::uninitialized_move`
-        // 函数，将旧的内存空间中的元素拷贝到新的内存空间中
-        mystl::uninitialized_move(begin_, end_, new_begin);
+        // 然后，使用 `mystl::uninitialized_relocate`
+        // 函数，将旧的内存空间中的元素搬移到新的内存空间中，可以按位搬移时直接 memcpy
+        mystl::uninitialized_relocate(begin_, end_, new_begin);
     } catch (...) {
-        // 如果在拷贝过程中出现异常，就需要使用 `data_allocator::deallocate`
+        // 如果在拷贝过程中出现异常，就需要使用 `alloc_.deallocate`
         // 函数释放新的内存空间，并将异常继续抛出
-        data_allocator::deallocate(new_begin, size);
+        deallocate_storage(new_begin, size);
         throw;
     }
-    data_allocator::deallocate(begin_, cap_ - begin_);
+    deallocate_storage(begin_, cap_ - begin_);
     begin_ = new_begin;
     end_ = begin_ + size;
     cap_ = begin_ + size;
@@ -952,45 +1291,53 @@ void vector<T>::reinsert(size_type size) {
 /*******************************************/
 // 重载比较操作符
 
-template <class T>
-bool operator==(const vector<T>& lhs, const vector<T>& rhs) {
+template <class T, class Alloc>
+bool operator==(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
     return lhs.size() == rhs.size() &&
            mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <class T>
-bool operator<(const vector<T>& lhs, const vector<T>& rhs) {
+template <class T, class Alloc>
+bool operator<(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
     return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(),
                                           rhs.end());
 }
 
-template <class T>
-bool operator!=(const vector<T>& lhs, const vector<T>& rhs) {
+template <class T, class Alloc>
+bool operator!=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
     return !(lhs == rhs);
 }
 
-template <class T>
-bool operator>(const vector<T>& lhs, const vector<T>& rhs) {
+template <class T, class Alloc>
+bool operator>(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
     return rhs < lhs;
 }
 
-template <class T>
-bool operator<=(const vector<T>& lhs, const vector<T>& rhs) {
+template <class T, class Alloc>
+bool operator<=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
     return !(rhs < lhs);
 }
 
-template <class T>
-bool operator>=(const vector<T>& lhs, const vector<T>& rhs) {
+template <class T, class Alloc>
+bool operator>=(const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs) {
     return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <class T>
-void swap(vector<T>& lhs, vector<T>& rhs) {
+template <class T, class Alloc>
+void swap(vector<T, Alloc>& lhs, vector<T, Alloc>& rhs) {
     // 简单的交换
     lhs.swap(rhs);
 }
 
+// vector 只保存指向堆上空间的指针，分配器可以按位搬移时整个 vector 也可以
+template <class T, class Alloc>
+struct is_trivially_relocatable<vector<T, Alloc>>
+    : is_trivially_relocatable<Alloc> {};
+
 }  // namespace mystl
 
+// vector<bool> 的特化
+#include "bit_vector.h"
+
 #endif
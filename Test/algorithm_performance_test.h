@@ -1,11 +1,24 @@
 ﻿#ifndef MYTINYSTL_ALGORITHM_PERFORMANCE_TEST_H_
 #define MYTINYSTL_ALGORITHM_PERFORMANCE_TEST_H_
 
-// 仅仅针对 sort, binary_search 做了性能测试
+// 仅仅针对 sort, parallel::sort, radix_sort, binary_search 做了性能测试
 
 #include <algorithm>
+#include <chrono>
+#include <vector>
+// 找到 TBB 时由 CMakeLists.txt 定义 MYSTL_HAS_STD_PAR，与 std::execution::par 对比
+#if defined(MYSTL_HAS_STD_PAR) && __cplusplus >= 201703L
+#include <execution>
+#define MYSTL_TEST_STD_PAR 1
+#else
+#define MYSTL_TEST_STD_PAR 0
+#endif
 
 #include "../MyTinySTL/algorithm.h"
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/eytzinger.h"
+#include "../MyTinySTL/parallel_algo.h"
+#include "../MyTinySTL/radix_sort.h"
 #include "test.h"
 
 namespace mystl
@@ -55,6 +68,130 @@ namespace algorithm_performance_test
     delete []arr;                                              \
 } while(0)
 
+// 并行排序的性能测试，多个线程同时工作，使用墙上时间而不是 clock()
+// call 中可以使用 arr 与 len 表示待排序的数组与长度
+#define PSORT_TEST(call, length) do {                           \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    const size_t len = length;                                 \
+    std::vector<int> data(len);                                \
+    for(size_t i = 0; i < len; ++i)  data[i] = rand();         \
+    int *arr = data.data();                                    \
+    auto start = std::chrono::steady_clock::now();             \
+    call;                                                      \
+    auto end = std::chrono::steady_clock::now();               \
+    int n = static_cast<int>(std::chrono::duration_cast<       \
+        std::chrono::milliseconds>(end - start).count());      \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define PSORT_ROW(call)                      \
+    PSORT_TEST(call, LEN1);                  \
+    PSORT_TEST(call, LEN2);                  \
+    PSORT_TEST(call, LEN3);
+
+#define PSORT_THREADS_ROW(threads) do {                          \
+    mystl::parallel::thread_pool pool(threads);                 \
+    std::cout << std::endl << "|  mystl parallel x" << std::setw(2) \
+              << threads << " |";                               \
+    PSORT_ROW(mystl::parallel::sort(pool, arr, arr + len));      \
+} while(0)
+
+void parallel_sort_test()
+{
+  std::cout << "[------------------ function : parallel sort -------------------]" << std::endl;
+  std::cout << "|   threads \\ size    |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  std::cout << "|   std::sort  x 1    |";
+  PSORT_ROW(std::sort(arr, arr + len));
+#if MYSTL_TEST_STD_PAR
+  std::cout << std::endl << "|   std::sort  par    |";
+  PSORT_ROW(std::sort(std::execution::par, arr, arr + len));
+#endif
+  std::cout << std::endl << "|  mystl::sort x 1    |";
+  PSORT_ROW(mystl::sort(arr, arr + len));
+  PSORT_THREADS_ROW(1);
+  PSORT_THREADS_ROW(2);
+  PSORT_THREADS_ROW(4);
+  PSORT_THREADS_ROW(8);
+  PSORT_THREADS_ROW(16);
+  std::cout << std::endl;
+}
+
+// 不同类型的键的排序测试，gen 为生成一个随机元素的表达式
+#define SORT_KEY_TEST(mode, fun, type, gen, length) do {      \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    clock_t start, end;                                        \
+    std::vector<type> data(length);                            \
+    for(size_t i = 0; i < data.size(); ++i)  data[i] = gen;    \
+    start = clock();                                           \
+    mode::fun(data.data(), data.data() + data.size());         \
+    end = clock();                                             \
+    int n = static_cast<int>(static_cast<double>(end - start)  \
+        / CLOCKS_PER_SEC * 1000);                              \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define SORT_KEY_ROW(mode, fun, type, gen, len1, len2, len3) \
+    SORT_KEY_TEST(mode, fun, type, gen, len1);               \
+    SORT_KEY_TEST(mode, fun, type, gen, len2);               \
+    SORT_KEY_TEST(mode, fun, type, gen, len3);
+
+// 生成随机的 64 位整数、浮点数与字符串
+inline uint64_t rand_u64()
+{
+  return (static_cast<uint64_t>(rand()) << 33) ^ (static_cast<uint64_t>(rand()) << 11) ^ rand();
+}
+
+inline double rand_double()
+{
+  return (static_cast<double>(rand()) - RAND_MAX / 2) / 1024.0;
+}
+
+inline mystl::string rand_string()
+{
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "key:%08d", rand());
+  return mystl::string(buf);
+}
+
+void radix_sort_test()
+{
+  std::cout << "[-------------------- function : radix_sort --------------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  std::cout << "|  int   mystl::sort  |";
+  FUN_TEST1(mystl, sort, LEN1);
+  FUN_TEST1(mystl, sort, LEN2);
+  FUN_TEST1(mystl, sort, LEN3);
+  std::cout << std::endl << "|  int   radix_sort   |";
+  FUN_TEST1(mystl, radix_sort, LEN1);
+  FUN_TEST1(mystl, radix_sort, LEN2);
+  FUN_TEST1(mystl, radix_sort, LEN3);
+  std::cout << std::endl << "|  u64   mystl::sort  |";
+  SORT_KEY_ROW(mystl, sort, uint64_t, rand_u64(), LEN1, LEN2, LEN3);
+  std::cout << std::endl << "|  u64   radix_sort   |";
+  SORT_KEY_ROW(mystl, radix_sort, uint64_t, rand_u64(), LEN1, LEN2, LEN3);
+  std::cout << std::endl << "| double mystl::sort  |";
+  SORT_KEY_ROW(mystl, sort, double, rand_double(), LEN1, LEN2, LEN3);
+  std::cout << std::endl << "| double radix_sort   |";
+  SORT_KEY_ROW(mystl, radix_sort, double, rand_double(), LEN1, LEN2, LEN3);
+  std::cout << std::endl << "| string mystl::sort  |";
+  SORT_KEY_ROW(mystl, sort, mystl::string, rand_string(), SCALE_S(LEN1),
+               SCALE_S(LEN2), SCALE_S(LEN3));
+  std::cout << std::endl << "| string radix_sort   |";
+  SORT_KEY_ROW(mystl, radix_sort, mystl::string, rand_string(), SCALE_S(LEN1),
+               SCALE_S(LEN2), SCALE_S(LEN3));
+  std::cout << std::endl;
+}
+
 void binary_search_test()
 {
   std::cout << "[------------------- function : binary_search ------------------]" << std::endl;
@@ -71,6 +208,95 @@ void binary_search_test()
   std::cout << std::endl;
 }
 
+// 有序查找表的性能测试，表中为 0, 2, 4, ...，每个数量级都做 LEN2 次随机查找
+// build 在计时前执行，lookup 为查找 key 的表达式，可以使用 v 与 idx
+#define LOOKUP_TEST(build, lookup, length) do {               \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    clock_t start, end;                                        \
+    const size_t len = length;                                 \
+    mystl::vector<int> v(len);                                 \
+    for(size_t i = 0; i < len; ++i)                            \
+      v[i] = static_cast<int>(i * 2);                          \
+    mystl::eytzinger_index<int> idx;                           \
+    build;                                                     \
+    std::vector<int> keys(LEN2);                               \
+    for(size_t i = 0; i < keys.size(); ++i)                    \
+      keys[i] = static_cast<int>(rand() % (2 * len));          \
+    size_t found = 0;                                          \
+    start = clock();                                           \
+    for(size_t i = 0; i < keys.size(); ++i) {                  \
+      const int key = keys[i];                                 \
+      found += (lookup) ? 1 : 0;                               \
+    }                                                          \
+    end = clock();                                             \
+    int n = static_cast<int>(static_cast<double>(end - start)  \
+        / CLOCKS_PER_SEC * 1000);                              \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+    volatile size_t sink = found;                              \
+    (void)sink;                                                \
+} while(0)
+
+#if LARGER_TEST_DATA_ON
+#define LOOKUP_ROW(build, lookup)                               \
+    LOOKUP_TEST(build, lookup, SCALE_SS(LEN1));                 \
+    LOOKUP_TEST(build, lookup, LEN2);                           \
+    LOOKUP_TEST(build, lookup, SCALE_LL(LEN3));
+#else
+#define LOOKUP_ROW(build, lookup)                               \
+    LOOKUP_TEST(build, lookup, SCALE_SS(LEN1));                 \
+    LOOKUP_TEST(build, lookup, LEN2);                           \
+    LOOKUP_TEST(build, lookup, LEN3);
+#endif
+
+void eytzinger_test()
+{
+  std::cout << "[------------------ lookup table : lower_bound -----------------]" << std::endl;
+  std::cout << "|    table size       |";
+#if LARGER_TEST_DATA_ON
+  TEST_LEN(SCALE_SS(LEN1), LEN2, SCALE_LL(LEN3), WIDE);
+#else
+  TEST_LEN(SCALE_SS(LEN1), LEN2, LEN3, WIDE);
+#endif
+  std::cout << "| std::lower_bound    |";
+  LOOKUP_ROW(, std::lower_bound(v.begin(), v.end(), key) != v.end());
+  std::cout << std::endl << "| mystl::lower_bound  |";
+  LOOKUP_ROW(, mystl::lower_bound(v.begin(), v.end(), key) != v.end());
+  std::cout << std::endl << "| eytzinger lower     |";
+  LOOKUP_ROW(idx.assign(v.begin(), v.end()), idx.lower_bound(key) != idx.end());
+  std::cout << std::endl << "| eytzinger contains  |";
+  LOOKUP_ROW(idx.assign(v.begin(), v.end()), idx.contains(key));
+  std::cout << std::endl;
+}
+
+// 有规律的输入，gen 为第 i 个元素的表达式，可以使用 len 表示长度
+#define SORT_PATTERN_TEST(mode, fun, gen, count) do {         \
+    srand((int)time(0));                                       \
+    char buf[10];                                              \
+    clock_t start, end;                                        \
+    const size_t len = count;                                  \
+    int *arr = new int[len];                                   \
+    for(size_t i = 0; i < len; ++i)  *(arr + i) = gen;         \
+    start = clock();                                           \
+    mode::fun(arr, arr + len);                                 \
+    end = clock();                                             \
+    int n = static_cast<int>(static_cast<double>(end - start)  \
+        / CLOCKS_PER_SEC * 1000);                              \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms   |";                                             \
+    std::cout << std::setw(WIDE) << t;                         \
+    delete []arr;                                              \
+} while(0)
+
+#define SORT_PATTERN_ROW(mode, fun, gen)     \
+    SORT_PATTERN_TEST(mode, fun, gen, LEN1); \
+    SORT_PATTERN_TEST(mode, fun, gen, LEN2); \
+    SORT_PATTERN_TEST(mode, fun, gen, LEN3);
+
 void sort_test()
 {
   std::cout << "[----------------------- function : sort -----------------------]" << std::endl;
@@ -84,6 +310,55 @@ void sort_test()
   FUN_TEST1(mystl, sort, LEN1);
   FUN_TEST1(mystl, sort, LEN2);
   FUN_TEST1(mystl, sort, LEN3);
+  std::cout << std::endl << "|   sorted     std    |";
+  SORT_PATTERN_ROW(std, sort, static_cast<int>(i));
+  std::cout << std::endl << "|   sorted    mystl   |";
+  SORT_PATTERN_ROW(mystl, sort, static_cast<int>(i));
+  std::cout << std::endl << "|  reversed    std    |";
+  SORT_PATTERN_ROW(std, sort, static_cast<int>(len - i));
+  std::cout << std::endl << "|  reversed   mystl   |";
+  SORT_PATTERN_ROW(mystl, sort, static_cast<int>(len - i));
+  std::cout << std::endl << "| organ-pipe   std    |";
+  SORT_PATTERN_ROW(std, sort, static_cast<int>(i < len / 2 ? i : len - i));
+  std::cout << std::endl << "| organ-pipe  mystl   |";
+  SORT_PATTERN_ROW(mystl, sort, static_cast<int>(i < len / 2 ? i : len - i));
+  std::cout << std::endl << "| few unique   std    |";
+  SORT_PATTERN_ROW(std, sort, rand() % 16);
+  std::cout << std::endl << "| few unique  mystl   |";
+  SORT_PATTERN_ROW(mystl, sort, rand() % 16);
+  std::cout << std::endl;
+}
+
+// 部分有序的输入：每 100 个元素中有一个随机元素；由长度为 1000 的升序段组成
+void stable_sort_test()
+{
+  std::cout << "[-------------------- function : stable_sort -------------------]" << std::endl;
+  std::cout << "| orders of magnitude |";
+  TEST_LEN(LEN1, LEN2, LEN3, WIDE);
+  std::cout << "|         std         |";
+  FUN_TEST1(std, stable_sort, LEN1);
+  FUN_TEST1(std, stable_sort, LEN2);
+  FUN_TEST1(std, stable_sort, LEN3);
+  std::cout << std::endl << "|        mystl        |";
+  FUN_TEST1(mystl, stable_sort, LEN1);
+  FUN_TEST1(mystl, stable_sort, LEN2);
+  FUN_TEST1(mystl, stable_sort, LEN3);
+  std::cout << std::endl << "|   sorted     std    |";
+  SORT_PATTERN_ROW(std, stable_sort, static_cast<int>(i));
+  std::cout << std::endl << "|   sorted    mystl   |";
+  SORT_PATTERN_ROW(mystl, stable_sort, static_cast<int>(i));
+  std::cout << std::endl << "|  1% random   std    |";
+  SORT_PATTERN_ROW(std, stable_sort, i % 100 == 0 ? rand() : static_cast<int>(i));
+  std::cout << std::endl << "|  1% random  mystl   |";
+  SORT_PATTERN_ROW(mystl, stable_sort, i % 100 == 0 ? rand() : static_cast<int>(i));
+  std::cout << std::endl << "|  asc runs    std    |";
+  SORT_PATTERN_ROW(std, stable_sort, i % 1000 == 0 ? rand() % 1000000 : *(arr + i - 1) + 1);
+  std::cout << std::endl << "|  asc runs   mystl   |";
+  SORT_PATTERN_ROW(mystl, stable_sort, i % 1000 == 0 ? rand() % 1000000 : *(arr + i - 1) + 1);
+  std::cout << std::endl << "|  reversed    std    |";
+  SORT_PATTERN_ROW(std, stable_sort, static_cast<int>(len - i));
+  std::cout << std::endl << "|  reversed   mystl   |";
+  SORT_PATTERN_ROW(mystl, stable_sort, static_cast<int>(len - i));
   std::cout << std::endl;
 }
 
@@ -94,7 +369,11 @@ void algorithm_performance_test()
   std::cout << "[===============================================================]" << std::endl;
   std::cout << "[--------------- Run algorithm performance test ----------------]" << std::endl;
   sort_test();
+  stable_sort_test();
+  parallel_sort_test();
+  radix_sort_test();
   binary_search_test();
+  eytzinger_test();
   std::cout << "[--------------- End algorithm performance test ----------------]" << std::endl;
   std::cout << "[===============================================================]" << std::endl;
 #endif // PERFORMANCE_TEST_ON
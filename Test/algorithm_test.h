@@ -1,13 +1,20 @@
 #ifndef MYTINYSTL_ALGORITHM_TEST_H_
 #define MYTINYSTL_ALGORITHM_TEST_H_
 
-// 算法测试: 包含了 mystl 的 81 个算法测试
+// 算法测试: 包含了 mystl 的 86 个算法测试
 
 #include <algorithm>
 #include <functional>
 #include <numeric>
+#include <string>
+#include <vector>
 
 #include "../MyTinySTL/algorithm.h"
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/eytzinger.h"
+#include "../MyTinySTL/list.h"
+#include "../MyTinySTL/parallel_algo.h"
+#include "../MyTinySTL/radix_sort.h"
 #include "../MyTinySTL/vector.h"
 #include "test.h"
 
@@ -522,6 +529,51 @@ TEST(equal_range_test)
   EXPECT_EQ(p4.second, p3.second);
 }
 
+TEST(eytzinger_index_test)
+{
+  std::vector<int> v1(1000);
+  for (size_t i = 0; i < v1.size(); ++i)
+    v1[i] = rand() % 2000;
+  mystl::eytzinger_index<int> idx(v1.data(), v1.data() + v1.size());
+  std::sort(v1.begin(), v1.end());
+  EXPECT_EQ(v1.size(), idx.size());
+  for (int x = -1; x <= 2001; ++x)
+  {
+    auto exp1 = std::lower_bound(v1.begin(), v1.end(), x);
+    auto act1 = idx.lower_bound(x);
+    EXPECT_EQ((exp1 == v1.end()), (act1 == idx.end()));
+    if (exp1 != v1.end() && act1 != idx.end())
+      EXPECT_EQ(*exp1, *act1);
+    auto exp2 = std::upper_bound(v1.begin(), v1.end(), x);
+    auto act2 = idx.upper_bound(x);
+    EXPECT_EQ((exp2 == v1.end()), (act2 == idx.end()));
+    if (exp2 != v1.end() && act2 != idx.end())
+      EXPECT_EQ(*exp2, *act2);
+    EXPECT_EQ(std::binary_search(v1.begin(), v1.end(), x), idx.contains(x));
+    EXPECT_EQ(static_cast<size_t>(std::count(v1.begin(), v1.end(), x)), idx.count(x));
+  }
+  // 重复较多的键与全部相等的键
+  for (size_t len : {67, 1000, 1295})
+  {
+    std::vector<int> v2(len);
+    for (size_t i = 0; i < len; ++i)
+      v2[i] = rand() % 3;
+    mystl::eytzinger_index<int> few(v2.data(), v2.data() + v2.size());
+    for (int x = -1; x <= 3; ++x)
+      EXPECT_EQ(static_cast<size_t>(std::count(v2.begin(), v2.end(), x)), few.count(x));
+    std::vector<int> v3(len, 7);
+    mystl::eytzinger_index<int> same(v3.data(), v3.data() + v3.size());
+    EXPECT_EQ(len, same.count(7));
+    EXPECT_EQ(0u, same.count(8));
+  }
+  mystl::eytzinger_index<int, std::greater<int>> idx2{ 5,3,9,1 };
+  EXPECT_EQ(3, *idx2.lower_bound(4));
+  EXPECT_TRUE(idx2.lower_bound(0) == idx2.end());
+  mystl::eytzinger_index<int> idx3;
+  EXPECT_TRUE(idx3.empty());
+  EXPECT_FALSE(idx3.contains(0));
+}
+
 TEST(find_test)
 {
   int arr1[] = { 1,2,3,4,5 };
@@ -1096,6 +1148,180 @@ TEST(sort_test)
   EXPECT_CON_EQ(arr1, arr2);
   EXPECT_CON_EQ(arr3, arr4);
   EXPECT_CON_EQ(arr5, arr6);
+  // 较长的区间会经过分割，并覆盖有序、逆序、organ-pipe 等有规律的输入
+  std::vector<int> v1(1000);
+  for (size_t i = 0; i < v1.size(); ++i)
+    v1[i] = rand() % 100;
+  std::vector<int> v2(v1);
+  std::sort(v1.begin(), v1.end());
+  mystl::sort(v2.data(), v2.data() + v2.size());
+  EXPECT_CON_EQ(v1, v2);
+  mystl::sort(v2.data(), v2.data() + v2.size());
+  EXPECT_CON_EQ(v1, v2);
+  std::reverse(v2.begin(), v2.end());
+  mystl::sort(v2.data(), v2.data() + v2.size());
+  EXPECT_CON_EQ(v1, v2);
+  std::vector<double> v3(1000);
+  for (size_t i = 0; i < v3.size(); ++i)
+    v3[i] = static_cast<double>(i < 500 ? i : 1000 - i);
+  std::vector<double> v4(v3);
+  std::sort(v3.begin(), v3.end(), std::greater<double>());
+  mystl::sort(v4.data(), v4.data() + v4.size(), std::greater<double>());
+  EXPECT_CON_EQ(v3, v4);
+}
+
+TEST(parallel_sort_test)
+{
+  mystl::parallel::thread_pool pool(4);
+  std::vector<int> v1(200000);
+  for (size_t i = 0; i < v1.size(); ++i)
+    v1[i] = rand() % 1000;
+  std::vector<int> v2(v1);
+  std::vector<int> v3(v1);
+  std::vector<int> v4(v1);
+  std::sort(v1.begin(), v1.end());
+  mystl::parallel::sort(pool, v2.data(), v2.data() + v2.size());
+  std::sort(v3.begin(), v3.end(), std::greater<int>());
+  mystl::parallel::sort(pool, v4.data(), v4.data() + v4.size(),
+                        std::greater<int>());
+  EXPECT_CON_EQ(v1, v2);
+  EXPECT_CON_EQ(v3, v4);
+  std::vector<int> v5(100000, 7);
+  std::vector<int> v6(100000);
+  for (size_t i = 0; i < v6.size(); ++i)
+    v6[i] = static_cast<int>(i);
+  std::vector<int> v7(v5);
+  std::vector<int> v8(v6);
+  mystl::parallel::sort(pool, v7.data(), v7.data() + v7.size());
+  mystl::parallel::sort(pool, v8.data(), v8.data() + v8.size());
+  EXPECT_CON_EQ(v5, v7);
+  EXPECT_CON_EQ(v6, v8);
+  std::vector<std::string> v9(100000);
+  for (size_t i = 0; i < v9.size(); ++i)
+    v9[i] = std::to_string(rand() % 5000);
+  std::vector<std::string> v10(v9);
+  std::sort(v9.begin(), v9.end());
+  mystl::parallel::sort(pool, v10.data(), v10.data() + v10.size());
+  EXPECT_CON_EQ(v9, v10);
+  int arr1[] = { 6,1,2,5,4,8,3,2,4,6,10,2,1,9 };
+  int arr2[] = { 6,1,2,5,4,8,3,2,4,6,10,2,1,9 };
+  std::sort(arr1, arr1 + 14);
+  mystl::parallel::sort(arr2, arr2 + 14);
+  EXPECT_CON_EQ(arr1, arr2);
+}
+
+TEST(radix_sort_test)
+{
+  std::vector<int> v1(1000);
+  std::vector<double> v3(1000);
+  std::vector<mystl::string> v5(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    v1[i] = rand() - RAND_MAX / 2;
+    v3[i] = (rand() % 2001 - 1000) / 7.0;
+    v5[i].append(static_cast<size_t>(rand()) % 5, static_cast<char>('a' + rand() % 3));
+    v5[i].append(static_cast<size_t>(rand()) % 3, static_cast<char>('a' + rand() % 3));
+  }
+  std::vector<int> v2(v1);
+  std::vector<double> v4(v3);
+  std::vector<mystl::string> v6(v5);
+  std::sort(v1.begin(), v1.end());
+  mystl::radix_sort(v2.data(), v2.data() + v2.size());
+  std::sort(v3.begin(), v3.end());
+  mystl::radix_sort(v4.data(), v4.data() + v4.size());
+  std::sort(v5.begin(), v5.end());
+  mystl::radix_sort(v6.data(), v6.data() + v6.size());
+  EXPECT_CON_EQ(v1, v2);
+  EXPECT_CON_EQ(v3, v4);
+  EXPECT_CON_EQ(v5, v6);
+  // 按键排序，相同的键保持原来的顺序
+  std::vector<mystl::pair<unsigned, int>> v7(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    v7[i] = mystl::make_pair(static_cast<unsigned>(rand() % 10), static_cast<int>(i));
+  std::vector<mystl::pair<unsigned, int>> v8(v7);
+  std::stable_sort(v7.begin(), v7.end(),
+                   [](const mystl::pair<unsigned, int>& a,
+                      const mystl::pair<unsigned, int>& b) { return a.first < b.first; });
+  mystl::radix_sort(v8.data(), v8.data() + v8.size(),
+                    mystl::selectfirst<mystl::pair<unsigned, int>>());
+  EXPECT_TRUE(v7 == v8);
+  // 不超过 kRadixSortThreshold 的小区间同样保持稳定
+  for (size_t len : {24, 200, 256})
+  {
+    std::vector<mystl::pair<unsigned, int>> v9(len);
+    for (size_t i = 0; i < len; ++i)
+      v9[i] = mystl::make_pair(static_cast<unsigned>(rand() % 3), static_cast<int>(i));
+    std::vector<mystl::pair<unsigned, int>> v10(v9);
+    std::stable_sort(v9.begin(), v9.end(),
+                     [](const mystl::pair<unsigned, int>& a,
+                        const mystl::pair<unsigned, int>& b) { return a.first < b.first; });
+    mystl::radix_sort(v10.data(), v10.data() + v10.size(),
+                      mystl::selectfirst<mystl::pair<unsigned, int>>());
+    EXPECT_TRUE(v9 == v10);
+  }
+  // 64 位的键按字节做 MSD 基数排序，同样保持稳定
+  std::vector<mystl::pair<long long, int>> v11(5000);
+  for (size_t i = 0; i < v11.size(); ++i)
+    v11[i] = mystl::make_pair(static_cast<long long>(rand() % 41 - 20) * (1LL << 40) +
+                              rand() % 300, static_cast<int>(i));
+  std::vector<mystl::pair<long long, int>> v12(v11);
+  std::stable_sort(v11.begin(), v11.end(),
+                   [](const mystl::pair<long long, int>& a,
+                      const mystl::pair<long long, int>& b) { return a.first < b.first; });
+  mystl::radix_sort(v12.data(), v12.data() + v12.size(),
+                    mystl::selectfirst<mystl::pair<long long, int>>());
+  EXPECT_TRUE(v11 == v12);
+}
+
+TEST(stable_partition_test)
+{
+  int arr1[] = { 1,2,3,4,5,6,7,8,9 };
+  int arr2[] = { 1,2,3,4,5,6,7,8,9 };
+  EXPECT_EQ(std::stable_partition(arr1, arr1 + 9, is_odd) - arr1,
+            mystl::stable_partition(arr2, arr2 + 9, is_odd) - arr2);
+  EXPECT_CON_EQ(arr1, arr2);
+  std::vector<int> v1(1000);
+  for (size_t i = 0; i < v1.size(); ++i)
+    v1[i] = rand();
+  std::vector<int> v2(v1);
+  std::stable_partition(v1.begin(), v1.end(), is_even);
+  mystl::stable_partition(v2.data(), v2.data() + v2.size(), is_even);
+  EXPECT_CON_EQ(v1, v2);
+  mystl::list<int> l1 = { 1,2,3,4,5,6 };
+  mystl::list<int> l2 = { 2,4,6,1,3,5 };
+  mystl::stable_partition(l1.begin(), l1.end(), is_even);
+  EXPECT_CON_EQ(l1, l2);
+}
+
+TEST(stable_sort_test)
+{
+  // 按键排序，相同的键保持原来的顺序
+  typedef mystl::pair<int, int> value_type;
+  auto key_less = [](const value_type& a, const value_type& b) { return a.first < b.first; };
+  std::vector<value_type> v1(100000);
+  for (size_t i = 0; i < v1.size(); ++i)
+    v1[i] = mystl::make_pair(rand() % 100, static_cast<int>(i));
+  // 部分有序：有序的段中夹杂少量随机元素与逆序的段
+  for (size_t i = 20000; i < 40000; ++i)
+    v1[i].first = i % 100 == 0 ? rand() % 100 : static_cast<int>(i);
+  for (size_t i = 60000; i < 70000; ++i)
+    v1[i].first = static_cast<int>(70000 - i);
+  std::vector<value_type> v2(v1);
+  std::stable_sort(v1.begin(), v1.end(), key_less);
+  mystl::stable_sort(v2.data(), v2.data() + v2.size(), key_less);
+  EXPECT_TRUE(v1 == v2);
+  int arr1[] = { 6,1,2,5,4,8,3,2,4,6,10,2,1,9 };
+  int arr2[] = { 6,1,2,5,4,8,3,2,4,6,10,2,1,9 };
+  std::stable_sort(arr1, arr1 + 14, std::greater<int>());
+  mystl::stable_sort(arr2, arr2 + 14, std::greater<int>());
+  EXPECT_CON_EQ(arr1, arr2);
+  std::vector<mystl::string> v3(1000);
+  for (size_t i = 0; i < v3.size(); ++i)
+    v3[i] = mystl::string(static_cast<size_t>(rand() % 20), 'a' + rand() % 3);
+  std::vector<mystl::string> v4(v3);
+  std::stable_sort(v3.begin(), v3.end());
+  mystl::stable_sort(v4.data(), v4.data() + v4.size());
+  EXPECT_CON_EQ(v3, v4);
 }
 
 TEST(swap_ranges_test)
@@ -0,0 +1,312 @@
+#ifndef MYTINYSTL_ALLOCATOR_TEST_H_
+#define MYTINYSTL_ALLOCATOR_TEST_H_
+
+// allocator test : 测试 pool_allocator、arena_allocator 的接口，
+// 以及 list、map、unordered_map 使用不同分配器时插入、删除节点的性能，
+// vector 在以请求为单位的负载下使用不同分配器的性能
+
+#include <list>
+#include <map>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../MyTinySTL/arena_allocator.h"
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/deque.h"
+#include "../MyTinySTL/list.h"
+#include "../MyTinySTL/map.h"
+#include "../MyTinySTL/pool_allocator.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl {
+namespace test {
+namespace allocator_test {
+
+typedef mystl::pair<const int, int> node_value;
+
+typedef mystl::pool_allocator<int> list_pool;
+typedef mystl::arena_allocator<int> list_arena;
+typedef mystl::pool_allocator<node_value> map_pool;
+typedef mystl::arena_allocator<node_value> map_arena;
+
+typedef std::map<int, int> std_map;
+typedef std::unordered_map<int, int> std_unordered_map;
+typedef mystl::map<int, int> mystl_map;
+typedef mystl::unordered_map<int, int> mystl_unordered_map;
+
+typedef mystl::list<int, list_pool> pool_list;
+typedef mystl::list<int, list_arena> arena_list;
+typedef mystl::vector<int, list_pool> pool_vector;
+typedef mystl::vector<int, list_arena> arena_vector;
+typedef mystl::deque<int, list_arena> arena_deque;
+typedef mystl::basic_string<char, mystl::char_traits<char>,
+                            mystl::arena_allocator<char>>
+    arena_string;
+typedef mystl::map<int, int, mystl::less<int>, map_pool> pool_map;
+typedef mystl::map<int, int, mystl::less<int>, map_arena> arena_map;
+typedef mystl::unordered_map<int, int, mystl::hash<int>, mystl::equal_to<int>,
+                             map_pool>
+    pool_unordered_map;
+typedef mystl::unordered_map<int, int, mystl::hash<int>, mystl::equal_to<int>,
+                             map_arena>
+    arena_unordered_map;
+
+// 计时的输出，包括容器与 arena 的析构
+#define ALLOC_TEST_END()                                       \
+    end = clock();                                             \
+    int n = static_cast<int>(static_cast<double>(end - start)  \
+        / CLOCKS_PER_SEC * 1000);                              \
+    std::snprintf(buf, sizeof(buf), "%d", n);                  \
+    std::string t = buf;                                       \
+    t += "ms    |";                                            \
+    std::cout << std::setw(WIDE) << t
+
+// list：在尾部插入 len 个元素，再从头部逐个删除
+// args 为构造容器的参数，可以使用名为 ar 的 arena
+#define ALLOC_LIST_DO_TEST(con, args, len)                     \
+    do {                                                       \
+        clock_t start, end;                                    \
+        char buf[16];                                          \
+        start = clock();                                       \
+        {                                                      \
+            mystl::arena ar;                                   \
+            (void)ar;                                          \
+            con c args;                                        \
+            for (size_t i = 0; i < len; ++i)                   \
+                c.push_back(static_cast<int>(i));              \
+            for (size_t i = 0; i < len; ++i)                   \
+                c.pop_front();                                 \
+        }                                                      \
+        ALLOC_TEST_END();                                      \
+    } while (0)
+
+// map / unordered_map：插入 len 个随机键，再按插入顺序逐个删除
+#define ALLOC_MAP_DO_TEST(con, args, len)                      \
+    do {                                                       \
+        srand((int)time(0));                                   \
+        clock_t start, end;                                    \
+        char buf[16];                                          \
+        std::vector<int> keys(len);                            \
+        for (auto& k : keys)                                   \
+            k = rand();                                        \
+        start = clock();                                       \
+        {                                                      \
+            mystl::arena ar;                                   \
+            (void)ar;                                          \
+            con c args;                                        \
+            for (size_t i = 0; i < len; ++i)                   \
+                c.emplace(keys[i], 0);                         \
+            for (size_t i = 0; i < len; ++i)                   \
+                c.erase(keys[i]);                              \
+        }                                                      \
+        ALLOC_TEST_END();                                      \
+    } while (0)
+
+// vector：模拟 len / 64 次请求，每次请求构造 4 个临时 vector，各插入 64 个元素
+// arena 使用栈上的缓冲区，每次请求结束后整体归还
+#define ALLOC_REQUEST_DO_TEST(con, args, len)                  \
+    do {                                                       \
+        clock_t start, end;                                    \
+        char buf[16];                                          \
+        start = clock();                                       \
+        {                                                      \
+            char storage[16 * 1024];                           \
+            mystl::arena ar(storage, sizeof(storage));         \
+            for (size_t r = 0; r < (len) / 64; ++r) {          \
+                {                                              \
+                    con v1 args, v2 args, v3 args, v4 args;    \
+                    for (int i = 0; i < 64; ++i) {             \
+                        v1.push_back(i);                       \
+                        v2.push_back(i + 1);                   \
+                        v3.push_back(i + 2);                   \
+                        v4.push_back(i + 3);                   \
+                    }                                          \
+                }                                              \
+                ar.release();                                  \
+            }                                                  \
+        }                                                      \
+        ALLOC_TEST_END();                                      \
+    } while (0)
+
+#define ALLOC_TEST(kind, con, args, len1, len2, len3) \
+    ALLOC_##kind##_DO_TEST(con, args, len1);          \
+    ALLOC_##kind##_DO_TEST(con, args, len2);          \
+    ALLOC_##kind##_DO_TEST(con, args, len3);
+
+#define ALLOC_CON_TEST(kind, std_con, con, pool_con, arena_con, arena_alloc, \
+                       len1, len2, len3)                                     \
+    TEST_LEN(len1, len2, len3, WIDE);                                        \
+    std::cout << "|         std         |";                                  \
+    ALLOC_TEST(kind, std_con, , len1, len2, len3);                           \
+    std::cout << "\n|        mystl        |";                                \
+    ALLOC_TEST(kind, con, , len1, len2, len3);                               \
+    std::cout << "\n|     mystl + pool    |";                                \
+    ALLOC_TEST(kind, pool_con, , len1, len2, len3);                          \
+    std::cout << "\n|    mystl + arena    |";                                \
+    ALLOC_TEST(kind, arena_con, {arena_alloc(ar)}, len1, len2, len3);
+
+void allocator_test() {
+    std::cout
+        << "[===============================================================]"
+        << std::endl;
+    std::cout
+        << "[----------------- Run container test : allocator --------------]"
+        << std::endl;
+    std::cout
+        << "[-------------------------- API test ---------------------------]"
+        << std::endl;
+    {
+        // pool_allocator：释放的块会被同样大小的请求复用
+        int* p1 = list_pool::allocate(1);
+        list_pool::deallocate(p1, 1);
+        int* p2 = list_pool::allocate(1);
+        FUN_VALUE((p1 == p2));
+        list_pool::deallocate(p2, 1);
+        FUN_VALUE((list_pool() == mystl::pool_allocator<double>()));
+        // 线程退出时交回的块由之后的线程复用
+        int* p3 = nullptr;
+        int* p4 = nullptr;
+        std::thread([&p3] {
+            p3 = list_pool::allocate(1);
+            list_pool::deallocate(p3, 1);
+        }).join();
+        std::thread([&p4] {
+            p4 = list_pool::allocate(1);
+            list_pool::deallocate(p4, 1);
+        }).join();
+        FUN_VALUE((p3 == p4));
+
+        pool_list l1{1, 2, 3};
+        pool_list l2(l1);
+        l2.push_front(0);
+        FUN_AFTER(l2, l2.pop_back());
+        pool_map m1;
+        for (int i = 0; i < 5; ++i)
+            m1.emplace(i, i * i);
+        FUN_VALUE(m1.size());
+        FUN_VALUE(m1[3]);
+    }
+    {
+        // arena_allocator：分配只移动指针，容器复制时沿用原来的 arena
+        mystl::arena ar(256);
+        arena_list l1{list_arena(ar)};
+        for (int i = 0; i < 5; ++i)
+            l1.push_back(i);
+        COUT(l1);
+        arena_list l2(l1);
+        FUN_VALUE((l2.get_allocator() == l1.get_allocator()));
+        FUN_VALUE((l2 == l1));
+
+        mystl::arena ar2;
+        arena_list l3{list_arena(ar2)};
+        l3 = l1;  // 复制赋值不传播分配器
+        FUN_VALUE((l3.get_allocator() == list_arena(ar2)));
+        l3 = mystl::move(l2);  // 移动赋值时分配器随元素传播
+        FUN_VALUE((l3.get_allocator() == list_arena(ar)));
+        FUN_VALUE(l3.size());
+
+        arena_unordered_map um{map_arena(ar)};
+        for (int i = 0; i < 100; ++i)
+            um.emplace(i, i);
+        FUN_VALUE(um.size());
+        FUN_VALUE((ar.bytes_used() > 0));
+    }
+    {
+        // vector、deque、basic_string 同样可以把空间放在 arena 中
+        char storage[1024];
+        mystl::arena ar(storage, sizeof(storage));
+        arena_vector v1{list_arena(ar)};
+        for (int i = 0; i < 8; ++i)
+            v1.push_back(i);
+        COUT(v1);
+        arena_vector v2(v1);
+        FUN_VALUE((v2.get_allocator() == v1.get_allocator()));
+        arena_deque d1{list_arena(ar)};
+        d1.push_front(1);
+        d1.push_back(2);
+        COUT(d1);
+        arena_string s1("a string longer than the local buffer",
+                        list_arena(ar));
+        COUT(s1);
+        FUN_VALUE((s1.get_allocator() == list_arena(ar)));
+
+        mystl::arena ar2;
+        arena_vector v3{list_arena(ar2)};
+        v3.swap(v1);  // 交换时分配器随元素传播
+        FUN_VALUE((v3.get_allocator() == list_arena(ar)));
+        FUN_VALUE(v3.size());
+    }
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout
+        << "[--------------------- Performance Testing ---------------------]"
+        << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "| list push/pop       |";
+#if LARGER_TEST_DATA_ON
+    ALLOC_CON_TEST(LIST, std::list<int>, mystl::list<int>, pool_list,
+                   arena_list, list_arena, SCALE_M(LEN1), SCALE_M(LEN2),
+                   SCALE_M(LEN3));
+#else
+    ALLOC_CON_TEST(LIST, std::list<int>, mystl::list<int>, pool_list,
+                   arena_list, list_arena, SCALE_S(LEN1), SCALE_S(LEN2),
+                   SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "| map insert/erase    |";
+#if LARGER_TEST_DATA_ON
+    ALLOC_CON_TEST(MAP, std_map, mystl_map, pool_map,
+                   arena_map, map_arena, SCALE_S(LEN1), SCALE_S(LEN2),
+                   SCALE_S(LEN3));
+#else
+    ALLOC_CON_TEST(MAP, std_map, mystl_map, pool_map,
+                   arena_map, map_arena, SCALE_SS(LEN1), SCALE_SS(LEN2),
+                   SCALE_SS(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "| vector per request  |";
+    ALLOC_CON_TEST(REQUEST, std::vector<int>, mystl::vector<int>, pool_vector,
+                   arena_vector, list_arena, SCALE_M(LEN1), SCALE_M(LEN2),
+                   SCALE_M(LEN3));
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "| hash insert/erase   |";
+#if LARGER_TEST_DATA_ON
+    ALLOC_CON_TEST(MAP, std_unordered_map,
+                   mystl_unordered_map, pool_unordered_map,
+                   arena_unordered_map, map_arena, SCALE_S(LEN1),
+                   SCALE_S(LEN2), SCALE_S(LEN3));
+#else
+    ALLOC_CON_TEST(MAP, std_unordered_map,
+                   mystl_unordered_map, pool_unordered_map,
+                   arena_unordered_map, map_arena, SCALE_SS(LEN1),
+                   SCALE_SS(LEN2), SCALE_SS(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    PASSED;
+#endif
+    std::cout
+        << "[----------------- End container test : allocator --------------]"
+        << std::endl;
+}
+
+}  // namespace allocator_test
+}  // namespace test
+}  // namespace mystl
+#endif  // !MYTINYSTL_ALLOCATOR_TEST_H_
@@ -0,0 +1,280 @@
+#ifndef MYTINYSTL_FLAT_HASH_MAP_TEST_H_
+#define MYTINYSTL_FLAT_HASH_MAP_TEST_H_
+
+// flat_hash_map test : 测试 flat_hash_map, flat_hash_set 的接口，
+// 并与 unordered_map 对比 insert、find、erase 的性能
+
+#include <unordered_map>
+
+#include "../MyTinySTL/flat_hash_map.h"
+#include "../MyTinySTL/flat_hash_set.h"
+#include "../MyTinySTL/unordered_map.h"
+#include "map_test.h"
+#include "test.h"
+#include "unordered_map_test.h"
+
+namespace mystl {
+namespace test {
+namespace flat_hash_map_test {
+
+using unordered_map_test::int_key;
+
+// 插入性能测试：插入 len 个随机键
+#define FLAT_MAP_INSERT_DO_TEST(con, len)                         \
+    do {                                                           \
+        srand((int)time(0));                                       \
+        clock_t start, end;                                        \
+        con c;                                                     \
+        char buf[10];                                              \
+        start = clock();                                           \
+        for (size_t i = 0; i < len; ++i)                           \
+            c.emplace(rand(), static_cast<int>(i));                \
+        end = clock();                                             \
+        int n = static_cast<int>(static_cast<double>(end - start)  \
+                                 / CLOCKS_PER_SEC * 1000);         \
+        std::snprintf(buf, sizeof(buf), "%d", n);                  \
+        std::string t = buf;                                       \
+        t += "ms    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+// 删除性能测试：先插入 len 个元素，再按键逐个删除
+#define FLAT_MAP_ERASE_DO_TEST(con, len)                          \
+    do {                                                           \
+        srand((int)time(0));                                       \
+        clock_t start, end;                                        \
+        con c;                                                     \
+        char buf[10];                                              \
+        for (size_t i = 0; i < len; ++i)                           \
+            c.emplace(static_cast<int>(i), static_cast<int>(i));   \
+        volatile size_t erased = 0;                                \
+        start = clock();                                           \
+        for (size_t i = 0; i < len; ++i)                           \
+            erased += c.erase(static_cast<int>(i));                \
+        end = clock();                                             \
+        int n = static_cast<int>(static_cast<double>(end - start)  \
+                                 / CLOCKS_PER_SEC * 1000);         \
+        std::snprintf(buf, sizeof(buf), "%d", n);                  \
+        std::string t = buf;                                       \
+        t += "ms    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+#define FLAT_MAP_TEST(do_test, len1, len2, len3)                  \
+    TEST_LEN(len1, len2, len3, WIDE);                              \
+    std::cout << "|         std         |";                        \
+    do_test(std_int_map, len1);                                    \
+    do_test(std_int_map, len2);                                    \
+    do_test(std_int_map, len3);                                    \
+    std::cout << "\n|    unordered_map    |";                      \
+    do_test(mystl_int_map, len1);                                  \
+    do_test(mystl_int_map, len2);                                  \
+    do_test(mystl_int_map, len3);                                  \
+    std::cout << "\n|    flat_hash_map    |";                      \
+    do_test(flat_int_map, len1);                                   \
+    do_test(flat_int_map, len2);                                   \
+    do_test(flat_int_map, len3);
+
+#define FLAT_MAP_FIND_DO_TEST(con, len) \
+    MAP_FIND_DO_TEST(con, int_key, len)
+
+typedef std::unordered_map<int, int> std_int_map;
+typedef mystl::unordered_map<int, int> mystl_int_map;
+typedef mystl::flat_hash_map<int, int> flat_int_map;
+
+void flat_hash_map_test() {
+    std::cout
+        << "[===============================================================]"
+        << std::endl;
+    std::cout
+        << "[-------------- Run container test : flat_hash_map -------------]"
+        << std::endl;
+    std::cout
+        << "[-------------------------- API test ---------------------------]"
+        << std::endl;
+    mystl::vector<PAIR> v;
+    for (int i = 0; i < 5; ++i)
+        v.push_back(PAIR(5 - i, 5 - i));
+    mystl::flat_hash_map<int, int> fm1;
+    mystl::flat_hash_map<int, int> fm2(520);
+    mystl::flat_hash_map<int, int> fm3(520, mystl::hash<int>());
+    mystl::flat_hash_map<int, int> fm4(520, mystl::hash<int>(),
+                                       mystl::equal_to<int>());
+    mystl::flat_hash_map<int, int> fm5(v.begin(), v.end());
+    mystl::flat_hash_map<int, int> fm6(v.begin(), v.end(), 100);
+    mystl::flat_hash_map<int, int> fm7(v.begin(), v.end(), 100,
+                                       mystl::hash<int>());
+    mystl::flat_hash_map<int, int> fm8(
+        v.begin(), v.end(), 100, mystl::hash<int>(), mystl::equal_to<int>());
+    mystl::flat_hash_map<int, int> fm9(fm5);
+    mystl::flat_hash_map<int, int> fm10(std::move(fm5));
+    mystl::flat_hash_map<int, int> fm11;
+    fm11 = fm6;
+    mystl::flat_hash_map<int, int> fm12;
+    fm12 = std::move(fm6);
+    mystl::flat_hash_map<int, int> fm13{PAIR(1, 1), PAIR(2, 3), PAIR(3, 3)};
+    mystl::flat_hash_map<int, int> fm14;
+    fm14 = {PAIR(1, 1), PAIR(2, 3), PAIR(3, 3)};
+
+    MAP_FUN_AFTER(fm1, fm1.emplace(1, 1));
+    MAP_FUN_AFTER(fm1, fm1.emplace_hint(fm1.begin(), 1, 2));
+    MAP_FUN_AFTER(fm1, fm1.insert(PAIR(2, 2)));
+    MAP_FUN_AFTER(fm1, fm1.insert(fm1.end(), PAIR(3, 3)));
+    MAP_FUN_AFTER(fm1, fm1.insert(v.begin(), v.end()));
+    MAP_FUN_AFTER(fm1, fm1.erase(fm1.begin()));
+    MAP_FUN_AFTER(fm1, fm1.erase(fm1.begin(), fm1.find(3)));
+    MAP_FUN_AFTER(fm1, fm1.erase(1));
+    std::cout << std::boolalpha;
+    FUN_VALUE(fm1.empty());
+    std::cout << std::noboolalpha;
+    FUN_VALUE(fm1.size());
+    FUN_VALUE(fm1.bucket_count());
+    FUN_VALUE(fm1.max_bucket_count());
+    MAP_FUN_AFTER(fm1, fm1.clear());
+    MAP_FUN_AFTER(fm1, fm1.swap(fm7));
+    MAP_VALUE(*fm1.begin());
+    FUN_VALUE(fm1.at(1));
+    FUN_VALUE(fm1[1]);
+    FUN_VALUE(fm1[6]);
+    std::cout << std::boolalpha;
+    FUN_VALUE(fm1.empty());
+    FUN_VALUE((fm1 == fm8));
+    std::cout << std::noboolalpha;
+    FUN_VALUE(fm1.size());
+    FUN_VALUE(fm1.max_size());
+    FUN_VALUE(fm1.bucket_count());
+    MAP_FUN_AFTER(fm1, fm1.reserve(1000));
+    FUN_VALUE(fm1.size());
+    FUN_VALUE(fm1.bucket_count());
+    MAP_FUN_AFTER(fm1, fm1.rehash(150));
+    FUN_VALUE(fm1.bucket_count());
+    FUN_VALUE(fm1.count(1));
+    MAP_VALUE(*fm1.find(3));
+    auto first = *fm1.equal_range(3).first;
+    std::cout << " fm1.equal_range(3) : from <" << first.first << ", "
+              << first.second << ">" << std::endl;
+    FUN_VALUE(fm1.load_factor());
+    FUN_VALUE(fm1.max_load_factor());
+    MAP_FUN_AFTER(fm1, fm1.max_load_factor(0.5f));
+    FUN_VALUE(fm1.max_load_factor());
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout
+        << "[--------------------- Performance Testing ---------------------]"
+        << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|     insert <int>    |";
+#if LARGER_TEST_DATA_ON
+    FLAT_MAP_TEST(FLAT_MAP_INSERT_DO_TEST, SCALE_M(LEN1), SCALE_M(LEN2),
+                  SCALE_M(LEN3));
+#else
+    FLAT_MAP_TEST(FLAT_MAP_INSERT_DO_TEST, SCALE_S(LEN1), SCALE_S(LEN2),
+                  SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|      find <int>     |";
+#if LARGER_TEST_DATA_ON
+    FLAT_MAP_TEST(FLAT_MAP_FIND_DO_TEST, SCALE_M(LEN1), SCALE_M(LEN2),
+                  SCALE_M(LEN3));
+#else
+    FLAT_MAP_TEST(FLAT_MAP_FIND_DO_TEST, SCALE_S(LEN1), SCALE_S(LEN2),
+                  SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|     erase <int>     |";
+#if LARGER_TEST_DATA_ON
+    FLAT_MAP_TEST(FLAT_MAP_ERASE_DO_TEST, SCALE_M(LEN1), SCALE_M(LEN2),
+                  SCALE_M(LEN3));
+#else
+    FLAT_MAP_TEST(FLAT_MAP_ERASE_DO_TEST, SCALE_S(LEN1), SCALE_S(LEN2),
+                  SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    PASSED;
+#endif
+    std::cout
+        << "[-------------- End container test : flat_hash_map -------------]"
+        << std::endl;
+}
+
+void flat_hash_set_test() {
+    std::cout
+        << "[===============================================================]"
+        << std::endl;
+    std::cout
+        << "[-------------- Run container test : flat_hash_set -------------]"
+        << std::endl;
+    std::cout
+        << "[-------------------------- API test ---------------------------]"
+        << std::endl;
+    int a[] = {5, 4, 3, 2, 1};
+    mystl::flat_hash_set<int> fs1;
+    mystl::flat_hash_set<int> fs2(520);
+    mystl::flat_hash_set<int> fs3(520, mystl::hash<int>());
+    mystl::flat_hash_set<int> fs4(520, mystl::hash<int>(),
+                                  mystl::equal_to<int>());
+    mystl::flat_hash_set<int> fs5(a, a + 5);
+    mystl::flat_hash_set<int> fs6(a, a + 5, 100);
+    mystl::flat_hash_set<int> fs7(a, a + 5, 100, mystl::hash<int>());
+    mystl::flat_hash_set<int> fs8(a, a + 5, 100, mystl::hash<int>(),
+                                  mystl::equal_to<int>());
+    mystl::flat_hash_set<int> fs9(fs5);
+    mystl::flat_hash_set<int> fs10(std::move(fs5));
+    mystl::flat_hash_set<int> fs11;
+    fs11 = fs6;
+    mystl::flat_hash_set<int> fs12;
+    fs12 = std::move(fs6);
+    mystl::flat_hash_set<int> fs13{1, 2, 3, 4, 5};
+    mystl::flat_hash_set<int> fs14;
+    fs14 = {1, 2, 3, 4, 5};
+
+    FUN_AFTER(fs1, fs1.emplace(1));
+    FUN_AFTER(fs1, fs1.emplace_hint(fs1.end(), 2));
+    FUN_AFTER(fs1, fs1.insert(5));
+    FUN_AFTER(fs1, fs1.insert(fs1.begin(), 5));
+    FUN_AFTER(fs1, fs1.insert(a, a + 5));
+    FUN_AFTER(fs1, fs1.erase(fs1.begin()));
+    FUN_AFTER(fs1, fs1.erase(fs1.begin(), fs1.find(3)));
+    FUN_AFTER(fs1, fs1.erase(1));
+    std::cout << std::boolalpha;
+    FUN_VALUE(fs1.empty());
+    std::cout << std::noboolalpha;
+    FUN_VALUE(fs1.size());
+    FUN_VALUE(fs1.bucket_count());
+    FUN_AFTER(fs1, fs1.clear());
+    FUN_AFTER(fs1, fs1.swap(fs7));
+    FUN_VALUE(*fs1.begin());
+    std::cout << std::boolalpha;
+    FUN_VALUE(fs1.empty());
+    FUN_VALUE((fs1 == fs13));
+    std::cout << std::noboolalpha;
+    FUN_VALUE(fs1.size());
+    FUN_AFTER(fs1, fs1.reserve(1000));
+    FUN_VALUE(fs1.bucket_count());
+    FUN_AFTER(fs1, fs1.rehash(150));
+    FUN_VALUE(fs1.bucket_count());
+    FUN_VALUE(fs1.count(1));
+    FUN_VALUE(*fs1.find(3));
+    FUN_VALUE(fs1.load_factor());
+    FUN_VALUE(fs1.max_load_factor());
+    PASSED;
+    std::cout
+        << "[-------------- End container test : flat_hash_set -------------]"
+        << std::endl;
+}
+
+}  // namespace flat_hash_map_test
+}  // namespace test
+}  // namespace mystl
+#endif  // !MYTINYSTL_FLAT_HASH_MAP_TEST_H_
@@ -0,0 +1,304 @@
+#ifndef MYTINYSTL_FLAT_MAP_TEST_H_
+#define MYTINYSTL_FLAT_MAP_TEST_H_
+
+// flat_map test : 测试 flat_map, flat_multimap, flat_set 的接口，
+// 并与 map 对比构造、查找、遍历的性能与每个元素占用的内存
+
+#include "../MyTinySTL/flat_map.h"
+#include "../MyTinySTL/flat_set.h"
+#include "../MyTinySTL/map.h"
+#include "../MyTinySTL/vector.h"
+#include "map_test.h"
+#include "test.h"
+
+namespace mystl {
+namespace test {
+namespace flat_map_test {
+
+typedef mystl::map<int, int> int_map;
+typedef mystl::flat_map<int, int> flat_int_map;
+
+// 每个元素占用的字节数：map 为一个节点的大小，不含分配器的额外开销；
+// flat_map 为两个数组的容量之和除以元素个数
+inline size_t bytes_per_element(const int_map&) {
+    return sizeof(int_map::node_type);
+}
+
+inline size_t bytes_per_element(const flat_int_map& c) {
+    return (c.keys().capacity() * sizeof(int) +
+            c.values().capacity() * sizeof(int)) /
+           c.size();
+}
+
+void flat_map_test() {
+    std::cout
+        << "[===============================================================]"
+        << std::endl;
+    std::cout
+        << "[---------------- Run container test : flat_map ----------------]"
+        << std::endl;
+    std::cout
+        << "[-------------------------- API test ---------------------------]"
+        << std::endl;
+    mystl::vector<PAIR> v;
+    for (int i = 0; i < 5; ++i)
+        v.push_back(PAIR(5 - i, 5 - i));
+    mystl::flat_map<int, int> m1;
+    mystl::flat_map<int, int, mystl::greater<int>> m2;
+    mystl::flat_map<int, int> m3(v.begin(), v.end());
+    mystl::flat_map<int, int> m4(v.begin(), v.end());
+    mystl::flat_map<int, int> m5(m3);
+    mystl::flat_map<int, int> m6(std::move(m3));
+    mystl::flat_map<int, int> m7;
+    m7 = m4;
+    mystl::flat_map<int, int> m8;
+    m8 = std::move(m4);
+    mystl::flat_map<int, int> m9{PAIR(1, 1), PAIR(3, 2), PAIR(2, 3)};
+    mystl::flat_map<int, int> m10;
+    m10 = {PAIR(1, 1), PAIR(3, 2), PAIR(2, 3)};
+
+    for (int i = 5; i > 0; --i)
+        MAP_FUN_AFTER(m1, m1.emplace(i, i));
+    MAP_FUN_AFTER(m1, m1.emplace_hint(m1.begin(), 0, 0));
+    MAP_FUN_AFTER(m1, m1.erase(m1.begin()));
+    MAP_FUN_AFTER(m1, m1.erase(0));
+    MAP_FUN_AFTER(m1, m1.erase(1));
+    MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.end()));
+    for (int i = 0; i < 5; ++i)
+        MAP_FUN_AFTER(m1, m1.insert(PAIR(i, i)));
+    MAP_FUN_AFTER(m1, m1.insert(v.begin(), v.end()));
+    MAP_FUN_AFTER(m1, m1.insert(m1.end(), PAIR(5, 5)));
+    FUN_VALUE(m1.count(1));
+    MAP_VALUE(*m1.find(3));
+    MAP_VALUE(*m1.lower_bound(3));
+    MAP_VALUE(*m1.upper_bound(2));
+    auto first = *m1.equal_range(2).first;
+    auto second = *m1.equal_range(2).second;
+    std::cout << " m1.equal_range(2) : from <" << first.first << ", "
+              << first.second << "> to <" << second.first << ", "
+              << second.second << ">" << std::endl;
+    MAP_FUN_AFTER(m1, m1.erase(m1.begin()));
+    MAP_FUN_AFTER(m1, m1.erase(1));
+    MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.find(3)));
+    MAP_FUN_AFTER(m1, m1.clear());
+    MAP_FUN_AFTER(m1, m1.swap(m9));
+    MAP_VALUE(*m1.begin());
+    MAP_VALUE(*m1.rbegin());
+    FUN_VALUE(m1[1]);
+    MAP_FUN_AFTER(m1, m1[1] = 3);
+    FUN_VALUE(m1.at(1));
+    std::cout << std::boolalpha;
+    FUN_VALUE(m1.empty());
+    FUN_VALUE((m5 == m6));
+    std::cout << std::noboolalpha;
+    FUN_VALUE(m1.size());
+    FUN_VALUE(m1.max_size());
+    FUN_VALUE(m1.keys().size());
+    FUN_VALUE(m1.values().size());
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout
+        << "[--------------------- Performance Testing ---------------------]"
+        << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|    build <int>      |";
+#if LARGER_TEST_DATA_ON
+    ORDERED_MAP_TEST(ORDERED_BUILD_DO_TEST, ORDERED_RANGE_BUILD,
+                     flat_int_map, "|      flat_map       |", SCALE_M(LEN1),
+                     SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+    ORDERED_MAP_TEST(ORDERED_BUILD_DO_TEST, ORDERED_RANGE_BUILD,
+                     flat_int_map, "|      flat_map       |", SCALE_S(LEN1),
+                     SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|     find <int>      |";
+#if LARGER_TEST_DATA_ON
+    ORDERED_MAP_TEST(ORDERED_FIND_DO_TEST, ORDERED_RANGE_BUILD,
+                     flat_int_map, "|      flat_map       |", SCALE_M(LEN1),
+                     SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+    ORDERED_MAP_TEST(ORDERED_FIND_DO_TEST, ORDERED_RANGE_BUILD,
+                     flat_int_map, "|      flat_map       |", SCALE_S(LEN1),
+                     SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|   iterate x10       |";
+#if LARGER_TEST_DATA_ON
+    ORDERED_MAP_TEST(ORDERED_ITER_DO_TEST, ORDERED_RANGE_BUILD,
+                     flat_int_map, "|      flat_map       |", SCALE_M(LEN1),
+                     SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+    ORDERED_MAP_TEST(ORDERED_ITER_DO_TEST, ORDERED_RANGE_BUILD,
+                     flat_int_map, "|      flat_map       |", SCALE_S(LEN1),
+                     SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|  bytes per element  |";
+#if LARGER_TEST_DATA_ON
+    ORDERED_MAP_TEST(ORDERED_MEMORY_DO_TEST, ORDERED_RANGE_BUILD,
+                     flat_int_map, "|      flat_map       |", SCALE_M(LEN1),
+                     SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+    ORDERED_MAP_TEST(ORDERED_MEMORY_DO_TEST, ORDERED_RANGE_BUILD,
+                     flat_int_map, "|      flat_map       |", SCALE_S(LEN1),
+                     SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    PASSED;
+#endif
+    std::cout
+        << "[---------------- End container test : flat_map ----------------]"
+        << std::endl;
+}
+
+void flat_multimap_test() {
+    std::cout
+        << "[===============================================================]"
+        << std::endl;
+    std::cout
+        << "[------------- Run container test : flat_multimap --------------]"
+        << std::endl;
+    std::cout
+        << "[-------------------------- API test ---------------------------]"
+        << std::endl;
+    mystl::vector<PAIR> v;
+    for (int i = 0; i < 5; ++i)
+        v.push_back(PAIR(i, i));
+    mystl::flat_multimap<int, int> m1;
+    mystl::flat_multimap<int, int, mystl::greater<int>> m2;
+    mystl::flat_multimap<int, int> m3(v.begin(), v.end());
+    mystl::flat_multimap<int, int> m4(v.begin(), v.end());
+    mystl::flat_multimap<int, int> m5(m3);
+    mystl::flat_multimap<int, int> m6(std::move(m3));
+    mystl::flat_multimap<int, int> m7;
+    m7 = m4;
+    mystl::flat_multimap<int, int> m8;
+    m8 = std::move(m4);
+    mystl::flat_multimap<int, int> m9{PAIR(1, 1), PAIR(3, 2), PAIR(2, 3),
+                                      PAIR(3, 4)};
+    mystl::flat_multimap<int, int> m10;
+    m10 = {PAIR(1, 1), PAIR(3, 2), PAIR(2, 3), PAIR(3, 4)};
+
+    for (int i = 0; i < 5; ++i)
+        MAP_FUN_AFTER(m1, m1.emplace(i, i));
+    MAP_FUN_AFTER(m1, m1.emplace_hint(m1.begin(), 0, 0));
+    MAP_FUN_AFTER(m1, m1.erase(m1.begin()));
+    MAP_FUN_AFTER(m1, m1.erase(0));
+    MAP_FUN_AFTER(m1, m1.erase(1));
+    MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.end()));
+    for (int i = 0; i < 5; ++i)
+        MAP_FUN_AFTER(m1, m1.insert(PAIR(i, i)));
+    MAP_FUN_AFTER(m1, m1.insert(v.begin(), v.end()));
+    MAP_FUN_AFTER(m1, m1.insert(PAIR(5, 5)));
+    MAP_FUN_AFTER(m1, m1.insert(m1.end(), PAIR(5, 5)));
+    FUN_VALUE(m1.count(3));
+    MAP_VALUE(*m1.find(3));
+    MAP_VALUE(*m1.lower_bound(3));
+    MAP_VALUE(*m1.upper_bound(2));
+    auto first = *m1.equal_range(2).first;
+    auto second = *m1.equal_range(2).second;
+    std::cout << " m1.equal_range(2) : from <" << first.first << ", "
+              << first.second << "> to <" << second.first << ", "
+              << second.second << ">" << std::endl;
+    MAP_FUN_AFTER(m1, m1.erase(m1.begin()));
+    MAP_FUN_AFTER(m1, m1.erase(1));
+    MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.find(3)));
+    MAP_FUN_AFTER(m1, m1.clear());
+    MAP_FUN_AFTER(m1, m1.swap(m9));
+    MAP_FUN_AFTER(m1, m1.insert(PAIR(3, 3)));
+    MAP_VALUE(*m1.begin());
+    MAP_VALUE(*m1.rbegin());
+    std::cout << std::boolalpha;
+    FUN_VALUE(m1.empty());
+    FUN_VALUE((m5 == m6));
+    std::cout << std::noboolalpha;
+    FUN_VALUE(m1.size());
+    FUN_VALUE(m1.max_size());
+    PASSED;
+    std::cout
+        << "[------------- End container test : flat_multimap --------------]"
+        << std::endl;
+}
+
+void flat_set_test() {
+    std::cout
+        << "[===============================================================]"
+        << std::endl;
+    std::cout
+        << "[---------------- Run container test : flat_set ----------------]"
+        << std::endl;
+    std::cout
+        << "[-------------------------- API test ---------------------------]"
+        << std::endl;
+    int a[] = {5, 4, 3, 2, 1};
+    mystl::flat_set<int> s1;
+    mystl::flat_set<int, mystl::greater<int>> s2;
+    mystl::flat_set<int> s3(a, a + 5);
+    mystl::flat_set<int> s4(a, a + 5);
+    mystl::flat_set<int> s5(s3);
+    mystl::flat_set<int> s6(std::move(s3));
+    mystl::flat_set<int> s7;
+    s7 = s4;
+    mystl::flat_set<int> s8;
+    s8 = std::move(s4);
+    mystl::flat_set<int> s9{1, 2, 3, 4, 5};
+    mystl::flat_set<int> s10;
+    s10 = {1, 2, 3, 4, 5};
+
+    for (int i = 5; i > 0; --i)
+        FUN_AFTER(s1, s1.emplace(i));
+    FUN_AFTER(s1, s1.emplace_hint(s1.begin(), 0));
+    FUN_AFTER(s1, s1.erase(s1.begin()));
+    FUN_AFTER(s1, s1.erase(0));
+    FUN_AFTER(s1, s1.erase(1));
+    FUN_AFTER(s1, s1.erase(s1.begin(), s1.end()));
+    for (int i = 0; i < 5; ++i)
+        FUN_AFTER(s1, s1.insert(i));
+    FUN_AFTER(s1, s1.insert(a, a + 5));
+    FUN_AFTER(s1, s1.insert(s1.end(), 5));
+    FUN_VALUE(s1.count(5));
+    FUN_VALUE(*s1.find(3));
+    FUN_VALUE(*s1.lower_bound(3));
+    FUN_VALUE(*s1.upper_bound(3));
+    auto first = *s1.equal_range(3).first;
+    auto second = *s1.equal_range(3).second;
+    std::cout << " s1.equal_range(3) : from " << first << " to " << second
+              << std::endl;
+    FUN_AFTER(s1, s1.erase(s1.begin()));
+    FUN_AFTER(s1, s1.erase(1));
+    FUN_AFTER(s1, s1.erase(s1.begin(), s1.find(3)));
+    FUN_AFTER(s1, s1.clear());
+    FUN_AFTER(s1, s1.swap(s5));
+    FUN_VALUE(*s1.begin());
+    FUN_VALUE(*s1.rbegin());
+    std::cout << std::boolalpha;
+    FUN_VALUE(s1.empty());
+    FUN_VALUE((s1 == s9));
+    std::cout << std::noboolalpha;
+    FUN_VALUE(s1.size());
+    FUN_VALUE(s1.max_size());
+    PASSED;
+    std::cout
+        << "[---------------- End container test : flat_set ----------------]"
+        << std::endl;
+}
+
+}  // namespace flat_map_test
+}  // namespace test
+}  // namespace mystl
+#endif  // !MYTINYSTL_FLAT_MAP_TEST_H_
@@ -0,0 +1,177 @@
+#ifndef MYTINYSTL_HASH_TEST_H_
+#define MYTINYSTL_HASH_TEST_H_
+
+// hash test : 测试 mystl::hash 的接口，以及字节序列哈希的吞吐量与在
+// unordered_set 中的分布情况
+
+#include <vector>
+
+#include "../MyTinySTL/astring.h"
+#include "../MyTinySTL/functional.h"
+#include "../MyTinySTL/unordered_set.h"
+#include "test.h"
+
+namespace mystl {
+namespace test {
+namespace hash_test {
+
+// 作为对比的 FNV-1a 哈希，每次处理一个字节
+inline size_t fnv1a_hash(const unsigned char* first, size_t count) {
+#if (_MSC_VER && _WIN64) || ((__GNUC__ || __clang__) && __SIZEOF_POINTER__ == 8)
+    size_t result = 14695981039346656037ull;
+    const size_t prime = 1099511628211ull;
+#else
+    size_t result = 2166136261u;
+    const size_t prime = 16777619u;
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        result ^= (size_t)first[i];
+        result *= prime;
+    }
+    return result;
+}
+
+struct fnv1a_string_hash {
+    size_t operator()(const mystl::string& str) const noexcept {
+        return fnv1a_hash((const unsigned char*)str.data(), str.size());
+    }
+};
+
+struct bitwise_hash_fcn {
+    size_t operator()(const unsigned char* p, size_t n) const noexcept {
+        return mystl::bitwise_hash(p, n);
+    }
+};
+
+struct fnv1a_hash_fcn {
+    size_t operator()(const unsigned char* p, size_t n) const noexcept {
+        return fnv1a_hash(p, n);
+    }
+};
+
+// 吞吐量测试：在一段随机数据中依次取长度为 len 的片段做哈希，共处理约 total 字节
+#define HASH_SPEED_DO_TEST(fcn, len, total)                        \
+    do {                                                            \
+        srand((int)time(0));                                        \
+        clock_t start, end;                                         \
+        char buf[16];                                               \
+        std::vector<unsigned char> data(1 << 20);                   \
+        for (auto& ch : data)                                       \
+            ch = static_cast<unsigned char>(rand());                \
+        const size_t span = data.size() - len;                      \
+        const size_t times = (total) / (len);                       \
+        volatile size_t sink = 0;                                   \
+        fcn f;                                                      \
+        start = clock();                                            \
+        for (size_t i = 0, off = 0; i < times; ++i) {               \
+            sink += f(data.data() + off, len);                      \
+            off += len;                                             \
+            if (off > span)                                         \
+                off = 0;                                            \
+        }                                                           \
+        end = clock();                                              \
+        double sec = static_cast<double>(end - start) / CLOCKS_PER_SEC; \
+        double gbs = sec > 0 ? (double)times * len / sec / 1e9 : 0.0; \
+        std::snprintf(buf, sizeof(buf), "%.2f", gbs);              \
+        std::string t = buf;                                        \
+        t += "GB/s  |";                                             \
+        std::cout << std::setw(WIDE) << t;                          \
+    } while (0)
+
+#define HASH_SPEED_TEST(fcn, total)        \
+    HASH_SPEED_DO_TEST(fcn, 8, total);     \
+    HASH_SPEED_DO_TEST(fcn, 64, total);    \
+    HASH_SPEED_DO_TEST(fcn, 1024, total);
+
+// 分布测试：把 len 个前缀相同的字符串插入 unordered_set，
+// 输出 sum(b * (b + 1) / 2) 与随机均匀分布下期望值的比值，越接近 1.00 越好
+#define HASH_DIST_DO_TEST(hasher, len)                             \
+    do {                                                            \
+        char buf[64];                                               \
+        mystl::unordered_set<mystl::string, hasher> s;              \
+        for (size_t i = 0; i < len; ++i) {                          \
+            std::snprintf(buf, sizeof(buf), "user:%08zu", i);       \
+            s.insert(mystl::string(buf));                           \
+        }                                                           \
+        const double n = static_cast<double>(s.size());             \
+        const double m = static_cast<double>(s.bucket_count());     \
+        double sum = 0;                                             \
+        for (size_t b = 0; b < s.bucket_count(); ++b) {             \
+            const double k = static_cast<double>(s.bucket_size(b)); \
+            sum += k * (k + 1) / 2;                                 \
+        }                                                           \
+        const double expect = n / (2 * m) * (n + 2 * m - 1);        \
+        std::snprintf(buf, sizeof(buf), "%.2f", sum / expect);      \
+        std::string t = buf;                                        \
+        t += "      |";                                             \
+        std::cout << std::setw(WIDE) << t;                          \
+    } while (0)
+
+#define HASH_DIST_TEST(hasher, len1, len2, len3) \
+    HASH_DIST_DO_TEST(hasher, len1);             \
+    HASH_DIST_DO_TEST(hasher, len2);             \
+    HASH_DIST_DO_TEST(hasher, len3);
+
+void hash_test() {
+    std::cout
+        << "[===============================================================]"
+        << std::endl;
+    std::cout
+        << "[------------------ Run container test : hash ------------------]"
+        << std::endl;
+    std::cout
+        << "[-------------------------- API test ---------------------------]"
+        << std::endl;
+    mystl::string s1 = "hello";
+    mystl::string s2 = "hello, world! hello, world! hello, world! hello!";
+    FUN_VALUE(mystl::hash<int>()(520));
+    FUN_VALUE(mystl::hash<double>()(0.0));
+    FUN_VALUE(mystl::hash<double>()(-0.0));
+    FUN_VALUE(mystl::hash<double>()(1.5));
+    FUN_VALUE(mystl::hash<mystl::string>()(s1));
+    FUN_VALUE(mystl::hash<mystl::string>()(s2));
+    FUN_VALUE(mystl::bitwise_hash((const unsigned char*)"", 0));
+    FUN_VALUE(mystl::bitwise_hash((const unsigned char*)"hello", 5));
+    FUN_VALUE(mystl::bitwise_hash((const unsigned char*)"hello", 5, 1));
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout
+        << "[--------------------- Performance Testing ---------------------]"
+        << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout
+        << "|   bytes per hash    |       8     |      64     |    1024     |"
+        << std::endl;
+    std::cout << "|       fnv-1a        |";
+    HASH_SPEED_TEST(fnv1a_hash_fcn, LEN3 * 16);
+    std::cout << "\n|        mystl        |";
+    HASH_SPEED_TEST(bitwise_hash_fcn, LEN3 * 16);
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|   distribution      |";
+    TEST_LEN(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3), WIDE);
+    std::cout << "|       fnv-1a        |";
+    HASH_DIST_TEST(fnv1a_string_hash, SCALE_S(LEN1), SCALE_S(LEN2),
+                   SCALE_S(LEN3));
+    std::cout << "\n|        mystl        |";
+    HASH_DIST_TEST(mystl::hash<mystl::string>, SCALE_S(LEN1), SCALE_S(LEN2),
+                   SCALE_S(LEN3));
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    PASSED;
+#endif
+    std::cout
+        << "[------------------ End container test : hash ------------------]"
+        << std::endl;
+}
+
+}  // namespace hash_test
+}  // namespace test
+}  // namespace mystl
+#endif  // !MYTINYSTL_HASH_TEST_H_
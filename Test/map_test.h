@@ -1,7 +1,8 @@
 ﻿#ifndef MYTINYSTL_MAP_TEST_H_
 #define MYTINYSTL_MAP_TEST_H_
 
-// map test : 测试 map, multimap 的接口与它们 insert 的性能
+// map test : 测试 map, multimap 的接口与它们 insert、find 的性能，
+// 以及由有序数据整体构造、两个 map 求并集与交集的性能
 
 #include <map>
 
@@ -42,6 +43,85 @@ namespace map_test
     std::cout << " " << str << " : <" << it.first << "," << it.second << ">\n"; \
 } while(0)
 
+// 由有序数据构造：len 个键值递增的元素，逐个在尾部插入或用区间构造一次建成
+#define MAP_SORTED_BUILD_DO_TEST(bulk, len) do {             \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  mystl::vector<PAIR> v;                                     \
+  for (size_t i = 0; i < len; ++i)                           \
+    v.push_back(PAIR(static_cast<int>(i), 0));               \
+  start = clock();                                           \
+  {                                                          \
+    mystl::map<int, int> c;                                  \
+    if (bulk)                                                \
+      mystl::map<int, int>(v.begin(), v.end()).swap(c);      \
+    else                                                     \
+      for (size_t i = 0; i < len; ++i)                       \
+        c.insert(c.end(), v[i]);                             \
+    end = clock();                                           \
+  }                                                          \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 集合运算：两个各有 len 个元素、键值部分重叠的 map，逐个插入或 union_with / intersect_with
+#define MAP_SET_OP_DO_TEST(op, len) do {                     \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  mystl::vector<PAIR> va, vb;                                \
+  for (size_t i = 0; i < len; ++i)                           \
+  {                                                          \
+    va.push_back(PAIR(static_cast<int>(i * 2), 0));          \
+    vb.push_back(PAIR(static_cast<int>(i * 3), 0));          \
+  }                                                          \
+  mystl::map<int, int> a(va.begin(), va.end());              \
+  mystl::map<int, int> b(vb.begin(), vb.end());              \
+  start = clock();                                           \
+  if (op == 0)                                               \
+    a.insert(b.begin(), b.end());                            \
+  else if (op == 1)                                          \
+    a.union_with(b);                                         \
+  else                                                       \
+    a.intersect_with(b);                                     \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+#define MAP_SORTED_BUILD_TEST(len1, len2, len3)              \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|   insert at end     |";                    \
+  MAP_SORTED_BUILD_DO_TEST(false, len1);                     \
+  MAP_SORTED_BUILD_DO_TEST(false, len2);                     \
+  MAP_SORTED_BUILD_DO_TEST(false, len3);                     \
+  std::cout << "\n|   bulk build        |";                  \
+  MAP_SORTED_BUILD_DO_TEST(true, len1);                      \
+  MAP_SORTED_BUILD_DO_TEST(true, len2);                      \
+  MAP_SORTED_BUILD_DO_TEST(true, len3);
+
+#define MAP_SET_OP_TEST(len1, len2, len3)                    \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|   insert range      |";                    \
+  MAP_SET_OP_DO_TEST(0, len1);                               \
+  MAP_SET_OP_DO_TEST(0, len2);                               \
+  MAP_SET_OP_DO_TEST(0, len3);                               \
+  std::cout << "\n|   union_with        |";                  \
+  MAP_SET_OP_DO_TEST(1, len1);                               \
+  MAP_SET_OP_DO_TEST(1, len2);                               \
+  MAP_SET_OP_DO_TEST(1, len3);                               \
+  std::cout << "\n|   intersect_with    |";                  \
+  MAP_SET_OP_DO_TEST(2, len1);                               \
+  MAP_SET_OP_DO_TEST(2, len2);                               \
+  MAP_SET_OP_DO_TEST(2, len3);
+
 void map_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -83,6 +163,15 @@ void map_test()
   MAP_VALUE(*m1.find(3));
   MAP_VALUE(*m1.lower_bound(3));
   MAP_VALUE(*m1.upper_bound(2));
+  {
+    int keys[] = { 1,3,6 };
+    mystl::map<int, int>::iterator res[3];
+    m1.find_batch(keys, keys + 3, res);
+    MAP_VALUE(*res[1]);
+    bool found[3];
+    m1.contains_batch(keys, keys + 3, found);
+    FUN_VALUE(found[0] + found[1] + found[2]);
+  }
   auto first = *m1.equal_range(2).first;
   auto second = *m1.equal_range(2).second;
   std::cout << " m1.equal_range(2) : from <" << first.first << ", " << first.second
@@ -92,6 +181,8 @@ void map_test()
   MAP_FUN_AFTER(m1, m1.erase(m1.begin(), m1.find(3)));
   MAP_FUN_AFTER(m1, m1.clear());
   MAP_FUN_AFTER(m1, m1.swap(m9));
+  MAP_FUN_AFTER(m10, m10.union_with(mystl::map<int, int>{ PAIR(2,4),PAIR(4,4) }));
+  MAP_FUN_AFTER(m10, m10.intersect_with(mystl::map<int, int>{ PAIR(3,0),PAIR(4,0),PAIR(5,0) }));
   MAP_VALUE(*m1.begin());
   MAP_VALUE(*m1.rbegin());
   FUN_VALUE(m1[1]);
@@ -111,6 +202,30 @@ void map_test()
   MAP_EMPLACE_TEST(map, SCALE_L(LEN1), SCALE_L(LEN2), SCALE_L(LEN3));
 #else
   MAP_EMPLACE_TEST(map, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        find         |";
+#if LARGER_TEST_DATA_ON
+  MAP_LOOKUP_TEST(map, SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  MAP_LOOKUP_TEST(map, SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  build from sorted  |";
+#if LARGER_TEST_DATA_ON
+  MAP_SORTED_BUILD_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  MAP_SORTED_BUILD_TEST(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  union / intersect  |";
+#if LARGER_TEST_DATA_ON
+  MAP_SET_OP_TEST(SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+  MAP_SET_OP_TEST(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
@@ -178,6 +293,13 @@ void multimap_test()
   std::cout << std::noboolalpha;
   FUN_VALUE(m1.size());
   FUN_VALUE(m1.max_size());
+  mystl::multimap<int, int, mystl::less<int>,
+    mystl::allocator<mystl::pair<const int, int>>, true> m11{ PAIR(1,1),PAIR(3,2),PAIR(2,3),PAIR(3,4) };
+  MAP_VALUE(*m11.select(0));
+  MAP_VALUE(*m11.select(3));
+  FUN_VALUE(m11.rank(3));
+  MAP_FUN_AFTER(m11, m11.erase(m11.select(1)));
+  FUN_VALUE(m11.rank(3));
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
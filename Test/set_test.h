@@ -1,11 +1,13 @@
 ﻿#ifndef MYTINYSTL_SET_TEST_H_
 #define MYTINYSTL_SET_TEST_H_
 
-// set test : 测试 set, multiset 的接口与它们 insert 的性能
+// set test : 测试 set, multiset 的接口与它们 insert 的性能，
+// 以及维护子树大小的 multiset 做滑动窗口中位数的性能
 
 #include <set>
 
 #include "../MyTinySTL/set.h"
+#include "../MyTinySTL/vector.h"
 #include "test.h"
 
 namespace mystl
@@ -15,6 +17,61 @@ namespace test
 namespace set_test
 {
 
+typedef mystl::multiset<int>                                              plain_multiset;
+typedef mystl::multiset<int, mystl::less<int>, mystl::allocator<int>, true> ranked_multiset;
+
+// 取第 k 小的元素：普通 multiset 只能从 begin() 逐个前进，维护子树大小的 multiset 直接 select
+inline int kth_element(const plain_multiset& s, size_t k)
+{
+  auto it = s.begin();
+  mystl::advance(it, k);
+  return *it;
+}
+
+inline int kth_element(const ranked_multiset& s, size_t k)
+{
+  return *s.select(k);
+}
+
+// 滑动窗口中位数：在 n 个随机数上滑动大小为 w 的窗口，每一步插入新元素、删除最旧的元素并取中位数
+#define SET_MEDIAN_DO_TEST(mode, n, w) do {                    \
+  srand((int)time(0));                                         \
+  clock_t start, end;                                          \
+  char buf[10];                                                \
+  mystl::vector<int> v;                                        \
+  for (size_t i = 0; i < n; ++i)                               \
+    v.push_back(rand());                                       \
+  mode s;                                                      \
+  volatile long long sum = 0;                                  \
+  start = clock();                                             \
+  for (size_t i = 0; i < n; ++i)                               \
+  {                                                            \
+    s.insert(v[i]);                                            \
+    if (i >= w)                                                \
+      s.erase(s.find(v[i - w]));                               \
+    if (i + 1 >= w)                                            \
+      sum += kth_element(s, w / 2);                            \
+  }                                                            \
+  end = clock();                                               \
+  int t = static_cast<int>(static_cast<double>(end - start)    \
+    / CLOCKS_PER_SEC * 1000);                                  \
+  std::snprintf(buf, sizeof(buf), "%d", t);                    \
+  std::string str = buf;                                       \
+  str += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << str;                         \
+} while(0)
+
+#define SET_MEDIAN_TEST(n, w1, w2, w3)                         \
+  TEST_LEN(w1, w2, w3, WIDE);                                  \
+  std::cout << "|   iterator walk     |";                      \
+  SET_MEDIAN_DO_TEST(plain_multiset, n, w1);                   \
+  SET_MEDIAN_DO_TEST(plain_multiset, n, w2);                   \
+  SET_MEDIAN_DO_TEST(plain_multiset, n, w3);                   \
+  std::cout << "\n|       select        |";                    \
+  SET_MEDIAN_DO_TEST(ranked_multiset, n, w1);                  \
+  SET_MEDIAN_DO_TEST(ranked_multiset, n, w2);                  \
+  SET_MEDIAN_DO_TEST(ranked_multiset, n, w3);
+
 void set_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -142,6 +199,14 @@ void multiset_test()
   std::cout << std::noboolalpha;
   FUN_VALUE(s1.size());
   FUN_VALUE(s1.max_size());
+  ranked_multiset r1{ 5,3,3,1,4 };
+  FUN_VALUE(*r1.select(0));
+  FUN_VALUE(*r1.select(2));
+  FUN_VALUE(r1.rank(3));
+  FUN_VALUE(r1.rank(4));
+  FUN_AFTER(r1, r1.erase(3));
+  FUN_VALUE(*r1.select(1));
+  FUN_VALUE(r1.rank(6));
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -151,6 +216,14 @@ void multiset_test()
   CON_TEST_P1(multiset<int>, emplace, rand(), SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
 #else
   CON_TEST_P1(multiset<int>, emplace, rand(), SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  window median      |";
+#if LARGER_TEST_DATA_ON
+  SET_MEDIAN_TEST(SCALE_M(LEN1), LEN1 / 1000, LEN1 / 100, LEN1 / 10);
+#else
+  SET_MEDIAN_TEST(SCALE_S(LEN1), LEN1 / 1000, LEN1 / 100, LEN1 / 10);
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
@@ -0,0 +1,187 @@
+#ifndef MYTINYSTL_SMALL_VECTOR_TEST_H_
+#define MYTINYSTL_SMALL_VECTOR_TEST_H_
+
+// small_vector test : 测试 small_vector 的接口，并与 vector 对比大量短命的小向量
+// 的耗时与分配次数
+
+#include "../MyTinySTL/small_vector.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl {
+namespace test {
+namespace small_vector_test {
+
+// 统计 allocate 调用次数的分配器
+inline size_t& allocation_count() {
+    static size_t n = 0;
+    return n;
+}
+
+template <class T>
+class counting_allocator : public mystl::allocator<T> {
+public:
+    template <class U>
+    struct rebind {
+        typedef counting_allocator<U> other;
+    };
+
+    counting_allocator() noexcept = default;
+    template <class U>
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+
+    static T* allocate(size_t n) {
+        ++allocation_count();
+        return mystl::allocator<T>::allocate(n);
+    }
+};
+
+typedef mystl::vector<int, counting_allocator<int>> counted_vector;
+typedef mystl::small_vector<int, 8, counting_allocator<int>>
+    counted_small_vector;
+
+// 构造 count 个向量，每个 push_back elems 个元素后立即析构
+#define SMALL_VECTOR_LOOP(con, count, elems)                      \
+    for (size_t i = 0; i < count; ++i) {                           \
+        con v;                                                     \
+        for (size_t j = 0; j < elems; ++j)                         \
+            v.push_back(static_cast<int>(i + j));                  \
+        sum += v[elems / 2];                                       \
+    }
+
+// 耗时
+#define SMALL_VECTOR_TIME_DO_TEST(con, count, elems)              \
+    do {                                                           \
+        clock_t start, end;                                        \
+        char buf[10];                                              \
+        volatile long long sum = 0;                                \
+        start = clock();                                           \
+        SMALL_VECTOR_LOOP(con, count, elems)                       \
+        end = clock();                                             \
+        int n = static_cast<int>(static_cast<double>(end - start)  \
+                                 / CLOCKS_PER_SEC * 1000);         \
+        std::snprintf(buf, sizeof(buf), "%d", n);                  \
+        std::string t = buf;                                       \
+        t += "ms    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+// 分配次数，输出平均每个向量的分配次数
+#define SMALL_VECTOR_ALLOC_DO_TEST(con, count, elems)             \
+    do {                                                           \
+        char buf[10];                                              \
+        volatile long long sum = 0;                                \
+        allocation_count() = 0;                                    \
+        SMALL_VECTOR_LOOP(con, count, elems)                       \
+        std::snprintf(buf, sizeof(buf), "%.2f",                    \
+                      static_cast<double>(allocation_count()) /    \
+                          count);                                  \
+        std::string t = buf;                                       \
+        t += "      |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+#define SMALL_VECTOR_TEST(count, e1, e2, e3)                      \
+    TEST_LEN(e1, e2, e3, WIDE);                                    \
+    std::cout << "|    vector time      |";                        \
+    SMALL_VECTOR_TIME_DO_TEST(counted_vector, count, e1);          \
+    SMALL_VECTOR_TIME_DO_TEST(counted_vector, count, e2);          \
+    SMALL_VECTOR_TIME_DO_TEST(counted_vector, count, e3);          \
+    std::cout << "\n| small_vector time   |";                      \
+    SMALL_VECTOR_TIME_DO_TEST(counted_small_vector, count, e1);    \
+    SMALL_VECTOR_TIME_DO_TEST(counted_small_vector, count, e2);    \
+    SMALL_VECTOR_TIME_DO_TEST(counted_small_vector, count, e3);    \
+    std::cout << "\n|   vector allocs     |";                      \
+    SMALL_VECTOR_ALLOC_DO_TEST(counted_vector, count, e1);         \
+    SMALL_VECTOR_ALLOC_DO_TEST(counted_vector, count, e2);         \
+    SMALL_VECTOR_ALLOC_DO_TEST(counted_vector, count, e3);         \
+    std::cout << "\n| small_vector allocs |";                      \
+    SMALL_VECTOR_ALLOC_DO_TEST(counted_small_vector, count, e1);   \
+    SMALL_VECTOR_ALLOC_DO_TEST(counted_small_vector, count, e2);   \
+    SMALL_VECTOR_ALLOC_DO_TEST(counted_small_vector, count, e3);
+
+void small_vector_test() {
+    std::cout << "[===============================================================]\n";
+    std::cout << "[-------------- Run container test : small_vector --------------]\n";
+    std::cout << "[-------------------------- API test ---------------------------]\n";
+    int a[] = {1, 2, 3, 4, 5};
+    mystl::small_vector<int, 8> v1;
+    mystl::small_vector<int, 8> v2(10);
+    mystl::small_vector<int, 8> v3(10, 1);
+    mystl::small_vector<int, 8> v4(a, a + 5);
+    mystl::small_vector<int, 8> v5(v2);
+    mystl::small_vector<int, 8> v6(std::move(v2));
+    mystl::small_vector<int, 8> v7{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    mystl::small_vector<int, 8> v8, v9, v10;
+    v8 = v3;
+    v9 = std::move(v3);
+    v10 = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    FUN_AFTER(v1, v1.assign(8, 8));
+    FUN_AFTER(v1, v1.assign(a, a + 5));
+    FUN_AFTER(v1, v1.emplace(v1.begin(), 0));
+    FUN_AFTER(v1, v1.emplace_back(6));
+    FUN_AFTER(v1, v1.push_back(6));
+    std::cout << std::boolalpha;
+    FUN_VALUE(v1.is_inline());
+    FUN_AFTER(v1, v1.insert(v1.end(), 7));
+    FUN_VALUE(v1.is_inline());
+    std::cout << std::noboolalpha;
+    FUN_AFTER(v1, v1.insert(v1.begin() + 3, 2, 3));
+    FUN_AFTER(v1, v1.insert(v1.begin(), a, a + 5));
+    FUN_AFTER(v1, v1.pop_back());
+    FUN_AFTER(v1, v1.erase(v1.begin()));
+    FUN_AFTER(v1, v1.erase(v1.begin(), v1.begin() + 2));
+    FUN_AFTER(v1, v1.reverse());
+    FUN_AFTER(v1, v1.swap(v4));
+    FUN_VALUE(*v1.begin());
+    FUN_VALUE(*(v1.end() - 1));
+    FUN_VALUE(*v1.rbegin());
+    FUN_VALUE(*(v1.rend() - 1));
+    FUN_VALUE(v1.front());
+    FUN_VALUE(v1.back());
+    FUN_VALUE(v1[0]);
+    FUN_VALUE(v1.at(1));
+    std::cout << std::boolalpha;
+    FUN_VALUE(v1.empty());
+    FUN_VALUE(v1.is_inline());
+    FUN_VALUE((v7 == v10));
+    std::cout << std::noboolalpha;
+    FUN_VALUE(v1.size());
+    FUN_VALUE(v1.max_size());
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.resize(10));
+    FUN_VALUE(v1.size());
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.resize(6, 6));
+    FUN_AFTER(v1, v1.shrink_to_fit());
+    FUN_VALUE(v1.size());
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.clear());
+    FUN_AFTER(v1, v1.reserve(5));
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.reserve(20));
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.shrink_to_fit());
+    FUN_VALUE(v1.capacity());
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout << "[--------------------- Performance Testing ---------------------]\n";
+    std::cout << "|---------------------|-------------|-------------|-------------|\n";
+    std::cout << "|  elems per vector   |";
+#if LARGER_TEST_DATA_ON
+    SMALL_VECTOR_TEST(LEN3, 4, 8, 32);
+#else
+    SMALL_VECTOR_TEST(LEN2, 4, 8, 32);
+#endif
+    std::cout << "\n";
+    std::cout << "|---------------------|-------------|-------------|-------------|\n";
+    PASSED;
+#endif
+    std::cout << "[-------------- End container test : small_vector --------------]\n";
+}
+
+}  // namespace small_vector_test
+}  // namespace test
+}  // namespace mystl
+#endif  // !MYTINYSTL_SMALL_VECTOR_TEST_H_
@@ -1,9 +1,12 @@
 #ifndef MYTINYSTL_STRING_TEST_H_
 #define MYTINYSTL_STRING_TEST_H_
 
-// string test : 测试 string 的接口和 insert 的性能
+// string test : 测试 string 的接口和 insert 的性能，短字符串的构造、
+// 复制、移动、追加的性能，查找操作的吞吐量，以及各字符类型 char_traits 的吞吐量
 
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include "../MyTinySTL/astring.h"
 #include "test.h"
@@ -12,6 +15,141 @@ namespace mystl {
 namespace test {
 namespace string_test {
 
+// 短字符串的几种操作，src 为源字符串，s 为长度为 str_len 的字符串
+#define STR_CONSTRUCT_OP(str_type)         \
+    do {                                   \
+        str_type t(src, str_len);          \
+        sink += t.size();                  \
+    } while (0)
+
+#define STR_COPY_OP(str_type)              \
+    do {                                   \
+        str_type t(s);                     \
+        sink += t.size();                  \
+    } while (0)
+
+#define STR_MOVE_OP(str_type)              \
+    do {                                   \
+        str_type t(std::move(s));          \
+        s = std::move(t);                  \
+        sink += s.size();                  \
+    } while (0)
+
+#define STR_APPEND_OP(str_type)            \
+    do {                                   \
+        str_type t;                        \
+        t.append(src, str_len / 2);        \
+        t.append(src + str_len / 2, str_len - str_len / 2); \
+        sink += t.size();                  \
+    } while (0)
+
+// 对长度为 len 的字符串执行 count 次 op
+#define STR_SHORT_DO_TEST(str_type, op, len, count)                \
+    do {                                                            \
+        clock_t start, end;                                         \
+        char buf[10];                                               \
+        const char* src =                                           \
+            "0123456789abcdef0123456789abcdef"                      \
+            "0123456789abcdef0123456789abcdef";                     \
+        const size_t str_len = len;                                 \
+        str_type s(src, str_len);                                   \
+        volatile size_t sink = 0;                                   \
+        start = clock();                                            \
+        for (size_t i = 0; i < count; ++i)                          \
+            op(str_type);                                           \
+        end = clock();                                              \
+        int n = static_cast<int>(static_cast<double>(end - start)   \
+                                 / CLOCKS_PER_SEC * 1000);          \
+        std::snprintf(buf, sizeof(buf), "%d", n);                   \
+        std::string t = buf;                                        \
+        t += "ms    |";                                             \
+        std::cout << std::setw(WIDE) << t;                          \
+    } while (0)
+
+#define STR_SHORT_TEST(str_type, op, count)          \
+    STR_SHORT_DO_TEST(str_type, op, 8, count);       \
+    STR_SHORT_DO_TEST(str_type, op, 24, count);      \
+    STR_SHORT_DO_TEST(str_type, op, 64, count);
+
+// 几种查找操作，h 为只含小写字母的字符串，都会找不到从而扫描整个字符串
+#define STR_MEMCHR_OP(h) \
+    (std::memchr(h.data(), '#', h.size()) == nullptr ? 0 : 1)
+#define STR_FIND_CHAR_OP(h) h.find('#')
+#define STR_FIND_OP(h) h.find("needle")
+#define STR_RFIND_OP(h) h.rfind("needle")
+#define STR_FIND_FIRST_OF_OP(h) h.find_first_of("#$%&")
+#define STR_FIND_FIRST_NOT_OF_OP(h) \
+    h.find_first_not_of("abcdefghijklmnopqrstuvwxyz")
+
+// 在长度为 len 的字符串上重复 op，共扫描约 total 字节，输出吞吐量
+#define STR_SEARCH_DO_TEST(str_type, op, len, total)               \
+    do {                                                            \
+        srand((int)time(0));                                        \
+        clock_t start, end;                                         \
+        char buf[16];                                               \
+        std::vector<char> data(len);                                \
+        for (auto& ch : data)                                       \
+            ch = static_cast<char>('a' + rand() % 26);              \
+        const str_type h(data.data(), data.size());                 \
+        const size_t times = (total) / (len);                       \
+        volatile size_t sink = 0;                                   \
+        start = clock();                                            \
+        for (size_t i = 0; i < times; ++i)                          \
+            sink += op(h);                                          \
+        end = clock();                                              \
+        double sec = static_cast<double>(end - start) / CLOCKS_PER_SEC; \
+        double gbs = sec > 0 ? (double)times * len / sec / 1e9 : 0.0; \
+        std::snprintf(buf, sizeof(buf), "%.2f", gbs);              \
+        std::string t = buf;                                        \
+        t += "GB/s  |";                                             \
+        std::cout << std::setw(WIDE) << t;                          \
+    } while (0)
+
+#define STR_SEARCH_TEST(str_type, op, total)          \
+    STR_SEARCH_DO_TEST(str_type, op, 64, total);      \
+    STR_SEARCH_DO_TEST(str_type, op, 1024, total);    \
+    STR_SEARCH_DO_TEST(str_type, op, 65536, total);
+
+// char_traits 的几种操作，a、b 为内容相同的 n 个字符，ch 不在其中
+#define TRAITS_COMPARE_OP(traits) traits::compare(a, b, n)
+#define TRAITS_FIND_OP(traits) (traits::find(a, n, ch) == nullptr ? 0 : 1)
+#define TRAITS_COPY_OP(traits) (traits::copy(b, a, n) == b ? 1 : 0)
+
+// 对 4096 个字符重复 op，共处理约 total 字节，输出吞吐量
+#define TRAITS_DO_TEST(traits, op, total)                          \
+    do {                                                            \
+        typedef traits::char_type char_type;                        \
+        clock_t start, end;                                         \
+        char buf[16];                                               \
+        const size_t n = 4096;                                      \
+        std::vector<char_type> va(n, char_type('a'));               \
+        std::vector<char_type> vb(n, char_type('a'));               \
+        const char_type* a = va.data();                             \
+        char_type* b = vb.data();                                   \
+        const char_type ch = char_type('#');                        \
+        const size_t times = (total) / (n * sizeof(char_type));     \
+        (void)b;                                                    \
+        (void)ch;                                                   \
+        volatile int sink = 0;                                      \
+        start = clock();                                            \
+        for (size_t i = 0; i < times; ++i)                          \
+            sink += op(traits);                                     \
+        end = clock();                                              \
+        double sec = static_cast<double>(end - start) / CLOCKS_PER_SEC; \
+        double gbs =                                                \
+            sec > 0 ? (double)times * n * sizeof(char_type) / sec / 1e9 \
+                    : 0.0;                                          \
+        std::snprintf(buf, sizeof(buf), "%.2f", gbs);              \
+        std::string t = buf;                                        \
+        t += "GB/s  |";                                             \
+        std::cout << std::setw(WIDE) << t;                          \
+    } while (0)
+
+#define TRAITS_TEST(traits, total)                   \
+    TRAITS_DO_TEST(traits, TRAITS_COMPARE_OP, total); \
+    TRAITS_DO_TEST(traits, TRAITS_FIND_OP, total);    \
+    TRAITS_DO_TEST(traits, TRAITS_COPY_OP, total);
+
 void string_test() {
     std::cout
         << "[===============================================================]"
@@ -203,6 +341,77 @@ void string_test() {
     CON_TEST_P1(string, append, "s", SCALE_L(LEN1), SCALE_L(LEN2),
                 SCALE_L(LEN3));
 #endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout
+        << "|   bytes per string  |       8     |      24     |      64     |"
+        << std::endl;
+    std::cout << "|   construct (std)   |";
+    STR_SHORT_TEST(std::string, STR_CONSTRUCT_OP, LEN3);
+    std::cout << "\n|   construct (mystl) |";
+    STR_SHORT_TEST(mystl::string, STR_CONSTRUCT_OP, LEN3);
+    std::cout << "\n|     copy (std)      |";
+    STR_SHORT_TEST(std::string, STR_COPY_OP, LEN3);
+    std::cout << "\n|     copy (mystl)    |";
+    STR_SHORT_TEST(mystl::string, STR_COPY_OP, LEN3);
+    std::cout << "\n|     move (std)      |";
+    STR_SHORT_TEST(std::string, STR_MOVE_OP, LEN3);
+    std::cout << "\n|     move (mystl)    |";
+    STR_SHORT_TEST(mystl::string, STR_MOVE_OP, LEN3);
+    std::cout << "\n|    append (std)     |";
+    STR_SHORT_TEST(std::string, STR_APPEND_OP, LEN3);
+    std::cout << "\n|    append (mystl)   |";
+    STR_SHORT_TEST(mystl::string, STR_APPEND_OP, LEN3);
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout
+        << "|   bytes per search  |      64     |    1024     |   65536     |"
+        << std::endl;
+    std::cout << "|    memchr (char)    |";
+    STR_SEARCH_TEST(std::string, STR_MEMCHR_OP, LEN3 * 16);
+    std::cout << "\n|    find (std char)  |";
+    STR_SEARCH_TEST(std::string, STR_FIND_CHAR_OP, LEN3 * 16);
+    std::cout << "\n|   find (mystl char) |";
+    STR_SEARCH_TEST(mystl::string, STR_FIND_CHAR_OP, LEN3 * 16);
+    std::cout << "\n|     find (std)      |";
+    STR_SEARCH_TEST(std::string, STR_FIND_OP, LEN3 * 16);
+    std::cout << "\n|     find (mystl)    |";
+    STR_SEARCH_TEST(mystl::string, STR_FIND_OP, LEN3 * 16);
+    std::cout << "\n|     rfind (std)     |";
+    STR_SEARCH_TEST(std::string, STR_RFIND_OP, LEN3 * 16);
+    std::cout << "\n|    rfind (mystl)    |";
+    STR_SEARCH_TEST(mystl::string, STR_RFIND_OP, LEN3 * 16);
+    std::cout << "\n| first_of (std)      |";
+    STR_SEARCH_TEST(std::string, STR_FIND_FIRST_OF_OP, LEN3 * 16);
+    std::cout << "\n| first_of (mystl)    |";
+    STR_SEARCH_TEST(mystl::string, STR_FIND_FIRST_OF_OP, LEN3 * 16);
+    std::cout << "\n| first_not_of (std)  |";
+    STR_SEARCH_TEST(std::string, STR_FIND_FIRST_NOT_OF_OP, LEN3 * 16);
+    std::cout << "\n| first_not_of (mystl)|";
+    STR_SEARCH_TEST(mystl::string, STR_FIND_FIRST_NOT_OF_OP, LEN3 * 16);
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout
+        << "| char_traits, 4096   |   compare   |    find     |    copy     |"
+        << std::endl;
+    std::cout << "|     char (std)      |";
+    TRAITS_TEST(std::char_traits<char>, LEN3 * 64);
+    std::cout << "\n|     char (mystl)    |";
+    TRAITS_TEST(mystl::char_traits<char>, LEN3 * 64);
+    std::cout << "\n|   char16_t (std)    |";
+    TRAITS_TEST(std::char_traits<char16_t>, LEN3 * 64);
+    std::cout << "\n|   char16_t (mystl)  |";
+    TRAITS_TEST(mystl::char_traits<char16_t>, LEN3 * 64);
+    std::cout << "\n|   char32_t (std)    |";
+    TRAITS_TEST(std::char_traits<char32_t>, LEN3 * 64);
+    std::cout << "\n|   char32_t (mystl)  |";
+    TRAITS_TEST(mystl::char_traits<char32_t>, LEN3 * 64);
     std::cout << std::endl;
     std::cout
         << "|---------------------|-------------|-------------|-------------|"
@@ -648,6 +648,137 @@ void test_len(size_t len1, size_t len2, size_t len3, size_t wide)
   std::cout << std::setw(WIDE) << t;                         \
 } while(0)
 
+// 查找性能测试：先插入 len 个随机键，再查找 len 个键，约一半命中
+// batch 为 false 时逐个调用 count，为 true 时调用一次 contains_batch
+#define MAP_LOOKUP_DO_TEST(con, len, batch)   do {           \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  mystl::con<int, int> c;                                    \
+  char buf[10];                                              \
+  std::vector<int> keys(len), query(len);                    \
+  for (size_t i = 0; i < len;   ++i) {                       \
+    keys[i] = rand();                                        \
+    c.emplace(keys[i], 0);                                   \
+  }                                                          \
+  for (size_t i = 0; i < len;   ++i)                         \
+    query[i] = (i & 1) ? rand() : keys[rand() % len]  ;      \
+  std::vector<char> found(len);                              \
+  start = clock();                                           \
+  if (batch) {                                               \
+    c.contains_batch(query.begin(), query.end(), found.begin()); \
+  } else {                                                   \
+    for (size_t i = 0; i < len;   ++i)                       \
+      found[i] = c.find(query[i]) != c.end();                \
+  }                                                          \
+  end = clock();                                             \
+  volatile size_t hit = 0;                                   \
+  for (size_t i = 0; i < len;   ++i)                         \
+    hit += found[i];                                         \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 有序关联容器的性能测试，con 为 mystl::pair<int, int> 的容器
+// build 决定如何由键值对数组 v 得到容器 c：ORDERED_RANGE_BUILD 用区间构造，
+// ORDERED_EMPLACE_BUILD 逐个 emplace
+#define ORDERED_RANGE_BUILD(con, c, v)                       \
+  con c(v.begin(), v.end())
+
+#define ORDERED_EMPLACE_BUILD(con, c, v)                     \
+  con c;                                                     \
+  for (size_t k = 0; k < v.size(); ++k)                      \
+    c.emplace(v[k].first, v[k].second)
+
+// 构造性能测试：由 len 个无序的随机键值得到容器
+#define ORDERED_BUILD_DO_TEST(build, con, len) do {          \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  mystl::vector<mystl::pair<int, int>> v;                    \
+  for (size_t i = 0; i < len; ++i)                           \
+    v.push_back(mystl::make_pair(rand(), static_cast<int>(i))); \
+  start = clock();                                           \
+  build(con, c, v);                                          \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 查找性能测试：放入 len 个元素后，查找 len 个随机键，约一半命中
+#define ORDERED_FIND_DO_TEST(build, con, len) do {           \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  mystl::vector<mystl::pair<int, int>> v;                    \
+  for (size_t i = 0; i < len; ++i)                           \
+    v.push_back(mystl::make_pair(static_cast<int>(i * 2),    \
+                                 static_cast<int>(i)));      \
+  build(con, c, v);                                          \
+  mystl::vector<int> keys;                                   \
+  for (size_t i = 0; i < len; ++i)                           \
+    keys.push_back(static_cast<int>(rand() % (len * 2)));    \
+  volatile size_t found = 0;                                 \
+  start = clock();                                           \
+  for (size_t i = 0; i < len; ++i)                           \
+    found += c.count(keys[i]);                               \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 遍历性能测试：放入 len 个随机元素后，完整遍历 10 次并累加实值
+#define ORDERED_ITER_DO_TEST(build, con, len) do {           \
+  srand((int)time(0));                                       \
+  clock_t start, end;                                        \
+  char buf[10];                                              \
+  mystl::vector<mystl::pair<int, int>> v;                    \
+  for (size_t i = 0; i < len; ++i)                           \
+    v.push_back(mystl::make_pair(rand(), static_cast<int>(i))); \
+  build(con, c, v);                                          \
+  volatile long long sum = 0;                                \
+  start = clock();                                           \
+  for (int r = 0; r < 10; ++r) {                             \
+    long long s = 0;                                         \
+    for (auto it = c.begin(); it != c.end(); ++it)           \
+      s += it->second;                                       \
+    sum += s;                                                \
+  }                                                          \
+  end = clock();                                             \
+  int n = static_cast<int>(static_cast<double>(end - start)  \
+      / CLOCKS_PER_SEC * 1000);                              \
+  std::snprintf(buf, sizeof(buf), "%d", n);                  \
+  std::string t = buf;                                       \
+  t += "ms    |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
+// 内存测试：放入 len 个随机元素后，输出 bytes_per_element(c)
+#define ORDERED_MEMORY_DO_TEST(build, con, len) do {         \
+  srand((int)time(0));                                       \
+  char buf[10];                                              \
+  mystl::vector<mystl::pair<int, int>> v;                    \
+  for (size_t i = 0; i < len; ++i)                           \
+    v.push_back(mystl::make_pair(rand(), static_cast<int>(i))); \
+  build(con, c, v);                                          \
+  std::snprintf(buf, sizeof(buf), "%d",                      \
+                static_cast<int>(bytes_per_element(c)));     \
+  std::string t = buf;                                       \
+  t += "B     |";                                            \
+  std::cout << std::setw(WIDE) << t;                         \
+} while(0)
+
 // 重构重复代码
 #define CON_TEST_P1(con, fun, arg, len1, len2, len3)         \
   TEST_LEN(len1, len2, len3, WIDE);                          \
@@ -682,6 +813,29 @@ void test_len(size_t len1, size_t len2, size_t len3, size_t wide)
   MAP_EMPLACE_DO_TEST(mystl, con, len2);                     \
   MAP_EMPLACE_DO_TEST(mystl, con, len3);
 
+#define MAP_LOOKUP_TEST(con, len1, len2, len3)               \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|      find loop      |";                    \
+  MAP_LOOKUP_DO_TEST(con, len1, false);                      \
+  MAP_LOOKUP_DO_TEST(con, len2, false);                      \
+  MAP_LOOKUP_DO_TEST(con, len3, false);                      \
+  std::cout << "\n|     find batch      |";                  \
+  MAP_LOOKUP_DO_TEST(con, len1, true);                       \
+  MAP_LOOKUP_DO_TEST(con, len2, true);                       \
+  MAP_LOOKUP_DO_TEST(con, len3, true);
+
+// 有序关联容器与 int_map（调用处定义的 mystl::map<int, int>）对比，label 为 con 一行的标题
+#define ORDERED_MAP_TEST(do_test, build, con, label, len1, len2, len3) \
+  TEST_LEN(len1, len2, len3, WIDE);                          \
+  std::cout << "|         map         |";                    \
+  do_test(build, int_map, len1);                             \
+  do_test(build, int_map, len2);                             \
+  do_test(build, int_map, len3);                             \
+  std::cout << "\n" << label;                                \
+  do_test(build, con, len1);                                 \
+  do_test(build, con, len2);                                 \
+  do_test(build, con, len3);
+
 #define LIST_SORT_TEST(len1, len2, len3)                     \
   TEST_LEN(len1, len2, len3, WIDE);                          \
   std::cout << "|         std         |";                    \
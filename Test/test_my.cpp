@@ -30,12 +30,19 @@ STL（标准模板库）中的安全检查机制。
 #include "queue_test.h"
 #include "string_test.h"
 #include "vector_test.h"
+#include "vector_bool_test.h"
+#include "small_vector_test.h"
 #include "stack_test.h"
 #include "list_test.h"
 #include "set_test.h"
 #include "map_test.h"
 #include "unordered_map_test.h"
 #include "unordered_set_test.h"
+#include "flat_hash_map_test.h"
+#include "flat_map_test.h"
+#include "btree_map_test.h"
+#include "hash_test.h"
+#include "allocator_test.h"
 #include "algorithm_performance_test.h"
 
 int main() {
@@ -51,6 +58,8 @@ int main() {
     RUN_ALL_TESTS();
     algorithm_performance_test::algorithm_performance_test();
     vector_test::vector_test();
+    vector_bool_test::vector_bool_test();
+    small_vector_test::small_vector_test();
     string_test::string_test();
     deque_test::deque_test();
     queue_test::queue_test();
@@ -65,6 +74,16 @@ int main() {
     unordered_map_test::unordered_multimap_test();
     unordered_set_test::unordered_set_test();
     unordered_set_test::unordered_multiset_test();
+    flat_hash_map_test::flat_hash_map_test();
+    flat_hash_map_test::flat_hash_set_test();
+    flat_map_test::flat_map_test();
+    flat_map_test::flat_multimap_test();
+    flat_map_test::flat_set_test();
+    btree_map_test::btree_map_test();
+    btree_map_test::btree_multimap_test();
+    btree_map_test::btree_set_test();
+    hash_test::hash_test();
+    allocator_test::allocator_test();
 
 // 使用 _CrtDumpMemoryLeaks()
 // 函数可以在程序退出时检查是否有内存泄漏。这个函数只有在程序以调试模式（Debug）编译时才会有效
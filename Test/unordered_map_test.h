@@ -2,10 +2,12 @@
 #define MYTINYSTL_UNORDERED_MAP_TEST_H_
 
 // unordered_map test : 测试 unordered_map, unordered_multimap 的接口与它们
-// insert 的性能
+// insert、rehash、find 的性能
 
+#include <string>
 #include <unordered_map>
 
+#include "../MyTinySTL/astring.h"
 #include "../MyTinySTL/unordered_map.h"
 #include "map_test.h"
 #include "test.h"
@@ -14,6 +16,151 @@ namespace mystl {
 namespace test {
 namespace unordered_map_test {
 
+// 生成测试用的键
+inline int int_key(int n) {
+    return n;
+}
+
+// 分散在整个 int 范围内、近似随机的整数键，避免连续的键恰好落在不同的 bucket 中
+inline int scattered_int_key(int n) {
+    auto x = static_cast<unsigned>(n);
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return static_cast<int>(x);
+}
+
+template <class Str>
+Str str_key(int n) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "unordered_map_key_%d", n);
+    return Str(buf);
+}
+
+// 64 字节的长字符串键，前缀相同
+template <class Str>
+Str long_str_key(int n) {
+    char buf[80];
+    std::snprintf(buf, sizeof(buf), "http://example.com/unordered_map/%031d", n);
+    return Str(buf);
+}
+
+// 不缓存哈希值的字符串哈希函数，用于对比节点缓存哈希值的效果
+struct uncached_string_hash : public mystl::hash<mystl::string> {};
+
+// 使用 2 的幂次个 bucket 的整数哈希函数，用于对比质数取模的效果
+struct pow2_int_hash : public mystl::hash<int> {};
+
+}  // namespace unordered_map_test
+}  // namespace test
+
+template <>
+struct pow2_bucket_count<test::unordered_map_test::pow2_int_hash>
+    : public mystl::m_true_type {};
+
+namespace test {
+namespace unordered_map_test {
+
+// 扩容性能测试：先插入 count 个元素，再测量把 bucket 数量扩大一倍的耗时
+#define MAP_REHASH_DO_TEST(con, key, count)                   \
+    do {                                                       \
+        srand((int)time(0));                                   \
+        clock_t start, end;                                    \
+        con c;                                                 \
+        char buf[10];                                          \
+        for (size_t i = 0; i < count; ++i)                     \
+            c.emplace(key(rand()), static_cast<int>(i));       \
+        start = clock();                                       \
+        c.rehash(c.bucket_count() * 2);                        \
+        end = clock();                                         \
+        int n = static_cast<int>(static_cast<double>(end - start) \
+                                 / CLOCKS_PER_SEC * 1000);     \
+        std::snprintf(buf, sizeof(buf), "%d", n);              \
+        std::string t = buf;                                   \
+        t += "ms    |";                                        \
+        std::cout << std::setw(WIDE) << t;                     \
+    } while (0)
+
+#define MAP_REHASH_TEST(std_con, std_key, my_con, my_key, len1, len2, len3) \
+    TEST_LEN(len1, len2, len3, WIDE);                                     \
+    std::cout << "|         std         |";                               \
+    MAP_REHASH_DO_TEST(std_con, std_key, len1);                           \
+    MAP_REHASH_DO_TEST(std_con, std_key, len2);                           \
+    MAP_REHASH_DO_TEST(std_con, std_key, len3);                           \
+    std::cout << "\n|        mystl        |";                             \
+    MAP_REHASH_DO_TEST(my_con, my_key, len1);                             \
+    MAP_REHASH_DO_TEST(my_con, my_key, len2);                             \
+    MAP_REHASH_DO_TEST(my_con, my_key, len3);
+
+// 查找性能测试：先插入 len 个元素，再查找 len 次，命中与未命中约各占一半
+#define MAP_FIND_DO_TEST(con, key, len)                           \
+    do {                                                           \
+        srand((int)time(0));                                       \
+        clock_t start, end;                                        \
+        con c;                                                     \
+        char buf[10];                                              \
+        std::vector<con::key_type> keys;                           \
+        for (size_t i = 0; i < len; ++i) {                         \
+            c.emplace(key(static_cast<int>(i)), static_cast<int>(i)); \
+            keys.push_back(key(rand() % (len * 2)));               \
+        }                                                          \
+        volatile size_t found = 0;                                 \
+        start = clock();                                           \
+        for (size_t i = 0; i < len; ++i)                           \
+            found += c.count(keys[i]);                             \
+        end = clock();                                             \
+        int n = static_cast<int>(static_cast<double>(end - start)  \
+                                 / CLOCKS_PER_SEC * 1000);         \
+        std::snprintf(buf, sizeof(buf), "%d", n);                  \
+        std::string t = buf;                                       \
+        t += "ms    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+// 热查找性能测试：插入 len 个元素后，循环查找共 total 次，命中与未命中约各占一半
+// 表格较小时主要测量定位 bucket 的计算开销
+#define MAP_HOT_FIND_DO_TEST(con, key, len, total)                \
+    do {                                                           \
+        srand((int)time(0));                                       \
+        clock_t start, end;                                        \
+        con c;                                                     \
+        char buf[10];                                              \
+        std::vector<con::key_type> keys;                           \
+        for (size_t i = 0; i < len; ++i) {                         \
+            c.emplace(key(static_cast<int>(i)), static_cast<int>(i)); \
+            keys.push_back(key(rand() % (len * 2)));               \
+        }                                                          \
+        volatile size_t found = 0;                                 \
+        start = clock();                                           \
+        for (size_t i = 0, j = 0; i < total; ++i, ++j) {           \
+            if (j == len)                                          \
+                j = 0;                                             \
+            found += c.count(keys[j]);                             \
+        }                                                          \
+        end = clock();                                             \
+        int n = static_cast<int>(static_cast<double>(end - start)  \
+                                 / CLOCKS_PER_SEC * 1000);         \
+        std::snprintf(buf, sizeof(buf), "%d", n);                  \
+        std::string t = buf;                                       \
+        t += "ms    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+#define MAP_HOT_FIND_TEST(con, len1, len2, len3, total)           \
+    MAP_HOT_FIND_DO_TEST(con, scattered_int_key, len1, total);     \
+    MAP_HOT_FIND_DO_TEST(con, scattered_int_key, len2, total);     \
+    MAP_HOT_FIND_DO_TEST(con, scattered_int_key, len3, total);
+
+typedef std::unordered_map<int, int> std_int_map;
+typedef mystl::unordered_map<int, int> mystl_int_map;
+typedef std::unordered_map<std::string, int> std_str_map;
+typedef mystl::unordered_map<mystl::string, int> mystl_str_map;
+typedef mystl::unordered_map<mystl::string, int, uncached_string_hash>
+    mystl_uncached_str_map;
+typedef mystl::unordered_map<int, int, pow2_int_hash> mystl_pow2_int_map;
+
 void unordered_map_test() {
     std::cout
         << "[===============================================================]"
@@ -88,6 +235,15 @@ void unordered_map_test() {
     FUN_VALUE(um1.bucket_count());
     FUN_VALUE(um1.count(1));
     MAP_VALUE(*um1.find(3));
+    {
+        int keys[] = {1, 3, 1000};
+        mystl::unordered_map<int, int>::iterator res[3];
+        um1.find_batch(keys, keys + 3, res);
+        MAP_VALUE(*res[1]);
+        bool found[3];
+        um1.contains_batch(keys, keys + 3, found);
+        FUN_VALUE(found[0] + found[1] + found[2]);
+    }
     auto first = *um1.equal_range(3).first;
     auto second = *um1.equal_range(3).second;
     std::cout << " um1.equal_range(3) : from <" << first.first << ", "
@@ -112,6 +268,83 @@ void unordered_map_test() {
 #else
     MAP_EMPLACE_TEST(unordered_map, SCALE_S(LEN1), SCALE_S(LEN2),
                      SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|    rehash <int>     |";
+#if LARGER_TEST_DATA_ON
+    MAP_REHASH_TEST(std_int_map, int_key, mystl_int_map, int_key,
+                    SCALE_M(LEN1), SCALE_M(LEN2), SCALE_M(LEN3));
+#else
+    MAP_REHASH_TEST(std_int_map, int_key, mystl_int_map, int_key,
+                    SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|   rehash <string>   |";
+#if LARGER_TEST_DATA_ON
+    MAP_REHASH_TEST(std_str_map, str_key<std::string>, mystl_str_map,
+                    str_key<mystl::string>, SCALE_M(LEN1), SCALE_M(LEN2),
+                    SCALE_M(LEN3));
+#else
+    MAP_REHASH_TEST(std_str_map, str_key<std::string>, mystl_str_map,
+                    str_key<mystl::string>, SCALE_S(LEN1), SCALE_S(LEN2),
+                    SCALE_S(LEN3));
+#endif
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|      find <int>     |";
+    TEST_LEN(SCALE_SS(LEN1), SCALE_SS(LEN2), SCALE_SS(LEN3), WIDE);
+    std::cout << "|         std         |";
+    MAP_HOT_FIND_TEST(std_int_map, SCALE_SS(LEN1), SCALE_SS(LEN2),
+                      SCALE_SS(LEN3), LEN3);
+    std::cout << "\n|    mystl (prime)    |";
+    MAP_HOT_FIND_TEST(mystl_int_map, SCALE_SS(LEN1), SCALE_SS(LEN2),
+                      SCALE_SS(LEN3), LEN3);
+    std::cout << "\n|    mystl (pow2)     |";
+    MAP_HOT_FIND_TEST(mystl_pow2_int_map, SCALE_SS(LEN1), SCALE_SS(LEN2),
+                      SCALE_SS(LEN3), LEN3);
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "| find <long string>  |";
+    TEST_LEN(SCALE_S(LEN1), SCALE_S(LEN2), SCALE_S(LEN3), WIDE);
+    std::cout << "|         std         |";
+    MAP_FIND_DO_TEST(std_str_map, long_str_key<std::string>, SCALE_S(LEN1));
+    MAP_FIND_DO_TEST(std_str_map, long_str_key<std::string>, SCALE_S(LEN2));
+    MAP_FIND_DO_TEST(std_str_map, long_str_key<std::string>, SCALE_S(LEN3));
+    std::cout << "\n|  mystl (no cache)   |";
+    MAP_FIND_DO_TEST(mystl_uncached_str_map, long_str_key<mystl::string>,
+                     SCALE_S(LEN1));
+    MAP_FIND_DO_TEST(mystl_uncached_str_map, long_str_key<mystl::string>,
+                     SCALE_S(LEN2));
+    MAP_FIND_DO_TEST(mystl_uncached_str_map, long_str_key<mystl::string>,
+                     SCALE_S(LEN3));
+    std::cout << "\n|        mystl        |";
+    MAP_FIND_DO_TEST(mystl_str_map, long_str_key<mystl::string>,
+                     SCALE_S(LEN1));
+    MAP_FIND_DO_TEST(mystl_str_map, long_str_key<mystl::string>,
+                     SCALE_S(LEN2));
+    MAP_FIND_DO_TEST(mystl_str_map, long_str_key<mystl::string>,
+                     SCALE_S(LEN3));
+    std::cout << std::endl;
+    std::cout
+        << "|---------------------|-------------|-------------|-------------|"
+        << std::endl;
+    std::cout << "|        find         |";
+#if LARGER_TEST_DATA_ON
+    MAP_LOOKUP_TEST(unordered_map, SCALE_M(LEN1), SCALE_M(LEN2),
+                    SCALE_M(LEN3));
+#else
+    MAP_LOOKUP_TEST(unordered_map, SCALE_S(LEN1), SCALE_S(LEN2),
+                    SCALE_S(LEN3));
 #endif
     std::cout << std::endl;
     std::cout
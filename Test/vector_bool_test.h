@@ -0,0 +1,193 @@
+#ifndef MYTINYSTL_VECTOR_BOOL_TEST_H_
+#define MYTINYSTL_VECTOR_BOOL_TEST_H_
+
+// vector<bool> test : 测试按位压缩的 vector<bool> 的接口，并与 vector<char>、
+// std::vector<bool> 对比 count、find、fill、copy、equal 的耗时与占用的内存
+
+#include <algorithm>
+#include <vector>
+
+#include "../MyTinySTL/algo.h"
+#include "../MyTinySTL/vector.h"
+#include "test.h"
+
+namespace mystl {
+namespace test {
+namespace vector_bool_test {
+
+// 每种操作重复的次数
+#define BIT_REPEAT 10
+
+// 耗时，语句重复 BIT_REPEAT 次
+#define BIT_OP_DO_TEST(...)                                       \
+    do {                                                           \
+        clock_t start, end;                                        \
+        char buf[10];                                              \
+        start = clock();                                           \
+        for (int r = 0; r < BIT_REPEAT; ++r) {                     \
+            __VA_ARGS__;                                           \
+        }                                                          \
+        end = clock();                                             \
+        int n = static_cast<int>(static_cast<double>(end - start)  \
+                                 / CLOCKS_PER_SEC * 1000);         \
+        std::snprintf(buf, sizeof(buf), "%d", n);                  \
+        std::string t = buf;                                       \
+        t += "ms    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+// 占用的内存，单位 MB
+#define BIT_MEM_DO_TEST(bytes)                                     \
+    do {                                                           \
+        char buf[10];                                              \
+        std::snprintf(buf, sizeof(buf), "%.1f",                    \
+                      static_cast<double>(bytes) / (1 << 20));     \
+        std::string t = buf;                                       \
+        t += "MB    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+// x 中每三个元素有一个为 true，y 只有最后一个元素为 true
+#define VECTOR_BOOL_TEST(len)                                                 \
+    do {                                                                      \
+        const size_t n = len;                                                 \
+        volatile size_t sink = 0;                                             \
+        mystl::vector<char> cx(n), cy(n);                                     \
+        std::vector<bool> sx(n), sy(n);                                       \
+        mystl::vector<bool> bx(n), by(n);                                     \
+        for (size_t i = 0; i < n; i += 3) {                                   \
+            cx[i] = 1;                                                        \
+            sx[i] = true;                                                     \
+            bx[i] = true;                                                     \
+        }                                                                     \
+        cy[n - 1] = 1;                                                        \
+        sy[n - 1] = true;                                                     \
+        by[n - 1] = true;                                                     \
+        std::cout << "|" << std::setw(12) << n << " elements|";               \
+        std::cout << std::setw(WIDE) << "vector<char>|";                      \
+        std::cout << std::setw(WIDE) << "std::v<bool>|";                      \
+        std::cout << std::setw(WIDE) << "vector<bool>|";                      \
+        std::cout << "\n|        count        |";                             \
+        BIT_OP_DO_TEST(sink += mystl::count(cx.begin(), cx.end(), char(1)));  \
+        BIT_OP_DO_TEST(sink += std::count(sx.begin(), sx.end(), true));       \
+        BIT_OP_DO_TEST(sink += mystl::count(bx.begin(), bx.end(), true));     \
+        std::cout << "\n|        find         |";                             \
+        BIT_OP_DO_TEST(sink += mystl::find(cy.begin(), cy.end(), char(1)) -   \
+                               cy.begin());                                   \
+        BIT_OP_DO_TEST(sink += std::find(sy.begin(), sy.end(), true) -        \
+                               sy.begin());                                   \
+        BIT_OP_DO_TEST(sink += mystl::find(by.begin(), by.end(), true) -      \
+                               by.begin());                                   \
+        std::cout << "\n|        fill         |";                             \
+        BIT_OP_DO_TEST(mystl::fill(cy.begin(), cy.end() - 1, char(r & 1)));   \
+        BIT_OP_DO_TEST(std::fill(sy.begin(), sy.end() - 1, (r & 1) != 0));    \
+        BIT_OP_DO_TEST(mystl::fill(by.begin(), by.end() - 1, (r & 1) != 0));  \
+        std::cout << "\n|        copy         |";                             \
+        BIT_OP_DO_TEST(mystl::copy(cx.begin(), cx.end(), cy.begin()));        \
+        BIT_OP_DO_TEST(std::copy(sx.begin(), sx.end(), sy.begin()));          \
+        BIT_OP_DO_TEST(mystl::copy(bx.begin(), bx.end(), by.begin()));        \
+        std::cout << "\n|    copy (shifted)   |";                             \
+        BIT_OP_DO_TEST(mystl::copy(cx.begin() + 1, cx.end(), cy.begin()));    \
+        BIT_OP_DO_TEST(std::copy(sx.begin() + 1, sx.end(), sy.begin()));      \
+        BIT_OP_DO_TEST(mystl::copy(bx.begin() + 1, bx.end(), by.begin()));    \
+        mystl::copy(cx.begin(), cx.end(), cy.begin());                        \
+        std::copy(sx.begin(), sx.end(), sy.begin());                          \
+        mystl::copy(bx.begin(), bx.end(), by.begin());                        \
+        std::cout << "\n|        equal        |";                             \
+        BIT_OP_DO_TEST(sink += mystl::equal(cx.begin(), cx.end(), cy.begin())); \
+        BIT_OP_DO_TEST(sink += std::equal(sx.begin(), sx.end(), sy.begin()));   \
+        BIT_OP_DO_TEST(sink += mystl::equal(bx.begin(), bx.end(), by.begin())); \
+        std::cout << "\n|       memory        |";                             \
+        BIT_MEM_DO_TEST(cx.capacity());                                       \
+        BIT_MEM_DO_TEST(sx.capacity() / 8);                                   \
+        BIT_MEM_DO_TEST(bx.capacity() / 8);                                   \
+        (void)sink;                                                           \
+    } while (0)
+
+void vector_bool_test() {
+    std::cout << "[===============================================================]\n";
+    std::cout << "[-------------- Run container test : vector<bool> --------------]\n";
+    std::cout << "[-------------------------- API test ---------------------------]\n";
+    bool a[] = {true, false, true, true, false};
+    mystl::vector<bool> v1;
+    mystl::vector<bool> v2(10);
+    mystl::vector<bool> v3(10, true);
+    mystl::vector<bool> v4(a, a + 5);
+    mystl::vector<bool> v5(v2);
+    mystl::vector<bool> v6(std::move(v2));
+    mystl::vector<bool> v7{true, false, true, false, true, false, true};
+    mystl::vector<bool> v8, v9, v10;
+    v8 = v3;
+    v9 = std::move(v3);
+    v10 = {true, false, true, false, true, false, true};
+
+    FUN_AFTER(v1, v1.assign(8, true));
+    FUN_AFTER(v1, v1.assign(a, a + 5));
+    FUN_AFTER(v1, v1.emplace(v1.begin(), false));
+    FUN_AFTER(v1, v1.emplace_back(true));
+    FUN_AFTER(v1, v1.push_back(false));
+    FUN_AFTER(v1, v1.insert(v1.end(), true));
+    FUN_AFTER(v1, v1.insert(v1.begin() + 3, 2, false));
+    FUN_AFTER(v1, v1.insert(v1.begin(), a, a + 5));
+    FUN_AFTER(v1, v1.pop_back());
+    FUN_AFTER(v1, v1.erase(v1.begin()));
+    FUN_AFTER(v1, v1.erase(v1.begin(), v1.begin() + 2));
+    FUN_AFTER(v1, v1.flip());
+    FUN_AFTER(v1, v1[0].flip());
+    FUN_AFTER(v1, v1.swap(v1[0], v1[3]));
+    FUN_AFTER(v1, mystl::reverse(v1.begin(), v1.end()));
+    FUN_AFTER(v1, mystl::fill(v1.begin() + 1, v1.begin() + 4, true));
+    FUN_AFTER(v1, mystl::copy(v4.begin(), v4.end(), v1.begin() + 2));
+    FUN_AFTER(v1, v1.swap(v4));
+    FUN_VALUE(*v1.begin());
+    FUN_VALUE(*(v1.end() - 1));
+    FUN_VALUE(*v1.rbegin());
+    FUN_VALUE(*(v1.rend() - 1));
+    FUN_VALUE(v1.front());
+    FUN_VALUE(v1.back());
+    FUN_VALUE(v1[0]);
+    FUN_VALUE(v1.at(1));
+    FUN_VALUE(mystl::count(v1.begin(), v1.end(), true));
+    FUN_VALUE(mystl::find(v1.begin(), v1.end(), false) - v1.begin());
+    FUN_VALUE(*v1.word_data());
+    std::cout << std::boolalpha;
+    FUN_VALUE(v1.empty());
+    FUN_VALUE((v7 == v10));
+    FUN_VALUE((v5 < v7));
+    FUN_VALUE(mystl::equal(v1.begin(), v1.end(), v4.begin()));
+    std::cout << std::noboolalpha;
+    FUN_VALUE(v1.size());
+    FUN_VALUE(v1.max_size());
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.resize(10));
+    FUN_VALUE(v1.size());
+    FUN_AFTER(v1, v1.resize(70, true));
+    FUN_VALUE(v1.size());
+    FUN_VALUE(mystl::count(v1.begin(), v1.end(), true));
+    FUN_AFTER(v1, v1.shrink_to_fit());
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.clear());
+    FUN_AFTER(v1, v1.reserve(5));
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.reserve(1000));
+    FUN_VALUE(v1.capacity());
+    PASSED;
+#if PERFORMANCE_TEST_ON
+    std::cout << "[--------------------- Performance Testing ---------------------]\n";
+    std::cout << "|---------------------|-------------|-------------|-------------|\n";
+#if LARGER_TEST_DATA_ON
+    VECTOR_BOOL_TEST(SCALE_LL(SCALE_LL(LEN3)));
+#else
+    VECTOR_BOOL_TEST(SCALE_LL(LEN3));
+#endif
+    std::cout << "\n";
+    std::cout << "|---------------------|-------------|-------------|-------------|\n";
+    PASSED;
+#endif
+    std::cout << "[-------------- End container test : vector<bool> --------------]\n";
+}
+
+}  // namespace vector_bool_test
+}  // namespace test
+}  // namespace mystl
+#endif  // !MYTINYSTL_VECTOR_BOOL_TEST_H_
@@ -1,10 +1,16 @@
 #ifndef MYTINYSTL_VECTOR_TEST_H_
 #define MYTINYSTL_VECTOR_TEST_H_
 
-// vector test : 测试 vector 的接口与 push_back 的性能
+// vector test : 测试 vector 的接口与 push_back 的性能，vector<mystl::string>
+// 扩容时按位搬移与逐个移动元素的耗时，构造 1 GB 的 vector 时的耗时与内存峰值，
+// 以及把字节流解码到 vector 中的几种写法
 
+#include <cstdint>
+#include <fstream>
+#include <string>
 #include <vector>
 
+#include "../MyTinySTL/astring.h"
 #include "../MyTinySTL/vector.h"
 #include "test.h"
 
@@ -12,6 +18,198 @@ namespace mystl {
 namespace test {
 namespace vector_test {
 
+// 与 mystl::string 相同，但没有特化 is_trivially_relocatable，
+// vector 扩容时只能逐个移动构造再析构原来的元素
+struct moved_string : public mystl::string {
+    moved_string(const char* s) : mystl::string(s) {}
+};
+
+// 反复构造 total / elems 个向量，每个不预留空间逐个 emplace_back elems 个短字符串，
+// 耗时主要来自扩容时搬移元素
+#define VECTOR_GROW_DO_TEST(con, elems, total)                    \
+    do {                                                           \
+        clock_t start, end;                                        \
+        char buf[10];                                              \
+        start = clock();                                           \
+        for (size_t k = 0; k < total / elems; ++k) {               \
+            con v;                                                 \
+            for (size_t i = 0; i < elems; ++i)                     \
+                v.emplace_back("relocate");                        \
+        }                                                          \
+        end = clock();                                             \
+        int n = static_cast<int>(static_cast<double>(end - start)  \
+                                 / CLOCKS_PER_SEC * 1000);         \
+        std::snprintf(buf, sizeof(buf), "%d", n);                  \
+        std::string t = buf;                                       \
+        t += "ms    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+// 与 mystl::allocator 相同，但 vector 不会对它使用映射的页面，扩容时总是复制
+template <class T>
+class copy_allocator : public mystl::allocator<T> {
+public:
+    template <class U>
+    struct rebind {
+        typedef copy_allocator<U> other;
+    };
+
+    copy_allocator() noexcept = default;
+    template <class U>
+    copy_allocator(const copy_allocator<U>&) noexcept {}
+};
+
+typedef mystl::vector<uint64_t, copy_allocator<uint64_t>> copy_vector;
+
+// 进程的内存峰值（MB），读取 Linux 的 VmHWM，其他平台为 0
+inline size_t peak_rss_mb() {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return std::strtoul(line.c_str() + 6, nullptr, 10) / 1024;
+    }
+    return 0;
+}
+
+// 把内存峰值重置为当前占用
+inline void reset_peak_rss() {
+    std::ofstream out("/proc/self/clear_refs");
+    out << "5";
+}
+
+// 不预留空间 push_back 到 bytes 字节，输出耗时、内存峰值以及峰值与数据量之比
+#define VECTOR_BUILD_TEST(con, bytes)                              \
+    do {                                                           \
+        clock_t start, end;                                        \
+        char buf[16];                                              \
+        const size_t count = bytes / sizeof(uint64_t);             \
+        reset_peak_rss();                                          \
+        const size_t base = peak_rss_mb();                         \
+        start = clock();                                           \
+        {                                                          \
+            con v;                                                 \
+            for (size_t i = 0; i < count; ++i)                     \
+                v.push_back(i);                                    \
+            sink += v[count / 2];                                  \
+        }                                                          \
+        end = clock();                                             \
+        const size_t peak = peak_rss_mb();                         \
+        const size_t used = peak > base ? peak - base : 0;         \
+        int n = static_cast<int>(static_cast<double>(end - start)  \
+                                 / CLOCKS_PER_SEC * 1000);         \
+        std::snprintf(buf, sizeof(buf), "%d", n);                  \
+        std::string t = buf;                                       \
+        t += "ms    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+        std::snprintf(buf, sizeof(buf), "%zu", used);              \
+        t = buf;                                                   \
+        t += "MB    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+        std::snprintf(buf, sizeof(buf), "%.2fx",                   \
+                      static_cast<double>(used) / (bytes >> 20));  \
+        t = buf;                                                   \
+        t += "     |";                                             \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+// 把小端字节流 src 解码为 n 个 int 写入 out
+inline void decode_ints(const unsigned char* src, size_t n, int* out) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t x;
+        std::memcpy(&x, src + i * 4, 4);
+        out[i] = static_cast<int>(x);
+    }
+}
+
+// 待解码的字节流，按需扩大，所有测试共用
+inline const unsigned char* decode_source(size_t n) {
+    static std::vector<unsigned char> src;
+    if (src.size() < n * 4) {
+        src.resize(n * 4);
+        for (size_t i = 0; i < src.size(); ++i)
+            src[i] = static_cast<unsigned char>(i * 131);
+    }
+    return src.data();
+}
+
+// 几种解码方式：先 resize 再覆盖、resize_default_init、分块 append_uninitialized、
+// 逐个 push_back
+#define DECODE_RESIZE(v, src, n)                                   \
+    v.resize(n);                                                   \
+    decode_ints(src, n, v.data())
+
+#define DECODE_DEFAULT_INIT(v, src, n)                             \
+    v.resize_default_init(n);                                      \
+    decode_ints(src, n, v.data())
+
+#define DECODE_APPEND(v, src, n)                                   \
+    for (size_t off = 0; off < n; off += 65536) {                  \
+        const size_t m = n - off < 65536 ? n - off : 65536;        \
+        decode_ints(src + off * 4, m, v.append_uninitialized(m));  \
+    }
+
+#define DECODE_PUSH_BACK(v, src, n)                                \
+    for (size_t i = 0; i < n; ++i) {                               \
+        uint32_t x;                                                \
+        std::memcpy(&x, src + i * 4, 4);                           \
+        v.push_back(static_cast<int>(x));                          \
+    }
+
+#define VECTOR_DECODE_DO_TEST(mode, count)                        \
+    do {                                                           \
+        clock_t start, end;                                        \
+        char buf[10];                                              \
+        const unsigned char* src = decode_source(count);          \
+        start = clock();                                           \
+        {                                                          \
+            mystl::vector<int> v;                                  \
+            mode(v, src, count);                                   \
+            sink += v[count / 2];                                  \
+        }                                                          \
+        end = clock();                                             \
+        int n = static_cast<int>(static_cast<double>(end - start)  \
+                                 / CLOCKS_PER_SEC * 1000);         \
+        std::snprintf(buf, sizeof(buf), "%d", n);                  \
+        std::string t = buf;                                       \
+        t += "ms    |";                                            \
+        std::cout << std::setw(WIDE) << t;                         \
+    } while (0)
+
+#define VECTOR_DECODE_TEST(l1, l2, l3)                            \
+    TEST_LEN(l1, l2, l3, WIDE);                                    \
+    std::cout << "|       resize        |";                        \
+    VECTOR_DECODE_DO_TEST(DECODE_RESIZE, l1);                      \
+    VECTOR_DECODE_DO_TEST(DECODE_RESIZE, l2);                      \
+    VECTOR_DECODE_DO_TEST(DECODE_RESIZE, l3);                      \
+    std::cout << "\n| resize_default_init |";                      \
+    VECTOR_DECODE_DO_TEST(DECODE_DEFAULT_INIT, l1);                \
+    VECTOR_DECODE_DO_TEST(DECODE_DEFAULT_INIT, l2);                \
+    VECTOR_DECODE_DO_TEST(DECODE_DEFAULT_INIT, l3);                \
+    std::cout << "\n|append_uninitialized |";                      \
+    VECTOR_DECODE_DO_TEST(DECODE_APPEND, l1);                      \
+    VECTOR_DECODE_DO_TEST(DECODE_APPEND, l2);                      \
+    VECTOR_DECODE_DO_TEST(DECODE_APPEND, l3);                      \
+    std::cout << "\n|      push_back      |";                      \
+    VECTOR_DECODE_DO_TEST(DECODE_PUSH_BACK, l1);                   \
+    VECTOR_DECODE_DO_TEST(DECODE_PUSH_BACK, l2);                   \
+    VECTOR_DECODE_DO_TEST(DECODE_PUSH_BACK, l3);
+
+#define VECTOR_GROW_TEST(total, e1, e2, e3)                       \
+    TEST_LEN(e1, e2, e3, WIDE);                                    \
+    std::cout << "|     std::string     |";                        \
+    VECTOR_GROW_DO_TEST(std::vector<std::string>, e1, total);      \
+    VECTOR_GROW_DO_TEST(std::vector<std::string>, e2, total);      \
+    VECTOR_GROW_DO_TEST(std::vector<std::string>, e3, total);      \
+    std::cout << "\n|   string (move)     |";                      \
+    VECTOR_GROW_DO_TEST(mystl::vector<moved_string>, e1, total);   \
+    VECTOR_GROW_DO_TEST(mystl::vector<moved_string>, e2, total);   \
+    VECTOR_GROW_DO_TEST(mystl::vector<moved_string>, e3, total);   \
+    std::cout << "\n|  string (relocate)  |";                      \
+    VECTOR_GROW_DO_TEST(mystl::vector<mystl::string>, e1, total);  \
+    VECTOR_GROW_DO_TEST(mystl::vector<mystl::string>, e2, total);  \
+    VECTOR_GROW_DO_TEST(mystl::vector<mystl::string>, e3, total);
+
 void vector_test() {
     std::cout << "[===============================================================]\n";
     std::cout << "[----------------- Run container test : vector -----------------]\n";
@@ -87,6 +285,29 @@ void vector_test() {
     FUN_AFTER(v1, v1.shrink_to_fit());
     FUN_VALUE(v1.size());
     FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.append_range(a, a + 5));
+    FUN_AFTER(v1, v1.resize_default_init(3));
+    v1.resize_default_init(5);  // 新增的两个元素未初始化，只看大小
+    FUN_VALUE(v1.size());
+    v1.resize_default_init(3);
+    {
+        int* w = v1.append_uninitialized(3);
+        w[0] = 7;
+        w[1] = 8;
+        w[2] = 9;
+    }
+    std::cout << " After v1.append_uninitialized(3) and fill 7 8 9 :\n";
+    COUT(v1);
+    mystl::vector<mystl::string> v11;
+    v11.emplace_back("short");
+    v11.emplace_back("a string longer than the inline buffer");
+    FUN_AFTER(v11, v11.emplace(v11.begin(), "front"));
+    FUN_AFTER(v11, v11.insert(v11.begin() + 1, 2, "two"));
+    FUN_AFTER(v11, v11.shrink_to_fit());
+    std::cout << std::boolalpha;
+    FUN_VALUE(mystl::is_trivially_relocatable<mystl::string>::value);
+    FUN_VALUE(mystl::is_trivially_relocatable<moved_string>::value);
+    std::cout << std::noboolalpha;
     PASSED;
 #if PERFORMANCE_TEST_ON
     std::cout << "[--------------------- Performance Testing ---------------------]\n";
@@ -101,6 +322,32 @@ void vector_test() {
 #endif
     std::cout << "\n";
     std::cout << "|---------------------|-------------|-------------|-------------|\n";
+    std::cout << "|  strings per vector |";
+#if LARGER_TEST_DATA_ON
+    VECTOR_GROW_TEST(SCALE_L(LEN3), 1000, 10000, 100000);
+#else
+    VECTOR_GROW_TEST(LEN3, 1000, 10000, 100000);
+#endif
+    std::cout << "\n";
+    std::cout << "|---------------------|-------------|-------------|-------------|\n";
+    {
+        // 峰值只在 Linux 上统计，重置峰值需要内核支持 clear_refs
+        volatile uint64_t sink = 0;
+        const size_t bytes = size_t(1) << 30;
+        std::cout << "| push_back to 1 GB   |    time     |  peak RSS   | RSS / data  |\n";
+        std::cout << "|     std::vector     |";
+        VECTOR_BUILD_TEST(std::vector<uint64_t>, bytes);
+        std::cout << "\n|    vector (copy)    |";
+        VECTOR_BUILD_TEST(copy_vector, bytes);
+        std::cout << "\n|   vector (mremap)   |";
+        VECTOR_BUILD_TEST(mystl::vector<uint64_t>, bytes);
+        std::cout << "\n";
+        std::cout << "|---------------------|-------------|-------------|-------------|\n";
+        std::cout << "|     decode ints     |";
+        VECTOR_DECODE_TEST(LEN2, LEN3, SCALE_LL(LEN3));
+        std::cout << "\n";
+        std::cout << "|---------------------|-------------|-------------|-------------|\n";
+    }
     PASSED;
 #endif
     std::cout << "[----------------- End container test : vector -----------------]\n";